@@ -8,6 +8,10 @@ import org.junit.Test
 import org.junit.runner.RunWith
 import java.io.File
 import java.io.FileOutputStream
+import java.nio.ByteBuffer
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertFalse
 import kotlin.test.assertNotNull
 import kotlin.test.assertTrue
 
@@ -174,4 +178,213 @@ class ThumbnailGenerationTest {
         assertTrue(metadata.containsKey("height"), "Metadata should contain height")
         assertTrue(metadata.containsKey("duration"), "Metadata should contain duration")
     }
+    
+    @Test
+    fun testMediaHandleBatchedThumbnailsAndMetadata() {
+        val videoPath = "C:\\Work\\smart-ffmpeg-android\\assets\\heavenly_place.avi"
+        val videoFile = File(videoPath)
+        
+        assertTrue(videoFile.exists(), "Test video file should exist")
+        
+        val media = MediaHandle.open(videoPath)
+        assertNotNull(media, "Media handle should open")
+        
+        media.use {
+            // Same results as the one-shot calls
+            assertEquals(SmartFfmpegBridge.getVideoDuration(videoPath), it.getDuration())
+            assertEquals(SmartFfmpegBridge.getVideoMetadata(videoPath), it.getMetadata())
+            assertEquals(SmartFfmpegBridge.getVideoMetadataJson(videoPath), it.getMetadataJson())
+            
+            val timestamps = listOf(0L, 1000L, 2000L, 3000L, 4000L)
+            val targetWidth = 320
+            val targetHeight = 180
+            
+            val startTime = System.currentTimeMillis()
+            timestamps.forEach { timeMs ->
+                val rgbaData = it.extractThumbnail(timeMs, targetWidth, targetHeight)
+                
+                assertNotNull(rgbaData, "Thumbnail at ${timeMs}ms should not be null")
+                assertEquals(targetWidth * targetHeight * 4, rgbaData.size)
+            }
+            val extractionTime = System.currentTimeMillis() - startTime
+            
+            println("✅ ${timestamps.size} thumbnails through one handle in ${extractionTime}ms")
+        }
+        
+        assertTrue(media.isClosed, "Handle should be closed after use")
+        assertFailsWith<IllegalStateException> { media.getDuration() }
+    }
+    
+    @Test
+    fun testSpriteSheetSinglePass() {
+        val videoPath = "C:\\Work\\smart-ffmpeg-android\\assets\\heavenly_place.avi"
+        val videoFile = File(videoPath)
+        
+        assertTrue(videoFile.exists(), "Test video file should exist")
+        
+        val media = MediaHandle.open(videoPath)
+        assertNotNull(media, "Media handle should open")
+        
+        media.use {
+            val count = 10
+            val columns = 5
+            val tileWidth = 160
+            val tileHeight = 90
+            
+            listOf(false, true).forEach { keyframesOnly ->
+                val timestamps = LongArray(count)
+                val startTime = System.currentTimeMillis()
+                val sheet = it.extractSpriteSheet(
+                    count, tileWidth, tileHeight, columns,
+                    keyframesOnly = keyframesOnly, timestampsOut = timestamps
+                )
+                val extractionTime = System.currentTimeMillis() - startTime
+                
+                assertNotNull(sheet, "Sprite sheet should not be null")
+                assertEquals(columns * tileWidth * 2 * tileHeight * 4, sheet.size)
+                // One ordered pass: tile times never go backwards
+                for (i in 1 until count) {
+                    assertTrue(timestamps[i] >= timestamps[i - 1], "Tile times should be ordered")
+                }
+                
+                println("✅ Sprite sheet ($count tiles, keyframesOnly=$keyframesOnly) in ${extractionTime}ms")
+            }
+        }
+    }
+    
+    @Test
+    fun testFastThumbnailMode() {
+        val videoPath = "C:\\Work\\smart-ffmpeg-android\\assets\\heavenly_place.avi"
+        val videoFile = File(videoPath)
+        
+        assertTrue(videoFile.exists(), "Test video file should exist")
+        
+        val targetWidth = 160
+        val targetHeight = 90
+        val expectedSize = targetWidth * targetHeight * 4
+        
+        listOf(0L, 2000L, 4000L).forEach { timeMs ->
+            var startTime = System.currentTimeMillis()
+            val exact = SmartFfmpegBridge.extractThumbnail(videoPath, timeMs, targetWidth, targetHeight)
+            val exactTime = System.currentTimeMillis() - startTime
+            
+            startTime = System.currentTimeMillis()
+            val fast = SmartFfmpegBridge.extractThumbnailFast(videoPath, timeMs, targetWidth, targetHeight)
+            val fastTime = System.currentTimeMillis() - startTime
+            
+            assertNotNull(exact, "Exact thumbnail at ${timeMs}ms should not be null")
+            assertNotNull(fast, "Fast thumbnail at ${timeMs}ms should not be null")
+            assertEquals(expectedSize, exact.size)
+            assertEquals(expectedSize, fast.size)
+            
+            println("✅ ${timeMs}ms: exact ${exactTime}ms, fast ${fastTime}ms")
+        }
+        
+        MediaHandle.open(videoPath)?.use {
+            val fast = it.extractThumbnail(2000L, targetWidth, targetHeight, fast = true)
+            assertNotNull(fast, "Fast handle thumbnail should not be null")
+            assertEquals(expectedSize, fast.size)
+        }
+    }
+    
+    @Test
+    fun testThumbnailIntoDirectBuffer() {
+        val videoPath = "C:\\Work\\smart-ffmpeg-android\\assets\\heavenly_place.avi"
+        val videoFile = File(videoPath)
+        
+        assertTrue(videoFile.exists(), "Test video file should exist")
+        
+        val targetWidth = 160
+        val targetHeight = 90
+        val buffer = SmartFfmpegBridge.allocateThumbnailBuffer(targetWidth, targetHeight)
+        assertEquals(targetWidth * targetHeight * 4, buffer.capacity())
+        
+        // Same pixels as the ByteArray API
+        val expected = SmartFfmpegBridge.extractThumbnail(videoPath, 2000L, targetWidth, targetHeight)
+        assertNotNull(expected, "Reference thumbnail should not be null")
+        assertTrue(SmartFfmpegBridge.extractThumbnailInto(videoPath, 2000L, targetWidth, targetHeight, false, buffer, 0))
+        val actual = ByteArray(buffer.capacity())
+        buffer.duplicate().get(actual)
+        assertTrue(expected.contentEquals(actual), "Direct buffer pixels should match extractThumbnail")
+        
+        // One buffer reused across a warm handle
+        MediaHandle.open(videoPath)?.use { media ->
+            listOf(0L, 2000L, 4000L).forEach { timeMs ->
+                assertTrue(media.extractThumbnailInto(timeMs, targetWidth, targetHeight, buffer), "Thumbnail at ${timeMs}ms")
+            }
+        }
+        
+        // Undersized buffers are rejected
+        val small = ByteBuffer.allocateDirect(16)
+        assertFalse(SmartFfmpegBridge.extractThumbnailInto(videoPath, 0L, targetWidth, targetHeight, false, small, 0))
+    }
+    
+    @Test
+    fun testEncodedThumbnail() {
+        val videoPath = "C:\\Work\\smart-ffmpeg-android\\assets\\heavenly_place.avi"
+        val videoFile = File(videoPath)
+        
+        assertTrue(videoFile.exists(), "Test video file should exist")
+        assertTrue(ThumbnailFormat.JPEG.isSupported, "MJPEG encoder should be bundled")
+        
+        val targetWidth = 320
+        val targetHeight = 180
+        val jpeg = SmartFfmpegBridge.extractThumbnailEncoded(
+            videoPath, 2000L, targetWidth, targetHeight, false, ThumbnailFormat.JPEG.value, 80
+        )
+        assertNotNull(jpeg, "JPEG thumbnail should not be null")
+        assertEquals(0xFF.toByte(), jpeg[0])
+        assertEquals(0xD8.toByte(), jpeg[1])
+        assertTrue(jpeg.size < targetWidth * targetHeight * 4 / 4, "JPEG should be much smaller than RGBA")
+        
+        val bitmap = BitmapFactory.decodeByteArray(jpeg, 0, jpeg.size)
+        assertNotNull(bitmap, "JPEG should decode")
+        assertEquals(targetWidth, bitmap.width)
+        assertEquals(targetHeight, bitmap.height)
+        println("✅ JPEG thumbnail: ${jpeg.size} bytes (RGBA: ${targetWidth * targetHeight * 4})")
+        
+        if (ThumbnailFormat.WEBP.isSupported) {
+            MediaHandle.open(videoPath)?.use {
+                val webp = it.extractThumbnailEncoded(2000L, targetWidth, targetHeight, ThumbnailFormat.WEBP)
+                assertNotNull(webp, "WebP thumbnail should not be null")
+                assertNotNull(BitmapFactory.decodeByteArray(webp, 0, webp.size), "WebP should decode")
+            }
+        } else {
+            assertEquals(null, SmartFfmpegBridge.extractThumbnailEncoded(
+                videoPath, 2000L, targetWidth, targetHeight, false, ThumbnailFormat.WEBP.value, 80
+            ))
+        }
+    }
+    
+    @Test
+    fun testMediaBatchDeliversEveryFile() {
+        val videoPath = "C:\\Work\\smart-ffmpeg-android\\assets\\heavenly_place.avi"
+        val videoFile = File(videoPath)
+        
+        assertTrue(videoFile.exists(), "Test video file should exist")
+        
+        // Same file several times plus one missing file: every index is reported once
+        val paths = List(8) { videoPath } + "/nonexistent/missing.mp4"
+        val seen = mutableSetOf<Int>()
+        val options = MediaBatch.Options(thumbnailWidth = 160, thumbnailHeight = 90)
+        
+        val startTime = System.currentTimeMillis()
+        val delivered = MediaBatch.run(paths, options) { result ->
+            assertTrue(seen.add(result.index), "Index ${result.index} should be delivered once")
+            if (result.index == paths.lastIndex) {
+                assertNotNull(result.error, "Missing file should report an error")
+            } else {
+                assertEquals(SmartFfmpegBridge.getVideoDuration(videoPath), result.durationMs)
+                assertNotNull(result.metadata, "Metadata should not be null")
+                assertNotNull(result.thumbnail, "Thumbnail should not be null")
+                assertEquals(160 * 90 * 4, result.thumbnail.size)
+            }
+            true
+        }
+        val batchTime = System.currentTimeMillis() - startTime
+        
+        assertEquals(paths.size, delivered)
+        assertEquals(paths.indices.toSet(), seen)
+        println("✅ Batch of ${paths.size} files in ${batchTime}ms")
+    }
 }
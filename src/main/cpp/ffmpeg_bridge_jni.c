@@ -1,183 +1,38 @@
 #include <jni.h>
+#include <stdlib.h>
 #include <string.h>
 #include <android/log.h>
 #include <libavformat/avformat.h>
-#include <libavcodec/avcodec.h>
-#include <libavutil/imgutils.h>
-#include <libswscale/swscale.h>
+#include <libavutil/mem.h>
+#include "media_handle.h"  // Open-once handle: format context / decoder / sws (native_media_engine/ffmpeg_player)
+#include "media_batch.h"   // Gallery batches on a bounded worker pool
+#include "thumb_encode.h"  // JPEG / WebP thumbnails through libavcodec encoders
 
 #define LOG_TAG "SmartFfmpegBridge"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
 /**
- * Extract thumbnail from video at specified timestamp
- * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnail
+ * Decode a thumbnail through an open handle into a new Java byte array (RGBA8888)
  */
-JNIEXPORT jbyteArray JNICALL
-Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnail(
-    JNIEnv *env,
-    jobject thiz,
-    jstring videoPath,
-    jlong timeMs,
-    jint width,
-    jint height
-) {
-    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
-    if (path == NULL) {
-        LOGE("Failed to get video path string");
-        return NULL;
-    }
-
-    LOGI("Extracting thumbnail from: %s at %lld ms, size: %dx%d", path, (long long)timeMs, width, height);
-
-    AVFormatContext *formatCtx = NULL;
-    AVCodecContext *codecCtx = NULL;
-    AVCodec *codec = NULL;
-    AVFrame *frame = NULL;
-    AVFrame *frameRGBA = NULL;
-    AVPacket packet;
-    struct SwsContext *swsCtx = NULL;
-    jbyteArray result = NULL;
-    int videoStream = -1;
-
-    // Open video file
-    if (avformat_open_input(&formatCtx, path, NULL, NULL) != 0) {
-        LOGE("Could not open video file: %s", path);
-        goto cleanup;
-    }
-
-    // Retrieve stream information
-    if (avformat_find_stream_info(formatCtx, NULL) < 0) {
-        LOGE("Could not find stream information");
-        goto cleanup;
-    }
-
-    // Find video stream
-    for (int i = 0; i < formatCtx->nb_streams; i++) {
-        if (formatCtx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
-            videoStream = i;
-            break;
-        }
-    }
-
-    if (videoStream == -1) {
+static jbyteArray thumbnail_to_byte_array(JNIEnv *env, MediaHandle *handle, jlong timeMs,
+                                          jint width, jint height, MediaThumbnailMode mode) {
+    int outWidth = 0;
+    int outHeight = 0;
+    if (media_handle_thumbnail_size(handle, width, height, &outWidth, &outHeight) != MEDIA_HANDLE_OK) {
         LOGE("Could not find video stream");
-        goto cleanup;
-    }
-
-    // Get codec parameters
-    AVCodecParameters *codecParams = formatCtx->streams[videoStream]->codecpar;
-    
-    // Find decoder
-    codec = avcodec_find_decoder(codecParams->codec_id);
-    if (codec == NULL) {
-        LOGE("Unsupported codec");
-        goto cleanup;
-    }
-
-    // Allocate codec context
-    codecCtx = avcodec_alloc_context3(codec);
-    if (codecCtx == NULL) {
-        LOGE("Could not allocate codec context");
-        goto cleanup;
-    }
-
-    // Copy codec parameters to context
-    if (avcodec_parameters_to_context(codecCtx, codecParams) < 0) {
-        LOGE("Could not copy codec parameters");
-        goto cleanup;
-    }
-
-    // Open codec
-    if (avcodec_open2(codecCtx, codec, NULL) < 0) {
-        LOGE("Could not open codec");
-        goto cleanup;
-    }
-
-    // Allocate frames
-    frame = av_frame_alloc();
-    frameRGBA = av_frame_alloc();
-    if (frame == NULL || frameRGBA == NULL) {
-        LOGE("Could not allocate frames");
-        goto cleanup;
+        return NULL;
     }
 
-    // Determine output size
-    int outWidth = width > 0 ? width : codecCtx->width;
-    int outHeight = height > 0 ? height : codecCtx->height;
-
-    // Allocate buffer for RGBA frame
-    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGBA, outWidth, outHeight, 1);
-    uint8_t *buffer = (uint8_t *)av_malloc(numBytes * sizeof(uint8_t));
+    int numBytes = outWidth * outHeight * 4;
+    uint8_t *buffer = (uint8_t *)av_malloc(numBytes);
     if (buffer == NULL) {
         LOGE("Could not allocate buffer");
-        goto cleanup;
-    }
-
-    av_image_fill_arrays(frameRGBA->data, frameRGBA->linesize, buffer,
-                        AV_PIX_FMT_RGBA, outWidth, outHeight, 1);
-
-    // Initialize SWS context for software scaling
-    swsCtx = sws_getContext(
-        codecCtx->width, codecCtx->height, codecCtx->pix_fmt,
-        outWidth, outHeight, AV_PIX_FMT_RGBA,
-        SWS_BILINEAR, NULL, NULL, NULL
-    );
-
-    if (swsCtx == NULL) {
-        LOGE("Could not initialize SWS context");
-        av_free(buffer);
-        goto cleanup;
-    }
-
-    // Seek to timestamp
-    int64_t timestamp = (timeMs * formatCtx->streams[videoStream]->time_base.den) / 
-                       (1000 * formatCtx->streams[videoStream]->time_base.num);
-    
-    if (av_seek_frame(formatCtx, videoStream, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
-        LOGE("Could not seek to timestamp");
-    }
-
-    avcodec_flush_buffers(codecCtx);
-
-    // Read frames until we find the one we want
-    int frameFinished = 0;
-    while (av_read_frame(formatCtx, &packet) >= 0) {
-        if (packet.stream_index == videoStream) {
-            // Decode video frame
-            int ret = avcodec_send_packet(codecCtx, &packet);
-            if (ret < 0) {
-                LOGE("Error sending packet for decoding");
-                av_packet_unref(&packet);
-                continue;
-            }
-
-            ret = avcodec_receive_frame(codecCtx, frame);
-            if (ret == 0) {
-                frameFinished = 1;
-                av_packet_unref(&packet);
-                break;
-            } else if (ret == AVERROR(EAGAIN)) {
-                // Need more packets
-                av_packet_unref(&packet);
-                continue;
-            } else {
-                LOGE("Error receiving frame");
-                av_packet_unref(&packet);
-                break;
-            }
-        }
-        av_packet_unref(&packet);
+        return NULL;
     }
 
-    if (frameFinished) {
-        // Convert to RGBA
-        sws_scale(swsCtx, (uint8_t const *const *)frame->data,
-                 frame->linesize, 0, codecCtx->height,
-                 frameRGBA->data, frameRGBA->linesize);
-
-        // Create Java byte array
+    jbyteArray result = NULL;
+    if (media_handle_thumbnail_rgba(handle, timeMs, outWidth, outHeight, mode, buffer, outWidth * 4) == MEDIA_HANDLE_OK) {
         result = (*env)->NewByteArray(env, numBytes);
         if (result != NULL) {
             (*env)->SetByteArrayRegion(env, result, 0, numBytes, (jbyte *)buffer);
@@ -190,126 +45,88 @@ Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnail(
     }
 
     av_free(buffer);
-    sws_freeContext(swsCtx);
-
-cleanup:
-    if (frame) av_frame_free(&frame);
-    if (frameRGBA) av_frame_free(&frameRGBA);
-    if (codecCtx) avcodec_free_context(&codecCtx);
-    if (formatCtx) avformat_close_input(&formatCtx);
-    (*env)->ReleaseStringUTFChars(env, videoPath, path);
-
     return result;
 }
 
 /**
- * Get video duration in milliseconds
- * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoDuration
+ * Decode a thumbnail through an open handle and compress it natively (JPEG / WebP) into a Java byte array
  */
-JNIEXPORT jlong JNICALL
-Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoDuration(
-    JNIEnv *env,
-    jobject thiz,
-    jstring videoPath
-) {
-    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
-    if (path == NULL) {
-        LOGE("Failed to get video path string");
-        return -1;
+static jbyteArray thumbnail_to_encoded_array(JNIEnv *env, MediaHandle *handle, jlong timeMs,
+                                             jint width, jint height, MediaThumbnailMode mode,
+                                             jint format, jint quality) {
+    if (format != MEDIA_THUMB_JPEG && format != MEDIA_THUMB_WEBP) {
+        LOGE("Unknown compressed thumbnail format: %d", format);
+        return NULL;
     }
-
-    LOGI("Getting duration for: %s", path);
-
-    AVFormatContext *formatCtx = NULL;
-    jlong duration = -1;
-
-    // Open video file
-    if (avformat_open_input(&formatCtx, path, NULL, NULL) != 0) {
-        LOGE("Could not open video file: %s", path);
-        goto cleanup;
+    int outWidth = 0;
+    int outHeight = 0;
+    if (media_handle_thumbnail_size(handle, width, height, &outWidth, &outHeight) != MEDIA_HANDLE_OK) {
+        LOGE("Could not find video stream");
+        return NULL;
     }
 
-    // Retrieve stream information
-    if (avformat_find_stream_info(formatCtx, NULL) < 0) {
-        LOGE("Could not find stream information");
-        goto cleanup;
+    uint8_t *data = NULL;
+    int size = 0;
+    MediaHandleStatus status = media_handle_thumbnail_encoded(handle, timeMs, outWidth, outHeight, mode,
+                                                              (MediaThumbnailFormat)format, quality, &data, &size);
+    if (status != MEDIA_HANDLE_OK) {
+        if (status == MEDIA_HANDLE_ERR_UNSUPPORTED) {
+            LOGE("Thumbnail format %d is not supported by this FFmpeg build", format);
+        } else {
+            LOGE("Could not encode thumbnail (format %d)", format);
+        }
+        return NULL;
     }
 
-    // Get duration in milliseconds
-    if (formatCtx->duration != AV_NOPTS_VALUE) {
-        duration = (jlong)(formatCtx->duration / (AV_TIME_BASE / 1000));
-        LOGI("Duration: %lld ms", (long long)duration);
+    jbyteArray result = (*env)->NewByteArray(env, size);
+    if (result != NULL) {
+        (*env)->SetByteArrayRegion(env, result, 0, size, (const jbyte *)data);
+        LOGI("Successfully extracted compressed thumbnail: %d bytes (raw %d)", size, outWidth * outHeight * 4);
     } else {
-        LOGE("Duration not available");
+        LOGE("Could not create byte array");
     }
-
-cleanup:
-    if (formatCtx) avformat_close_input(&formatCtx);
-    (*env)->ReleaseStringUTFChars(env, videoPath, path);
-
-    return duration;
+    av_free(data);
+    return result;
 }
 
 /**
- * Get video metadata (extended version with more fields)
- * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoMetadata
+ * Resolve the destination of a direct-buffer thumbnail: explicit size, capacity for stride * height
  */
-JNIEXPORT jobject JNICALL
-Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoMetadata(
-    JNIEnv *env,
-    jobject thiz,
-    jstring videoPath
-) {
-    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
-    if (path == NULL) {
-        LOGE("Failed to get video path string");
-        return NULL;
-    }
-
-    LOGI("Getting metadata for: %s", path);
-
-    AVFormatContext *formatCtx = NULL;
-    jobject result = NULL;
-    int videoStream = -1;
-    int audioStream = -1;
-
-    // Open video file
-    if (avformat_open_input(&formatCtx, path, NULL, NULL) != 0) {
-        LOGE("Could not open video file: %s", path);
-        goto cleanup;
-    }
-
-    // Retrieve stream information
-    if (avformat_find_stream_info(formatCtx, NULL) < 0) {
-        LOGE("Could not find stream information");
-        goto cleanup;
+static int direct_buffer_target(JNIEnv *env, jobject buffer, jint width, jint height, jint stride,
+                                uint8_t **outData, int *outStride) {
+    if (width <= 0 || height <= 0) {
+        LOGE("Direct buffer thumbnails need an explicit size, got %dx%d", width, height);
+        return 0;
     }
-
-    // Find video and audio streams
-    int subtitleCount = 0;
-    for (int i = 0; i < formatCtx->nb_streams; i++) {
-        enum AVMediaType type = formatCtx->streams[i]->codecpar->codec_type;
-        if (type == AVMEDIA_TYPE_VIDEO && videoStream == -1) {
-            videoStream = i;
-        } else if (type == AVMEDIA_TYPE_AUDIO && audioStream == -1) {
-            audioStream = i;
-        } else if (type == AVMEDIA_TYPE_SUBTITLE) {
-            subtitleCount++;
-        }
+    uint8_t *data = buffer != NULL ? (uint8_t *)(*env)->GetDirectBufferAddress(env, buffer) : NULL;
+    jlong capacity = buffer != NULL ? (*env)->GetDirectBufferCapacity(env, buffer) : -1;
+    if (data == NULL || capacity < 0) {
+        LOGE("Thumbnail buffer is not a direct ByteBuffer");
+        return 0;
     }
-
-    if (videoStream == -1) {
-        LOGE("Could not find video stream");
-        goto cleanup;
+    int rowBytes = stride > 0 ? stride : width * 4;
+    jlong required = (jlong)rowBytes * (height - 1) + (jlong)width * 4;
+    if (rowBytes < width * 4 || capacity < required) {
+        LOGE("Thumbnail buffer too small: %lld < %lld bytes (stride %d)", (long long)capacity,
+             (long long)required, rowBytes);
+        return 0;
     }
+    *outData = data;
+    *outStride = rowBytes;
+    return 1;
+}
 
+/**
+ * Build the getVideoMetadata HashMap from MediaInfo
+ */
+static jobject media_info_to_map(JNIEnv *env, const MediaInfo *info) {
     // Create HashMap
     jclass hashMapClass = (*env)->FindClass(env, "java/util/HashMap");
     jmethodID hashMapInit = (*env)->GetMethodID(env, hashMapClass, "<init>", "()V");
     jmethodID hashMapPut = (*env)->GetMethodID(env, hashMapClass, "put",
         "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
-    
-    result = (*env)->NewObject(env, hashMapClass, hashMapInit);
+
+    jobject result = (*env)->NewObject(env, hashMapClass, hashMapInit);
 
     // Helper classes
     jclass integerClass = (*env)->FindClass(env, "java/lang/Integer");
@@ -321,309 +138,897 @@ Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoMetadata(
     jclass doubleClass = (*env)->FindClass(env, "java/lang/Double");
     jmethodID doubleInit = (*env)->GetMethodID(env, doubleClass, "<init>", "(D)V");
 
-    // Get video codec parameters
-    AVCodecParameters *codecParams = formatCtx->streams[videoStream]->codecpar;
-    AVCodec *codec = avcodec_find_decoder(codecParams->codec_id);
-    AVStream *stream = formatCtx->streams[videoStream];
-
     // Add width
-    jobject widthObj = (*env)->NewObject(env, integerClass, integerInit, codecParams->width);
+    jobject widthObj = (*env)->NewObject(env, integerClass, integerInit, info->width);
     (*env)->CallObjectMethod(env, result, hashMapPut,
         (*env)->NewStringUTF(env, "width"), widthObj);
 
     // Add height
-    jobject heightObj = (*env)->NewObject(env, integerClass, integerInit, codecParams->height);
+    jobject heightObj = (*env)->NewObject(env, integerClass, integerInit, info->height);
     (*env)->CallObjectMethod(env, result, hashMapPut,
         (*env)->NewStringUTF(env, "height"), heightObj);
 
     // Add duration
-    if (formatCtx->duration != AV_NOPTS_VALUE) {
-        jlong duration = (jlong)(formatCtx->duration / (AV_TIME_BASE / 1000));
-        jobject durationObj = (*env)->NewObject(env, longClass, longInit, duration);
+    if (info->duration_ms >= 0) {
+        jobject durationObj = (*env)->NewObject(env, longClass, longInit, (jlong)info->duration_ms);
         (*env)->CallObjectMethod(env, result, hashMapPut,
             (*env)->NewStringUTF(env, "duration"), durationObj);
     }
 
     // Add codec name
-    if (codec) {
+    if (info->codec[0]) {
         (*env)->CallObjectMethod(env, result, hashMapPut,
             (*env)->NewStringUTF(env, "codec"),
-            (*env)->NewStringUTF(env, codec->name));
+            (*env)->NewStringUTF(env, info->codec));
     }
 
     // Add bitrate
-    if (codecParams->bit_rate > 0) {
-        jobject bitrateObj = (*env)->NewObject(env, longClass, longInit, (jlong)codecParams->bit_rate);
+    if (info->bit_rate > 0) {
+        jobject bitrateObj = (*env)->NewObject(env, longClass, longInit, (jlong)info->bit_rate);
         (*env)->CallObjectMethod(env, result, hashMapPut,
             (*env)->NewStringUTF(env, "bitrate"), bitrateObj);
     }
 
     // Add FPS
-    AVRational frameRate = av_guess_frame_rate(formatCtx, stream, NULL);
-    if (frameRate.num > 0 && frameRate.den > 0) {
-        double fps = (double)frameRate.num / (double)frameRate.den;
-        jobject fpsObj = (*env)->NewObject(env, doubleClass, doubleInit, fps);
+    if (info->fps > 0) {
+        jobject fpsObj = (*env)->NewObject(env, doubleClass, doubleInit, info->fps);
         (*env)->CallObjectMethod(env, result, hashMapPut,
             (*env)->NewStringUTF(env, "fps"), fpsObj);
     }
 
     // Add rotation
-    AVDictionaryEntry *rotate_tag = av_dict_get(stream->metadata, "rotate", NULL, 0);
-    int rotation = 0;
-    if (rotate_tag && rotate_tag->value) {
-        rotation = atoi(rotate_tag->value);
-    }
-    jobject rotationObj = (*env)->NewObject(env, integerClass, integerInit, rotation);
+    jobject rotationObj = (*env)->NewObject(env, integerClass, integerInit, info->rotation);
     (*env)->CallObjectMethod(env, result, hashMapPut,
         (*env)->NewStringUTF(env, "rotation"), rotationObj);
 
     // Add container format
-    if (formatCtx->iformat && formatCtx->iformat->name) {
+    if (info->container[0]) {
         (*env)->CallObjectMethod(env, result, hashMapPut,
             (*env)->NewStringUTF(env, "container"),
-            (*env)->NewStringUTF(env, formatCtx->iformat->name));
+            (*env)->NewStringUTF(env, info->container));
     }
 
     // Add stream count
-    jobject streamCountObj = (*env)->NewObject(env, integerClass, integerInit, formatCtx->nb_streams);
+    jobject streamCountObj = (*env)->NewObject(env, integerClass, integerInit, info->stream_count);
     (*env)->CallObjectMethod(env, result, hashMapPut,
         (*env)->NewStringUTF(env, "streamCount"), streamCountObj);
 
     // Add hasAudio
-    jobject hasAudioObj = (*env)->NewObject(env, booleanClass, booleanInit, audioStream != -1);
+    jobject hasAudioObj = (*env)->NewObject(env, booleanClass, booleanInit, info->has_audio != 0);
     (*env)->CallObjectMethod(env, result, hashMapPut,
         (*env)->NewStringUTF(env, "hasAudio"), hasAudioObj);
 
     // Add hasSubtitles
-    jobject hasSubtitlesObj = (*env)->NewObject(env, booleanClass, booleanInit, subtitleCount > 0);
+    jobject hasSubtitlesObj = (*env)->NewObject(env, booleanClass, booleanInit, info->has_subtitles != 0);
     (*env)->CallObjectMethod(env, result, hashMapPut,
         (*env)->NewStringUTF(env, "hasSubtitles"), hasSubtitlesObj);
 
     // Add audio metadata if audio stream exists
-    if (audioStream != -1) {
-        AVCodecParameters *audioCodecParams = formatCtx->streams[audioStream]->codecpar;
-        AVCodec *audioCodec = avcodec_find_decoder(audioCodecParams->codec_id);
-        
+    if (info->has_audio) {
         // Audio codec
-        if (audioCodec) {
+        if (info->audio_codec[0]) {
             (*env)->CallObjectMethod(env, result, hashMapPut,
                 (*env)->NewStringUTF(env, "audioCodec"),
-                (*env)->NewStringUTF(env, audioCodec->name));
+                (*env)->NewStringUTF(env, info->audio_codec));
         }
-        
+
         // Sample rate
-        if (audioCodecParams->sample_rate > 0) {
-            jobject sampleRateObj = (*env)->NewObject(env, integerClass, integerInit, audioCodecParams->sample_rate);
+        if (info->sample_rate > 0) {
+            jobject sampleRateObj = (*env)->NewObject(env, integerClass, integerInit, info->sample_rate);
             (*env)->CallObjectMethod(env, result, hashMapPut,
                 (*env)->NewStringUTF(env, "sampleRate"), sampleRateObj);
         }
-        
+
         // Channels
-        if (audioCodecParams->channels > 0) {
-            jobject channelsObj = (*env)->NewObject(env, integerClass, integerInit, audioCodecParams->channels);
+        if (info->channels > 0) {
+            jobject channelsObj = (*env)->NewObject(env, integerClass, integerInit, info->channels);
             (*env)->CallObjectMethod(env, result, hashMapPut,
                 (*env)->NewStringUTF(env, "channels"), channelsObj);
         }
     }
 
     LOGI("Metadata extracted successfully");
-
-cleanup:
-    if (formatCtx) avformat_close_input(&formatCtx);
-    (*env)->ReleaseStringUTFChars(env, videoPath, path);
-
     return result;
 }
 
 /**
- * Get FFmpeg version
- * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getFFmpegVersion
- */
-JNIEXPORT jstring JNICALL
-Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getFFmpegVersion(
-    JNIEnv *env,
-    jobject thiz
-) {
-    const char *version = av_version_info();
-    LOGI("FFmpeg version: %s", version);
-    return (*env)->NewStringUTF(env, version);
-}
-
-/**
- * Get video metadata as JSON string (with safe-mode error handling)
- * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoMetadataJson
+ * Build the getVideoMetadataJson success document from MediaInfo (manual, safe and simple)
  */
-JNIEXPORT jstring JNICALL
-Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoMetadataJson(
-    JNIEnv *env,
-    jobject thiz,
-    jstring videoPath
-) {
-    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
-    if (path == NULL) {
-        LOGE("Failed to get video path string");
-        return (*env)->NewStringUTF(env, "{\"version\":1,\"success\":false,\"error\":\"Invalid path\"}");
-    }
-
-    LOGI("Getting JSON metadata for: %s", path);
-
-    AVFormatContext *formatCtx = NULL;
-    char jsonBuffer[8192];
-    int videoStream = -1;
-    int audioStream = -1;
-    int subtitleCount = 0;
-
-    // Open video file with error handling
-    int ret = avformat_open_input(&formatCtx, path, NULL, NULL);
-    if (ret != 0) {
-        char errBuf[128];
-        av_strerror(ret, errBuf, sizeof(errBuf));
-        LOGE("Could not open video file: %s, error: %s", path, errBuf);
-        snprintf(jsonBuffer, sizeof(jsonBuffer),
-            "{\"version\":1,\"success\":false,\"error\":\"Could not open file: %s\"}", errBuf);
-        (*env)->ReleaseStringUTFChars(env, videoPath, path);
-        return (*env)->NewStringUTF(env, jsonBuffer);
-    }
-
-    // Retrieve stream information with error handling
-    ret = avformat_find_stream_info(formatCtx, NULL);
-    if (ret < 0) {
-        char errBuf[128];
-        av_strerror(ret, errBuf, sizeof(errBuf));
-        LOGE("Could not find stream information: %s", errBuf);
-        snprintf(jsonBuffer, sizeof(jsonBuffer),
-            "{\"version\":1,\"success\":false,\"error\":\"Could not find stream info: %s\"}", errBuf);
-        avformat_close_input(&formatCtx);
-        (*env)->ReleaseStringUTFChars(env, videoPath, path);
-        return (*env)->NewStringUTF(env, jsonBuffer);
-    }
-
-    // Find streams
-    for (int i = 0; i < formatCtx->nb_streams; i++) {
-        enum AVMediaType type = formatCtx->streams[i]->codecpar->codec_type;
-        if (type == AVMEDIA_TYPE_VIDEO && videoStream == -1) {
-            videoStream = i;
-        } else if (type == AVMEDIA_TYPE_AUDIO && audioStream == -1) {
-            audioStream = i;
-        } else if (type == AVMEDIA_TYPE_SUBTITLE) {
-            subtitleCount++;
-        }
-    }
-
-    if (videoStream == -1) {
-        LOGE("Could not find video stream");
-        snprintf(jsonBuffer, sizeof(jsonBuffer),
-            "{\"version\":1,\"success\":false,\"error\":\"No video stream found\"}");
-        avformat_close_input(&formatCtx);
-        (*env)->ReleaseStringUTFChars(env, videoPath, path);
-        return (*env)->NewStringUTF(env, jsonBuffer);
-    }
-
-    // Build JSON manually (safe and simple)
+static void media_info_to_json(const MediaInfo *info, char *jsonBuffer, size_t size) {
     char *ptr = jsonBuffer;
-    int remaining = sizeof(jsonBuffer);
+    int remaining = (int)size;
     int written;
 
     // Start JSON with version field
     written = snprintf(ptr, remaining, "{\"version\":1,\"success\":true,\"data\":{");
     ptr += written; remaining -= written;
 
-    // Get video stream info
-    AVCodecParameters *codecParams = formatCtx->streams[videoStream]->codecpar;
-    AVCodec *codec = avcodec_find_decoder(codecParams->codec_id);
-    AVStream *stream = formatCtx->streams[videoStream];
-
     // Width and height
-    written = snprintf(ptr, remaining, "\"width\":%d,\"height\":%d,",
-        codecParams->width, codecParams->height);
+    written = snprintf(ptr, remaining, "\"width\":%d,\"height\":%d,", info->width, info->height);
     ptr += written; remaining -= written;
 
     // Duration
-    if (formatCtx->duration != AV_NOPTS_VALUE) {
-        jlong duration = (jlong)(formatCtx->duration / (AV_TIME_BASE / 1000));
-        written = snprintf(ptr, remaining, "\"duration\":%lld,", (long long)duration);
+    if (info->duration_ms >= 0) {
+        written = snprintf(ptr, remaining, "\"duration\":%lld,", (long long)info->duration_ms);
         ptr += written; remaining -= written;
     }
 
     // Codec
-    if (codec && codec->name) {
-        written = snprintf(ptr, remaining, "\"codec\":\"%s\",", codec->name);
+    if (info->codec[0]) {
+        written = snprintf(ptr, remaining, "\"codec\":\"%s\",", info->codec);
         ptr += written; remaining -= written;
     }
 
     // Bitrate
-    if (codecParams->bit_rate > 0) {
-        written = snprintf(ptr, remaining, "\"bitrate\":%lld,", (long long)codecParams->bit_rate);
+    if (info->bit_rate > 0) {
+        written = snprintf(ptr, remaining, "\"bitrate\":%lld,", (long long)info->bit_rate);
         ptr += written; remaining -= written;
     }
 
     // FPS
-    AVRational frameRate = av_guess_frame_rate(formatCtx, stream, NULL);
-    if (frameRate.num > 0 && frameRate.den > 0) {
-        double fps = (double)frameRate.num / (double)frameRate.den;
-        written = snprintf(ptr, remaining, "\"fps\":%.2f,", fps);
+    if (info->fps > 0) {
+        written = snprintf(ptr, remaining, "\"fps\":%.2f,", info->fps);
         ptr += written; remaining -= written;
     }
 
     // Rotation
-    AVDictionaryEntry *rotate_tag = av_dict_get(stream->metadata, "rotate", NULL, 0);
-    int rotation = 0;
-    if (rotate_tag && rotate_tag->value) {
-        rotation = atoi(rotate_tag->value);
-    }
-    written = snprintf(ptr, remaining, "\"rotation\":%d,", rotation);
+    written = snprintf(ptr, remaining, "\"rotation\":%d,", info->rotation);
     ptr += written; remaining -= written;
 
     // Container
-    if (formatCtx->iformat && formatCtx->iformat->name) {
-        written = snprintf(ptr, remaining, "\"container\":\"%s\",", formatCtx->iformat->name);
+    if (info->container[0]) {
+        written = snprintf(ptr, remaining, "\"container\":\"%s\",", info->container);
         ptr += written; remaining -= written;
     }
 
     // Stream count
-    written = snprintf(ptr, remaining, "\"streamCount\":%d,", formatCtx->nb_streams);
+    written = snprintf(ptr, remaining, "\"streamCount\":%d,", info->stream_count);
     ptr += written; remaining -= written;
 
     // Has audio
-    written = snprintf(ptr, remaining, "\"hasAudio\":%s,", audioStream != -1 ? "true" : "false");
+    written = snprintf(ptr, remaining, "\"hasAudio\":%s,", info->has_audio ? "true" : "false");
     ptr += written; remaining -= written;
 
     // Has subtitles
-    written = snprintf(ptr, remaining, "\"hasSubtitles\":%s", subtitleCount > 0 ? "true" : "false");
+    written = snprintf(ptr, remaining, "\"hasSubtitles\":%s", info->has_subtitles ? "true" : "false");
     ptr += written; remaining -= written;
 
-    // Audio metadata if exists
-    if (audioStream != -1) {
-        AVCodecParameters *audioCodecParams = formatCtx->streams[audioStream]->codecpar;
-        AVCodec *audioCodec = avcodec_find_decoder(audioCodecParams->codec_id);
-        
-        written = snprintf(ptr, remaining, ",");
-        ptr += written; remaining -= written;
-        
-        if (audioCodec && audioCodec->name) {
-            written = snprintf(ptr, remaining, "\"audioCodec\":\"%s\",", audioCodec->name);
+    // Audio metadata if exists (each field carries its own leading comma)
+    if (info->has_audio) {
+        if (info->audio_codec[0]) {
+            written = snprintf(ptr, remaining, ",\"audioCodec\":\"%s\"", info->audio_codec);
             ptr += written; remaining -= written;
         }
-        
-        if (audioCodecParams->sample_rate > 0) {
-            written = snprintf(ptr, remaining, "\"sampleRate\":%d,", audioCodecParams->sample_rate);
+
+        if (info->sample_rate > 0) {
+            written = snprintf(ptr, remaining, ",\"sampleRate\":%d", info->sample_rate);
             ptr += written; remaining -= written;
         }
-        
-        if (audioCodecParams->channels > 0) {
-            written = snprintf(ptr, remaining, "\"channels\":%d", audioCodecParams->channels);
+
+        if (info->channels > 0) {
+            written = snprintf(ptr, remaining, ",\"channels\":%d", info->channels);
             ptr += written; remaining -= written;
         }
     }
 
     // Close JSON
-    written = snprintf(ptr, remaining, "}}");
-    ptr += written; remaining -= written;
+    snprintf(ptr, remaining, "}}");
 
     LOGI("JSON metadata created successfully");
+}
+
+/**
+ * Error message for a failed handle open / query
+ */
+static void media_status_message(MediaHandleStatus status, int averror, char *message, size_t size) {
+    char errBuf[128];
+    av_strerror(averror, errBuf, sizeof(errBuf));
+
+    switch (status) {
+    case MEDIA_HANDLE_ERR_OPEN:
+        LOGE("Could not open video file, error: %s", errBuf);
+        snprintf(message, size, "Could not open file: %s", errBuf);
+        break;
+    case MEDIA_HANDLE_ERR_PROBE:
+        LOGE("Could not find stream information: %s", errBuf);
+        snprintf(message, size, "Could not find stream info: %s", errBuf);
+        break;
+    case MEDIA_HANDLE_ERR_NO_VIDEO:
+        LOGE("Could not find video stream");
+        snprintf(message, size, "No video stream found");
+        break;
+    case MEDIA_HANDLE_ERR_DECODE:
+        snprintf(message, size, "Could not decode frame");
+        break;
+    case MEDIA_HANDLE_ERR_NOMEM:
+        snprintf(message, size, "Out of memory");
+        break;
+    case MEDIA_HANDLE_ERR_UNSUPPORTED:
+        snprintf(message, size, "Thumbnail format not supported by this FFmpeg build");
+        break;
+    default:
+        snprintf(message, size, "Invalid media handle");
+        break;
+    }
+}
+
+/**
+ * Build a getVideoMetadataJson error document for a failed handle open / query
+ */
+static void media_status_to_json(MediaHandleStatus status, int averror, char *jsonBuffer, size_t size) {
+    char message[256];
+    media_status_message(status, averror, message, sizeof(message));
+    snprintf(jsonBuffer, size, "{\"version\":1,\"success\":false,\"error\":\"%s\"}", message);
+}
+
+/**
+ * One-shot thumbnail: open → thumbnail → close (use openMediaHandle for repeated calls)
+ */
+static jbyteArray extract_thumbnail_once(JNIEnv *env, jstring videoPath, jlong timeMs,
+                                         jint width, jint height, MediaThumbnailMode mode) {
+    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
+    if (path == NULL) {
+        LOGE("Failed to get video path string");
+        return NULL;
+    }
+
+    LOGI("Extracting thumbnail from: %s at %lld ms, size: %dx%d, mode: %s", path, (long long)timeMs,
+         width, height, mode == MEDIA_THUMB_FAST ? "fast" : "exact");
+
+    MediaHandle *handle = NULL;
+    jbyteArray result = NULL;
+    if (media_handle_open(path, &handle, NULL) == MEDIA_HANDLE_OK) {
+        result = thumbnail_to_byte_array(env, handle, timeMs, width, height, mode);
+        media_handle_close(&handle);
+    } else {
+        LOGE("Could not open video file: %s", path);
+    }
 
-    avformat_close_input(&formatCtx);
     (*env)->ReleaseStringUTFChars(env, videoPath, path);
+    return result;
+}
 
-    return (*env)->NewStringUTF(env, jsonBuffer);
+/**
+ * Extract thumbnail from video at specified timestamp
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnail
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnail(
+    JNIEnv *env,
+    jobject thiz,
+    jstring videoPath,
+    jlong timeMs,
+    jint width,
+    jint height
+) {
+    return extract_thumbnail_once(env, videoPath, timeMs, width, height, MEDIA_THUMB_EXACT);
+}
+
+/**
+ * Extract the nearest keyframe at or before timestamp: keyframes only, no loop filter, lowres decode
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnailFast
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnailFast(
+    JNIEnv *env,
+    jobject thiz,
+    jstring videoPath,
+    jlong timeMs,
+    jint width,
+    jint height
+) {
+    return extract_thumbnail_once(env, videoPath, timeMs, width, height, MEDIA_THUMB_FAST);
+}
+
+/**
+ * Extract a thumbnail straight into a direct ByteBuffer: no Java array, no intermediate native buffer
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnailInto
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnailInto(
+    JNIEnv *env,
+    jobject thiz,
+    jstring videoPath,
+    jlong timeMs,
+    jint width,
+    jint height,
+    jboolean fast,
+    jobject buffer,
+    jint stride
+) {
+    uint8_t *dst = NULL;
+    int dstStride = 0;
+    if (!direct_buffer_target(env, buffer, width, height, stride, &dst, &dstStride)) {
+        return JNI_FALSE;
+    }
+
+    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
+    if (path == NULL) {
+        LOGE("Failed to get video path string");
+        return JNI_FALSE;
+    }
+
+    MediaHandle *handle = NULL;
+    jboolean result = JNI_FALSE;
+    if (media_handle_open(path, &handle, NULL) == MEDIA_HANDLE_OK) {
+        if (media_handle_thumbnail_rgba(handle, timeMs, width, height, fast ? MEDIA_THUMB_FAST : MEDIA_THUMB_EXACT,
+                                        dst, dstStride) == MEDIA_HANDLE_OK) {
+            result = JNI_TRUE;
+        } else {
+            LOGE("Could not decode frame");
+        }
+        media_handle_close(&handle);
+    } else {
+        LOGE("Could not open video file: %s", path);
+    }
+
+    (*env)->ReleaseStringUTFChars(env, videoPath, path);
+    return result;
+}
+
+/**
+ * Extract a thumbnail compressed natively to JPEG (format 1) or WebP (format 2), quality 1..100
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnailEncoded
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractThumbnailEncoded(
+    JNIEnv *env,
+    jobject thiz,
+    jstring videoPath,
+    jlong timeMs,
+    jint width,
+    jint height,
+    jboolean fast,
+    jint format,
+    jint quality
+) {
+    if (!thumb_encode_supported((MediaThumbnailFormat)format) || format == MEDIA_THUMB_RGBA) {
+        LOGE("Thumbnail format %d is not supported by this FFmpeg build", format);
+        return NULL;
+    }
+
+    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
+    if (path == NULL) {
+        LOGE("Failed to get video path string");
+        return NULL;
+    }
+
+    MediaHandle *handle = NULL;
+    jbyteArray result = NULL;
+    if (media_handle_open(path, &handle, NULL) == MEDIA_HANDLE_OK) {
+        result = thumbnail_to_encoded_array(env, handle, timeMs, width, height,
+                                            fast ? MEDIA_THUMB_FAST : MEDIA_THUMB_EXACT, format, quality);
+        media_handle_close(&handle);
+    } else {
+        LOGE("Could not open video file: %s", path);
+    }
+
+    (*env)->ReleaseStringUTFChars(env, videoPath, path);
+    return result;
+}
+
+/**
+ * Whether a compressed thumbnail format has an encoder in the bundled FFmpeg (JPEG: always, WebP: --enable-libwebp)
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_isThumbnailFormatSupported
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_isThumbnailFormatSupported(
+    JNIEnv *env,
+    jobject thiz,
+    jint format
+) {
+    return thumb_encode_supported((MediaThumbnailFormat)format) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Get video duration in milliseconds
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoDuration
+ */
+JNIEXPORT jlong JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoDuration(
+    JNIEnv *env,
+    jobject thiz,
+    jstring videoPath
+) {
+    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
+    if (path == NULL) {
+        LOGE("Failed to get video path string");
+        return -1;
+    }
+
+    LOGI("Getting duration for: %s", path);
+
+    MediaHandle *handle = NULL;
+    jlong duration = -1;
+    if (media_handle_open(path, &handle, NULL) == MEDIA_HANDLE_OK) {
+        duration = (jlong)media_handle_duration_ms(handle);
+        media_handle_close(&handle);
+        if (duration >= 0) {
+            LOGI("Duration: %lld ms", (long long)duration);
+        } else {
+            LOGE("Duration not available");
+        }
+    } else {
+        LOGE("Could not open video file: %s", path);
+    }
+
+    (*env)->ReleaseStringUTFChars(env, videoPath, path);
+    return duration;
+}
+
+/**
+ * Get video metadata (extended version with more fields)
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoMetadata
+ */
+JNIEXPORT jobject JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoMetadata(
+    JNIEnv *env,
+    jobject thiz,
+    jstring videoPath
+) {
+    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
+    if (path == NULL) {
+        LOGE("Failed to get video path string");
+        return NULL;
+    }
+
+    LOGI("Getting metadata for: %s", path);
+
+    MediaHandle *handle = NULL;
+    jobject result = NULL;
+    if (media_handle_open(path, &handle, NULL) == MEDIA_HANDLE_OK) {
+        MediaInfo info;
+        if (media_handle_get_info(handle, &info) == MEDIA_HANDLE_OK) {
+            result = media_info_to_map(env, &info);
+        } else {
+            LOGE("Could not find video stream");
+        }
+        media_handle_close(&handle);
+    } else {
+        LOGE("Could not open video file: %s", path);
+    }
+
+    (*env)->ReleaseStringUTFChars(env, videoPath, path);
+    return result;
+}
+
+/**
+ * Get FFmpeg version
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getFFmpegVersion
+ */
+JNIEXPORT jstring JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getFFmpegVersion(
+    JNIEnv *env,
+    jobject thiz
+) {
+    const char *version = av_version_info();
+    LOGI("FFmpeg version: %s", version);
+    return (*env)->NewStringUTF(env, version);
+}
+
+/**
+ * Get video metadata as JSON string (with safe-mode error handling)
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoMetadataJson
+ */
+JNIEXPORT jstring JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getVideoMetadataJson(
+    JNIEnv *env,
+    jobject thiz,
+    jstring videoPath
+) {
+    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
+    if (path == NULL) {
+        LOGE("Failed to get video path string");
+        return (*env)->NewStringUTF(env, "{\"version\":1,\"success\":false,\"error\":\"Invalid path\"}");
+    }
+
+    LOGI("Getting JSON metadata for: %s", path);
+
+    char jsonBuffer[8192];
+    MediaHandle *handle = NULL;
+    int averror = 0;
+    MediaHandleStatus status = media_handle_open(path, &handle, &averror);
+    if (status == MEDIA_HANDLE_OK) {
+        MediaInfo info;
+        status = media_handle_get_info(handle, &info);
+        if (status == MEDIA_HANDLE_OK) {
+            media_info_to_json(&info, jsonBuffer, sizeof(jsonBuffer));
+        }
+        media_handle_close(&handle);
+    }
+    if (status != MEDIA_HANDLE_OK) {
+        media_status_to_json(status, averror, jsonBuffer, sizeof(jsonBuffer));
+    }
+
+    (*env)->ReleaseStringUTFChars(env, videoPath, path);
+    return (*env)->NewStringUTF(env, jsonBuffer);
+}
+
+/**
+ * Open a media handle: format context, decoder and scaler stay warm across calls
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_openMediaHandle
+ *
+ * @return Native handle, or 0 on error
+ */
+JNIEXPORT jlong JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_openMediaHandle(
+    JNIEnv *env,
+    jobject thiz,
+    jstring videoPath
+) {
+    const char *path = (*env)->GetStringUTFChars(env, videoPath, NULL);
+    if (path == NULL) {
+        LOGE("Failed to get video path string");
+        return 0;
+    }
+
+    MediaHandle *handle = NULL;
+    int averror = 0;
+    if (media_handle_open(path, &handle, &averror) != MEDIA_HANDLE_OK) {
+        char errBuf[128];
+        av_strerror(averror, errBuf, sizeof(errBuf));
+        LOGE("Could not open media handle: %s, error: %s", path, errBuf);
+    }
+
+    (*env)->ReleaseStringUTFChars(env, videoPath, path);
+    return (jlong)(intptr_t)handle;
+}
+
+/**
+ * Close a media handle (0 is ignored)
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_closeMediaHandle
+ */
+JNIEXPORT void JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_closeMediaHandle(
+    JNIEnv *env,
+    jobject thiz,
+    jlong handle
+) {
+    MediaHandle *h = (MediaHandle *)(intptr_t)handle;
+    media_handle_close(&h);
+}
+
+/**
+ * Get duration in milliseconds through an open handle
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getMediaHandleDuration
+ */
+JNIEXPORT jlong JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getMediaHandleDuration(
+    JNIEnv *env,
+    jobject thiz,
+    jlong handle
+) {
+    return (jlong)media_handle_duration_ms((MediaHandle *)(intptr_t)handle);
+}
+
+/**
+ * Get metadata (same keys as getVideoMetadata) through an open handle
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getMediaHandleMetadata
+ */
+JNIEXPORT jobject JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getMediaHandleMetadata(
+    JNIEnv *env,
+    jobject thiz,
+    jlong handle
+) {
+    MediaInfo info;
+    if (media_handle_get_info((MediaHandle *)(intptr_t)handle, &info) != MEDIA_HANDLE_OK) {
+        LOGE("Could not get metadata from media handle");
+        return NULL;
+    }
+    return media_info_to_map(env, &info);
+}
+
+/**
+ * Get metadata as JSON (same document as getVideoMetadataJson) through an open handle
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getMediaHandleMetadataJson
+ */
+JNIEXPORT jstring JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_getMediaHandleMetadataJson(
+    JNIEnv *env,
+    jobject thiz,
+    jlong handle
+) {
+    char jsonBuffer[8192];
+    MediaInfo info;
+    MediaHandleStatus status = media_handle_get_info((MediaHandle *)(intptr_t)handle, &info);
+    if (status == MEDIA_HANDLE_OK) {
+        media_info_to_json(&info, jsonBuffer, sizeof(jsonBuffer));
+    } else {
+        media_status_to_json(status, 0, jsonBuffer, sizeof(jsonBuffer));
+    }
+    return (*env)->NewStringUTF(env, jsonBuffer);
+}
+
+/**
+ * Extract thumbnail through an open handle: only seek + decode, no open / probe (fast: nearest keyframe)
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractMediaHandleThumbnail
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractMediaHandleThumbnail(
+    JNIEnv *env,
+    jobject thiz,
+    jlong handle,
+    jlong timeMs,
+    jint width,
+    jint height,
+    jboolean fast
+) {
+    MediaHandle *h = (MediaHandle *)(intptr_t)handle;
+    if (h == NULL) {
+        LOGE("Invalid media handle");
+        return NULL;
+    }
+    return thumbnail_to_byte_array(env, h, timeMs, width, height, fast ? MEDIA_THUMB_FAST : MEDIA_THUMB_EXACT);
+}
+
+/**
+ * Extract a natively compressed (JPEG / WebP) thumbnail through an open handle
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractMediaHandleThumbnailEncoded
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractMediaHandleThumbnailEncoded(
+    JNIEnv *env,
+    jobject thiz,
+    jlong handle,
+    jlong timeMs,
+    jint width,
+    jint height,
+    jboolean fast,
+    jint format,
+    jint quality
+) {
+    MediaHandle *h = (MediaHandle *)(intptr_t)handle;
+    if (h == NULL) {
+        LOGE("Invalid media handle");
+        return NULL;
+    }
+    return thumbnail_to_encoded_array(env, h, timeMs, width, height,
+                                      fast ? MEDIA_THUMB_FAST : MEDIA_THUMB_EXACT, format, quality);
+}
+
+/**
+ * Extract thumbnail through an open handle straight into a direct ByteBuffer (no per-call allocation)
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractMediaHandleThumbnailInto
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractMediaHandleThumbnailInto(
+    JNIEnv *env,
+    jobject thiz,
+    jlong handle,
+    jlong timeMs,
+    jint width,
+    jint height,
+    jboolean fast,
+    jobject buffer,
+    jint stride
+) {
+    MediaHandle *h = (MediaHandle *)(intptr_t)handle;
+    if (h == NULL) {
+        LOGE("Invalid media handle");
+        return JNI_FALSE;
+    }
+    uint8_t *dst = NULL;
+    int dstStride = 0;
+    if (!direct_buffer_target(env, buffer, width, height, stride, &dst, &dstStride)) {
+        return JNI_FALSE;
+    }
+    if (media_handle_thumbnail_rgba(h, timeMs, width, height, fast ? MEDIA_THUMB_FAST : MEDIA_THUMB_EXACT,
+                                    dst, dstStride) != MEDIA_HANDLE_OK) {
+        LOGE("Could not decode frame");
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+/**
+ * Extract a sprite sheet (RGBA8888, row-major tiles) in one ordered pass through an open handle
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractMediaHandleSpriteSheet
+ */
+JNIEXPORT jbyteArray JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_extractMediaHandleSpriteSheet(
+    JNIEnv *env,
+    jobject thiz,
+    jlong handle,
+    jint count,
+    jint tileWidth,
+    jint tileHeight,
+    jint columns,
+    jlong startMs,
+    jlong endMs,
+    jboolean keyframesOnly,
+    jlongArray timestampsOut
+) {
+    MediaHandle *h = (MediaHandle *)(intptr_t)handle;
+    if (h == NULL) {
+        LOGE("Invalid media handle");
+        return NULL;
+    }
+
+    MediaSpriteSpec spec = {
+        .count = count,
+        .tile_width = tileWidth,
+        .tile_height = tileHeight,
+        .columns = columns,
+        .start_ms = startMs,
+        .end_ms = endMs,
+        .mode = keyframesOnly ? MEDIA_SPRITE_KEYFRAME : MEDIA_SPRITE_EVEN,
+    };
+    int sheetWidth = 0;
+    int sheetHeight = 0;
+    if (media_sprite_sheet_size(&spec, &sheetWidth, &sheetHeight) < 0) {
+        LOGE("Invalid sprite sheet size: %d tiles of %dx%d", count, tileWidth, tileHeight);
+        return NULL;
+    }
+    if (timestampsOut != NULL && (*env)->GetArrayLength(env, timestampsOut) < count) {
+        LOGE("Timestamps array is shorter than tile count");
+        return NULL;
+    }
+
+    int numBytes = sheetWidth * sheetHeight * 4;
+    uint8_t *buffer = (uint8_t *)av_malloc(numBytes);
+    int64_t *timestamps = (int64_t *)av_malloc(sizeof(int64_t) * count);
+    if (buffer == NULL || timestamps == NULL) {
+        LOGE("Could not allocate buffer");
+        av_free(buffer);
+        av_free(timestamps);
+        return NULL;
+    }
+
+    jbyteArray result = NULL;
+    if (media_handle_sprite_sheet(h, &spec, buffer, sheetWidth * 4, timestamps) == MEDIA_HANDLE_OK) {
+        result = (*env)->NewByteArray(env, numBytes);
+        if (result != NULL) {
+            (*env)->SetByteArrayRegion(env, result, 0, numBytes, (jbyte *)buffer);
+            if (timestampsOut != NULL) {
+                (*env)->SetLongArrayRegion(env, timestampsOut, 0, count, (const jlong *)timestamps);
+            }
+            LOGI("Successfully extracted sprite sheet: %dx%d, %d bytes", sheetWidth, sheetHeight, numBytes);
+        } else {
+            LOGE("Could not create byte array");
+        }
+    } else {
+        LOGE("Could not build sprite sheet");
+    }
+
+    av_free(timestamps);
+    av_free(buffer);
+    return result;
+}
+
+/**
+ * Listener state for runMediaBatch (results are delivered on the calling thread)
+ */
+typedef struct BatchListener {
+    JNIEnv *env;
+    jobject listener;
+    jmethodID onResult;
+    int outputs;
+} BatchListener;
+
+static int batch_deliver(void *opaque, const MediaBatchResult *result) {
+    BatchListener *l = (BatchListener *)opaque;
+    JNIEnv *env = l->env;
+
+    // Each result creates a few dozen local refs (metadata map); free them per file
+    if ((*env)->PushLocalFrame(env, 64) != 0) {
+        return 1;
+    }
+
+    jobject metadata = NULL;
+    jbyteArray thumbnail = NULL;
+    jstring error = NULL;
+    char message[256];
+
+    if (result->status != MEDIA_HANDLE_OK) {
+        media_status_message(result->status, result->averror, message, sizeof(message));
+        error = (*env)->NewStringUTF(env, message);
+    } else {
+        if ((l->outputs & MEDIA_BATCH_INFO) && result->info_status == MEDIA_HANDLE_OK) {
+            metadata = media_info_to_map(env, &result->info);
+        }
+        if (result->thumb_data != NULL) {
+            thumbnail = (*env)->NewByteArray(env, result->thumb_size);
+            if (thumbnail != NULL) {
+                (*env)->SetByteArrayRegion(env, thumbnail, 0, result->thumb_size, (const jbyte *)result->thumb_data);
+            }
+        } else if (l->outputs & MEDIA_BATCH_THUMBNAIL) {
+            media_status_message(result->thumb_status, 0, message, sizeof(message));
+            error = (*env)->NewStringUTF(env, message);
+        }
+    }
+
+    jboolean keepGoing = (*env)->CallBooleanMethod(env, l->listener, l->onResult,
+        (jint)result->index, (jlong)result->duration_ms, metadata, thumbnail,
+        (jint)result->thumb_width, (jint)result->thumb_height, error);
+    int cancel = (*env)->ExceptionCheck(env) || !keepGoing;
+
+    (*env)->PopLocalFrame(env, NULL);
+    return cancel;
+}
+
+/**
+ * Process a list of files on a bounded native worker pool
+ * JNI signature: Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_runMediaBatch
+ *
+ * Blocks until every file is delivered or the listener returns false.
+ * The listener is called on this thread, in completion order.
+ *
+ * @return Number of delivered results, or -1 on error
+ */
+JNIEXPORT jint JNICALL
+Java_com_smartmedia_ffmpeg_SmartFfmpegBridge_runMediaBatch(
+    JNIEnv *env,
+    jobject thiz,
+    jobjectArray videoPaths,
+    jint outputs,
+    jlong timeMs,
+    jint width,
+    jint height,
+    jboolean fast,
+    jint format,
+    jint quality,
+    jint threads,
+    jobject listener
+) {
+    if (videoPaths == NULL || listener == NULL) {
+        LOGE("Invalid batch arguments");
+        return -1;
+    }
+
+    jclass listenerClass = (*env)->GetObjectClass(env, listener);
+    jmethodID onResult = (*env)->GetMethodID(env, listenerClass, "onResult",
+        "(IJLjava/util/Map;[BIILjava/lang/String;)Z");
+    if (onResult == NULL) {
+        LOGE("MediaBatch listener has no onResult method");
+        return -1;
+    }
+
+    // Copy paths up front: holding hundreds of jstrings would exhaust local refs
+    jsize count = (*env)->GetArrayLength(env, videoPaths);
+    char **paths = (char **)calloc(count > 0 ? count : 1, sizeof(char *));
+    if (paths == NULL) {
+        LOGE("Could not allocate batch paths");
+        return -1;
+    }
+    jint delivered = -1;
+    jsize copied = 0;
+    for (; copied < count; copied++) {
+        jstring pathString = (jstring)(*env)->GetObjectArrayElement(env, videoPaths, copied);
+        const char *path = pathString != NULL ? (*env)->GetStringUTFChars(env, pathString, NULL) : NULL;
+        paths[copied] = strdup(path != NULL ? path : "");
+        if (path != NULL) {
+            (*env)->ReleaseStringUTFChars(env, pathString, path);
+        }
+        (*env)->DeleteLocalRef(env, pathString);
+        if (paths[copied] == NULL) {
+            LOGE("Could not copy batch path %d", (int)copied);
+            goto cleanup;
+        }
+    }
+
+    MediaBatchRequest request = {
+        .outputs = outputs,
+        .thumb_time_ms = timeMs,
+        .thumb_width = width,
+        .thumb_height = height,
+        .thumb_mode = fast ? MEDIA_THUMB_FAST : MEDIA_THUMB_EXACT,
+        .thumb_format = (MediaThumbnailFormat)format,
+        .thumb_quality = quality,
+    };
+    BatchListener state = {
+        .env = env,
+        .listener = listener,
+        .onResult = onResult,
+        .outputs = outputs,
+    };
+    delivered = media_batch_run((const char *const *)paths, count, &request, threads, batch_deliver, &state);
+    LOGI("Media batch: %d of %d files delivered", (int)delivered, (int)count);
+
+cleanup:
+    for (jsize i = 0; i < copied; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+    return delivered;
 }
@@ -0,0 +1,421 @@
+/// 📊 bench_batch: throughput пакетной обработки галереи (media_batch.h)
+///
+/// Все файлы каталога (или перечисленные) прогоняются через media_batch_run
+/// для каждого числа worker'ов из --threads: open / probe, duration, метаданные
+/// и thumbnail, как при заполнении сетки галереи.
+///
+/// Перед замерами — один прогревочный прогон: page cache одинаково тёплый
+/// для всех конфигураций (probe cache по умолчанию выключен).
+///
+/// --format сравнивает вид thumbnail'а end-to-end (как путь галерея → дисковый кэш):
+///   rgba       RGBA из worker'ов (w * h * 4 байт через JNI)
+///   rgba+jpeg  RGBA из worker'ов, затем сжатие на вызывающем потоке (как было в Kotlin)
+///   jpeg|webp  сжатие natively в worker'ах (thumb_encode.h)
+///
+/// Метрики (медиана по --runs):
+///   - files/sec (wall) и ускорение относительно первой конфигурации
+///   - KB на файл, пересекающие JNI (xfer), и KB в дисковый кэш (disk)
+///   - p50 / p95 времени одного файла в worker'е (растёт при конкуренции за ядра)
+///   - CPU time процесса на файл
+///   - ошибки (open / probe / thumbnail)
+///
+/// Использование:
+///   bench_batch [--threads N[,N...]] [--outputs duration,info,thumb] [--thumb WxH]
+///               [--at MS] [--fast] [--format F[,F...]] [--quality Q] [--runs N] [--csv] dir|file...
+///   N: число worker'ов, 0 — media_batch_default_threads (по умолчанию 1,2,4,0)
+///   Корпус: bench/gen_gallery.sh <dir> [count]
+
+#include "media_batch.h"
+#include "thumb_encode.h"
+#include "platform_time.h"
+#include "libavutil/frame.h"
+#include "libavutil/mem.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define BENCH_MAX_RUNS 32
+#define BENCH_MAX_CONFIGS 16
+
+/// Вид thumbnail'а (--format)
+typedef struct BenchFormat {
+    const char *name;
+    MediaThumbnailFormat native;  // Что отдают worker'ы
+    MediaThumbnailFormat after;   // != RGBA — сжать RGBA на вызывающем потоке
+} BenchFormat;
+
+static const BenchFormat k_formats[] = {
+    { "rgba", MEDIA_THUMB_RGBA, MEDIA_THUMB_RGBA },
+    { "rgba+jpeg", MEDIA_THUMB_RGBA, MEDIA_THUMB_JPEG },
+    { "rgba+webp", MEDIA_THUMB_RGBA, MEDIA_THUMB_WEBP },
+    { "jpeg", MEDIA_THUMB_JPEG, MEDIA_THUMB_RGBA },
+    { "webp", MEDIA_THUMB_WEBP, MEDIA_THUMB_RGBA },
+};
+
+/// Накопитель одного прогона (callback на вызывающем потоке — без синхронизации)
+typedef struct BenchBatchRun {
+    int outputs;
+    double *file_ms;
+    int files;
+    int errors;
+    const BenchFormat *format;
+    int quality;
+    AVFrame *rgba;            // Обёртка над thumb_data для rgba+jpeg / rgba+webp
+    int64_t xfer_bytes;
+    int64_t disk_bytes;
+} BenchBatchRun;
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n) {
+    qsort(v, n, sizeof(double), cmp_double);
+    return (n % 2) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+/// Перцентиль по nearest-rank (v отсортирован)
+static double percentile(const double *v, int n, double p) {
+    int rank = (int)(p / 100.0 * n + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return v[(rank > n ? n : rank) - 1];
+}
+
+static int cmp_str(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/// Добавить путь (каталог → все обычные файлы в нём, без рекурсии)
+static int collect_paths(const char *arg, char ***paths, int *count, int *capacity) {
+    struct stat st;
+    if (stat(arg, &st) < 0) {
+        fprintf(stderr, "bench_batch: %s: not found\n", arg);
+        return -1;
+    }
+
+    char **names = NULL;
+    int n = 0;
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(arg);
+        if (!dir) {
+            return -1;
+        }
+        struct dirent *de;
+        while ((de = readdir(dir)) != NULL) {
+            if (de->d_name[0] == '.') {
+                continue;
+            }
+            size_t len = strlen(arg) + strlen(de->d_name) + 2;
+            char *full = malloc(len);
+            char **grown = realloc(names, (n + 1) * sizeof(char *));
+            if (!full || !grown) {
+                free(full);
+                closedir(dir);
+                return -1;
+            }
+            names = grown;
+            snprintf(full, len, "%s/%s", arg, de->d_name);
+            if (stat(full, &st) == 0 && S_ISREG(st.st_mode)) {
+                names[n++] = full;
+            } else {
+                free(full);
+            }
+        }
+        closedir(dir);
+        qsort(names, n, sizeof(char *), cmp_str);
+    } else {
+        names = malloc(sizeof(char *));
+        if (!names || !(names[0] = strdup(arg))) {
+            free(names);
+            return -1;
+        }
+        n = 1;
+    }
+
+    if (*count + n > *capacity) {
+        int capacity_new = (*count + n) * 2;
+        char **grown = realloc(*paths, capacity_new * sizeof(char *));
+        if (!grown) {
+            return -1;
+        }
+        *paths = grown;
+        *capacity = capacity_new;
+    }
+    memcpy(*paths + *count, names, n * sizeof(char *));
+    *count += n;
+    free(names);
+    return 0;
+}
+
+static int on_result(void *opaque, const MediaBatchResult *result) {
+    BenchBatchRun *run = opaque;
+    run->file_ms[run->files++] = result->elapsed_us / 1000.0;
+    if (result->status != MEDIA_HANDLE_OK ||
+        ((run->outputs & MEDIA_BATCH_THUMBNAIL) && result->thumb_status != MEDIA_HANDLE_OK)) {
+        run->errors++;
+    }
+    if (!result->thumb_data) {
+        return 0;
+    }
+
+    run->xfer_bytes += result->thumb_size;
+    if (run->format->after == MEDIA_THUMB_RGBA) {
+        run->disk_bytes += result->thumb_size;
+        return 0;
+    }
+    run->rgba->format = AV_PIX_FMT_RGBA;
+    run->rgba->width = result->thumb_width;
+    run->rgba->height = result->thumb_height;
+    run->rgba->data[0] = result->thumb_data;
+    run->rgba->linesize[0] = result->thumb_width * 4;
+    uint8_t *data = NULL;
+    int size = 0;
+    if (thumb_encode_frame(run->rgba, result->thumb_width, result->thumb_height, run->format->after,
+                           run->quality, &data, &size) < 0) {
+        run->errors++;
+    }
+    run->disk_bytes += size;
+    av_free(data);
+    return 0;
+}
+
+/// Разобрать --format F[,F...]
+static int parse_formats(const char *arg, const BenchFormat **formats) {
+    int n = 0;
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", arg);
+    for (char *save = NULL, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        const BenchFormat *found = NULL;
+        for (size_t i = 0; i < sizeof(k_formats) / sizeof(k_formats[0]); i++) {
+            if (strcmp(tok, k_formats[i].name) == 0) {
+                found = &k_formats[i];
+            }
+        }
+        if (!found || n >= BENCH_MAX_CONFIGS) {
+            return -1;
+        }
+        if (!thumb_encode_supported(found->native) || !thumb_encode_supported(found->after)) {
+            fprintf(stderr, "bench_batch: %s: encoder not available in this FFmpeg build\n", tok);
+            return -1;
+        }
+        formats[n++] = found;
+    }
+    return n;
+}
+
+/// Разобрать --outputs duration,info,thumb
+static int parse_outputs(const char *arg) {
+    int outputs = 0;
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", arg);
+    for (char *save = NULL, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        if (strcmp(tok, "duration") == 0) {
+            outputs |= MEDIA_BATCH_DURATION;
+        } else if (strcmp(tok, "info") == 0) {
+            outputs |= MEDIA_BATCH_INFO;
+        } else if (strcmp(tok, "thumb") == 0) {
+            outputs |= MEDIA_BATCH_THUMBNAIL;
+        } else {
+            return -1;
+        }
+    }
+    return outputs;
+}
+
+/// Разобрать --threads N[,N...]
+static int parse_threads(const char *arg, int *threads) {
+    int n = 0;
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", arg);
+    for (char *save = NULL, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        if (n >= BENCH_MAX_CONFIGS || atoi(tok) < 0) {
+            return -1;
+        }
+        threads[n++] = atoi(tok);
+    }
+    return n;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--threads N[,N...]] [--outputs duration,info,thumb] [--thumb WxH]\n"
+            "       [--at MS] [--fast] [--format F[,F...]] [--quality Q] [--runs N] [--csv] dir|file...\n"
+            "  N: workers, 0 = media_batch_default_threads (default 1,2,4,0)\n"
+            "  F: rgba, rgba+jpeg, rgba+webp, jpeg, webp (default rgba)\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    int threads[BENCH_MAX_CONFIGS] = { 1, 2, 4, 0 };
+    int nb_threads = 4;
+    const BenchFormat *formats[BENCH_MAX_CONFIGS] = { &k_formats[0] };
+    int nb_formats = 1;
+    int runs = 3;
+    int csv = 0;
+    MediaBatchRequest request = {
+        .outputs = MEDIA_BATCH_DURATION | MEDIA_BATCH_INFO | MEDIA_BATCH_THUMBNAIL,
+        .thumb_time_ms = 1000,
+        .thumb_width = 320,
+        .thumb_height = 180,
+        .thumb_mode = MEDIA_THUMB_EXACT,
+        .thumb_format = MEDIA_THUMB_RGBA,
+        .thumb_quality = THUMB_ENCODE_DEFAULT_QUALITY,
+    };
+    int first_file = argc;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            nb_threads = parse_threads(argv[++i], threads);
+            if (nb_threads <= 0) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--outputs") == 0 && i + 1 < argc) {
+            request.outputs = parse_outputs(argv[++i]);
+            if (request.outputs <= 0) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--thumb") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &request.thumb_width, &request.thumb_height) != 2) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--at") == 0 && i + 1 < argc) {
+            request.thumb_time_ms = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--fast") == 0) {
+            request.thumb_mode = MEDIA_THUMB_FAST;
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            nb_formats = parse_formats(argv[++i], formats);
+            if (nb_formats <= 0) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--quality") == 0 && i + 1 < argc) {
+            request.thumb_quality = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            first_file = i;
+            break;
+        }
+    }
+    if (first_file >= argc || runs < 1 || runs > BENCH_MAX_RUNS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    char **paths = NULL;
+    int count = 0;
+    int capacity = 0;
+    for (int f = first_file; f < argc; f++) {
+        if (collect_paths(argv[f], &paths, &count, &capacity) < 0) {
+            return 1;
+        }
+    }
+    if (count == 0) {
+        fprintf(stderr, "bench_batch: no files\n");
+        return 1;
+    }
+
+    BenchBatchRun run = {
+        .outputs = request.outputs,
+        .file_ms = malloc(count * sizeof(double)),
+        .format = formats[0],
+        .quality = request.thumb_quality,
+        .rgba = av_frame_alloc(),
+    };
+    double *all_ms = malloc((size_t)count * runs * sizeof(double));
+    if (!run.file_ms || !all_ms || !run.rgba) {
+        return 1;
+    }
+
+    // Прогрев: page cache одинаковый для всех конфигураций
+    media_batch_run((const char *const *)paths, count, &request, 0, on_result, &run);
+
+    if (csv) {
+        printf("format,threads,files,files_per_sec,speedup,file_p50_ms,file_p95_ms,cpu_ms_per_file,"
+               "xfer_kb_per_file,disk_kb_per_file,errors\n");
+    } else {
+        printf("%d files, outputs=0x%x, thumb %dx%d at %lld ms (%s), quality %d\n", count, request.outputs,
+               request.thumb_width, request.thumb_height, (long long)request.thumb_time_ms,
+               request.thumb_mode == MEDIA_THUMB_FAST ? "fast" : "exact", request.thumb_quality);
+        printf("%-10s %8s %10s %8s %10s %10s %10s %9s %9s %7s\n", "format",
+               "threads", "files/s", "speedup", "p50 ms", "p95 ms", "cpu ms/f", "xfer KB/f", "disk KB/f", "errors");
+    }
+
+    double base_fps = 0.0;
+    int failures = 0;
+    for (int c = 0; c < nb_threads * nb_formats; c++) {
+        int workers = threads[c % nb_threads] > 0 ? threads[c % nb_threads] : media_batch_default_threads();
+        run.format = formats[c / nb_threads];
+        request.thumb_format = run.format->native;
+        double fps[BENCH_MAX_RUNS], cpf[BENCH_MAX_RUNS];
+        int nb_all = 0;
+        int errors = 0;
+        int64_t xfer_bytes = 0;
+        int64_t disk_bytes = 0;
+        int delivered = 0;
+
+        for (int r = 0; r < runs; r++) {
+            run.files = 0;
+            run.errors = 0;
+            run.xfer_bytes = 0;
+            run.disk_bytes = 0;
+            int64_t cpu_start = platform_process_cpu_us();
+            int64_t wall_start = platform_now_us();
+            media_batch_run((const char *const *)paths, count, &request, workers, on_result, &run);
+            double wall_sec = (platform_now_us() - wall_start) / 1e6;
+            double cpu_ms = (platform_process_cpu_us() - cpu_start) / 1000.0;
+
+            fps[r] = wall_sec > 0 ? run.files / wall_sec : 0.0;
+            cpf[r] = run.files > 0 ? cpu_ms / run.files : 0.0;
+            memcpy(all_ms + nb_all, run.file_ms, run.files * sizeof(double));
+            nb_all += run.files;
+            errors = run.errors > errors ? run.errors : errors;
+            xfer_bytes += run.xfer_bytes;
+            disk_bytes += run.disk_bytes;
+            delivered += run.files;
+        }
+        double xfer_kb = delivered ? xfer_bytes / 1024.0 / delivered : 0.0;
+        double disk_kb = delivered ? disk_bytes / 1024.0 / delivered : 0.0;
+
+        double fps_med = median(fps, runs);
+        double cpf_med = median(cpf, runs);
+        qsort(all_ms, nb_all, sizeof(double), cmp_double);
+        double p50 = nb_all ? percentile(all_ms, nb_all, 50.0) : 0.0;
+        double p95 = nb_all ? percentile(all_ms, nb_all, 95.0) : 0.0;
+        if (c == 0) {
+            base_fps = fps_med;
+        }
+        double speedup = base_fps > 0 ? fps_med / base_fps : 0.0;
+        failures += errors > 0;
+
+        if (csv) {
+            printf("%s,%d,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%d\n", run.format->name,
+                   workers, count, fps_med, speedup, p50, p95, cpf_med, xfer_kb, disk_kb, errors);
+        } else {
+            printf("%-10s %8d %10.1f %7.2fx %10.1f %10.1f %10.1f %9.1f %9.1f %7d\n", run.format->name,
+                   workers, fps_med, speedup, p50, p95, cpf_med, xfer_kb, disk_kb, errors);
+        }
+    }
+
+    av_frame_free(&run.rgba);
+    free(all_ms);
+    free(run.file_ms);
+    for (int i = 0; i < count; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,209 @@
+/// 📊 bench_convert: стоимость кадр → RGBA thumbnail (rgba_convert.h / sws_cache.h)
+///
+/// Синтетические кадры (градиент + шум, без файлов) в yuv420p и nv12,
+/// три пути на каждую комбинацию источник → thumbnail:
+///   - per-call: sws_getContext + sws_scale + sws_freeContext (как было в preview)
+///   - cached:   rgba_convert_frame с выключенным быстрым путём (sws_cache)
+///   - fast:     rgba_convert_frame (NEON / SSE2 box-downscale)
+///
+/// Метрики: медиана мкс на вызов по --iters, ускорение относительно per-call,
+/// mean abs diff быстрого пути против swscale (по каналам RGB, 0..255).
+///
+/// Использование:
+///   bench_convert [--iters N] [--csv]
+
+#include "rgba_convert.h"
+#include "sws_cache.h"
+#include "platform_time.h"
+#include "libavutil/frame.h"
+#include "libavutil/pixdesc.h"
+#include "libswscale/swscale.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_MAX_ITERS 10000
+
+typedef struct BenchSize {
+    int w;
+    int h;
+} BenchSize;
+
+static const BenchSize k_sources[] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+static const BenchSize k_thumbs[] = { { 320, 180 }, { 160, 90 } };
+static const enum AVPixelFormat k_formats[] = { AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12 };
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n) {
+    qsort(v, n, sizeof(double), cmp_double);
+    return (n % 2) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+/// Кадр с плавным градиентом и шумом (шум не даёт box-фильтру и bilinear совпасть тривиально)
+static AVFrame *make_frame(int w, int h, enum AVPixelFormat fmt) {
+    AVFrame *frame = av_frame_alloc();
+    if (!frame) {
+        return NULL;
+    }
+    frame->width = w;
+    frame->height = h;
+    frame->format = fmt;
+    frame->color_range = AVCOL_RANGE_MPEG;
+    frame->colorspace = w >= 1280 ? AVCOL_SPC_BT709 : AVCOL_SPC_BT470BG;
+    if (av_frame_get_buffer(frame, 0) < 0) {
+        av_frame_free(&frame);
+        return NULL;
+    }
+
+    unsigned seed = 12345;
+    for (int y = 0; y < h; y++) {
+        uint8_t *row = frame->data[0] + (size_t)y * frame->linesize[0];
+        for (int x = 0; x < w; x++) {
+            seed = seed * 1103515245u + 12345u;
+            row[x] = (uint8_t)(16 + (x * 200 / w + y * 19 / h) + ((seed >> 16) & 15));
+        }
+    }
+    for (int y = 0; y < h / 2; y++) {
+        uint8_t *u = frame->data[1] + (size_t)y * frame->linesize[1];
+        uint8_t *v = fmt == AV_PIX_FMT_NV12 ? u + 1 : frame->data[2] + (size_t)y * frame->linesize[2];
+        int step = fmt == AV_PIX_FMT_NV12 ? 2 : 1;
+        for (int x = 0; x < w / 2; x++) {
+            u[x * step] = (uint8_t)(64 + x * 128 / (w / 2));
+            v[x * step] = (uint8_t)(192 - y * 128 / (h / 2));
+        }
+    }
+    return frame;
+}
+
+static int convert_per_call(const AVFrame *frame, int dst_w, int dst_h, uint8_t *dst) {
+    struct SwsContext *sws = sws_getContext(frame->width, frame->height, (enum AVPixelFormat)frame->format,
+                                            dst_w, dst_h, AV_PIX_FMT_RGBA, SWS_BILINEAR, NULL, NULL, NULL);
+    if (!sws) {
+        return -1;
+    }
+    uint8_t *dst_data[4] = { dst, NULL, NULL, NULL };
+    int dst_linesize[4] = { dst_w * 4, 0, 0, 0 };
+    sws_scale(sws, (const uint8_t *const *)frame->data, frame->linesize, 0, frame->height,
+              dst_data, dst_linesize);
+    sws_freeContext(sws);
+    return 0;
+}
+
+/// Медиана мкс на вызов; mode: 0 per-call, 1 cached, 2 fast
+static double run_mode(int mode, const AVFrame *frame, int dst_w, int dst_h, uint8_t *dst,
+                       int iters, double *samples) {
+    rgba_convert_set_fast_path(mode == 2);
+    for (int i = 0; i < iters; i++) {
+        int64_t t0 = platform_now_us();
+        int ret = mode == 0 ? convert_per_call(frame, dst_w, dst_h, dst)
+                            : rgba_convert_frame(frame, dst_w, dst_h, dst, dst_w * 4);
+        samples[i] = (double)(platform_now_us() - t0);
+        if (ret < 0) {
+            return -1.0;
+        }
+    }
+    return median(samples, iters);
+}
+
+static double mean_abs_diff(const uint8_t *a, const uint8_t *b, int pixels) {
+    int64_t sum = 0;
+    for (int i = 0; i < pixels; i++) {
+        for (int c = 0; c < 3; c++) {
+            int d = a[i * 4 + c] - b[i * 4 + c];
+            sum += d < 0 ? -d : d;
+        }
+    }
+    return (double)sum / (pixels * 3.0);
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--iters N] [--csv]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    int iters = 200;
+    int csv = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            iters = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (iters < 1 || iters > BENCH_MAX_ITERS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    double *samples = malloc(sizeof(double) * iters);
+    uint8_t *out_sws = malloc((size_t)k_thumbs[0].w * k_thumbs[0].h * 4);
+    uint8_t *out_fast = malloc((size_t)k_thumbs[0].w * k_thumbs[0].h * 4);
+    if (!samples || !out_sws || !out_fast) {
+        return 1;
+    }
+
+    if (csv) {
+        printf("src,format,dst,per_call_us,cached_us,fast_us,cached_speedup,fast_speedup,fast_mad\n");
+    } else {
+        printf("%-10s %-8s %-8s %10s %10s %10s %8s %8s %8s\n",
+               "src", "format", "dst", "per-call", "cached", "fast", "cached", "fast", "MAD");
+    }
+
+    int failed = 0;
+    for (size_t s = 0; s < sizeof(k_sources) / sizeof(k_sources[0]); s++) {
+        for (size_t f = 0; f < sizeof(k_formats) / sizeof(k_formats[0]); f++) {
+            AVFrame *frame = make_frame(k_sources[s].w, k_sources[s].h, k_formats[f]);
+            if (!frame) {
+                fprintf(stderr, "bench_convert: frame alloc failed\n");
+                return 1;
+            }
+            for (size_t t = 0; t < sizeof(k_thumbs) / sizeof(k_thumbs[0]); t++) {
+                int dst_w = k_thumbs[t].w;
+                int dst_h = k_thumbs[t].h;
+                double per_call = run_mode(0, frame, dst_w, dst_h, out_sws, iters, samples);
+                double cached = run_mode(1, frame, dst_w, dst_h, out_sws, iters, samples);
+                double fast = run_mode(2, frame, dst_w, dst_h, out_fast, iters, samples);
+                if (per_call < 0 || cached < 0 || fast < 0) {
+                    failed = 1;
+                    continue;
+                }
+                double mad = mean_abs_diff(out_sws, out_fast, dst_w * dst_h);
+                char src_name[32];
+                char dst_name[32];
+                snprintf(src_name, sizeof(src_name), "%dx%d", k_sources[s].w, k_sources[s].h);
+                snprintf(dst_name, sizeof(dst_name), "%dx%d", dst_w, dst_h);
+                const char *fmt_name = av_get_pix_fmt_name(k_formats[f]);
+                if (csv) {
+                    printf("%s,%s,%s,%.1f,%.1f,%.1f,%.2f,%.2f,%.2f\n", src_name, fmt_name, dst_name,
+                           per_call, cached, fast, per_call / cached, per_call / fast, mad);
+                } else {
+                    printf("%-10s %-8s %-8s %10.1f %10.1f %10.1f %7.1fx %7.1fx %8.2f\n", src_name, fmt_name,
+                           dst_name, per_call, cached, fast, per_call / cached, per_call / fast, mad);
+                }
+            }
+            av_frame_free(&frame);
+        }
+    }
+
+    SwsCacheStats sws_stats;
+    RgbaConvertStats conv_stats;
+    sws_cache_get_stats(&sws_stats);
+    rgba_convert_get_stats(&conv_stats);
+    fprintf(stderr, "sws_cache: %lld hits, %lld misses, %lld evictions, setup %.1f ms; "
+            "convert: %lld fast, %lld sws\n",
+            (long long)sws_stats.hits, (long long)sws_stats.misses, (long long)sws_stats.evictions,
+            sws_stats.setup_us / 1000.0, (long long)conv_stats.fast_frames, (long long)conv_stats.sws_frames);
+
+    sws_cache_flush();
+    free(samples);
+    free(out_sws);
+    free(out_fast);
+    return failed ? 1 : 0;
+}
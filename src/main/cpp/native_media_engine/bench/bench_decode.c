@@ -0,0 +1,303 @@
+/// 📊 bench_decode: headless decode throughput поверх реального pipeline
+///
+/// open_media → demux_thread → video_decode_thread / audio_decode_thread
+/// → null sinks (platform/linux) без ограничения темпа.
+///
+/// Для каждого файла и каждого прогона запускается отдельный процесс (fork),
+/// чтобы peak RSS и CPU time не смешивались между файлами.
+///
+/// Метрики:
+///   - decoded video frames/sec (wall)
+///   - demuxed packets/sec (wall)
+///   - CPU time (все потоки процесса) на видеокадр
+///   - peak RSS (ru_maxrss)
+///   - malloc узлов PacketQueue (в steady-state не растёт: freelist)
+///   - потоки декодера (thread_count + frame/slice), см. --threads
+///   - I/O stalls demux thread'а (только с --io, read-ahead слой)
+///
+/// Использование:
+///   bench_decode [--runs N] [--csv] [--timeout SEC] [--threads MODE[:N]] [--io IO] file...
+///   MODE: auto | frame | slice | lowlat (player_set_decode_thread_policy)
+///   IO:   off | readahead[:BLOCK_KB[:COUNT]] | mmap (io_readahead_set_config)
+///   Корпус: bench/gen_corpus.sh <dir>
+
+#include "player_host.h"
+#include "platform_time.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define BENCH_MAX_RUNS 32
+
+typedef struct BenchDecodeResult {
+    int ok;
+    char container[32];
+    char video_codec[32];
+    char audio_codec[32];
+    int64_t video_frames;
+    int64_t audio_frames;
+    int64_t packets;
+    uint64_t pkt_node_allocs;  // malloc узлов PacketQueue (video + audio)
+    int decode_threads;        // codecCtx->thread_count после avcodec_open2
+    char thread_type[8];       // "frame" / "slice" / "none" (active_thread_type)
+    int64_t io_stalls;         // read callback ждал read-ahead поток (0 без --io)
+    int64_t io_stall_us;
+    double wall_sec;
+    double cpu_sec;
+    long peak_rss_kb;
+} BenchDecodeResult;
+
+/// Один прогон (выполняется в дочернем процессе)
+static void bench_run_child(const char *path, int timeout_sec, BenchDecodeResult *r) {
+    memset(r, 0, sizeof(*r));
+
+    int64_t cpu_start = platform_process_cpu_us();
+    int64_t wall_start = platform_now_us();
+
+    PlayerContext *ctx = player_host_open(path);
+    if (!ctx) {
+        return;
+    }
+
+    snprintf(r->container, sizeof(r->container), "%s", ctx->fmt->iformat->name);
+    snprintf(r->video_codec, sizeof(r->video_codec), "%s", ctx->video->codecCtx->codec->name);
+    snprintf(r->audio_codec, sizeof(r->audio_codec), "%s",
+             (ctx->audio && ctx->audio->codecCtx) ? ctx->audio->codecCtx->codec->name : "-");
+    r->decode_threads = ctx->video->codecCtx->thread_count;
+    snprintf(r->thread_type, sizeof(r->thread_type), "%s",
+             (ctx->video->codecCtx->active_thread_type & FF_THREAD_FRAME) ? "frame" :
+             (ctx->video->codecCtx->active_thread_type & FF_THREAD_SLICE) ? "slice" : "none");
+
+    if (player_host_start(ctx, false) == 0 &&
+        player_host_wait_eof(ctx, timeout_sec * 1000)) {
+        r->ok = 1;
+    }
+
+    r->wall_sec = (platform_now_us() - wall_start) / 1e6;
+    r->cpu_sec = (platform_process_cpu_us() - cpu_start) / 1e6;
+    r->video_frames = ctx->video->frames_decoded;
+    r->audio_frames = ctx->audio ? ctx->audio->frames_decoded : 0;
+    r->packets = ctx->packets_demuxed;
+    
+    IoStats io;
+    if (player_get_io_stats(ctx, &io) == 0) {
+        r->io_stalls = io.stalls;
+        r->io_stall_us = io.stall_us;
+    }
+
+    PacketQueueStats vq, aq;
+    if (player_get_packet_queue_stats(ctx, &vq, &aq) == 0) {
+        r->pkt_node_allocs = vq.node_allocs + aq.node_allocs;
+    }
+
+    player_host_close(ctx);
+
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    r->peak_rss_kb = ru.ru_maxrss;
+}
+
+static int bench_run(const char *path, int timeout_sec, BenchDecodeResult *out) {
+    int fds[2];
+    if (pipe(fds) < 0) {
+        perror("pipe");
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        BenchDecodeResult r;
+        bench_run_child(path, timeout_sec, &r);
+        ssize_t n = write(fds[1], &r, sizeof(r));
+        close(fds[1]);
+        _exit(n == (ssize_t)sizeof(r) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    memset(out, 0, sizeof(*out));
+    ssize_t n;
+    do {
+        n = read(fds[0], out, sizeof(*out));
+    } while (n < 0 && errno == EINTR);
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (n != (ssize_t)sizeof(*out) || !WIFEXITED(status)) {
+        out->ok = 0;
+        return -1;
+    }
+    return out->ok ? 0 : -1;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n) {
+    qsort(v, n, sizeof(double), cmp_double);
+    return (n % 2) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+/// Разобрать --threads MODE[:N]
+static int parse_thread_policy(const char *arg) {
+    static const char *const modes[] = { "auto", "frame", "slice", "lowlat" };
+    size_t len = strcspn(arg, ":");
+    for (int mode = 0; mode < (int)(sizeof(modes) / sizeof(modes[0])); mode++) {
+        if (strlen(modes[mode]) == len && !strncmp(arg, modes[mode], len)) {
+            int count = arg[len] == ':' ? atoi(arg + len + 1) : 0;
+            if (count < 0) {
+                return -1;
+            }
+            player_set_decode_thread_policy((VideoDecodeThreadMode)mode, count);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/// Разобрать --io off | readahead[:BLOCK_KB[:COUNT]] | mmap
+static int parse_io_config(const char *arg) {
+    IoReadaheadConfig cfg = io_readahead_get_config();
+    cfg.enabled = true;
+    cfg.use_mmap = false;
+    if (strcmp(arg, "off") == 0) {
+        cfg.enabled = false;
+    } else if (strcmp(arg, "mmap") == 0) {
+        cfg.use_mmap = true;
+    } else if (strncmp(arg, "readahead", 9) == 0 && (arg[9] == '\0' || arg[9] == ':')) {
+        int block_kb = 0, count = 0;
+        if (arg[9] == ':' && sscanf(arg + 10, "%d:%d", &block_kb, &count) < 1) {
+            return -1;
+        }
+        cfg.block_size = block_kb * 1024;
+        cfg.block_count = count;
+    } else {
+        return -1;
+    }
+    io_readahead_set_config(&cfg);
+    return 0;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--runs N] [--csv] [--timeout SEC] [--threads auto|frame|slice|lowlat[:N]]\n"
+                    "          [--io off|readahead[:BLOCK_KB[:COUNT]]|mmap] file...\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    int runs = 3;
+    int csv = 0;
+    int timeout_sec = 300;
+    int first_file = argc;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeout_sec = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            if (parse_thread_policy(argv[++i]) < 0) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--io") == 0 && i + 1 < argc) {
+            if (parse_io_config(argv[++i]) < 0) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            first_file = i;
+            break;
+        }
+    }
+    if (first_file >= argc || runs < 1 || runs > BENCH_MAX_RUNS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (csv) {
+        printf("file,container,vcodec,acodec,video_frames,audio_frames,packets,"
+               "fps,packets_per_sec,cpu_ms_per_frame,peak_rss_mb,pkt_node_allocs,"
+               "decode_threads,thread_type,io_stalls,io_stall_ms\n");
+    } else {
+        printf("%-28s %-9s %-8s %-8s %8s %8s %9s %10s %9s %7s %8s %9s %8s\n",
+               "file", "container", "vcodec", "acodec", "vframes", "fps",
+               "pkt/s", "cpu ms/fr", "rss MB", "nodes", "threads", "io ms", "runs");
+    }
+
+    int failures = 0;
+    for (int f = first_file; f < argc; f++) {
+        const char *path = argv[f];
+        const char *name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+
+        BenchDecodeResult r = {0};
+        BenchDecodeResult last = {0};
+        double fps[BENCH_MAX_RUNS], pps[BENCH_MAX_RUNS], cpf[BENCH_MAX_RUNS], iow[BENCH_MAX_RUNS];
+        long peak_rss_kb = 0;
+        int ok_runs = 0;
+
+        for (int run = 0; run < runs; run++) {
+            if (bench_run(path, timeout_sec, &r) < 0 || r.video_frames <= 0 || r.wall_sec <= 0) {
+                continue;
+            }
+            last = r;
+            fps[ok_runs] = r.video_frames / r.wall_sec;
+            pps[ok_runs] = r.packets / r.wall_sec;
+            cpf[ok_runs] = r.cpu_sec * 1000.0 / r.video_frames;
+            iow[ok_runs] = r.io_stall_us / 1000.0;
+            if (r.peak_rss_kb > peak_rss_kb) {
+                peak_rss_kb = r.peak_rss_kb;
+            }
+            ok_runs++;
+        }
+
+        if (ok_runs == 0) {
+            fprintf(stderr, "bench_decode: %s: failed\n", path);
+            failures++;
+            continue;
+        }
+
+        double fps_med = median(fps, ok_runs);
+        double pps_med = median(pps, ok_runs);
+        double cpf_med = median(cpf, ok_runs);
+        double rss_mb = peak_rss_kb / 1024.0;
+        double io_stall_ms = median(iow, ok_runs);
+
+        if (csv) {
+            printf("%s,%s,%s,%s,%lld,%lld,%lld,%.1f,%.1f,%.3f,%.1f,%llu,%d,%s,%lld,%.1f\n",
+                   name, last.container, last.video_codec, last.audio_codec,
+                   (long long)last.video_frames, (long long)last.audio_frames, (long long)last.packets,
+                   fps_med, pps_med, cpf_med, rss_mb, (unsigned long long)last.pkt_node_allocs,
+                   last.decode_threads, last.thread_type, (long long)last.io_stalls, io_stall_ms);
+        } else {
+            char threads[16];
+            snprintf(threads, sizeof(threads), "%d %.1s", last.decode_threads, last.thread_type);
+            printf("%-28.28s %-9.9s %-8.8s %-8.8s %8lld %8.1f %9.1f %10.3f %9.1f %7llu %8s %9.1f %5d/%d\n",
+                   name, last.container, last.video_codec, last.audio_codec,
+                   (long long)last.video_frames, fps_med, pps_med, cpf_med, rss_mb,
+                   (unsigned long long)last.pkt_node_allocs, threads, io_stall_ms, ok_runs, runs);
+        }
+        fflush(stdout);
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,329 @@
+/// 📊 bench_gl_upload: CPU-стоимость загрузки кадра в текстуры (EGL surfaceless, Mesa llvmpipe)
+///
+/// Кадры с padding'ом в linesize (как у декодера: linesize > ширины строки),
+/// поэтому прямой glTexSubImage2D из кадра невозможен. Режимы:
+///   legacy     — malloc + построчный memcpy + free на каждую плоскость (upload_yuv_frame до vr_yuv_uploader)
+///   staging    — GLES2 путь: SIMD упаковка в persistent staging (vr_yuv_pack_plane)
+///   row_length — GLES3 путь: GL_UNPACK_ROW_LENGTH, без копии на CPU (если context его поддерживает)
+///   pbo_stage  — копия кадра в mapped PBO (video_render_pbo.h), вне критического пути
+///   pbo_upload — glTexSubImage2D из подготовленного PBO: всё, что остаётся перед swap'ом
+///   pack       — только ядро упаковки всех плоскостей, без GL
+///
+/// Метрики: медиана CPU-времени потока на кадр (CLOCK_THREAD_CPUTIME_ID: у llvmpipe
+/// копия в текстуру тоже идёт в вызывающем потоке) и медиана wall-времени до glFinish.
+/// У llvmpipe нет DMA: копия PBO → текстура тоже выполняется CPU, поэтому pbo_upload
+/// на host'е — верхняя оценка; на устройстве её делает GPU.
+///
+/// Использование:
+///   bench_gl_upload [--iters N] [--csv]
+
+#include "video_render_pbo.h"
+#include "platform_time.h"
+#include "libavutil/frame.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/mem.h"
+#include "libavutil/pixdesc.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_MAX_ITERS 10000
+
+// Padding строки: типичное выравнивание декодера / hwaccel сверх ширины кадра
+#define BENCH_LINE_PADDING 64
+
+typedef struct BenchSize {
+    int w;
+    int h;
+} BenchSize;
+
+static const BenchSize k_sizes[] = { { 1920, 1080 }, { 3840, 2160 } };
+static const enum AVPixelFormat k_formats[] = {
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12, AV_PIX_FMT_P010LE, AV_PIX_FMT_YUV420P10LE,
+};
+
+typedef enum BenchMode {
+    BENCH_MODE_LEGACY,
+    BENCH_MODE_STAGING,
+    BENCH_MODE_ROW_LENGTH,
+    BENCH_MODE_PBO_STAGE,
+    BENCH_MODE_PBO_UPLOAD,
+    BENCH_MODE_PACK,
+    BENCH_MODE_COUNT
+} BenchMode;
+
+static const char *k_mode_names[BENCH_MODE_COUNT] = {
+    "legacy", "staging", "row_length", "pbo_stage", "pbo_upload", "pack",
+};
+
+typedef struct GlBench {
+    EGLDisplay display;
+    EGLContext context;
+} GlBench;
+
+/// Геометрия плоскостей кадра (все форматы — 4:2:0)
+typedef struct BenchPlanes {
+    int count;
+    int row_bytes[VR_YUV_MAX_PLANES];
+    int rows[VR_YUV_MAX_PLANES];
+    GLenum format[VR_YUV_MAX_PLANES];
+} BenchPlanes;
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n) {
+    qsort(v, n, sizeof(double), cmp_double);
+    return (n % 2) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+/// EGL без окна и без pbuffer: Mesa surfaceless, только текстуры
+static int gl_bench_init(GlBench *gl) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    gl->display = get_platform_display
+        ? get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL)
+        : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (gl->display == EGL_NO_DISPLAY || !eglInitialize(gl->display, NULL, NULL)) {
+        fprintf(stderr, "bench_gl_upload: EGL display unavailable (0x%x)\n", eglGetError());
+        return -1;
+    }
+    eglBindAPI(EGL_OPENGL_ES_API);
+
+    const EGLint context_attribs[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+    gl->context = eglCreateContext(gl->display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, context_attribs);
+    if (gl->context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(gl->display, EGL_NO_SURFACE, EGL_NO_SURFACE, gl->context)) {
+        fprintf(stderr, "bench_gl_upload: GLES2 context unavailable (0x%x)\n", eglGetError());
+        return -1;
+    }
+    return 0;
+}
+
+static void gl_bench_release(GlBench *gl) {
+    eglMakeCurrent(gl->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(gl->display, gl->context);
+    eglTerminate(gl->display);
+}
+
+static void frame_planes(enum AVPixelFormat fmt, int w, int h, BenchPlanes *p) {
+    int linesizes[4] = { 0 };
+    av_image_fill_linesizes(linesizes, fmt, w);
+    p->count = av_pix_fmt_count_planes(fmt);
+    int chroma_w = (w + 1) >> 1;
+    for (int i = 0; i < p->count; i++) {
+        int plane_w = i == 0 ? w : chroma_w;
+        int bpp = linesizes[i] / plane_w;
+        p->row_bytes[i] = linesizes[i];
+        p->rows[i] = i == 0 ? h : (h + 1) >> 1;
+        p->format[i] = bpp == 1 ? GL_LUMINANCE : bpp == 2 ? GL_LUMINANCE_ALPHA : GL_RGBA;
+    }
+}
+
+/// Кадр с linesize = строка + BENCH_LINE_PADDING; данные — шум (содержимое не важно)
+static AVFrame *make_padded_frame(enum AVPixelFormat fmt, int w, int h, const BenchPlanes *p) {
+    AVFrame *frame = av_frame_alloc();
+    if (!frame) {
+        return NULL;
+    }
+    frame->format = fmt;
+    frame->width = w;
+    frame->height = h;
+    unsigned seed = 12345;
+    for (int i = 0; i < p->count; i++) {
+        frame->linesize[i] = p->row_bytes[i] + BENCH_LINE_PADDING;
+        size_t size = (size_t)frame->linesize[i] * p->rows[i];
+        frame->data[i] = av_malloc(size);
+        if (!frame->data[i]) {
+            return NULL;
+        }
+        for (size_t k = 0; k < size; k++) {
+            seed = seed * 1103515245u + 12345u;
+            frame->data[i][k] = (uint8_t)(seed >> 16);
+        }
+    }
+    return frame;
+}
+
+static void free_padded_frame(AVFrame **frame) {
+    if (!*frame) {
+        return;
+    }
+    for (int i = 0; i < VR_YUV_MAX_PLANES; i++) {
+        av_freep(&(*frame)->data[i]);
+    }
+    av_frame_free(frame);
+}
+
+/// Прежний upload_yuv_frame: временный буфер на каждую плоскость каждого кадра
+static void upload_legacy(const GLuint *tex, const AVFrame *frame, const BenchPlanes *p, int w) {
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < p->count; i++) {
+        int plane_w = i == 0 ? w : (w + 1) >> 1;
+        uint8_t *temp = malloc((size_t)p->row_bytes[i] * p->rows[i]);
+        const uint8_t *src = frame->data[i];
+        uint8_t *dst = temp;
+        for (int y = 0; y < p->rows[i]; y++) {
+            memcpy(dst, src, p->row_bytes[i]);
+            src += frame->linesize[i];
+            dst += p->row_bytes[i];
+        }
+        glBindTexture(GL_TEXTURE_2D, tex[i]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, plane_w, p->rows[i], p->format[i], GL_UNSIGNED_BYTE, temp);
+        free(temp);
+    }
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--iters N] [--csv]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    int iters = 50;
+    int csv = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            iters = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (iters < 1 || iters > BENCH_MAX_ITERS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    GlBench gl;
+    if (gl_bench_init(&gl) < 0) {
+        return 1;
+    }
+    VrYuvUploader uploader;
+    vr_yuv_uploader_init(&uploader);
+    bool has_row_length = uploader.row_length;
+    VrPboRing ring;
+    vr_pbo_ring_init(&ring);
+    fprintf(stderr, "GL: %s / %s, GL_UNPACK_ROW_LENGTH: %s, PBO: %s\n", (const char *)glGetString(GL_RENDERER),
+            (const char *)glGetString(GL_VERSION), has_row_length ? "yes" : "no", ring.available ? "yes" : "no");
+
+    double *cpu_samples = malloc(sizeof(double) * iters);
+    double *wall_samples = malloc(sizeof(double) * iters);
+    if (!cpu_samples || !wall_samples) {
+        return 1;
+    }
+
+    if (csv) {
+        printf("size,format,mode,cpu_us,wall_us\n");
+    } else {
+        printf("%-10s %-12s %-10s %10s %10s\n", "size", "format", "mode", "cpu_us", "wall_us");
+    }
+
+    int failed = 0;
+    for (size_t s = 0; s < sizeof(k_sizes) / sizeof(k_sizes[0]); s++) {
+        int w = k_sizes[s].w;
+        int h = k_sizes[s].h;
+        for (size_t f = 0; f < sizeof(k_formats) / sizeof(k_formats[0]); f++) {
+            VrYuvLayout layout = vr_yuv_layout_for_format(k_formats[f]);
+            BenchPlanes planes;
+            frame_planes(k_formats[f], w, h, &planes);
+            AVFrame *frame = make_padded_frame(k_formats[f], w, h, &planes);
+            size_t pack_size = (size_t)planes.row_bytes[0] * planes.rows[0];
+            uint8_t *pack_dst = av_malloc(pack_size);
+            if (!frame || !pack_dst) {
+                fprintf(stderr, "bench_gl_upload: %s setup failed\n", av_get_pix_fmt_name(k_formats[f]));
+                free_padded_frame(&frame);
+                av_free(pack_dst);
+                failed = 1;
+                continue;
+            }
+
+            GLuint tex[VR_YUV_MAX_PLANES];
+            glGenTextures(VR_YUV_MAX_PLANES, tex);
+            vr_yuv_upload_frame(&uploader, layout, tex, frame, w, h, true);
+            glFinish();
+
+            char size_name[32];
+            snprintf(size_name, sizeof(size_name), "%dx%d", w, h);
+            const char *fmt_name = av_get_pix_fmt_name(k_formats[f]);
+
+            for (int mode = 0; mode < BENCH_MODE_COUNT; mode++) {
+                if (mode == BENCH_MODE_ROW_LENGTH && !has_row_length) {
+                    continue;
+                }
+                bool pbo_mode = mode == BENCH_MODE_PBO_STAGE || mode == BENCH_MODE_PBO_UPLOAD;
+                if (pbo_mode && !ring.available) {
+                    continue;
+                }
+                // YUV420P10 всегда упаковывается (сдвиг в старшие разряды): row_length для него не применим
+                if (mode == BENCH_MODE_ROW_LENGTH && layout == VR_YUV_LAYOUT_I420_10) {
+                    continue;
+                }
+                uploader.row_length = mode == BENCH_MODE_ROW_LENGTH;
+                for (int i = 0; i < iters; i++) {
+                    // Новый кадр на каждой итерации: кольцо не должно узнавать уже подготовленный
+                    frame->pts = i + 1;
+                    if (mode == BENCH_MODE_PBO_UPLOAD) {
+                        vr_pbo_ring_stage(&ring, layout, frame, w, h);
+                    }
+                    int64_t c0 = platform_thread_cpu_us();
+                    int64_t t0 = platform_now_us();
+                    if (mode == BENCH_MODE_LEGACY) {
+                        upload_legacy(tex, frame, &planes, w);
+                    } else if (mode == BENCH_MODE_PBO_STAGE) {
+                        vr_pbo_ring_stage(&ring, layout, frame, w, h);
+                    } else if (mode == BENCH_MODE_PBO_UPLOAD) {
+                        vr_pbo_ring_upload(&ring, layout, tex, frame, w, h, false);
+                    } else if (mode == BENCH_MODE_PACK) {
+                        for (int p = 0; p < planes.count; p++) {
+                            if (layout == VR_YUV_LAYOUT_I420_10) {
+                                vr_yuv_pack_plane_msb10(pack_dst, frame->data[p], frame->linesize[p],
+                                                        planes.row_bytes[p] / 2, planes.rows[p]);
+                            } else {
+                                vr_yuv_pack_plane(pack_dst, frame->data[p], frame->linesize[p],
+                                                  planes.row_bytes[p], planes.rows[p]);
+                            }
+                        }
+                    } else {
+                        vr_yuv_upload_frame(&uploader, layout, tex, frame, w, h, false);
+                    }
+                    if (mode != BENCH_MODE_PACK && mode != BENCH_MODE_PBO_STAGE) {
+                        glFinish();
+                    }
+                    cpu_samples[i] = (double)(platform_thread_cpu_us() - c0);
+                    wall_samples[i] = (double)(platform_now_us() - t0);
+                }
+                double cpu_us = median(cpu_samples, iters);
+                double wall_us = median(wall_samples, iters);
+                GLenum err = glGetError();
+                if (err != GL_NO_ERROR) {
+                    failed = 1;
+                }
+                if (csv) {
+                    printf("%s,%s,%s,%.1f,%.1f\n", size_name, fmt_name, k_mode_names[mode], cpu_us, wall_us);
+                } else {
+                    printf("%-10s %-12s %-10s %10.1f %10.1f%s\n", size_name, fmt_name, k_mode_names[mode],
+                           cpu_us, wall_us, err != GL_NO_ERROR ? "  GL error" : "");
+                }
+            }
+            uploader.row_length = has_row_length;
+
+            glDeleteTextures(VR_YUV_MAX_PLANES, tex);
+            av_free(pack_dst);
+            free_padded_frame(&frame);
+        }
+    }
+
+    vr_pbo_ring_release(&ring);
+    vr_yuv_uploader_free(&uploader);
+    free(cpu_samples);
+    free(wall_samples);
+    gl_bench_release(&gl);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,394 @@
+/// 📊 bench_gl_yuv: GPU-пути video_render_yuv.h без устройства (EGL surfaceless, Mesa llvmpipe)
+///
+/// Для каждой раскладки (nv12, nv21, p010, yuv420p10) синтетический кадр
+/// загружается в текстуры, рисуется shader'ом формата в FBO того же размера
+/// и читается обратно. Эталон — swscale (тот же кадр → RGBA, BT.709 limited).
+///
+/// Метрики: медиана мкс на загрузку кадра (vr_yuv_upload_frame + glFinish),
+/// медиана мкс на draw, mean / max abs diff против swscale (RGB, 0..255).
+/// Код возврата 1, если MAD какой-либо раскладки больше --max-mad.
+///
+/// Использование:
+///   bench_gl_yuv [--iters N] [--max-mad X] [--csv]
+
+#include "video_render_yuv.h"
+#include "platform_time.h"
+#include "libavutil/frame.h"
+#include "libavutil/pixdesc.h"
+#include "libswscale/swscale.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_MAX_ITERS 10000
+
+typedef struct BenchSize {
+    int w;
+    int h;
+} BenchSize;
+
+// Нечётный размер: chroma округляется вверх, linesize с padding'ом (построчная загрузка)
+static const BenchSize k_sizes[] = { { 1279, 719 }, { 1920, 1080 }, { 3840, 2160 } };
+static const enum AVPixelFormat k_formats[] = {
+    AV_PIX_FMT_NV12, AV_PIX_FMT_NV21, AV_PIX_FMT_P010LE, AV_PIX_FMT_YUV420P10LE,
+};
+
+// Vertex shader эталона video_render_gl.c (uScaleX / uScaleY — fit mode)
+static const char *k_vertex_shader =
+    "attribute vec4 aPosition;\n"
+    "attribute vec2 aTexCoord;\n"
+    "uniform float uScaleX;\n"
+    "uniform float uScaleY;\n"
+    "varying vec2 vTexCoord;\n"
+    "\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPosition.x * uScaleX, aPosition.y * uScaleY, aPosition.z, aPosition.w);\n"
+    "    vTexCoord = aTexCoord;\n"
+    "}\n";
+
+static const float k_quad[] = {
+    -1.0f, -1.0f, 0.0f, 1.0f,
+     1.0f, -1.0f, 1.0f, 1.0f,
+    -1.0f,  1.0f, 0.0f, 0.0f,
+     1.0f,  1.0f, 1.0f, 0.0f,
+};
+
+typedef struct GlBench {
+    EGLDisplay display;
+    EGLContext context;
+    GLuint vbo;
+} GlBench;
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n) {
+    qsort(v, n, sizeof(double), cmp_double);
+    return (n % 2) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+/// EGL без окна и без pbuffer: Mesa surfaceless, рендер только в FBO
+static int gl_bench_init(GlBench *gl) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    gl->display = get_platform_display
+        ? get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL)
+        : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (gl->display == EGL_NO_DISPLAY || !eglInitialize(gl->display, NULL, NULL)) {
+        fprintf(stderr, "bench_gl_yuv: EGL display unavailable (0x%x)\n", eglGetError());
+        return -1;
+    }
+    eglBindAPI(EGL_OPENGL_ES_API);
+
+    const EGLint config_attribs[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = NULL;
+    EGLint num_configs = 0;
+    eglChooseConfig(gl->display, config_attribs, &config, 1, &num_configs);
+
+    const EGLint context_attribs[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+    gl->context = eglCreateContext(gl->display, num_configs > 0 ? config : EGL_NO_CONFIG_KHR,
+                                   EGL_NO_CONTEXT, context_attribs);
+    if (gl->context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(gl->display, EGL_NO_SURFACE, EGL_NO_SURFACE, gl->context)) {
+        fprintf(stderr, "bench_gl_yuv: GLES2 context unavailable (0x%x)\n", eglGetError());
+        return -1;
+    }
+
+    glGenBuffers(1, &gl->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, gl->vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(k_quad), k_quad, GL_STATIC_DRAW);
+    return 0;
+}
+
+static void gl_bench_release(GlBench *gl) {
+    glDeleteBuffers(1, &gl->vbo);
+    eglMakeCurrent(gl->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(gl->display, gl->context);
+    eglTerminate(gl->display);
+}
+
+static GLuint compile_shader(GLenum type, const char *source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    GLint ok = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        fprintf(stderr, "bench_gl_yuv: shader compile failed: %s\n", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static GLuint create_program(const char *fragment_source) {
+    GLuint vs = compile_shader(GL_VERTEX_SHADER, k_vertex_shader);
+    GLuint fs = compile_shader(GL_FRAGMENT_SHADER, fragment_source);
+    GLuint program = 0;
+    if (vs && fs) {
+        program = glCreateProgram();
+        glAttachShader(program, vs);
+        glAttachShader(program, fs);
+        glLinkProgram(program);
+        GLint ok = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (!ok) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    return program;
+}
+
+/// Кадр формата fmt: 8-битный градиент с шумом, переведённый swscale в fmt
+static AVFrame *make_frame(int w, int h, enum AVPixelFormat fmt) {
+    AVFrame *src = av_frame_alloc();
+    AVFrame *dst = av_frame_alloc();
+    if (!src || !dst) {
+        goto fail;
+    }
+    src->width = dst->width = w;
+    src->height = dst->height = h;
+    src->format = AV_PIX_FMT_YUV420P;
+    dst->format = fmt;
+    if (av_frame_get_buffer(src, 0) < 0 || av_frame_get_buffer(dst, 0) < 0) {
+        goto fail;
+    }
+
+    unsigned seed = 12345;
+    for (int y = 0; y < h; y++) {
+        uint8_t *row = src->data[0] + (size_t)y * src->linesize[0];
+        for (int x = 0; x < w; x++) {
+            seed = seed * 1103515245u + 12345u;
+            row[x] = (uint8_t)(16 + (x * 200 / w + y * 19 / h) + ((seed >> 16) & 15));
+        }
+    }
+    int cw = (w + 1) / 2;
+    int ch = (h + 1) / 2;
+    for (int y = 0; y < ch; y++) {
+        uint8_t *u = src->data[1] + (size_t)y * src->linesize[1];
+        uint8_t *v = src->data[2] + (size_t)y * src->linesize[2];
+        for (int x = 0; x < cw; x++) {
+            u[x] = (uint8_t)(64 + x * 128 / cw);
+            v[x] = (uint8_t)(192 - y * 128 / ch);
+        }
+    }
+
+    struct SwsContext *sws = sws_getContext(w, h, AV_PIX_FMT_YUV420P, w, h, fmt, SWS_POINT, NULL, NULL, NULL);
+    if (!sws) {
+        goto fail;
+    }
+    sws_scale(sws, (const uint8_t *const *)src->data, src->linesize, 0, h, dst->data, dst->linesize);
+    sws_freeContext(sws);
+    av_frame_free(&src);
+
+    dst->color_range = AVCOL_RANGE_MPEG;
+    dst->colorspace = AVCOL_SPC_BT709;
+    return dst;
+
+fail:
+    av_frame_free(&src);
+    av_frame_free(&dst);
+    return NULL;
+}
+
+/// Эталон: swscale кадр → RGBA (BT.709 limited → full RGB)
+static int reference_rgba(const AVFrame *frame, uint8_t *dst) {
+    struct SwsContext *sws = sws_getContext(frame->width, frame->height, (enum AVPixelFormat)frame->format,
+                                            frame->width, frame->height, AV_PIX_FMT_RGBA,
+                                            SWS_BILINEAR | SWS_ACCURATE_RND | SWS_FULL_CHR_H_INT,
+                                            NULL, NULL, NULL);
+    if (!sws) {
+        return -1;
+    }
+    const int *coeffs = sws_getCoefficients(SWS_CS_ITU709);
+    sws_setColorspaceDetails(sws, coeffs, 0, coeffs, 1, 0, 1 << 16, 1 << 16);
+    uint8_t *dst_data[4] = { dst, NULL, NULL, NULL };
+    int dst_linesize[4] = { frame->width * 4, 0, 0, 0 };
+    sws_scale(sws, (const uint8_t *const *)frame->data, frame->linesize, 0, frame->height,
+              dst_data, dst_linesize);
+    sws_freeContext(sws);
+    return 0;
+}
+
+/// glReadPixels читает снизу вверх, а quad рисует первую строку кадра сверху
+static void compare(const uint8_t *gpu, const uint8_t *ref, int w, int h, double *mad, int *max_diff) {
+    int64_t sum = 0;
+    int worst = 0;
+    for (int y = 0; y < h; y++) {
+        const uint8_t *g = gpu + (size_t)(h - 1 - y) * w * 4;
+        const uint8_t *r = ref + (size_t)y * w * 4;
+        for (int x = 0; x < w * 4; x++) {
+            if ((x & 3) == 3) {
+                continue;
+            }
+            int d = g[x] - r[x];
+            d = d < 0 ? -d : d;
+            sum += d;
+            worst = d > worst ? d : worst;
+        }
+    }
+    *mad = (double)sum / ((double)w * h * 3.0);
+    *max_diff = worst;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--iters N] [--max-mad X] [--csv]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    int iters = 30;
+    double max_mad = 2.0;
+    int csv = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) {
+            iters = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-mad") == 0 && i + 1 < argc) {
+            max_mad = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (iters < 1 || iters > BENCH_MAX_ITERS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    GlBench gl;
+    if (gl_bench_init(&gl) < 0) {
+        return 1;
+    }
+    fprintf(stderr, "GL: %s / %s\n", (const char *)glGetString(GL_RENDERER), (const char *)glGetString(GL_VERSION));
+
+    double *samples = malloc(sizeof(double) * iters);
+    if (!samples) {
+        return 1;
+    }
+
+    if (csv) {
+        printf("size,format,upload_us,draw_us,mad,max_diff\n");
+    } else {
+        printf("%-10s %-12s %10s %10s %8s %8s\n", "size", "format", "upload", "draw", "MAD", "max");
+    }
+
+    int failed = 0;
+    for (size_t s = 0; s < sizeof(k_sizes) / sizeof(k_sizes[0]); s++) {
+        int w = k_sizes[s].w;
+        int h = k_sizes[s].h;
+        uint8_t *gpu = malloc((size_t)w * h * 4);
+        uint8_t *ref = malloc((size_t)w * h * 4);
+        GLuint fbo = 0;
+        GLuint target = 0;
+        glGenTextures(1, &target);
+        glBindTexture(GL_TEXTURE_2D, target);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+        if (!gpu || !ref || glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            fprintf(stderr, "bench_gl_yuv: %dx%d FBO unavailable\n", w, h);
+            return 1;
+        }
+        glViewport(0, 0, w, h);
+
+        for (size_t f = 0; f < sizeof(k_formats) / sizeof(k_formats[0]); f++) {
+            VrYuvLayout layout = vr_yuv_layout_for_format(k_formats[f]);
+            AVFrame *frame = make_frame(w, h, k_formats[f]);
+            GLuint program = create_program(vr_yuv_fragment_source(layout));
+            if (!frame || !program || reference_rgba(frame, ref) < 0) {
+                fprintf(stderr, "bench_gl_yuv: %s setup failed\n", av_get_pix_fmt_name(k_formats[f]));
+                failed = 1;
+                av_frame_free(&frame);
+                continue;
+            }
+            VrYuvProgram prog;
+            vr_yuv_program_init(&prog, program);
+
+            GLuint tex[VR_YUV_MAX_PLANES];
+            glGenTextures(VR_YUV_MAX_PLANES, tex);
+            for (int i = 0; i < VR_YUV_MAX_PLANES; i++) {
+                glBindTexture(GL_TEXTURE_2D, tex[i]);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            }
+
+            VrYuvUploader uploader;
+            vr_yuv_uploader_init(&uploader);
+            for (int i = 0; i < iters; i++) {
+                int64_t t0 = platform_now_us();
+                vr_yuv_upload_frame(&uploader, layout, tex, frame, w, h, i == 0);
+                glFinish();
+                samples[i] = (double)(platform_now_us() - t0);
+            }
+            double upload_us = median(samples, iters);
+
+            glBindBuffer(GL_ARRAY_BUFFER, gl.vbo);
+            glEnableVertexAttribArray(prog.a_position);
+            glVertexAttribPointer(prog.a_position, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
+            glEnableVertexAttribArray(prog.a_tex_coord);
+            glVertexAttribPointer(prog.a_tex_coord, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                                  (void *)(2 * sizeof(float)));
+            for (int i = 0; i < iters; i++) {
+                int64_t t0 = platform_now_us();
+                vr_yuv_program_use(&prog, layout, tex, 1.0f, 1.0f, 1, 0);
+                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+                glFinish();
+                samples[i] = (double)(platform_now_us() - t0);
+            }
+            double draw_us = median(samples, iters);
+
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, gpu);
+            double mad = 0.0;
+            int max_diff = 0;
+            compare(gpu, ref, w, h, &mad, &max_diff);
+            GLenum err = glGetError();
+            if (mad > max_mad || err != GL_NO_ERROR) {
+                failed = 1;
+            }
+
+            char size_name[32];
+            snprintf(size_name, sizeof(size_name), "%dx%d", w, h);
+            const char *fmt_name = av_get_pix_fmt_name(k_formats[f]);
+            if (csv) {
+                printf("%s,%s,%.1f,%.1f,%.2f,%d\n", size_name, fmt_name, upload_us, draw_us, mad, max_diff);
+            } else {
+                printf("%-10s %-12s %10.1f %10.1f %8.2f %8d%s\n", size_name, fmt_name, upload_us, draw_us,
+                       mad, max_diff, err != GL_NO_ERROR ? "  GL error" : "");
+            }
+
+            vr_yuv_uploader_free(&uploader);
+            glDeleteTextures(VR_YUV_MAX_PLANES, tex);
+            glDeleteProgram(program);
+            av_frame_free(&frame);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteTextures(1, &target);
+        free(gpu);
+        free(ref);
+    }
+
+    free(samples);
+    gl_bench_release(&gl);
+    return failed ? 1 : 0;
+}
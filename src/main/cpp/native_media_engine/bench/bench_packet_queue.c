@@ -0,0 +1,206 @@
+/// 📊 bench_packet_queue: накладные расходы PacketQueue на пакет
+///
+/// Один producer (как demux_thread) и один consumer (как decode thread)
+/// гоняют N пакетов через очередь с теми же лимитами и backpressure,
+/// что и в плеере (packet_queue_set_limits + space_cond).
+///
+/// Собирается дважды из одного исходника:
+///   bench_packet_queue       — linked-list (mutex + cond)
+///   bench_packet_queue_spsc  — lock-free SPSC ring (-DPACKET_QUEUE_SPSC)
+///
+/// Метрики:
+///   - ns/пакет (wall) для всего прогона
+///   - ns/пакет за вычетом базовой стоимости av_packet_ref/unref (сама очередь)
+///   - voluntary context switches (блокировки на mutex/cond/futex)
+///
+/// Использование:
+///   bench_packet_queue [--packets N] [--runs N] [--max-packets N]
+
+#include "packet_queue.h"
+#include "platform_time.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#define BENCH_MAX_RUNS 32
+
+#if defined(PACKET_QUEUE_SPSC)
+#define BENCH_QUEUE_IMPL "spsc-ring"
+#else
+#define BENCH_QUEUE_IMPL "linked-list"
+#endif
+
+typedef struct BenchQueueCtx {
+    PacketQueue q;
+    pthread_mutex_t space_mutex;
+    pthread_cond_t space_cond;
+    const AVPacket *src;
+    long packets;
+    long received;
+} BenchQueueCtx;
+
+/// Producer: put с backpressure, как demux_thread (ждём space_cond, пока очередь полна)
+static void *bench_producer(void *arg) {
+    BenchQueueCtx *b = arg;
+    AVPacket *pkt = av_packet_alloc();
+
+    for (long i = 0; i < b->packets; i++) {
+        if (packet_queue_is_full(&b->q)) {
+            pthread_mutex_lock(&b->space_mutex);
+            while (packet_queue_is_full(&b->q)) {
+                pthread_cond_wait(&b->space_cond, &b->space_mutex);
+            }
+            pthread_mutex_unlock(&b->space_mutex);
+        }
+
+        av_packet_ref(pkt, b->src);
+        pkt->pts = i;
+        if (packet_queue_put(&b->q, pkt, 0) < 0) {
+            break;
+        }
+    }
+
+    av_packet_free(&pkt);
+    return NULL;
+}
+
+/// Consumer: блокирующий get, как decode thread
+static void *bench_consumer(void *arg) {
+    BenchQueueCtx *b = arg;
+    AVPacket *pkt = av_packet_alloc();
+
+    while (b->received < b->packets) {
+        if (packet_queue_get(&b->q, pkt, true, NULL) <= 0) {
+            break;
+        }
+        av_packet_unref(pkt);
+        b->received++;
+    }
+
+    av_packet_free(&pkt);
+    return NULL;
+}
+
+static long voluntary_switches(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_nvcsw;
+}
+
+/// Базовая стоимость ref/unref пакета без очереди (вычитается из результата)
+static double bench_ref_baseline_ns(const AVPacket *src, long packets) {
+    AVPacket *pkt = av_packet_alloc();
+    int64_t start = platform_now_us();
+    for (long i = 0; i < packets; i++) {
+        av_packet_ref(pkt, src);
+        av_packet_unref(pkt);
+    }
+    int64_t elapsed = platform_now_us() - start;
+    av_packet_free(&pkt);
+    return elapsed * 1000.0 / packets;
+}
+
+static int bench_queue_run(const AVPacket *src, long packets, int max_packets,
+                           double *ns_per_pkt, long *switches) {
+    BenchQueueCtx b;
+    memset(&b, 0, sizeof(b));
+    b.src = src;
+    b.packets = packets;
+    pthread_mutex_init(&b.space_mutex, NULL);
+    pthread_cond_init(&b.space_cond, NULL);
+
+    packet_queue_init(&b.q);
+    packet_queue_set_limits(&b.q, 0, max_packets, 0, (AVRational){1, 1000});
+    packet_queue_set_space_notify(&b.q, &b.space_mutex, &b.space_cond);
+
+    long csw_start = voluntary_switches();
+    int64_t start = platform_now_us();
+
+    pthread_t producer, consumer;
+    pthread_create(&consumer, NULL, bench_consumer, &b);
+    pthread_create(&producer, NULL, bench_producer, &b);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    int64_t elapsed = platform_now_us() - start;
+    *switches = voluntary_switches() - csw_start;
+    *ns_per_pkt = elapsed * 1000.0 / packets;
+
+    int ok = b.received == packets;
+    packet_queue_destroy(&b.q);
+    pthread_cond_destroy(&b.space_cond);
+    pthread_mutex_destroy(&b.space_mutex);
+    return ok ? 0 : -1;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--packets N] [--runs N] [--max-packets N]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    long packets = 2000000;
+    int runs = 5;
+    int max_packets = PACKET_QUEUE_DEFAULT_MAX_PACKETS;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--packets") && i + 1 < argc) {
+            packets = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--max-packets") && i + 1 < argc) {
+            max_packets = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (packets < 1 || runs < 1 || runs > BENCH_MAX_RUNS || max_packets < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Типичный размер пакета сжатого видео; содержимое не важно — данные не копируются
+    AVPacket *src = av_packet_alloc();
+    if (!src || av_new_packet(src, 4096) < 0) {
+        fprintf(stderr, "bench_packet_queue: av_new_packet failed\n");
+        return 1;
+    }
+    src->duration = 33;
+
+    double baseline = bench_ref_baseline_ns(src, packets);
+    double ns[BENCH_MAX_RUNS];
+    long csw[BENCH_MAX_RUNS];
+
+    for (int run = 0; run < runs; run++) {
+        if (bench_queue_run(src, packets, max_packets, &ns[run], &csw[run]) < 0) {
+            fprintf(stderr, "bench_packet_queue: run %d lost packets\n", run);
+            av_packet_free(&src);
+            return 1;
+        }
+    }
+
+    long csw_total = 0;
+    for (int run = 0; run < runs; run++) {
+        csw_total += csw[run];
+    }
+    qsort(ns, runs, sizeof(double), cmp_double);
+    double ns_med = ns[runs / 2];
+
+    printf("impl=%s packets=%ld runs=%d max_packets=%d\n",
+           BENCH_QUEUE_IMPL, packets, runs, max_packets);
+    printf("  ns/pkt (median)     %8.1f\n", ns_med);
+    printf("  ns/pkt (min)        %8.1f\n", ns[0]);
+    printf("  ref/unref baseline  %8.1f\n", baseline);
+    printf("  queue ns/pkt        %8.1f\n", ns_med > baseline ? ns_med - baseline : 0.0);
+    printf("  ctx switches/1k pkt %8.2f\n", csw_total * 1000.0 / ((double)packets * runs));
+
+    av_packet_free(&src);
+    return 0;
+}
@@ -0,0 +1,266 @@
+/// 📊 bench_render_wait: точность показа и idle CPU render thread'а без GL
+///
+/// Producer (как decode thread) кладёт кадры в FrameQueue в реальном времени:
+/// кадр i с PTS i / fps появляется за --lead ms до своего deadline'а. Consumer
+/// (как render loop) "показывает" кадр, когда наступил его PTS, и пишет
+/// ошибку показа в VrPresentStats. Затем consumer --idle ms стоит на паузе.
+///
+/// Режимы ожидания consumer'а:
+///   poll  — usleep(--poll-us) между проверками (render loop до VrWaiter)
+///   event — VrWaiter: frame_queue_set_frame_notify + timedwait до deadline'а,
+///           пауза — до vr_waiter_wake
+///
+/// Метрики: средняя / максимальная |ошибка| показа, гистограмма, пробуждения
+/// и CPU-время consumer'а на паузе (CLOCK_THREAD_CPUTIME_ID).
+///
+/// Использование:
+///   bench_render_wait [--frames N] [--fps N] [--lead MS] [--idle MS] [--poll-us N] [--csv]
+
+#include "frame_queue.h"
+#include "video_render_wait.h"
+#include "platform_time.h"
+#include "libavutil/frame.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef enum BenchMode {
+    BENCH_MODE_POLL,
+    BENCH_MODE_EVENT,
+    BENCH_MODE_COUNT
+} BenchMode;
+
+static const char *k_mode_names[BENCH_MODE_COUNT] = { "poll", "event" };
+
+typedef struct BenchConfig {
+    int frames;
+    int fps;
+    int lead_ms;
+    int idle_ms;
+    int poll_us;
+} BenchConfig;
+
+typedef struct BenchCtx {
+    const BenchConfig *cfg;
+    BenchMode mode;
+    FrameQueue fq;
+    VrWaiter waiter;
+    int64_t start_us;      // Монотонное время PTS 0
+    int abort;
+    bool paused;
+
+    VrPresentStats stats;
+    int64_t play_wakeups;
+    int64_t idle_wakeups;
+    int64_t idle_cpu_us;
+} BenchCtx;
+
+static int64_t frame_deadline_us(const BenchCtx *b, double pts) {
+    return b->start_us + (int64_t)(pts * 1000000.0);
+}
+
+/// Спать до монотонного времени (producer, не измеряется)
+static void sleep_until_us(int64_t t_us) {
+    int64_t now = platform_now_us();
+    if (t_us > now) {
+        usleep((useconds_t)(t_us - now));
+    }
+}
+
+static void *bench_producer(void *arg) {
+    BenchCtx *b = arg;
+    AVFrame *frame = av_frame_alloc();
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = 16;
+    frame->height = 16;
+    av_frame_get_buffer(frame, 0);
+
+    for (int i = 0; i < b->cfg->frames && !b->abort; i++) {
+        double pts = (double)i / b->cfg->fps;
+        sleep_until_us(frame_deadline_us(b, pts) - (int64_t)b->cfg->lead_ms * 1000);
+        frame->pts = i;
+        if (frame_queue_push(&b->fq, frame, pts, 0) < 0) {
+            break;
+        }
+    }
+
+    av_frame_free(&frame);
+    return NULL;
+}
+
+static bool bench_queue_ready(void *arg) {
+    return frame_queue_size(arg) > 0;
+}
+
+typedef struct BenchHead {
+    FrameQueue *fq;
+    Frame *head;
+} BenchHead;
+
+static bool bench_head_changed(void *arg) {
+    BenchHead *h = arg;
+    return frame_queue_peek_ptr(h->fq) != h->head;
+}
+
+/// Воспроизведение: показать каждый кадр в его PTS
+static void bench_play(BenchCtx *b) {
+    for (int shown = 0; shown < b->cfg->frames;) {
+        uint64_t seq = vr_waiter_seq(&b->waiter);
+        Frame *f = frame_queue_peek_ptr(&b->fq);
+        if (!f) {
+            b->play_wakeups++;
+            if (b->mode == BENCH_MODE_POLL) {
+                usleep((useconds_t)b->cfg->poll_us);
+            } else {
+                vr_waiter_wait(&b->waiter, seq, bench_queue_ready, &b->fq, 0, &b->abort);
+            }
+            continue;
+        }
+
+        int64_t deadline_us = frame_deadline_us(b, f->pts);
+        if (platform_now_us() < deadline_us) {
+            b->play_wakeups++;
+            if (b->mode == BENCH_MODE_POLL) {
+                usleep((useconds_t)b->cfg->poll_us);
+            } else {
+                BenchHead h = { &b->fq, f };
+                vr_waiter_wait(&b->waiter, seq, bench_head_changed, &h, deadline_us, &b->abort);
+            }
+            continue;
+        }
+
+        vr_present_stats_add(&b->stats, platform_now_us(), deadline_us);
+        frame_queue_next(&b->fq);
+        shown++;
+    }
+}
+
+/// Пауза: нечего показывать до resume (его шлёт main через idle_ms)
+static void bench_idle(BenchCtx *b) {
+    int64_t cpu_start = platform_thread_cpu_us();
+    for (;;) {
+        uint64_t seq = vr_waiter_seq(&b->waiter);
+        if (!__atomic_load_n(&b->paused, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        b->idle_wakeups++;
+        if (b->mode == BENCH_MODE_POLL) {
+            usleep((useconds_t)b->cfg->poll_us);
+        } else {
+            vr_waiter_wait(&b->waiter, seq, NULL, NULL, 0, &b->abort);
+        }
+    }
+    b->idle_cpu_us = platform_thread_cpu_us() - cpu_start;
+}
+
+static void *bench_consumer(void *arg) {
+    BenchCtx *b = arg;
+    bench_play(b);
+    bench_idle(b);
+    return NULL;
+}
+
+static int bench_run(const BenchConfig *cfg, BenchMode mode, BenchCtx *b) {
+    memset(b, 0, sizeof(*b));
+    b->cfg = cfg;
+    b->mode = mode;
+    frame_queue_init(&b->fq, (AVRational){ 1, cfg->fps });
+    if (vr_waiter_init(&b->waiter) < 0) {
+        return -1;
+    }
+    if (mode == BENCH_MODE_EVENT) {
+        frame_queue_set_frame_notify(&b->fq, &b->waiter.mutex, &b->waiter.cond);
+    }
+    b->paused = true;  // Выставлена заранее: consumer уходит в паузу сразу после последнего кадра
+    b->start_us = platform_now_us() + 50000;
+
+    pthread_t producer, consumer;
+    pthread_create(&consumer, NULL, bench_consumer, b);
+    pthread_create(&producer, NULL, bench_producer, b);
+    pthread_join(producer, NULL);
+
+    // Последний кадр + пауза, затем resume
+    sleep_until_us(frame_deadline_us(b, (double)cfg->frames / cfg->fps) + (int64_t)cfg->idle_ms * 1000);
+    __atomic_store_n(&b->paused, false, __ATOMIC_RELEASE);
+    vr_waiter_wake(&b->waiter);
+    pthread_join(consumer, NULL);
+
+    frame_queue_set_frame_notify(&b->fq, NULL, NULL);
+    frame_queue_destroy(&b->fq);
+    vr_waiter_destroy(&b->waiter);
+    return 0;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--frames N] [--fps N] [--lead MS] [--idle MS] [--poll-us N] [--csv]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    BenchConfig cfg = { .frames = 300, .fps = 30, .lead_ms = 10, .idle_ms = 1000, .poll_us = 2000 };
+    bool csv = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            cfg.frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            cfg.fps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--lead") == 0 && i + 1 < argc) {
+            cfg.lead_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--idle") == 0 && i + 1 < argc) {
+            cfg.idle_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--poll-us") == 0 && i + 1 < argc) {
+            cfg.poll_us = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.frames <= 0 || cfg.fps <= 0 || cfg.lead_ms < 0 || cfg.idle_ms < 0 || cfg.poll_us <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (csv) {
+        printf("mode,frames,mean_us,max_us,early,late");
+        for (int i = 0; i < VR_PRESENT_HIST_BUCKETS; i++) {
+            printf(",hist%d", i);
+        }
+        printf(",play_wakeups,idle_wakeups,idle_cpu_us\n");
+    } else {
+        printf("%-6s %7s %9s %9s %8s %8s %11s  %s\n", "mode", "frames", "mean_us", "max_us",
+               "wakeups", "idle_wk", "idle_cpu_us", "|error| <0.25 <0.5 <1 <2 <4 <8 <16 >=16 ms");
+    }
+
+    for (int mode = 0; mode < BENCH_MODE_COUNT; mode++) {
+        BenchCtx b;
+        if (bench_run(&cfg, (BenchMode)mode, &b) < 0) {
+            fprintf(stderr, "bench_render_wait: waiter init failed\n");
+            return 1;
+        }
+        const VrPresentStats *st = &b.stats;
+        double mean_us = st->frames ? (double)st->sum_abs_us / (double)st->frames : 0.0;
+
+        if (csv) {
+            printf("%s,%lld,%.1f,%lld,%lld,%lld", k_mode_names[mode], (long long)st->frames, mean_us,
+                   (long long)st->max_abs_us, (long long)st->early, (long long)st->late);
+            for (int i = 0; i < VR_PRESENT_HIST_BUCKETS; i++) {
+                printf(",%lld", (long long)st->hist[i]);
+            }
+            printf(",%lld,%lld,%lld\n", (long long)b.play_wakeups, (long long)b.idle_wakeups,
+                   (long long)b.idle_cpu_us);
+        } else {
+            printf("%-6s %7lld %9.1f %9lld %8lld %8lld %11lld ", k_mode_names[mode], (long long)st->frames,
+                   mean_us, (long long)st->max_abs_us, (long long)b.play_wakeups, (long long)b.idle_wakeups,
+                   (long long)b.idle_cpu_us);
+            for (int i = 0; i < VR_PRESENT_HIST_BUCKETS; i++) {
+                printf(" %lld", (long long)st->hist[i]);
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,351 @@
+/// 📊 bench_seek: задержка seek → первый кадр после seek
+///
+/// Файл воспроизводится в realtime через null sink'и (platform/linux),
+/// во время воспроизведения выполняется фиксированная (по --seed) серия
+/// fast и exact seek (player_seek, exact=false/true).
+///
+/// Задержка = от вызова player_seek до показа первого кадра >= target
+/// (waiting_first_frame_after_seek сброшен null render loop'ом).
+///
+/// Результаты группируются по (container, vcodec, mode): AVI/FLV без индекса
+/// ведут себя в perform_fast_seek совсем иначе, чем MP4.
+///
+/// --index-cache DIR включает sidecar keyframe-индекс (keyframe_index.h) и ждёт
+/// фоновый индексатор перед seek'ами: все seek'и меряют индексированный путь.
+///
+/// Регрессии: --csv сохраняет baseline, --baseline FILE сравнивает p95 с ним
+/// и завершается с кодом 1, если группа стала медленнее, чем на --tolerance %.
+///
+/// Использование:
+///   bench_seek [--seeks N] [--seed N] [--timeout SEC] [--csv] [--index-cache DIR]
+///              [--baseline FILE] [--tolerance PCT] file...
+///   Корпус: bench/gen_corpus.sh <dir>
+
+#include "player_host.h"
+#include "video_sink_null.h"
+#include "platform_time.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BENCH_MAX_SEEKS 256
+#define BENCH_MAX_GROUPS 64
+
+/// Пауза между seek'ами: даём воспроизведению поработать, как при обычном использовании
+#define BENCH_SEEK_SETTLE_US 200000
+
+/// Абсолютный допуск регрессии p95: шум планировщика на коротких seek'ах
+#define BENCH_REGRESSION_SLACK_MS 20.0
+
+enum { SEEK_MODE_FAST = 0, SEEK_MODE_EXACT = 1, SEEK_MODE_COUNT };
+
+static const char *const k_mode_names[SEEK_MODE_COUNT] = { "fast", "exact" };
+
+/// Латентности одной группы (container, vcodec, mode) по всем файлам
+typedef struct BenchSeekGroup {
+    char container[32];
+    char video_codec[32];
+    int mode;
+    double *lat_ms;
+    int count;
+    int capacity;
+    int timeouts;
+} BenchSeekGroup;
+
+static BenchSeekGroup g_groups[BENCH_MAX_GROUPS];
+static int g_nb_groups;
+
+/// xorshift32: одна и та же последовательность seek'ов на любой платформе
+static uint32_t rng_next(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static BenchSeekGroup *group_get(const char *container, const char *video_codec, int mode) {
+    for (int i = 0; i < g_nb_groups; i++) {
+        BenchSeekGroup *g = &g_groups[i];
+        if (g->mode == mode && !strcmp(g->container, container) && !strcmp(g->video_codec, video_codec)) {
+            return g;
+        }
+    }
+    if (g_nb_groups >= BENCH_MAX_GROUPS) {
+        return NULL;
+    }
+    BenchSeekGroup *g = &g_groups[g_nb_groups++];
+    memset(g, 0, sizeof(*g));
+    snprintf(g->container, sizeof(g->container), "%s", container);
+    snprintf(g->video_codec, sizeof(g->video_codec), "%s", video_codec);
+    g->mode = mode;
+    return g;
+}
+
+static void group_add(BenchSeekGroup *g, double lat_ms) {
+    if (g->count == g->capacity) {
+        int capacity = g->capacity ? g->capacity * 2 : BENCH_MAX_SEEKS;
+        double *lat = realloc(g->lat_ms, capacity * sizeof(double));
+        if (!lat) {
+            return;
+        }
+        g->lat_ms = lat;
+        g->capacity = capacity;
+    }
+    g->lat_ms[g->count++] = lat_ms;
+}
+
+/// Дождаться, пока счётчик завершённых seek станет больше before
+static bool wait_seek_complete(int64_t before, int timeout_ms, VideoSinkNullStats *stats) {
+    int64_t deadline_us = platform_now_us() + (int64_t)timeout_ms * 1000;
+    for (;;) {
+        video_sink_null_get_stats(stats);
+        if (stats->seeks_completed > before) {
+            return true;
+        }
+        if (platform_now_us() >= deadline_us) {
+            return false;
+        }
+        usleep(500);
+    }
+}
+
+/// Дождаться первого показанного кадра после старта
+static bool wait_first_frame(int timeout_ms) {
+    int64_t deadline_us = platform_now_us() + (int64_t)timeout_ms * 1000;
+    VideoSinkNullStats stats;
+    for (;;) {
+        video_sink_null_get_stats(&stats);
+        if (stats.frames_presented > 0) {
+            return true;
+        }
+        if (platform_now_us() >= deadline_us) {
+            return false;
+        }
+        usleep(1000);
+    }
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/// Перцентиль по nearest-rank (v отсортирован)
+static double percentile(const double *v, int n, double p) {
+    int rank = (int)(p / 100.0 * n + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return v[(rank > n ? n : rank) - 1];
+}
+
+/// Серия seek'ов по одному файлу
+///
+/// Последовательность (позиции и fast/exact) зависит только от seed,
+/// поэтому у всех файлов и всех запусков она одинаковая.
+///
+/// @return количество успешно измеренных seek'ов, <0 если файл не открылся
+static int bench_seek_file(const char *path, int seeks, uint32_t seed, int timeout_sec, bool wait_index) {
+    PlayerContext *ctx = player_host_open(path);
+    if (!ctx) {
+        return -1;
+    }
+
+    // Индексатор запущен из open_media; demux применит индекс на первой итерации
+    if (wait_index && ctx->keyframe_index_thread_started) {
+        pthread_join(ctx->keyframeIndexThread, NULL);
+        ctx->keyframe_index_thread_started = 0;
+    }
+
+    // Имя demuxer'а до первой запятой ("mov,mp4,m4a,..." → "mov"): оно же ключ в CSV
+    char container[32];
+    snprintf(container, sizeof(container), "%.*s",
+             (int)strcspn(ctx->fmt->iformat->name, ","), ctx->fmt->iformat->name);
+    const char *video_codec = ctx->video->codecCtx->codec->name;
+    BenchSeekGroup *groups[SEEK_MODE_COUNT];
+    for (int mode = 0; mode < SEEK_MODE_COUNT; mode++) {
+        groups[mode] = group_get(container, video_codec, mode);
+    }
+
+    double duration_sec = get_duration(ctx) / 1000.0;
+    if (!groups[SEEK_MODE_FAST] || !groups[SEEK_MODE_EXACT] || duration_sec <= 1.0 ||
+        player_host_start(ctx, true) < 0 || !wait_first_frame(timeout_sec * 1000)) {
+        player_host_close(ctx);
+        return -1;
+    }
+
+    uint32_t rng = seed ? seed : 1;
+    int measured = 0;
+    for (int i = 0; i < seeks; i++) {
+        uint32_t r = rng_next(&rng);
+        int mode = (r & 1) ? SEEK_MODE_EXACT : SEEK_MODE_FAST;
+        double target = duration_sec * (0.02 + 0.93 * ((r >> 8) / (double)(1u << 24)));
+
+        VideoSinkNullStats stats;
+        video_sink_null_get_stats(&stats);
+        int64_t before = stats.seeks_completed;
+
+        int64_t start_us = platform_now_us();
+        if (player_seek(ctx, target, mode == SEEK_MODE_EXACT) < 0 ||
+            !wait_seek_complete(before, timeout_sec * 1000, &stats)) {
+            groups[mode]->timeouts++;
+            continue;
+        }
+        group_add(groups[mode], (stats.last_seek_complete_us - start_us) / 1000.0);
+        measured++;
+
+        usleep(BENCH_SEEK_SETTLE_US);
+    }
+
+    player_host_close(ctx);
+    return measured;
+}
+
+/// Найти p95 группы в baseline CSV (формат --csv)
+///
+/// @return true если группа есть в baseline
+static bool baseline_p95(const char *baseline, const BenchSeekGroup *g, double *p95) {
+    FILE *f = fopen(baseline, "r");
+    if (!f) {
+        return false;
+    }
+
+    char line[256];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), f)) {
+        char container[32], video_codec[32], mode[16];
+        int count, timeouts;
+        double p50, p95_ms, p99, max;
+        if (sscanf(line, "%31[^,],%31[^,],%15[^,],%d,%lf,%lf,%lf,%lf,%d",
+                   container, video_codec, mode, &count, &p50, &p95_ms, &p99, &max, &timeouts) == 9 &&
+            !strcmp(container, g->container) && !strcmp(video_codec, g->video_codec) &&
+            !strcmp(mode, k_mode_names[g->mode])) {
+            *p95 = p95_ms;
+            found = true;
+        }
+    }
+
+    fclose(f);
+    return found;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--seeks N] [--seed N] [--timeout SEC] [--csv] [--index-cache DIR] "
+                    "[--baseline FILE] [--tolerance PCT] file...\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    int seeks = 40;
+    uint32_t seed = 1;
+    int timeout_sec = 5;
+    int csv = 0;
+    const char *baseline = NULL;
+    const char *index_cache = NULL;
+    double tolerance_pct = 25.0;
+    int first_file = argc;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seeks") == 0 && i + 1 < argc) {
+            seeks = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeout_sec = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else if (strcmp(argv[i], "--index-cache") == 0 && i + 1 < argc) {
+            index_cache = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance_pct = atof(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            first_file = i;
+            break;
+        }
+    }
+    if (first_file >= argc || seeks < 1 || seeks > BENCH_MAX_SEEKS || timeout_sec < 1 || tolerance_pct < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (index_cache) {
+        keyframe_index_set_cache_dir(index_cache);
+    }
+
+    int failures = 0;
+    for (int f = first_file; f < argc; f++) {
+        const char *path = argv[f];
+        if (bench_seek_file(path, seeks, seed, timeout_sec, index_cache != NULL) <= 0) {
+            fprintf(stderr, "bench_seek: %s: failed\n", path);
+            failures++;
+        }
+    }
+
+    if (csv) {
+        printf("container,vcodec,mode,seeks,p50_ms,p95_ms,p99_ms,max_ms,timeouts\n");
+    } else {
+        printf("seed=%u seeks/file=%d\n", seed, seeks);
+        printf("%-10s %-8s %-6s %6s %9s %9s %9s %9s %8s %s\n",
+               "container", "vcodec", "mode", "seeks", "p50 ms", "p95 ms", "p99 ms", "max ms",
+               "timeouts", baseline ? "baseline p95" : "");
+    }
+
+    int regressions = 0;
+    for (int i = 0; i < g_nb_groups; i++) {
+        BenchSeekGroup *g = &g_groups[i];
+        if (g->count == 0 && g->timeouts == 0) {
+            continue;
+        }
+
+        double p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+        if (g->count > 0) {
+            qsort(g->lat_ms, g->count, sizeof(double), cmp_double);
+            p50 = percentile(g->lat_ms, g->count, 50.0);
+            p95 = percentile(g->lat_ms, g->count, 95.0);
+            p99 = percentile(g->lat_ms, g->count, 99.0);
+            max = g->lat_ms[g->count - 1];
+        }
+
+        if (csv) {
+            printf("%s,%s,%s,%d,%.1f,%.1f,%.1f,%.1f,%d\n",
+                   g->container, g->video_codec, k_mode_names[g->mode], g->count,
+                   p50, p95, p99, max, g->timeouts);
+            continue;
+        }
+
+        char verdict[48] = "";
+        double base_p95;
+        if (baseline && baseline_p95(baseline, g, &base_p95)) {
+            bool regressed = g->timeouts > 0 ||
+                             (p95 > base_p95 * (1.0 + tolerance_pct / 100.0) &&
+                              p95 > base_p95 + BENCH_REGRESSION_SLACK_MS);
+            snprintf(verdict, sizeof(verdict), "%.1f %s", base_p95, regressed ? "REGRESSION" : "ok");
+            regressions += regressed;
+        } else if (baseline) {
+            snprintf(verdict, sizeof(verdict), "-");
+        }
+
+        printf("%-10.10s %-8.8s %-6s %6d %9.1f %9.1f %9.1f %9.1f %8d %s\n",
+               g->container, g->video_codec, k_mode_names[g->mode], g->count,
+               p50, p95, p99, max, g->timeouts, verdict);
+    }
+    fflush(stdout);
+
+    for (int i = 0; i < g_nb_groups; i++) {
+        free(g_groups[i].lat_ms);
+    }
+
+    if (regressions) {
+        fprintf(stderr, "bench_seek: %d group(s) regressed vs %s\n", regressions, baseline);
+    }
+    return (failures || regressions) ? 1 : 0;
+}
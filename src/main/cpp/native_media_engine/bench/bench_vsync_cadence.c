@@ -0,0 +1,519 @@
+/// 📊 bench_vsync_cadence: каденс показа кадров на дисплее 60/90/120 Hz без устройства
+///
+/// Кадр i контента fps должен быть на экране в due_i = start + i / fps
+/// (deadline от master clock с шумом --clock-jitter-us). Draw + swap занимает
+/// --cost-us ± --cost-jitter-us. Модель дисплея — очередь swap'а с
+/// eglSwapInterval(1): кадр выходит на первом vsync после swap'а, но не раньше
+/// vsync'а после предыдущего кадра (FIFO, кадры не теряются).
+///
+/// Режимы:
+///   deadline — рисовать, когда наступил deadline (render loop до VideoScheduler)
+///   vsync    — VideoScheduler: vsync выбирается до рисования
+///
+/// Метрики (по фактическим vsync'ам показа):
+///   off — кадр вышел не на ближайшем к точному due vsync'е (допуск
+///         BENCH_TIE_US: посередине между vsync'ами годится любой из двух) —
+///         сбой каденса, 24 fps на 60 Hz вместо 3:2:3:2 даёт 3:3:1:2...;
+///   late — из них позже due;
+///   |error| — vsync показа относительно точного due, гистограмма VrPresentStats;
+///   pattern — первые vsync'и на кадр.
+///
+/// По умолчанию время виртуальное (детерминированно, матрица 23.976..60 fps ×
+/// 60/90/120 Hz): VsyncClock получает tick на каждый vsync модели дисплея.
+/// --realtime — настоящие ожидания и vsync от симулированного дисплея
+/// (platform/linux/vsync_source_sim.c).
+///
+/// Смена частоты дисплея (--switch-hz, и отдельная таблица в прогоне по умолчанию):
+/// посередине прогона дисплей переходит на другую частоту, а VsyncClock узнаёт
+/// о ней только по интервалам между tick'ами (как без refresh rate callback'а
+/// на API < 30). relearn — через сколько после смены период в VsyncClock совпал
+/// с новым.
+///
+/// Использование:
+///   bench_vsync_cadence [--fps F] [--hz N] [--switch-hz N] [--seconds S] [--cost-us N]
+///                       [--cost-jitter-us N] [--clock-jitter-us N] [--phase-us N] [--seed N]
+///                       [--realtime] [--csv]
+
+#include "video_scheduler.h"
+#include "video_render_wait.h"
+#include "vsync_source.h"
+#include "platform_time.h"
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_PATTERN_FRAMES 16
+/// Допуск к половине периода при проверке "ближайший vsync"
+#define BENCH_TIE_US 1000
+/// Начало виртуального времени (vsync'и с нулевым timestamp VsyncClock не примет)
+#define BENCH_VIRTUAL_ORIGIN_US 1000000
+
+typedef enum BenchMode {
+    BENCH_MODE_DEADLINE,
+    BENCH_MODE_VSYNC,
+    BENCH_MODE_COUNT
+} BenchMode;
+
+static const char *k_mode_names[BENCH_MODE_COUNT] = { "deadline", "vsync" };
+
+static const double k_matrix_fps[] = { 23.976, 24.0, 25.0, 30.0, 50.0, 60.0 };
+static const int k_matrix_hz[] = { 60, 90, 120 };
+
+/// Смена частоты дисплея: {fps, hz, switch_hz}
+static const struct {
+    double fps;
+    int hz;
+    int switch_hz;
+} k_switch_cases[] = {
+    { 24.0, 120, 60 }, { 24.0, 90, 60 }, { 24.0, 60, 90 }, { 24.0, 60, 120 },
+    { 30.0, 120, 60 }, { 30.0, 90, 60 }, { 30.0, 60, 90 }, { 30.0, 60, 120 },
+};
+
+typedef struct BenchConfig {
+    double fps;             // <= 0 — матрица
+    int hz;                 // <= 0 — матрица
+    int switch_hz;          // > 0 — посередине прогона дисплей переходит на эту частоту
+    double seconds;         // < 0 — по умолчанию для режима времени
+    int cost_us;
+    int cost_jitter_us;
+    int clock_jitter_us;
+    int phase_us;           // Сдвиг due первого кадра от vsync'а, < 0 — четверть периода
+    unsigned seed;
+    bool realtime;
+} BenchConfig;
+
+/// Модель дисплея: сетка vsync'ов с periods[0], с switch_us — с periods[1]
+typedef struct BenchDisplay {
+    int64_t origin_us;
+    int64_t period_us[2];
+    int64_t switch_us;      // 0 — частота не меняется; vsync сетки periods[0]
+} BenchDisplay;
+
+/// Время бенча: виртуальное (сдвигается ожиданиями и draw'ом) или настоящее
+typedef struct BenchTime {
+    bool realtime;
+    int64_t now_us;         // Виртуальное
+    BenchDisplay display;   // Виртуальный дисплей
+    int64_t next_tick_us;   // Виртуальный: следующий vsync для VsyncClock
+    VsyncClock clock;       // Realtime: тикает vsync_source_sim
+    VsyncSource *source;
+} BenchTime;
+
+typedef struct BenchResult {
+    int frames;
+    int shown;
+    int dropped;
+    int off_cadence;
+    int late;
+    int64_t missed;         // Только vsync: swap позже target
+    int64_t relearn_us;     // Смена частоты: период в VsyncClock совпал с новым (-1 — нет)
+    VrPresentStats error;
+    int64_t cadence[VS_CADENCE_BUCKETS];
+    char pattern[BENCH_PATTERN_FRAMES + 1];
+} BenchResult;
+
+static uint32_t g_rand_state = 1;
+
+/// xorshift32: одинаковая последовательность для обоих режимов
+static uint32_t bench_rand(void) {
+    uint32_t x = g_rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rand_state = x;
+    return x;
+}
+
+/// Равномерно в [-range, +range]
+static int64_t bench_jitter(int range) {
+    if (range <= 0) {
+        return 0;
+    }
+    return (int64_t)(bench_rand() % (uint32_t)(2 * range + 1)) - range;
+}
+
+static int64_t hz_period_us(int hz) {
+    return (1000000 + hz / 2) / hz;
+}
+
+/// Первый vsync дисплея >= t_us
+static int64_t display_next(const BenchDisplay *d, int64_t t_us) {
+    VsyncTiming vt = { .last_vsync_us = d->origin_us, .period_us = d->period_us[0] };
+    int64_t v = vsync_timing_next(&vt, t_us);
+    if (d->switch_us <= 0 || v <= d->switch_us) {
+        return v;
+    }
+    vt.last_vsync_us = d->switch_us;
+    vt.period_us = d->period_us[1];
+    return vsync_timing_next(&vt, t_us);
+}
+
+static int64_t display_period_at(const BenchDisplay *d, int64_t t_us) {
+    return d->switch_us > 0 && t_us >= d->switch_us ? d->period_us[1] : d->period_us[0];
+}
+
+static int64_t bt_now(BenchTime *t) {
+    return t->realtime ? platform_now_us() : t->now_us;
+}
+
+static void bt_sleep_until(BenchTime *t, int64_t t_us) {
+    if (!t->realtime) {
+        if (t_us > t->now_us) {
+            t->now_us = t_us;
+        }
+        return;
+    }
+    struct timespec ts = {
+        .tv_sec = (time_t)(t_us / 1000000),
+        .tv_nsec = (long)(t_us % 1000000) * 1000,
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+static bool bt_timing(BenchTime *t, VsyncTiming *vt) {
+    if (!t->realtime) {
+        // Vsync'и модели дисплея, прошедшие к now, — как callback'и источника
+        while (t->next_tick_us <= t->now_us) {
+            vsync_clock_tick(&t->clock, t->next_tick_us);
+            t->next_tick_us = display_next(&t->display, t->next_tick_us + 1);
+        }
+    }
+    return vsync_clock_get(&t->clock, bt_now(t), vt);
+}
+
+static int bt_start(BenchTime *t, bool realtime, int hz) {
+    memset(t, 0, sizeof(*t));
+    t->realtime = realtime;
+    if (vsync_clock_init(&t->clock) < 0) {
+        return -1;
+    }
+    if (!realtime) {
+        t->now_us = BENCH_VIRTUAL_ORIGIN_US;
+        t->display.origin_us = BENCH_VIRTUAL_ORIGIN_US;
+        t->display.period_us[0] = hz_period_us(hz);
+        t->next_tick_us = BENCH_VIRTUAL_ORIGIN_US;
+        // Частота от источника при старте, как vsync_source_sim
+        vsync_clock_set_period(&t->clock, t->display.period_us[0]);
+        return 0;
+    }
+    t->source = vsync_source_start(&t->clock, hz);
+    if (!t->source) {
+        vsync_clock_destroy(&t->clock);
+        return -1;
+    }
+    // Несколько vsync'ов, чтобы VsyncClock оценил период
+    bt_sleep_until(t, platform_now_us() + 100000);
+    VsyncTiming vt;
+    return bt_timing(t, &vt) ? 0 : -1;
+}
+
+static void bt_stop(BenchTime *t) {
+    if (t->realtime) {
+        vsync_source_stop(t->source);
+    }
+    vsync_clock_destroy(&t->clock);
+}
+
+/// Кадры, которые отдаются в swap: submit_us[i] — момент окончания swap'а (0 — дропнут)
+static void bench_present_loop(BenchTime *t, const BenchConfig *cfg, BenchMode mode, const int64_t *due,
+                               int frames, int64_t *submit_us, BenchResult *r) {
+    VideoScheduler sched;
+    video_scheduler_init(&sched);
+
+    for (int i = 0; i < frames;) {
+        int64_t now = bt_now(t);
+        int64_t due1 = i + 1 < frames ? due[i + 1] : 0;
+
+        if (mode == BENCH_MODE_DEADLINE) {
+            if (due1 > 0 && now >= due1) {
+                i++;  // Следующий кадр уже наступил: текущий дропается
+                continue;
+            }
+            if (due[i] - now > 500) {
+                bt_sleep_until(t, due[i]);
+                continue;
+            }
+            bt_sleep_until(t, now + cfg->cost_us + bench_jitter(cfg->cost_jitter_us));
+            submit_us[i++] = bt_now(t);
+            continue;
+        }
+
+        VsyncTiming vt;
+        bool have_vsync = bt_timing(t, &vt);
+        const BenchDisplay *d = &t->display;
+        if (have_vsync && d->switch_us > 0 && now >= d->switch_us && r->relearn_us < 0 &&
+            vt.period_us - d->period_us[1] <= d->period_us[1] / 16 &&
+            d->period_us[1] - vt.period_us <= d->period_us[1] / 16) {
+            r->relearn_us = now - d->switch_us;
+        }
+        VsPlan plan;
+        switch (video_scheduler_plan(&sched, have_vsync ? &vt : NULL, now, due[i], due1, false, &plan)) {
+        case VS_NEXT:
+            i++;
+            break;
+        case VS_WAIT:
+            bt_sleep_until(t, plan.wake_at_us);
+            break;
+        case VS_PRESENT:
+            bt_sleep_until(t, now + cfg->cost_us + bench_jitter(cfg->cost_jitter_us));
+            submit_us[i] = bt_now(t);
+            video_scheduler_on_present(&sched, &plan, true, now, submit_us[i]);
+            i++;
+            break;
+        }
+    }
+    r->missed = sched.stats.missed;
+}
+
+/// Модель дисплея и метрики каденса
+static void bench_measure(const BenchDisplay *d, const int64_t *due_exact, const int64_t *submit_us,
+                          int frames, BenchResult *r) {
+    int64_t prev_shown_us = 0;
+    int pattern_len = 0;
+
+    for (int i = 0; i < frames; i++) {
+        if (submit_us[i] <= 0) {
+            r->dropped++;
+            continue;
+        }
+        int64_t shown_us = display_next(d, submit_us[i]);
+        if (prev_shown_us > 0 && shown_us <= prev_shown_us) {
+            shown_us = display_next(d, prev_shown_us + 1);  // FIFO: один кадр на vsync
+        }
+        int64_t period = display_period_at(d, shown_us);
+
+        r->shown++;
+        vr_present_stats_add(&r->error, shown_us, due_exact[i]);
+        int64_t error_us = shown_us - due_exact[i];
+        if (error_us > period / 2 + BENCH_TIE_US || error_us < -(period / 2 + BENCH_TIE_US)) {
+            r->off_cadence++;
+            if (error_us > 0) {
+                r->late++;
+            }
+        }
+        if (prev_shown_us > 0) {
+            int64_t held = (shown_us - prev_shown_us + period / 2) / period;
+            if (held >= 1) {
+                r->cadence[(held < VS_CADENCE_BUCKETS ? held : VS_CADENCE_BUCKETS) - 1]++;
+            }
+            if (pattern_len < BENCH_PATTERN_FRAMES) {
+                r->pattern[pattern_len++] = held < 10 ? (char)('0' + held) : '+';
+            }
+        }
+        prev_shown_us = shown_us;
+    }
+    r->pattern[pattern_len] = '\0';
+}
+
+static int bench_run(const BenchConfig *cfg, double fps, int hz, int switch_hz, BenchMode mode,
+                     BenchResult *r) {
+    memset(r, 0, sizeof(*r));
+    r->relearn_us = -1;
+    BenchTime t;
+    if (bt_start(&t, cfg->realtime, hz) < 0) {
+        return -1;
+    }
+
+    double seconds = cfg->seconds >= 0 ? cfg->seconds : (cfg->realtime ? 2.0 : 60.0);
+    int frames = (int)(seconds * fps);
+    if (frames < 2) {
+        frames = 2;
+    }
+    int64_t *due_exact = calloc((size_t)frames, sizeof(int64_t));
+    int64_t *due = calloc((size_t)frames, sizeof(int64_t));
+    int64_t *submit_us = calloc((size_t)frames, sizeof(int64_t));
+    if (!due_exact || !due || !submit_us) {
+        free(due_exact);
+        free(due);
+        free(submit_us);
+        bt_stop(&t);
+        return -1;
+    }
+
+    // Первый кадр — через пару vsync'ов после старта, со сдвигом фазы
+    VsyncTiming vt;
+    bt_timing(&t, &vt);
+    if (!cfg->realtime && switch_hz > 0) {
+        // Смена частоты посередине прогона, на vsync'е старой сетки
+        t.display.period_us[1] = hz_period_us(switch_hz);
+        t.display.switch_us = display_next(&t.display, bt_now(&t) + (int64_t)(seconds * 500000.0));
+    }
+    int64_t phase_us = cfg->phase_us >= 0 ? cfg->phase_us : vt.period_us / 4;
+    int64_t start_us = vsync_timing_next(&vt, bt_now(&t) + 2 * vt.period_us) + phase_us;
+
+    g_rand_state = cfg->seed ? cfg->seed : 1;
+    for (int i = 0; i < frames; i++) {
+        due_exact[i] = start_us + llround((double)i * 1000000.0 / fps);
+        due[i] = due_exact[i] + bench_jitter(cfg->clock_jitter_us);
+    }
+
+    r->frames = frames;
+    bench_present_loop(&t, cfg, mode, due, frames, submit_us, r);
+
+    // Realtime: фаза и период — от симулированного дисплея на момент замера
+    if (cfg->realtime) {
+        bt_timing(&t, &vt);
+        t.display.origin_us = vt.last_vsync_us;
+        t.display.period_us[0] = vt.period_us;
+    }
+    bench_measure(&t.display, due_exact, submit_us, frames, r);
+
+    free(due_exact);
+    free(due);
+    free(submit_us);
+    bt_stop(&t);
+    return 0;
+}
+
+static void print_header(bool csv) {
+    if (csv) {
+        printf("fps,hz,switch_hz,mode,frames,shown,dropped,off_cadence,late,missed,mean_err_ms,max_err_ms,"
+               "relearn_ms");
+        for (int i = 0; i < VS_CADENCE_BUCKETS; i++) {
+            printf(",held%d", i + 1);
+        }
+        printf(",pattern\n");
+        return;
+    }
+    printf("%7s %7s %-8s %6s %5s %5s %5s %6s %8s %8s %8s  %s  %s\n", "fps", "hz", "mode", "frames", "drop",
+           "off", "late", "missed", "mean_ms", "max_ms", "relearn", "vsyncs/frame[1 2 3 4 5 >=6]", "pattern");
+}
+
+static void print_result(bool csv, double fps, int hz, int switch_hz, BenchMode mode, const BenchResult *r) {
+    const VrPresentStats *e = &r->error;
+    double mean_ms = e->frames ? (double)e->sum_abs_us / (double)e->frames / 1000.0 : 0.0;
+    double relearn_ms = r->relearn_us >= 0 ? (double)r->relearn_us / 1000.0 : -1.0;
+
+    if (csv) {
+        printf("%.3f,%d,%d,%s,%d,%d,%d,%d,%d,%lld,%.3f,%.3f,%.3f", fps, hz, switch_hz, k_mode_names[mode],
+               r->frames, r->shown, r->dropped, r->off_cadence, r->late, (long long)r->missed, mean_ms,
+               (double)e->max_abs_us / 1000.0, relearn_ms);
+        for (int i = 0; i < VS_CADENCE_BUCKETS; i++) {
+            printf(",%lld", (long long)r->cadence[i]);
+        }
+        printf(",%s\n", r->pattern);
+        return;
+    }
+    char hz_str[16];
+    char relearn_str[16];
+    if (switch_hz > 0) {
+        snprintf(hz_str, sizeof(hz_str), "%d>%d", hz, switch_hz);
+    } else {
+        snprintf(hz_str, sizeof(hz_str), "%d", hz);
+    }
+    if (relearn_ms >= 0.0) {
+        snprintf(relearn_str, sizeof(relearn_str), "%.1fms", relearn_ms);
+    } else {
+        snprintf(relearn_str, sizeof(relearn_str), "-");
+    }
+    printf("%7.3f %7s %-8s %6d %5d %5d %5d %6lld %8.2f %8.2f %8s  ", fps, hz_str, k_mode_names[mode],
+           r->frames, r->dropped, r->off_cadence, r->late, (long long)r->missed, mean_ms,
+           (double)e->max_abs_us / 1000.0, relearn_str);
+    for (int i = 0; i < VS_CADENCE_BUCKETS; i++) {
+        printf(" %lld", (long long)r->cadence[i]);
+    }
+    printf("  %s\n", r->pattern);
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--fps F] [--hz N] [--switch-hz N] [--seconds S] [--cost-us N]\n"
+            "          [--cost-jitter-us N] [--clock-jitter-us N] [--phase-us N] [--seed N]\n"
+            "          [--realtime] [--csv]\n",
+            argv0);
+}
+
+/// Оба режима для одного fps / частоты
+static int run_case(const BenchConfig *cfg, bool csv, double fps, int hz, int switch_hz) {
+    for (int mode = 0; mode < BENCH_MODE_COUNT; mode++) {
+        BenchResult r;
+        if (bench_run(cfg, fps, hz, switch_hz, (BenchMode)mode, &r) < 0) {
+            fprintf(stderr, "bench_vsync_cadence: run failed (fps=%.3f hz=%d)\n", fps, hz);
+            return -1;
+        }
+        print_result(csv, fps, hz, switch_hz, (BenchMode)mode, &r);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    BenchConfig cfg = {
+        .fps = 0.0, .hz = 0, .seconds = -1.0, .cost_us = 3000, .cost_jitter_us = 2000,
+        .clock_jitter_us = 500, .phase_us = -1, .seed = 1, .realtime = false,
+    };
+    bool csv = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            cfg.fps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc) {
+            cfg.hz = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--switch-hz") == 0 && i + 1 < argc) {
+            cfg.switch_hz = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            cfg.seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--cost-us") == 0 && i + 1 < argc) {
+            cfg.cost_us = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cost-jitter-us") == 0 && i + 1 < argc) {
+            cfg.cost_jitter_us = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--clock-jitter-us") == 0 && i + 1 < argc) {
+            cfg.clock_jitter_us = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--phase-us") == 0 && i + 1 < argc) {
+            cfg.phase_us = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            cfg.seed = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--realtime") == 0) {
+            cfg.realtime = true;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.cost_us < 0 || cfg.cost_jitter_us < 0 || cfg.cost_jitter_us > cfg.cost_us ||
+        cfg.clock_jitter_us < 0 || (cfg.switch_hz > 0 && cfg.realtime)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const double *fps_list = k_matrix_fps;
+    int fps_count = (int)(sizeof(k_matrix_fps) / sizeof(k_matrix_fps[0]));
+    const int *hz_list = k_matrix_hz;
+    int hz_count = (int)(sizeof(k_matrix_hz) / sizeof(k_matrix_hz[0]));
+    if (cfg.fps > 0.0) {
+        fps_list = &cfg.fps;
+        fps_count = 1;
+    }
+    if (cfg.hz > 0) {
+        hz_list = &cfg.hz;
+        hz_count = 1;
+    }
+
+    print_header(csv);
+    for (int h = 0; h < hz_count; h++) {
+        for (int f = 0; f < fps_count; f++) {
+            if (run_case(&cfg, csv, fps_list[f], hz_list[h], cfg.switch_hz) < 0) {
+                return 1;
+            }
+        }
+    }
+
+    // Прогон по умолчанию: ещё смена частоты дисплея
+    if (cfg.fps <= 0.0 && cfg.hz <= 0 && cfg.switch_hz <= 0 && !cfg.realtime) {
+        if (!csv) {
+            printf("\n");
+            print_header(csv);
+        }
+        for (size_t i = 0; i < sizeof(k_switch_cases) / sizeof(k_switch_cases[0]); i++) {
+            if (run_case(&cfg, csv, k_switch_cases[i].fps, k_switch_cases[i].hz, k_switch_cases[i].switch_hz) < 0) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#!/bin/bash
+# Генерация корпуса для bench_decode / bench_* (синтетика, без внешних файлов).
+#
+# Использование: gen_corpus.sh <out_dir> [duration_sec]
+# FFMPEG=/path/to/ffmpeg — бинарь, собранный build_ffmpeg.sh (по умолчанию ffmpeg из PATH).
+
+set -e
+
+OUT_DIR="${1:?usage: gen_corpus.sh <out_dir> [duration_sec]}"
+DURATION="${2:-20}"
+FFMPEG="${FFMPEG:-ffmpeg}"
+
+mkdir -p "$OUT_DIR"
+
+VIDEO_SRC="testsrc2=size=1280x720:rate=30:duration=${DURATION}"
+AUDIO_SRC="sine=frequency=440:sample_rate=48000:duration=${DURATION}"
+GOP=60
+
+gen() {
+    local name="$1"; shift
+    echo "▶ $name"
+    "$FFMPEG" -hide_banner -loglevel error -y \
+        -f lavfi -i "$VIDEO_SRC" -f lavfi -i "$AUDIO_SRC" \
+        -g "$GOP" -pix_fmt yuv420p -shortest "$@" "$OUT_DIR/$name"
+}
+
+gen h264_aac.mp4        -c:v libx264 -preset veryfast -c:a aac
+gen hevc_aac.mp4        -c:v libx265 -preset veryfast -tag:v hvc1 -c:a aac
+gen mpeg4_aac.mp4       -c:v mpeg4 -q:v 4 -c:a aac
+gen mpeg4_mp3.avi       -c:v mpeg4 -q:v 4 -vtag xvid -c:a libmp3lame
+gen h264_aac.flv        -c:v libx264 -preset veryfast -c:a aac
+gen h264_aac.ts         -c:v libx264 -preset veryfast -c:a aac
+gen h264_opus.mkv       -c:v libx264 -preset veryfast -c:a libopus
+gen h264_aac_bframes.mkv -c:v libx264 -preset medium -bf 3 -c:a aac
+
+# 4K HEVC: software decode упирается в потоки декодера (bench_decode --threads)
+VIDEO_SRC="testsrc2=size=3840x2160:rate=30:duration=${DURATION}"
+gen hevc_4k_aac.mp4     -c:v libx265 -preset ultrafast -tag:v hvc1 -c:a aac
+
+echo "✅ Corpus ready: $OUT_DIR"
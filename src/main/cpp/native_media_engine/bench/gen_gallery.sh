@@ -0,0 +1,38 @@
+#!/bin/bash
+# Корпус для bench_batch: много коротких клипов, как в папке галереи.
+#
+# Использование: gen_gallery.sh <out_dir> [count] [duration_sec]
+# FFMPEG=/path/to/ffmpeg — бинарь, собранный build_ffmpeg.sh (по умолчанию ffmpeg из PATH).
+
+set -e
+
+OUT_DIR="${1:?usage: gen_gallery.sh <out_dir> [count] [duration_sec]}"
+COUNT="${2:-64}"
+DURATION="${3:-6}"
+FFMPEG="${FFMPEG:-ffmpeg}"
+
+mkdir -p "$OUT_DIR"
+
+# Вариант клипа: "<размер> <расширение> <аргументы кодека>" — по кругу
+VARIANTS=(
+    "1280x720 mp4 -c:v libx264 -preset veryfast"
+    "1920x1080 mp4 -c:v libx264 -preset veryfast"
+    "1920x1080 mp4 -c:v libx265 -preset ultrafast -tag:v hvc1"
+    "640x360 avi -c:v mpeg4 -q:v 4 -vtag xvid"
+    "1280x720 mkv -c:v libx264 -preset veryfast -bf 3"
+    "1280x720 mov -c:v mjpeg -q:v 5"
+    "3840x2160 mp4 -c:v libx265 -preset ultrafast -tag:v hvc1"
+)
+
+for ((i = 0; i < COUNT; i++)); do
+    read -r size ext codec <<< "${VARIANTS[i % ${#VARIANTS[@]}]}"
+    name=$(printf "clip_%03d.%s" "$i" "$ext")
+    # Разный offset testsrc2 → разные кадры (probe / decode не кэшируются между файлами)
+    "$FFMPEG" -hide_banner -loglevel error -y \
+        -f lavfi -i "testsrc2=size=${size}:rate=30:duration=${DURATION},hue=h=$((i * 37 % 360))" \
+        -f lavfi -i "sine=frequency=$((220 + i * 10)):sample_rate=48000:duration=${DURATION}" \
+        -g 60 -pix_fmt yuv420p -shortest $codec -c:a aac "$OUT_DIR/$name"
+    echo "▶ $name ($size)"
+done
+
+echo "✅ Gallery corpus ready: $OUT_DIR ($COUNT clips)"
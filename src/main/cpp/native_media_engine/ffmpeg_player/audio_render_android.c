@@ -26,6 +26,11 @@ bool audio_render_init(AudioRenderAndroid *ar,
                        int channels) {
     memset(ar, 0, sizeof(*ar));
     
+    if (!jvm) {
+        LOGE("audio_render_init: JavaVM is NULL");
+        return false;
+    }
+    
     ar->jvm = jvm;
     ar->sample_rate = sample_rate;
     ar->channels = channels;
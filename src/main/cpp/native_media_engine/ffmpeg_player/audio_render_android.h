@@ -1,6 +1,6 @@
 #pragma once
 
-#include <jni.h>
+#include "platform_jni.h"  // JavaVM / jobject (непрозрачные типы на host)
 #include <stdint.h>
 #include <stdbool.h>
 
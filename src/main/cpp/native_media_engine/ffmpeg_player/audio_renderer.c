@@ -6,13 +6,12 @@
 #include "libavutil/frame.h"  // для frame->best_effort_timestamp
 #include "libavutil/rational.h"  // для av_q2d
 #include "libavutil/time.h"  // для av_gettime
-#include <jni.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <unistd.h>
 #include <stdbool.h>
-#include <android/log.h>
+#include "platform_log.h"
 #undef pause  // Убираем конфликт с системной функцией pause() из unistd.h
 
 #define LOG_TAG "AudioRenderer"
@@ -366,9 +365,13 @@ static void *audio_decode_thread(void *arg) {
         return NULL;
     }
     
+    // Эпоха, пакеты которой сейчас в декодере
+    int decoder_serial = ctx ? atomic_load(&ctx->seek_serial) : 0;
+    
     while (!as->abort) {
         // Извлекаем пакет из очереди (блокирующий)
-        int ret = packet_queue_get(as->packetQueue, &pkt, true);
+        int pkt_serial = 0;
+        int ret = packet_queue_get(as->packetQueue, &pkt, true, &pkt_serial);
         if (ret <= 0) {
             // EOF или abort (Шаг 22)
             // Помечаем audio как завершённый
@@ -382,16 +385,19 @@ static void *audio_decode_thread(void *arg) {
         }
         
         // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 10.4: Фильтрация старых эпох
-        // Если пакет из старой эпохи (serial не совпадает), дропаем его
-        // Это предотвращает декодирование старых пакетов после seek
+        // Дропаем только пакеты старой эпохи (по serial пакета). Пакеты новой эпохи
+        // декодируются сразу; до firstFrameAfterSeek кадры глушатся ниже (ШАГ 6.7)
         if (ctx) {
-            int current_serial = atomic_load(&ctx->seek_serial);
-            // Пакеты не имеют serial, но мы проверяем seek.in_progress
-            // Если seek в процессе, дропаем пакеты до тех пор, пока не найдём первый >= target
-            if (ctx->seek.in_progress && ctx->seek.drop_audio) {
+            if (pkt_serial != atomic_load(&ctx->seek_serial)) {
                 av_packet_unref(&pkt);
                 continue;  // Дропаем пакет из старой эпохи
             }
+            
+            if (pkt_serial != decoder_serial) {
+                // Первый пакет новой эпохи: сбрасываем декодер в СВОЁМ потоке
+                avcodec_flush_buffers(as->codecCtx);
+                decoder_serial = pkt_serial;
+            }
         }
         
         // Отправляем пакет в декодер
@@ -401,6 +407,7 @@ static void *audio_decode_thread(void *arg) {
         }
         
         av_packet_unref(&pkt);
+        as->packets_decoded++;
         
         // Получаем декодированные кадры
         while (!as->abort) {
@@ -414,6 +421,8 @@ static void *audio_decode_thread(void *arg) {
                 goto end;
             }
             
+            as->frames_decoded++;
+            
             // 🔄 Resample
             // Вычисляем количество выходных сэмплов
             int out_samples = av_rescale_rnd(
@@ -525,11 +534,8 @@ static void *audio_decode_thread(void *arg) {
             }
             
             // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 10.5: Передаём serial эпохи
-            // Получаем текущий seek_serial из PlayerContext
-            int current_serial = 0;
-            if (ctx) {
-                current_serial = atomic_load(&ctx->seek_serial);
-            }
+            // (эпоха пакетов в декодере, а не текущий seek_serial)
+            int current_serial = decoder_serial;
             
             // Добавляем кадр в очередь (клонируется внутри) с serial эпохи
             if (frame_queue_push(as->frameQueue, out, pts, current_serial) < 0) {
@@ -726,7 +732,8 @@ int audio_swr_init(AudioState *as) {
 }
 
 int audio_threads_start(AudioState *as, JavaVM *jvm) {
-    if (!as || !jvm) {
+    // jvm проверяется в audio_render_init (Android); host null-sink работает без JVM
+    if (!as) {
         ALOGE("❌ audio_threads_start: Invalid parameters");
         return -1;
     }
@@ -167,6 +167,11 @@ typedef struct {
     double clock_base_time_sec;  // DEPRECATED
     int clock_valid;  // DEPRECATED: используйте clock.valid
     int track_failed;  // DEPRECATED: используйте clock.stalled
+    
+    /// Счётчики decode thread (bench_decode, диагностика)
+    /// Пишутся только decode thread, читаются снаружи без блокировки
+    int64_t packets_decoded;  // Пакетов отправлено в avcodec_send_packet
+    int64_t frames_decoded;   // Кадров получено из avcodec_receive_frame
 } AudioState;
 
 /// Инициализировать аудио декодер
@@ -10,7 +10,7 @@
 #include "avsync_gate.h"
 #include "libavutil/time.h"  // для av_gettime
 #include <math.h>
-#include <android/log.h>
+#include "platform_log.h"
 
 #define LOG_TAG "AVSync"
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
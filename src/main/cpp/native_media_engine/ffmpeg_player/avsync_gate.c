@@ -1,7 +1,7 @@
 #include "avsync_gate.h"
 #include <string.h>
 #include <sys/time.h>
-#include <android/log.h>
+#include "platform_log.h"
 
 #define LOG_TAG "AVSyncGate"
 #define ALOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
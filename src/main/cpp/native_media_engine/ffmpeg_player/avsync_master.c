@@ -4,7 +4,7 @@
 #include "audio_renderer.h"
 #include "avsync_gate.h"  // для avsync_gate_is_open
 #include <math.h>
-#include <android/log.h>
+#include "platform_log.h"
 #include <sys/time.h>
 
 #define LOG_TAG "AvSyncMaster"
@@ -1,13 +1,11 @@
 #include "clock.h"
-#include <time.h>
+#include "platform_time.h"
 #include <string.h>
 #include <math.h>  // Для NAN
 
 /// Получить текущее время (monotonic clock, секунды)
 static double now_sec() {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec / 1e9;
+    return platform_now_sec();
 }
 
 void clock_init(Clock *c) {
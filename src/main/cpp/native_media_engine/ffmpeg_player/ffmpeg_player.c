@@ -4,20 +4,19 @@
 #include "clock.h"
 #include "audio_renderer.h"
 #include "video_renderer.h"
-#include "video_render_gl.h"  // 🔴 ЭТАЛОН: Для video_render_gl_clear при seek
-#include "ffmpeg_player_lifecycle.h"  // 🔴 ЗАДАЧА 4: Lifecycle management
-#include "native_player_jni.h"  // 🔒 FIX Z11: Для native_player_emit_prepared_event_with_data
+#include "video_sink.h"  // 🔴 ЭТАЛОН: Для video_sink_clear при seek (VideoRenderGL на Android)
+#include "player_watchdog.h"  // AVSYNC / seek watchdog
+#include "player_events.h"  // 🔒 FIX Z11: Для native_player_emit_prepared_event_with_data
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <signal.h>  // Для pthread_kill
 #include <errno.h>   // Для ESRCH
+#include <time.h>    // clock_gettime для demux backpressure
 #include <unistd.h>  // 🔥 КРИТИЧЕСКИЙ FIX: Для usleep() (DISPOSE-GATE)
-#include <android/log.h>
+#include "platform_log.h"
 #include "libavutil/error.h"
 
-// 🔴 ИСПРАВЛЕНО: Объявляем extern для доступа к g_renderer из native_player_jni.c
-extern VideoRenderGL *g_renderer;
 
 #define LOG_TAG "FFmpegPlayer"
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
@@ -25,6 +24,185 @@ extern VideoRenderGL *g_renderer;
 #define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
 #define ALOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 
+/// Политика потоков video decoder'а для следующих open_media
+static atomic_int g_decode_thread_mode = VIDEO_DECODE_THREADS_AUTO;
+static atomic_int g_decode_thread_count = 0;
+
+static void demux_wakeup(PlayerContext *ctx);
+
+/// 🔥 KEYFRAME INDEX: фоновое построение индекса (свой AVFormatContext, fmt плеера не трогает)
+static void *keyframe_index_thread(void *arg) {
+    PlayerContext *ctx = (PlayerContext *)arg;
+    
+    KeyframeIndex *idx = keyframe_index_build(ctx->media_path, ctx->videoStream, &ctx->keyframe_index_abort);
+    if (idx) {
+        // Применит demux thread между av_read_frame (fmt нельзя трогать из другого потока)
+        KeyframeIndex *old = atomic_exchange(&ctx->keyframe_index_pending, idx);
+        keyframe_index_free(&old);
+        demux_wakeup(ctx);
+    }
+    return NULL;
+}
+
+/// 🔥 KEYFRAME INDEX: загрузить sidecar или запустить фоновый индексатор
+///
+/// Вызывается в конце open_media: demux thread ещё не запущен,
+/// поэтому загруженный sidecar применяется к fmt сразу.
+static void keyframe_index_start(PlayerContext *ctx, const char *path) {
+    atomic_init(&ctx->keyframe_index_pending, NULL);
+    atomic_init(&ctx->keyframe_index_abort, false);
+    
+    if (ctx->videoStream < 0 || !keyframe_index_wanted(ctx->fmt, ctx->videoStream)) {
+        return;
+    }
+    
+    AVStream *st = ctx->fmt->streams[ctx->videoStream];
+    ctx->keyframe_index = keyframe_index_load(path, ctx->videoStream, st->time_base);
+    if (ctx->keyframe_index) {
+        int added = keyframe_index_apply(ctx->keyframe_index, st);
+        ALOGI("📇 Keyframe index from sidecar: %d entries applied", added);
+        return;
+    }
+    
+    ctx->media_path = strdup(path);
+    if (ctx->media_path &&
+        pthread_create(&ctx->keyframeIndexThread, NULL, keyframe_index_thread, ctx) == 0) {
+        ctx->keyframe_index_thread_started = 1;
+        ALOGI("📇 Keyframe indexer started (format=%s)", ctx->fmt->iformat->name);
+    }
+}
+
+/// 🔥 KEYFRAME INDEX: применить индекс от фонового индексатора (только demux thread)
+static void demux_adopt_keyframe_index(PlayerContext *ctx) {
+    if (!atomic_load_explicit(&ctx->keyframe_index_pending, memory_order_relaxed)) {
+        return;
+    }
+    KeyframeIndex *idx = atomic_exchange(&ctx->keyframe_index_pending, NULL);
+    if (!idx) {
+        return;
+    }
+    
+    int added = keyframe_index_apply(idx, ctx->fmt->streams[ctx->videoStream]);
+    keyframe_index_free(&ctx->keyframe_index);
+    ctx->keyframe_index = idx;
+    ALOGI("📇 Keyframe index adopted by demux: %d entries", added);
+}
+
+void player_keyframe_index_stop(PlayerContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+    
+    atomic_store(&ctx->keyframe_index_abort, true);
+    if (ctx->keyframe_index_thread_started) {
+        pthread_join(ctx->keyframeIndexThread, NULL);
+        ctx->keyframe_index_thread_started = 0;
+    }
+    
+    KeyframeIndex *pending = atomic_exchange(&ctx->keyframe_index_pending, NULL);
+    keyframe_index_free(&pending);
+    keyframe_index_free(&ctx->keyframe_index);
+    free(ctx->media_path);
+    ctx->media_path = NULL;
+}
+
+/// 🔥 AVDISCARD: стримы, которые плеер не декодирует (субтитры, data, лишние audio дорожки),
+/// demuxer пропускает сам — без чтения payload и без av_packet_unref в demux_thread
+static void demux_discard_unused_streams(PlayerContext *ctx) {
+    int discarded = 0;
+    for (unsigned int i = 0; i < ctx->fmt->nb_streams; i++) {
+        if ((int)i == ctx->videoStream || (int)i == ctx->audioStream) {
+            ctx->fmt->streams[i]->discard = AVDISCARD_DEFAULT;
+        } else {
+            ctx->fmt->streams[i]->discard = AVDISCARD_ALL;
+            discarded++;
+        }
+    }
+    ALOGI("🗑 AVDISCARD: %d of %u streams discarded at demuxer", discarded, ctx->fmt->nb_streams);
+}
+
+/// 🔥 AVDISCARD: в MODE_AUDIO_ONLY video стрим не демультиплексируется вовсе
+///
+/// Только demux thread (владелец fmt). Возврат в MODE_AV: native_on_foreground
+/// делает keyframe seek, поэтому decoder не получит P-кадры без референсов.
+static void demux_update_video_discard(PlayerContext *ctx, bool *video_discarded) {
+    if (ctx->videoStream < 0) {
+        return;
+    }
+    bool discard = ctx->playback_mode == MODE_AUDIO_ONLY;
+    if (discard == *video_discarded) {
+        return;
+    }
+    ctx->fmt->streams[ctx->videoStream]->discard = discard ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+    *video_discarded = discard;
+    ALOGI("🗑 AVDISCARD: video stream %s", discard ? "discarded (audio-only)" : "restored");
+}
+
+/// Все пакеты, прочитанные до EOF, забраны decode threads
+static bool demux_queues_drained(PlayerContext *ctx) {
+    bool drained = true;
+    if (ctx->video && ctx->video->packetQueue && ctx->video->decodeThread_started) {
+        drained = drained && packet_queue_nb_packets(ctx->video->packetQueue) == 0;
+    }
+    if (ctx->audio && ctx->audio->packetQueue && ctx->audio->decodeThread_started) {
+        drained = drained && packet_queue_nb_packets(ctx->audio->packetQueue) == 0;
+    }
+    return drained;
+}
+
+/// 🔥 DEMUX BACKPRESSURE: нужно ли приостановить чтение
+///
+/// Как в ffplay: ждём, только когда ВСЕ активные очереди заполнены.
+/// Если одна очередь пуста (плохой interleave в AVI/FLV), продолжаем читать,
+/// иначе decoder другого стрима голодает → render стоит → deadlock.
+static bool demux_queues_full(PlayerContext *ctx) {
+    bool video_full = true;
+    bool audio_full = true;
+    if (ctx->video && ctx->video->packetQueue && ctx->playback_mode != MODE_AUDIO_ONLY) {
+        video_full = packet_queue_is_full(ctx->video->packetQueue);
+    }
+    if (ctx->audio && ctx->audio->packetQueue) {
+        audio_full = packet_queue_is_full(ctx->audio->packetQueue);
+    }
+    return video_full && audio_full;
+}
+
+/// Есть ли для demux работа помимо чтения (seek / abort)
+static bool demux_has_request(PlayerContext *ctx) {
+    return ctx->state.abort_request || ctx->state.seek_req_legacy || ctx->state.seek_req.seeking;
+}
+
+/// Разбудить demux_thread (seek, close)
+static void demux_wakeup(PlayerContext *ctx) {
+    pthread_mutex_lock(&ctx->state.demux_wait_mutex);
+    pthread_cond_broadcast(&ctx->state.demux_wait_cond);
+    pthread_mutex_unlock(&ctx->state.demux_wait_mutex);
+}
+
+/// Ждать на demux_wait_cond, пока condition(ctx) истинно и нет seek/abort
+///
+/// Consumer'ы сигналят cond вне своего mutex (см. packet_queue_notify_space),
+/// поэтому проверка condition под demux_wait_mutex не теряет wakeup.
+/// Timeout — только страховка для флагов, выставленных без сигнала.
+static void demux_wait_while(PlayerContext *ctx, bool (*condition)(PlayerContext *)) {
+    pthread_mutex_lock(&ctx->state.demux_wait_mutex);
+    while (!demux_has_request(ctx) && condition(ctx)) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += 100 * 1000000L; // 100ms
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&ctx->state.demux_wait_cond, &ctx->state.demux_wait_mutex, &ts);
+    }
+    pthread_mutex_unlock(&ctx->state.demux_wait_mutex);
+}
+
+static bool demux_queues_not_drained(PlayerContext *ctx) {
+    return !demux_queues_drained(ctx);
+}
+
 /// Поток demux (главный поток для seek и EOF)
 ///
 /// Читает пакеты из файла и распределяет их по очередям
@@ -34,6 +212,7 @@ extern VideoRenderGL *g_renderer;
 void *demux_thread(void *arg) {
     PlayerContext *ctx = (PlayerContext *)arg;
     AVPacket pkt;
+    bool video_discarded = false;
     
     // 🔥 КРИТИЧЕСКИЙ FIX: Проверяем AVSYNC-GATE перед стартом demux
     // AVSYNC-GATE открывается только после surfaceReady (eglMakeCurrent успешно выполнен)
@@ -63,6 +242,12 @@ void *demux_thread(void *arg) {
     }
     
     while (!ctx->state.abort_request) {
+        // 🔥 KEYFRAME INDEX: индекс готов → отдаём demuxer'у до следующего seek
+        demux_adopt_keyframe_index(ctx);
+        
+        // 🔥 AVDISCARD: background → video не читаем (I/O, CPU, память)
+        demux_update_video_discard(ctx, &video_discarded);
+        
         // Проверяем запрос seek (Шаг 38)
         pthread_mutex_lock(&ctx->state.seek_mutex);
         if (ctx->state.seek_req_legacy || ctx->state.seek_req.seeking) {
@@ -93,10 +278,24 @@ void *demux_thread(void *arg) {
             pthread_mutex_unlock(&ctx->state.seek_mutex);
         }
         
+        // 🔥 DEMUX BACKPRESSURE: очереди заполнены → ждём consumer'ов (на cond, не polling)
+        if (demux_queues_full(ctx)) {
+            demux_wait_while(ctx, demux_queues_full);
+            continue;  // перепроверяем seek / abort
+        }
+        
         // Читаем пакет из файла
         int ret = av_read_frame(ctx->fmt, &pkt);
         
         if (ret == AVERROR_EOF) {
+            // 🔥 КРИТИЧЕСКИЙ FIX: EOF-DRAIN - abort очереди выбрасывает ещё не декодированный хвост
+            // (packet_queue_get возвращает -1 сразу, даже если пакеты остались).
+            // Ждём (на demux_wait_cond), пока decode threads заберут хвост; seek в это время обрабатывается.
+            if (!demux_queues_drained(ctx)) {
+                demux_wait_while(ctx, demux_queues_not_drained);
+                continue;
+            }
+            
             ALOGI("📦 demux_thread: EOF reached");
             // EOF достигнут (Шаг 22)
             // Помечаем очереди как завершённые
@@ -115,12 +314,26 @@ void *demux_thread(void *arg) {
             break;
         }
         
+        ctx->packets_demuxed++;
+        
+        // 🔥 SERIAL-TAGGED PACKETS: эпоха seek на момент чтения (как pkt->serial в ffplay)
+        // Seek выполняется в этом же потоке, поэтому всё, что прочитано после
+        // perform_fast_seek, гарантированно относится к новой эпохе
+        int pkt_serial = atomic_load(&ctx->seek_serial);
+        
         // Распределяем пакет по очередям
         if (pkt.stream_index == ctx->videoStream) {
-            if (ctx->video && ctx->video->packetQueue) {
-                packet_queue_put(ctx->video->packetQueue, &pkt);
+            if (ctx->playback_mode == MODE_AUDIO_ONLY) {
+                // 🔥 DEMUX BACKPRESSURE: в background video decoder остановлен —
+                // очередь никто не читает, копить пакеты нельзя (неограниченный рост).
+                // Обычно сюда не доходит (AVDISCARD_ALL), кроме пакетов, уже
+                // буферизованных demuxer'ом до переключения режима
+                av_packet_unref(&pkt);
+            } else if (ctx->video && ctx->video->packetQueue) {
                 // 🔎 DIAGNOSTIC: Log video packet (обязательно для диагностики)
+                // Логируем ДО put: put забирает пакет (move), после него pkt пустой
                 ALOGD("📦 demux_thread: VIDEO packet pts=%lld stream_index=%d", pkt.pts, pkt.stream_index);
+                packet_queue_put(ctx->video->packetQueue, &pkt, pkt_serial);
             } else {
                 ALOGW("⚠️ demux_thread: Video packet dropped (video=%p, packetQueue=%p)", 
                       (void *)ctx->video, 
@@ -129,8 +342,8 @@ void *demux_thread(void *arg) {
             }
         } else if (pkt.stream_index == ctx->audioStream && ctx->audioStream >= 0) {
             if (ctx->audio && ctx->audio->packetQueue) {
-                packet_queue_put(ctx->audio->packetQueue, &pkt);
                 ALOGD("📦 demux_thread: audio packet pts=%lld", pkt.pts);
+                packet_queue_put(ctx->audio->packetQueue, &pkt, pkt_serial);
             } else {
                 av_packet_unref(&pkt);
             }
@@ -145,27 +358,118 @@ void *demux_thread(void *arg) {
     return NULL;
 }
 
+/// Занять seek gate (вызывается под seek_mutex)
+///
+/// После этого все player_seek до firstFrameAfterSeek уходят в pending.
+static void player_seek_claim_locked(PlayerContext *ctx) {
+    ctx->seek_in_progress = 1;
+    ctx->waiting_first_frame_after_seek = 1;
+    ctx->has_pending_seek = false;
+    ctx->pending_seek_seconds = 0.0;
+    ctx->pending_seek_exact = false;
+}
+
+static int player_seek_start(PlayerContext *ctx, double seconds, bool exact);
+
 int player_seek(PlayerContext *ctx, double seconds, bool exact) {
     if (!ctx || !ctx->fmt) {
         return -1;
     }
     
+    pthread_mutex_lock(&ctx->state.seek_mutex);
+    
+    // 🔥 SCRUB: во время перетаскивания только fast seek, последний target
+    // запоминаем для точного seek в player_scrub_end
+    if (atomic_load(&ctx->state.scrubbing)) {
+        exact = false;
+        ctx->state.scrub_last_target = seconds;
+        ctx->state.scrub_has_target = true;
+    }
+    
     // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 15.7: Scrub Spam Protection
     // Если seek уже выполняется, сохраняем новый seek как pending
     // Pending seek будет выполнен после firstFrameAfterSeek
+    // Pending хранит только последний target — промежуточные позиции scrub не декодируются
     if (ctx->seek.in_progress || ctx->seek_in_progress) {
         ALOGI("🔍 SEEK: Seek already in progress, storing pending seek to %.3f sec", seconds);
         ctx->pending_seek_seconds = seconds;
         ctx->pending_seek_exact = exact;
         ctx->has_pending_seek = true;
+        pthread_mutex_unlock(&ctx->state.seek_mutex);
         return 0; // Возвращаем успех, но не выполняем seek
     }
     
-    // Очищаем pending seek флаги
-    ctx->has_pending_seek = false;
-    ctx->pending_seek_seconds = 0.0;
-    ctx->pending_seek_exact = false;
+    // 🔥 КРИТИЧЕСКИЙ FIX: SEEK-GATE - закрываем gate перед seek (атомарно с проверкой выше)
+    // Это блокирует decode/render от обработки старых пакетов/кадров
+    player_seek_claim_locked(ctx);
+    pthread_mutex_unlock(&ctx->state.seek_mutex);
+    
+    return player_seek_start(ctx, seconds, exact);
+}
+
+bool player_seek_run_pending(PlayerContext *ctx) {
+    if (!ctx || !ctx->fmt) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&ctx->state.seek_mutex);
+    if (!ctx->has_pending_seek || ctx->seek.in_progress || ctx->seek_in_progress) {
+        pthread_mutex_unlock(&ctx->state.seek_mutex);
+        return false;
+    }
     
+    double seconds = ctx->pending_seek_seconds;
+    bool exact = ctx->pending_seek_exact;
+    player_seek_claim_locked(ctx);
+    pthread_mutex_unlock(&ctx->state.seek_mutex);
+    
+    ALOGI("🔍 SEEK: Executing pending seek to %.3f sec (exact=%s)", seconds, exact ? "true" : "false");
+    player_seek_start(ctx, seconds, exact);
+    return true;
+}
+
+void player_scrub_begin(PlayerContext *ctx, bool keyframes_only) {
+    if (!ctx) {
+        return;
+    }
+    
+    pthread_mutex_lock(&ctx->state.seek_mutex);
+    ctx->state.scrub_has_target = false;
+    ctx->state.scrub_last_target = 0.0;
+    atomic_store(&ctx->state.scrub_keyframes_only, keyframes_only);
+    atomic_store(&ctx->state.scrubbing, true);
+    pthread_mutex_unlock(&ctx->state.seek_mutex);
+    
+    ALOGI("🔍 SCRUB: begin (keyframes_only=%s)", keyframes_only ? "true" : "false");
+}
+
+void player_scrub_end(PlayerContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+    
+    pthread_mutex_lock(&ctx->state.seek_mutex);
+    bool has_target = ctx->state.scrub_has_target;
+    double target = ctx->state.scrub_last_target;
+    ctx->state.scrub_has_target = false;
+    atomic_store(&ctx->state.scrubbing, false);
+    atomic_store(&ctx->state.scrub_keyframes_only, false);
+    pthread_mutex_unlock(&ctx->state.seek_mutex);
+    
+    ALOGI("🔍 SCRUB: end (final target=%.3f, has_target=%s)", target, has_target ? "true" : "false");
+    
+    // Финальная позиция — точный seek (если seek ещё идёт, заменит pending)
+    if (has_target) {
+        player_seek(ctx, target, true);
+    }
+}
+
+bool player_scrub_keyframe_preview(PlayerContext *ctx) {
+    return ctx && atomic_load(&ctx->state.scrubbing) && atomic_load(&ctx->state.scrub_keyframes_only);
+}
+
+/// Выполнить seek (gate уже занят player_seek_claim_locked)
+static int player_seek_start(PlayerContext *ctx, double seconds, bool exact) {
     // Шаг 38.12: Edge cases - clamp to duration
     double duration = (double)ctx->fmt->duration / AV_TIME_BASE;
     if (seconds < 0.0) {
@@ -188,11 +492,6 @@ int player_seek(PlayerContext *ctx, double seconds, bool exact) {
     }
     #endif
     
-    // 🔥 КРИТИЧЕСКИЙ FIX: SEEK-GATE - закрываем gate перед seek
-    // Это блокирует decode/render от обработки старых пакетов/кадров
-    ctx->seek_in_progress = 1;
-    ctx->waiting_first_frame_after_seek = 1;
-    
     // 🔥 КРИТИЧЕСКИЙ FIX: AVSYNC HARDENING - reset clocks при seek
     extern void avsync_reset(PlayerContext *ctx);
     avsync_reset(ctx);
@@ -243,6 +542,9 @@ int player_seek(PlayerContext *ctx, double seconds, bool exact) {
     
     pthread_mutex_unlock(&ctx->state.seek_mutex);
     
+    // demux может ждать в backpressure — seek должен выполниться сразу
+    demux_wakeup(ctx);
+    
     ALOGI("🔍 SEEK-GATE: Seek requested: %.3f seconds (target_pts=%lld, exact=%s, SEEK-GATE closed)", 
           seconds, target_pts, exact ? "true" : "false");
     
@@ -313,13 +615,8 @@ int perform_fast_seek(PlayerContext *ctx) {
     ctx->seek.drop_video = true;
     ctx->seek.seek_id = new_serial;  // Сохраняем serial в seek_id для совместимости
     
-    // ⛔️ ЖДЁМ остановки потоков (abort для немедленной остановки)
-    if (ctx->audio) {
-        ctx->audio->abort = 1;
-    }
-    if (ctx->video) {
-        ctx->video->abort = 1;
-    }
+    // 🔥 SERIAL-TAGGED PACKETS: decode threads НЕ останавливаем (abort=1 здесь мог
+    // завершить их цикл навсегда) — они сами отбрасывают пакеты старой эпохи по serial
     
     // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 10.9: КРИТИЧЕСКИЕ ASSERT-ы
     #ifdef DEBUG
@@ -432,14 +729,6 @@ int perform_fast_seek(PlayerContext *ctx) {
     ALOGI("🔍 SEEK-GATE: Closed (seek_in_progress=1, waiting_first_frame_after_seek=1, target=%.3f, last_pos=%lld ms)", 
           seek_target_sec, (long long)ctx->last_position_before_seek_ms);
     
-    // 1️⃣ Остановить декод/рендер потоки (abort для немедленной остановки)
-    if (ctx->audio) {
-        ctx->audio->abort = 1;
-    }
-    if (ctx->video) {
-        ctx->video->abort = 1;
-    }
-    
     // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 6.2
     // 🧹 ЖЁСТКИЙ FLUSH (ОДИН РАЗ, СТРОГО ПО ПОРЯДКУ)
     // 🚫 НИГДЕ БОЛЬШЕ flush не делаем
@@ -468,13 +757,9 @@ int perform_fast_seek(PlayerContext *ctx) {
         ALOGI("🔍 First frame buffer cleared for seek");
     }
     
-    // 3️⃣ Сброс декодеров (обязательно!)
-    if (ctx->audio && ctx->audio->codecCtx) {
-        avcodec_flush_buffers(ctx->audio->codecCtx);
-    }
-    if (ctx->video && ctx->video->codecCtx) {
-        avcodec_flush_buffers(ctx->video->codecCtx);
-    }
+    // 3️⃣ Сброс декодеров выполняют сами decode threads: при первом пакете новой
+    // эпохи (serial) — avcodec_flush_buffers из своего потока, без гонки с
+    // avcodec_send_packet/receive_frame
     
     // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 6.4
     // 📦 AVSEEK (ТОЧНО)
@@ -491,6 +776,18 @@ int perform_fast_seek(PlayerContext *ctx) {
         seek_flags = AVSEEK_FLAG_BACKWARD;
     }
     
+    // 🔥 KEYFRAME INDEX: keyframe ≤ target бинарным поиском; demuxer получил те же
+    // записи через av_add_index_entry и не сканирует файл линейно
+    int64_t keyframe_pts = seek_ts;
+    if (ctx->keyframe_index) {
+        int k = keyframe_index_lookup(ctx->keyframe_index, seek_ts);
+        if (k >= 0) {
+            keyframe_pts = ctx->keyframe_index->entries[k].pts;
+            ALOGI("📇 SEEK: keyframe index hit #%d pts=%lld pos=%lld", k,
+                  (long long)keyframe_pts, (long long)ctx->keyframe_index->entries[k].pos);
+        }
+    }
+    
     int ret = avformat_seek_file(
         ctx->fmt,
         ctx->videoStream,  // Seek по video stream
@@ -512,7 +809,7 @@ int perform_fast_seek(PlayerContext *ctx) {
     }
     
     // Сохраняем PTS keyframe, на который попали
-    req->seek_start_pts = seek_ts;
+    req->seek_start_pts = keyframe_pts;
     
     // 5️⃣ Сброс clock (НЕ на 0, а на target_pts!)
     // 🔴 ЭТАЛОН: clock_set на seek_target, не на 0 (убирает ускорение и скачок таймлайна)
@@ -545,11 +842,8 @@ int perform_fast_seek(PlayerContext *ctx) {
     
     // 🔴 ЭТАЛОН: Очищаем video renderer при seek (убирает старые кадры и сбрасывает флаги)
     // 🔴 ШАГ J: Передаём seek_target для правильного сброса clock
-    // 🔴 ИСПРАВЛЕНО: Используем g_renderer вместо ctx->video->video_render (который VideoRenderAndroid)
-    if (g_renderer) {
-        video_render_gl_clear(g_renderer, seek_pos_sec);
-        ALOGI("✅ ШАГ J: video_render_gl_clear called after seek (seek_target=%.3f)", seek_pos_sec);
-    }
+    video_sink_clear(seek_pos_sec);
+    ALOGI("✅ ШАГ J: video_sink_clear called after seek (seek_target=%.3f)", seek_pos_sec);
     
     // 🔴 ЗАДАЧА 6: Сбрасываем субтитры при seek (используем audio clock)
     if (ctx->audio) {
@@ -560,10 +854,9 @@ int perform_fast_seek(PlayerContext *ctx) {
     }
     
     // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 6.5
-    // ▶️ ПЕРЕЗАПУСК THREADS (НО decode НЕ СТАРТУЕТ)
+    // ▶️ Decode threads не останавливались: новая эпоха декодируется,
+    // как только demux положит первый пакет после seek
     // 🚫 decode НЕ стартует до surfaceReady + play
-    ctx->audio->abort = 0;
-    ctx->video->abort = 0;
     
     // Demux thread уже запущен (стартует автоматически после surfaceReady)
     // Decode threads НЕ стартуют до play()
@@ -677,28 +970,6 @@ void handle_eof(PlayerContext *ctx) {
     }
 }
 
-/// Уведомить Flutter о событии (Шаг 22)
-void notify_flutter_event(PlayerContext *ctx, const char *event) {
-    if (!ctx || !ctx->jvm || !ctx->jniCallback) {
-        return;
-    }
-    
-    JNIEnv *env = NULL;
-    if ((*ctx->jvm)->GetEnv(ctx->jvm, (void **)&env, JNI_VERSION_1_6) != JNI_OK) {
-        (*ctx->jvm)->AttachCurrentThread(ctx->jvm, &env, NULL);
-    }
-    
-    if (!env || !ctx->onEndedMethod) {
-        return;
-    }
-    
-    jstring jevent = (*env)->NewStringUTF(env, event);
-    (*env)->CallVoidMethod(env, ctx->jniCallback, ctx->onEndedMethod, jevent);
-    (*env)->DeleteLocalRef(env, jevent);
-    
-    ALOGI("Notified Flutter: %s", event);
-}
-
 /// Установить скорость воспроизведения (Шаг 39.7)
 int player_set_speed(PlayerContext *ctx, double speed) {
     if (!ctx) {
@@ -749,18 +1020,22 @@ int open_media(PlayerContext *ctx, const char *path) {
     ALOGI("🔄 open_media: Opening file: %s", path);
     
     // 1. Открыть AVFormatContext
+    // 🔥 IO READAHEAD: если включён — fmt уже создан с custom pb (кольцо больших блоков)
+    ctx->io = io_readahead_open(path, &ctx->fmt);
     int ret = avformat_open_input(&ctx->fmt, path, NULL, NULL);
     if (ret < 0) {
         char errbuf[AV_ERROR_MAX_STRING_SIZE];
         av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
         ALOGE("Failed to open input: %s (error: %s)", path, errbuf);
+        io_readahead_close(&ctx->io);  // avformat_open_input не освобождает custom pb
         return ret;
     }
     
-    ret = avformat_find_stream_info(ctx->fmt, NULL);
+    // 🔥 PROBE CACHE: повторный open того же файла — probe из кэша (пропущен или урезан)
+    ret = probe_cache_find_stream_info(ctx->fmt, path);
     if (ret < 0) {
         ALOGE("Failed to find stream info");
-        avformat_close_input(&ctx->fmt);
+        io_readahead_close_input(&ctx->fmt, &ctx->io);
         ctx->fmt = NULL;
         return ret;
     }
@@ -806,7 +1081,7 @@ int open_media(PlayerContext *ctx, const char *path) {
     
     if (ctx->videoStream < 0 && ctx->audioStream < 0) {
         ALOGE("❌ No video or audio stream found");
-        avformat_close_input(&ctx->fmt);
+        io_readahead_close_input(&ctx->fmt, &ctx->io);
         ctx->fmt = NULL;
         return -1;
     }
@@ -816,6 +1091,8 @@ int open_media(PlayerContext *ctx, const char *path) {
     // 🔥 КРИТИЧНО: Явно помечаем video-only режим
     ctx->has_audio = (ctx->audioStream >= 0) ? 1 : 0;
     
+    demux_discard_unused_streams(ctx);
+    
     // 🔥 КРИТИЧЕСКИЙ FIX: AVSYNC HARDENING - инициализация AvSyncState
     extern void avsync_init(PlayerContext *ctx, int has_audio);
     avsync_init(ctx, ctx->has_audio);
@@ -867,7 +1144,7 @@ int open_media(PlayerContext *ctx, const char *path) {
         ctx->audio = (AudioState *)calloc(1, sizeof(AudioState));
         if (!ctx->audio) {
             ALOGE("Failed to allocate AudioState");
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return -1;
         }
@@ -878,11 +1155,19 @@ int open_media(PlayerContext *ctx, const char *path) {
             ALOGE("Failed to allocate PacketQueue for audio");
             free(ctx->audio);
             ctx->audio = NULL;
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return -1;
         }
         packet_queue_init(ctx->audio->packetQueue);
+        packet_queue_set_limits(ctx->audio->packetQueue,
+                                PACKET_QUEUE_AUDIO_MAX_BYTES,
+                                PACKET_QUEUE_DEFAULT_MAX_PACKETS,
+                                PACKET_QUEUE_DEFAULT_MAX_DURATION_SEC,
+                                ctx->fmt->streams[ctx->audioStream]->time_base);
+        packet_queue_set_space_notify(ctx->audio->packetQueue,
+                                      &ctx->state.demux_wait_mutex,
+                                      &ctx->state.demux_wait_cond);
         
         ctx->audio->frameQueue = (FrameQueue *)calloc(1, sizeof(FrameQueue));
         if (!ctx->audio->frameQueue) {
@@ -891,7 +1176,7 @@ int open_media(PlayerContext *ctx, const char *path) {
             free(ctx->audio->packetQueue);
             free(ctx->audio);
             ctx->audio = NULL;
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return -1;
         }
@@ -912,7 +1197,7 @@ int open_media(PlayerContext *ctx, const char *path) {
             free(ctx->audio->packetQueue);
             free(ctx->audio);
             ctx->audio = NULL;
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return ret;
         }
@@ -928,7 +1213,7 @@ int open_media(PlayerContext *ctx, const char *path) {
             free(ctx->audio->packetQueue);
             free(ctx->audio);
             ctx->audio = NULL;
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return ret;
         }
@@ -951,7 +1236,7 @@ int open_media(PlayerContext *ctx, const char *path) {
             free(ctx->audio->packetQueue);
             free(ctx->audio);
             ctx->audio = NULL;
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return ret;
         }
@@ -985,7 +1270,7 @@ int open_media(PlayerContext *ctx, const char *path) {
                 free(ctx->audio);
                 ctx->audio = NULL;
             }
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return -1;
         }
@@ -1006,11 +1291,19 @@ int open_media(PlayerContext *ctx, const char *path) {
                 free(ctx->audio);
                 ctx->audio = NULL;
             }
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return -1;
         }
         packet_queue_init(ctx->video->packetQueue);
+        packet_queue_set_limits(ctx->video->packetQueue,
+                                PACKET_QUEUE_VIDEO_MAX_BYTES,
+                                PACKET_QUEUE_DEFAULT_MAX_PACKETS,
+                                PACKET_QUEUE_DEFAULT_MAX_DURATION_SEC,
+                                ctx->fmt->streams[ctx->videoStream]->time_base);
+        packet_queue_set_space_notify(ctx->video->packetQueue,
+                                      &ctx->state.demux_wait_mutex,
+                                      &ctx->state.demux_wait_cond);
         
         ctx->video->frameQueue = (FrameQueue *)calloc(1, sizeof(FrameQueue));
         if (!ctx->video->frameQueue) {
@@ -1029,7 +1322,7 @@ int open_media(PlayerContext *ctx, const char *path) {
                 free(ctx->audio);
                 ctx->audio = NULL;
             }
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return -1;
         }
@@ -1059,7 +1352,8 @@ int open_media(PlayerContext *ctx, const char *path) {
           video_stream->r_frame_rate.den ?
               av_q2d(video_stream->r_frame_rate) : 0.0);
     
-    ret = video_decoder_init(ctx->video, video_stream);
+    VideoDecodeThreadPolicy thread_policy = player_get_decode_thread_policy();
+    ret = video_decoder_init(ctx->video, video_stream, &thread_policy);
         if (ret < 0) {
             ALOGE("Failed to initialize video decoder");
             frame_queue_destroy(ctx->video->frameQueue);
@@ -1078,7 +1372,7 @@ int open_media(PlayerContext *ctx, const char *path) {
                 free(ctx->audio);
                 ctx->audio = NULL;
             }
-            avformat_close_input(&ctx->fmt);
+            io_readahead_close_input(&ctx->fmt, &ctx->io);
             ctx->fmt = NULL;
             return ret;
         }
@@ -1116,6 +1410,9 @@ int open_media(PlayerContext *ctx, const char *path) {
     ALOGI("✅ Prepared event emitted from open_media (duration=%lld ms, has_audio=%d)", 
           (long long)duration_ms, ctx->has_audio);
     
+    // 🔥 KEYFRAME INDEX: AVI/FLV/TS без индекса — sidecar или фоновое сканирование
+    keyframe_index_start(ctx, path);
+    
     return 0;
 }
 
@@ -1124,9 +1421,13 @@ void close_media(PlayerContext *ctx) {
         return;
     }
     
+    // Индексатор не держит fmt плеера, но читает тот же файл — прерываем сразу
+    atomic_store(&ctx->keyframe_index_abort, true);
+    
     // Останавливаем demux thread
     if (ctx->demuxThread) {
         ctx->state.abort_request = 1;
+        demux_wakeup(ctx);  // demux может ждать в backpressure
         // Проверяем, что поток действительно существует (не был присоединён ранее)
         // pthread_t может быть невалидным после pthread_join, поэтому проверяем через pthread_kill
         int kill_ret = pthread_kill(ctx->demuxThread, 0);
@@ -1140,6 +1441,12 @@ void close_media(PlayerContext *ctx) {
         ctx->demuxThread = 0;
     }
     
+    player_keyframe_index_stop(ctx);
+    
+    // Seek watchdog читает ctx->video и ждёт на seek_watchdog_cond —
+    // останавливаем до освобождения VideoState и destroy cond/mutex ниже
+    seek_watchdog_stop(ctx);
+    
     // Освобождаем VideoState
     if (ctx->video) {
         // video_decoder_destroy уже вызывает video_threads_stop внутри
@@ -1193,7 +1500,7 @@ void close_media(PlayerContext *ctx) {
     
     // Освобождаем format context
     if (ctx->fmt) {
-        avformat_close_input(&ctx->fmt);
+        io_readahead_close_input(&ctx->fmt, &ctx->io);
         ctx->fmt = NULL;
         ALOGI("AVFormatContext closed and freed");
     }
@@ -1203,10 +1510,61 @@ void close_media(PlayerContext *ctx) {
     
     // Освобождаем mutex
     pthread_mutex_destroy(&ctx->state.seek_mutex);
+    pthread_mutex_destroy(&ctx->state.demux_wait_mutex);
+    pthread_cond_destroy(&ctx->state.demux_wait_cond);
+    pthread_mutex_destroy(&ctx->state.seek_watchdog_mutex);
+    pthread_cond_destroy(&ctx->state.seek_watchdog_cond);
     
     ALOGI("✅ close_media: All resources released");
 }
 
+int player_get_io_stats(PlayerContext *ctx, IoStats *out) {
+    if (!ctx || !out || !ctx->io) {
+        return -1;
+    }
+    io_readahead_get_stats(ctx->io, out);
+    return 0;
+}
+
+int player_get_packet_queue_stats(PlayerContext *ctx, PacketQueueStats *video, PacketQueueStats *audio) {
+    if (!ctx || !video || !audio) {
+        return -1;
+    }
+    memset(video, 0, sizeof(*video));
+    memset(audio, 0, sizeof(*audio));
+    bool have_video = ctx->video && ctx->video->packetQueue;
+    bool have_audio = ctx->audio && ctx->audio->packetQueue;
+    if (!have_video && !have_audio) {
+        return -1;
+    }
+    if (have_video) {
+        packet_queue_get_stats(ctx->video->packetQueue, video);
+    }
+    if (have_audio) {
+        packet_queue_get_stats(ctx->audio->packetQueue, audio);
+    }
+    return 0;
+}
+
+void player_set_decode_thread_policy(VideoDecodeThreadMode mode, int thread_count) {
+    if (mode < VIDEO_DECODE_THREADS_AUTO || mode > VIDEO_DECODE_THREADS_LOW_LATENCY) {
+        mode = VIDEO_DECODE_THREADS_AUTO;
+    }
+    if (thread_count < 0) {
+        thread_count = 0;
+    }
+    atomic_store(&g_decode_thread_mode, mode);
+    atomic_store(&g_decode_thread_count, thread_count);
+    ALOGI("🎬 Decode thread policy: mode=%d, threads=%d", (int)mode, thread_count);
+}
+
+VideoDecodeThreadPolicy player_get_decode_thread_policy(void) {
+    VideoDecodeThreadPolicy policy;
+    policy.mode = (VideoDecodeThreadMode)atomic_load(&g_decode_thread_mode);
+    policy.thread_count = atomic_load(&g_decode_thread_count);
+    return policy;
+}
+
 int play(PlayerContext *ctx) {
     if (!ctx) {
         return -1;
@@ -1492,6 +1850,12 @@ void player_state_init(PlayerState *state) {
     
     memset(state, 0, sizeof(PlayerState));
     pthread_mutex_init(&state->seek_mutex, NULL);
+    pthread_mutex_init(&state->demux_wait_mutex, NULL);
+    pthread_cond_init(&state->demux_wait_cond, NULL);
+    pthread_mutex_init(&state->seek_watchdog_mutex, NULL);
+    pthread_cond_init(&state->seek_watchdog_cond, NULL);
+    atomic_init(&state->scrubbing, false);
+    atomic_init(&state->scrub_keyframes_only, false);
     state->seek_flags = AVSEEK_FLAG_BACKWARD;
     state->state = PLAYBACK_RUNNING;
     state->repeat_mode = 0; // repeat OFF по умолчанию
@@ -1,7 +1,7 @@
 #ifndef FFMPEG_PLAYER_H
 #define FFMPEG_PLAYER_H
 
-#include <jni.h>
+#include "platform_jni.h"  // JavaVM / jobject (непрозрачные типы на host)
 #include <pthread.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -17,6 +17,9 @@
 #include "video_renderer.h"
 #include "subtitle_manager.h"  // 🔴 ЗАДАЧА 6: Subtitles API
 #include "avsync_gate.h"  // 🔥 КРИТИЧЕСКИЙ FIX: AVSYNC-IMPLEMENTATION
+#include "keyframe_index.h"  // 🔥 KEYFRAME INDEX: sidecar для AVI/FLV/TS без индекса
+#include "io_readahead.h"  // 🔥 IO READAHEAD: custom AVIOContext для локальных файлов
+#include "probe_cache.h"  // 🔥 PROBE CACHE: persistent кэш find_stream_info
 
 // Forward declarations
 typedef struct PacketQueue PacketQueue;
@@ -148,6 +151,23 @@ typedef struct {
     /// Mutex для seek операций
     pthread_mutex_t seek_mutex;
     
+    /// 🔥 DEMUX BACKPRESSURE: demux_thread ждёт здесь, пока packet queues заполнены
+    /// Сигналится consumer'ами (packet_queue_get/flush/abort), seek и close
+    pthread_mutex_t demux_wait_mutex;
+    pthread_cond_t demux_wait_cond;
+    
+    /// 🔥 SCRUB: пользователь тащит seek bar (player_scrub_begin / player_scrub_end)
+    /// Seek'и во время scrub только fast и схлопываются в последний target
+    atomic_bool scrubbing;
+    atomic_bool scrub_keyframes_only;  // preview только по keyframe (без decode до target)
+    double scrub_last_target;          // Последний target во время scrub (под seek_mutex)
+    bool scrub_has_target;
+    
+    /// Seek watchdog: ожидание прерывается seek_watchdog_stop / новым seek
+    pthread_mutex_t seek_watchdog_mutex;
+    pthread_cond_t seek_watchdog_cond;
+    int seek_watchdog_cancel;
+    
     /// Флаги завершения потоков (для EOF)
     int audio_finished;
     int video_finished;
@@ -266,6 +286,18 @@ typedef struct {
     bool has_pending_seek;        // Флаг, что есть pending seek
     int64_t master_clock_ms;  // 🔥 КРИТИЧЕСКИЙ FIX: Master clock (video PTS) в миллисекундах - обновляется ТОЛЬКО после eglSwapBuffers
     int64_t last_render_ts_ms;  // 🔥 КРИТИЧЕСКИЙ FIX: RENDER_STALL_ASSERT - timestamp последнего успешного eglSwapBuffers (monotonic time)
+    int64_t packets_demuxed;  // Счётчик пакетов, прочитанных demux_thread (bench_decode, диагностика)
+    
+    // 🔥 KEYFRAME INDEX: индекс keyframe'ов для файлов без seek-индекса
+    char *media_path;  // Путь из open_media (для фонового индексатора)
+    KeyframeIndex *keyframe_index;  // Применён к fmt (владелец — demux thread)
+    _Atomic(KeyframeIndex *) keyframe_index_pending;  // Построен фоном, ждёт demux thread
+    atomic_bool keyframe_index_abort;
+    int keyframe_index_thread_started;
+    pthread_t keyframeIndexThread;
+    
+    // 🔥 IO READAHEAD: custom pb для fmt (NULL → обычный file protocol)
+    IoReadahead *io;
     
     // Threads
     pthread_t demuxThread;
@@ -303,6 +335,41 @@ int open_media(PlayerContext *ctx, const char *path);
 /// @param ctx Контекст плеера
 void close_media(PlayerContext *ctx);
 
+/// Остановить фоновый индексатор keyframe'ов и освободить индекс
+///
+/// Вызывается при shutdown ПОСЛЕ join demux thread (он владеет keyframe_index).
+///
+/// @param ctx Контекст плеера
+void player_keyframe_index_stop(PlayerContext *ctx);
+
+/// Статистика I/O текущего файла (read-ahead слой)
+///
+/// @param ctx Контекст плеера
+/// @param out Статистика
+/// @return 0 при успехе, -1 если файл открыт без read-ahead слоя
+int player_get_io_stats(PlayerContext *ctx, IoStats *out);
+
+/// Статистика packet queue (freelist узлов, node_allocs)
+///
+/// @param ctx Контекст плеера
+/// @param video Статистика video очереди (обнуляется, если очереди нет)
+/// @param audio Статистика audio очереди (обнуляется, если очереди нет)
+/// @return 0 при успехе, -1 если файл не открыт
+int player_get_packet_queue_stats(PlayerContext *ctx, PacketQueueStats *video, PacketQueueStats *audio);
+
+/// Установить политику потоков software video decoder'а
+///
+/// Применяется в open_media (avcodec_open2), уже открытые декодеры не меняются.
+///
+/// @param mode Режим (auto / frame / slice / low latency)
+/// @param thread_count 0 = auto (online CPU + разрешение), иначе явное число потоков
+void player_set_decode_thread_policy(VideoDecodeThreadMode mode, int thread_count);
+
+/// Текущая политика потоков декодера
+///
+/// @return Политика, которую получит следующий open_media
+VideoDecodeThreadPolicy player_get_decode_thread_policy(void);
+
 /// Начать воспроизведение
 ///
 /// @param ctx Контекст плеера
@@ -325,6 +392,37 @@ void player_pause(PlayerContext *ctx);
 /// @return 0 при успехе, <0 при ошибке
 int player_seek(PlayerContext *ctx, double seconds, bool exact);
 
+/// Выполнить pending seek (если есть)
+///
+/// Вызывается render loop'ом после firstFrameAfterSeek (seek.in_progress уже сброшен).
+/// Pending хранит только последний target: серия seek'ов во время seek
+/// схлопывается в один.
+///
+/// @param ctx Контекст плеера
+/// @return true если pending seek запущен
+bool player_seek_run_pending(PlayerContext *ctx);
+
+/// Начать scrub (перетаскивание seek bar)
+///
+/// До player_scrub_end все player_seek выполняются как fast seek,
+/// а запросы во время активного seek схлопываются в последний.
+///
+/// @param ctx Контекст плеера
+/// @param keyframes_only true = preview только keyframe'ами: decoder пропускает
+///                       non-key пакеты, render показывает keyframe даже если он < target
+void player_scrub_begin(PlayerContext *ctx, bool keyframes_only);
+
+/// Завершить scrub: точный seek в последнюю позицию пальца
+///
+/// @param ctx Контекст плеера
+void player_scrub_end(PlayerContext *ctx);
+
+/// Активен ли keyframe-only preview (scrub с keyframes_only)
+///
+/// @param ctx Контекст плеера
+/// @return true если кадры после seek показываются без проверки target
+bool player_scrub_keyframe_preview(PlayerContext *ctx);
+
 /// Выполнить fast seek (Phase 1, Шаг 38.4)
 ///
 /// Прыгает на ближайший keyframe ≤ target
@@ -270,6 +270,7 @@ int render_loop_start(PlayerContext *ctx) {
     // Останавливаем старый render loop, если он запущен
     if (ctx->rendering && ctx->renderThread) {
         g_lifecycle_render_abort = 1;
+        video_render_gl_wake(g_renderer);
         pthread_join(ctx->renderThread, NULL);
         ctx->renderThread = 0;
     }
@@ -296,8 +297,9 @@ void render_loop_stop(PlayerContext *ctx) {
         return; // Уже остановлен
     }
     
-    // Устанавливаем флаг abort
+    // Устанавливаем флаг abort и будим render thread (он может спать до deadline'а кадра)
     g_lifecycle_render_abort = 1;
+    video_render_gl_wake(g_renderer);
     
     // Ждём завершения render thread
     if (ctx->renderThread) {
@@ -413,7 +415,10 @@ void native_on_foreground(PlayerContext *ctx) {
     
     ALOGI("🔄 native_on_foreground: Switching to MODE_AV");
     
+    bool was_audio_only = ctx->playback_mode == MODE_AUDIO_ONLY;
+    
     // 1. Устанавливаем playback_mode
+    // (demux thread снимает AVDISCARD_ALL с video стрима на следующей итерации)
     ctx->playback_mode = MODE_AV;
     
     // 2. Reattach surface
@@ -440,6 +445,14 @@ void native_on_foreground(PlayerContext *ctx) {
         ALOGI("✅ native_on_foreground: Video decode resumed");
     }
     
+    // 🔥 AVDISCARD: в background video пакеты не демультиплексировались —
+    // keyframe seek в текущую (audio) позицию, иначе decoder начнёт с P-кадров
+    if (was_audio_only && ctx->video && ctx->decode_started && ctx->fmt) {
+        double position_sec = get_position(ctx) / 1000.0;
+        player_seek(ctx, position_sec, false);
+        ALOGI("✅ native_on_foreground: Keyframe seek to %.3f sec (video restored)", position_sec);
+    }
+    
     // 5. AVSYNC: audio master until first frame
     if (ctx->has_audio && ctx->audio) {
         ctx->avsync.master = CLOCK_MASTER_AUDIO;
@@ -504,19 +517,17 @@ static void enter_frame_step(PlayerContext *ctx) {
     }
     
     // 4. Clear decode queues
+    // 🔥 Packet queues НЕ flush'им из JNI-потока: flush — операция producer'а
+    // (SPSC ring), а demux может писать прямо сейчас. Как и seek, меняем эпоху:
+    // decode threads дропают пакеты старого serial, demux метит новые новым
+    int new_serial = atomic_fetch_add(&ctx->seek_serial, 1) + 1;
     if (ctx->video && ctx->video->frameQueue) {
         frame_queue_flush(ctx->video->frameQueue);
     }
-    if (ctx->video && ctx->video->packetQueue) {
-        packet_queue_flush(ctx->video->packetQueue);
-    }
     if (ctx->audio && ctx->audio->frameQueue) {
         frame_queue_flush(ctx->audio->frameQueue);
     }
-    if (ctx->audio && ctx->audio->packetQueue) {
-        packet_queue_flush(ctx->audio->packetQueue);
-    }
-    ALOGI("✅ enter_frame_step: Decode queues flushed");
+    ALOGI("✅ enter_frame_step: Decode queues invalidated (serial=%d)", new_serial);
     
     // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 13.7: ASSERT-ы
     #ifdef DEBUG
@@ -944,6 +955,9 @@ void player_shutdown(PlayerContext *ctx) {
         ctx->demuxThread = 0;
     }
     
+    // 🔥 KEYFRAME INDEX: фоновый индексатор + индекс (demux уже остановлен)
+    player_keyframe_index_stop(ctx);
+    
     // ─────────────────────────────────────────
     // 🔴 7. СБРОС CLOCK (ЗАМОРОЗКА)
     // ─────────────────────────────────────────
@@ -1017,7 +1031,7 @@ void player_shutdown(PlayerContext *ctx) {
     // ─────────────────────────────────────────
     ALOGI("🛑 player_shutdown: Closing media file...");
     if (ctx->fmt) {
-        avformat_close_input(&ctx->fmt);
+        io_readahead_close_input(&ctx->fmt, &ctx->io);
     }
     
     // ─────────────────────────────────────────
@@ -1045,216 +1059,3 @@ void player_shutdown(PlayerContext *ctx) {
     
     ALOGI("✅ player_shutdown: Shutdown sequence complete");
 }
-
-/// 🔥 КРИТИЧЕСКИЙ FIX: AVSYNC-CODE-DIFF - AVSYNC Watchdog thread
-///
-/// Проверяет clock stall каждые 500ms
-/// Если master clock не обновляется > 500ms → инвалидирует AVSYNC и останавливает playback
-///
-/// 🔥 КРИТИЧЕСКИЙ FIX: Watchdog должен быть контекстно-осознанным
-/// - Не проверяет stall если state != PLAYING
-/// - Не проверяет stall если первый кадр ещё не отрисован
-/// - Для video-only разрешает idle clock до первого frame
-static void *avsync_watchdog_thread(void *arg) {
-    PlayerContext *ctx = (PlayerContext *)arg;
-    if (!ctx) {
-        return NULL;
-    }
-    
-    ALOGI("🔄 AVSYNC Watchdog: Thread started");
-    
-    while (!ctx->abort && !ctx->shutting_down) {
-        usleep(500000); // 500ms
-        
-        if (ctx->abort || ctx->shutting_down) {
-            break;
-        }
-        
-        // 🔥 КРИТИЧЕСКИЙ FIX: AUTO-NEXT - EOF ≠ STALL
-        // Если EOF достигнут, watchdog должен быть отключён
-        // EOF - это нормальное завершение playback, не ошибка
-        if (ctx->eof_reached) {
-            continue; // ❌ EOF достигнут - не проверяем stall
-        }
-        
-        // 🔥 FIX 3: Watchdog должен знать FSM state
-        // Не проверяем stall если state != PLAYING
-        if (ctx->state.state != PLAYBACK_RUNNING || ctx->paused) {
-            continue; // ❌ не проверяем stall если не playing
-        }
-        
-        // 🔥 FIX 4: Первому кадру — special handling
-        // Clock не считается stalled, пока не отрисован первый frame
-        // Это КРИТИЧНО для AVI / FLV (часто первый frame приходит с задержкой)
-        if (ctx->video && !ctx->video->first_frame_rendered) {
-            continue; // ❌ не проверяем stall до первого frame
-        }
-        
-        // 🔥 FIX 2: Video-only → разрешить "idle clock"
-        // Для video-only режима до первого frame clock = IDLE (это нормально)
-        bool is_video_only = (ctx->has_audio == 0);
-        if (is_video_only && ctx->video && !ctx->video->clock.valid) {
-            continue; // ❌ video-only: clock может быть idle до первого frame
-        }
-        
-        // Проверяем clock stall (только если все условия выполнены)
-        if (avsync_gate_check_stall(&ctx->avsync_gate, 500000)) { // 500ms threshold
-            // 🔒 ЗАЩИТНЫЙ ASSERT (ОБЯЗАТЕЛЬНО)
-            #ifdef DEBUG
-            if (ctx->eof_reached) {
-                ALOGE("❌ AVSYNC Watchdog ASSERT FAILED: STALL and EOF cannot happen together (FATAL)");
-                abort();
-            }
-            #endif
-            
-            // Clock stall обнаружен → инвалидируем AVSYNC и эмитим error
-            avsync_gate_invalidate(&ctx->avsync_gate, "MASTER CLOCK STALLED");
-            
-            extern void native_player_emit_error_event(const char *message);
-            native_player_emit_error_event("CLOCK_STALL");
-            
-            // Останавливаем playback
-            player_pause(ctx);
-            
-            ALOGE("❌ AVSYNC Watchdog: Clock stall detected - playback stopped");
-        }
-    }
-    
-    ALOGI("✅ AVSYNC Watchdog: Thread stopped");
-    return NULL;
-}
-
-/// 🔥 КРИТИЧЕСКИЙ FIX: AVSYNC-CODE-DIFF - запустить AVSYNC watchdog thread
-///
-/// 🔥 КРИТИЧЕСКИЙ FIX: Вызывается ТОЛЬКО после play()
-/// Watchdog должен стартовать когда clocks начали тикать
-/// Иначе для video-only файлов watchdog будет считать idle clock как stall
-int avsync_watchdog_start(PlayerContext *ctx) {
-    if (!ctx) {
-        return -1;
-    }
-    
-    // Проверяем, не запущен ли уже
-    if (ctx->avsyncWatchdogThread != 0) {
-        ALOGD("⚠️ avsync_watchdog_start: Watchdog already running");
-        return 0;
-    }
-    
-    int ret = pthread_create(&ctx->avsyncWatchdogThread, NULL, avsync_watchdog_thread, ctx);
-    if (ret != 0) {
-        ALOGE("❌ avsync_watchdog_start: Failed to create watchdog thread: %d", ret);
-        return -1;
-    }
-    
-    ALOGI("✅ AVSYNC Watchdog: Thread started");
-    return 0;
-}
-
-/// 🔥 КРИТИЧЕСКИЙ FIX: AUTO-NEXT - остановить AVSYNC watchdog thread
-///
-/// Вызывается при EOF для предотвращения ложных срабатываний
-/// EOF ≠ STALL - это нормальное завершение playback
-void avsync_watchdog_stop(PlayerContext *ctx) {
-    if (!ctx) {
-        return;
-    }
-    
-    // Проверяем, запущен ли watchdog
-    if (ctx->avsyncWatchdogThread == 0) {
-        ALOGD("⚠️ avsync_watchdog_stop: Watchdog not running");
-        return;
-    }
-    
-    // Останавливаем watchdog thread
-    // Thread сам завершится при следующей проверке abort/shutting_down
-    // Мы просто ждём его завершения
-    ALOGI("🛑 avsync_watchdog_stop: Stopping AVSYNC watchdog thread...");
-    pthread_join(ctx->avsyncWatchdogThread, NULL);
-    ctx->avsyncWatchdogThread = 0;
-    ALOGI("✅ avsync_watchdog_stop: AVSYNC watchdog thread stopped");
-}
-
-/// 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - Seek Watchdog thread
-///
-/// Проверяет seek deadlock каждые 1200ms
-/// Если seek_in_progress > 1200ms и нет firstFrameAfterSeek → эмитим error и останавливаем playback
-static void *seek_watchdog_thread(void *arg) {
-    PlayerContext *ctx = (PlayerContext *)arg;
-    if (!ctx) {
-        return NULL;
-    }
-    
-    ALOGI("🔄 Seek Watchdog: Thread started");
-    
-    int64_t seek_start_ms = av_gettime() / 1000;  // миллисекунды
-    
-    // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - PATCH 4: Hard deadlock guard
-    // Ждём 1000ms (уменьшено с 1200ms для более быстрой детекции)
-    usleep(1000000); // 1000ms
-    
-    // Проверяем, завершился ли seek
-    if (ctx->abort || ctx->shutting_down) {
-        ALOGI("✅ Seek Watchdog: Thread stopped (abort/shutdown)");
-        return NULL;
-    }
-    
-    // Проверяем, идёт ли ещё seek
-    if (avsync_gate_is_seek_in_progress(&ctx->avsync_gate) || ctx->waiting_first_frame_after_seek) {
-        int64_t elapsed_ms = (av_gettime() / 1000) - seek_start_ms;
-        // Seek deadlock обнаружен → эмитим error
-        // ❌ Никаких silent fails, ❌ Никаких infinite waits
-        ALOGE("❌ SEEK DEADLOCK: no frame after seek (%lld ms timeout) - SEEK_FRAME_ASSERT_FAILED", 
-              (long long)elapsed_ms);
-        
-        extern void native_player_emit_error_event(const char *message);
-        native_player_emit_error_event("SEEK_FRAME_ASSERT_FAILED");
-        
-        // Останавливаем playback
-        player_pause(ctx);
-        
-        ALOGE("❌ Seek Watchdog: Deadlock detected - playback stopped");
-    }
-    
-    ALOGI("✅ Seek Watchdog: Thread stopped");
-    return NULL;
-}
-
-/// 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - запустить seek watchdog thread
-///
-/// Вызывается при начале seek для мониторинга deadlock
-int seek_watchdog_start(PlayerContext *ctx) {
-    if (!ctx) {
-        return -1;
-    }
-    
-    // Останавливаем предыдущий watchdog если он запущен
-    if (ctx->seekWatchdogThread != 0) {
-        ALOGD("⚠️ seek_watchdog_start: Stopping previous watchdog");
-        pthread_join(ctx->seekWatchdogThread, NULL);
-        ctx->seekWatchdogThread = 0;
-    }
-    
-    int ret = pthread_create(&ctx->seekWatchdogThread, NULL, seek_watchdog_thread, ctx);
-    if (ret != 0) {
-        ALOGE("❌ seek_watchdog_start: Failed to create watchdog thread: %d", ret);
-        return -1;
-    }
-    
-    ALOGI("✅ Seek Watchdog: Thread started");
-    return 0;
-}
-
-/// Остановить seek watchdog thread
-void seek_watchdog_stop(PlayerContext *ctx) {
-    if (!ctx) {
-        return;
-    }
-    
-    if (ctx->seekWatchdogThread != 0) {
-        ALOGI("🛑 seek_watchdog_stop: Stopping seek watchdog thread...");
-        pthread_join(ctx->seekWatchdogThread, NULL);
-        ctx->seekWatchdogThread = 0;
-        ALOGI("✅ seek_watchdog_stop: Seek watchdog thread stopped");
-    }
-}
-
@@ -4,6 +4,7 @@
 #define FFMPEG_PLAYER_LIFECYCLE_H
 
 #include "ffmpeg_player.h"
+#include "player_watchdog.h"  // avsync_watchdog_* / seek_watchdog_*
 
 /// Присоединить ANativeWindow к плееру
 ///
@@ -93,33 +94,5 @@ void native_step_frame(PlayerContext *ctx, int direction);
 /// @param ctx Контекст плеера
 void player_shutdown(PlayerContext *ctx);
 
-/// 🔥 КРИТИЧЕСКИЙ FIX: AVSYNC-CODE-DIFF - запустить AVSYNC watchdog thread
-///
-/// 🔥 КРИТИЧЕСКИЙ FIX: Вызывается ТОЛЬКО после play()
-/// Watchdog должен стартовать когда clocks начали тикать
-/// Иначе для video-only файлов watchdog будет считать idle clock как stall
-/// @param ctx Контекст плеера
-/// @return 0 при успехе, <0 при ошибке
-int avsync_watchdog_start(PlayerContext *ctx);
-
-/// 🔥 КРИТИЧЕСКИЙ FIX: AUTO-NEXT - остановить AVSYNC watchdog thread
-///
-/// Вызывается при EOF для предотвращения ложных срабатываний
-/// EOF ≠ STALL - это нормальное завершение playback
-/// @param ctx Контекст плеера
-void avsync_watchdog_stop(PlayerContext *ctx);
-
-/// 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - запустить seek watchdog thread
-///
-/// Вызывается при начале seek для мониторинга deadlock
-/// @param ctx Контекст плеера
-/// @return 0 при успехе, <0 при ошибке
-int seek_watchdog_start(PlayerContext *ctx);
-
-/// Остановить seek watchdog thread
-///
-/// @param ctx Контекст плеера
-void seek_watchdog_stop(PlayerContext *ctx);
-
 #endif // FFMPEG_PLAYER_LIFECYCLE_H
 
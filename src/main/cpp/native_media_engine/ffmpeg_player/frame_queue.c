@@ -3,7 +3,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include "libavutil/rational.h"
-#include <android/log.h>
+#include "platform_log.h"
 
 #define LOG_TAG "FrameQueue"
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
@@ -20,6 +20,21 @@ static void frame_clear(Frame *f) {
     f->pts = 0.0;
 }
 
+/// Разбудить внешнего consumer'а (вызывается вне fq->mutex)
+static void frame_queue_notify_frame(FrameQueue *fq) {
+    pthread_mutex_lock(&fq->mutex);
+    pthread_mutex_t *mutex = fq->frame_mutex;
+    pthread_cond_t *cond = fq->frame_cond;
+    pthread_mutex_unlock(&fq->mutex);
+    
+    if (!mutex || !cond) {
+        return;
+    }
+    pthread_mutex_lock(mutex);
+    pthread_cond_broadcast(cond);
+    pthread_mutex_unlock(mutex);
+}
+
 void frame_queue_init(FrameQueue *fq, AVRational time_base) {
     memset(fq, 0, sizeof(FrameQueue));
     pthread_mutex_init(&fq->mutex, NULL);
@@ -57,6 +72,8 @@ void frame_queue_abort(FrameQueue *fq) {
     fq->abort_request = true;
     pthread_cond_signal(&fq->cond);
     pthread_mutex_unlock(&fq->mutex);
+    
+    frame_queue_notify_frame(fq);
 }
 
 void frame_queue_flush(FrameQueue *fq) {
@@ -77,6 +94,15 @@ void frame_queue_flush(FrameQueue *fq) {
     
     pthread_cond_signal(&fq->cond);
     pthread_mutex_unlock(&fq->mutex);
+    
+    frame_queue_notify_frame(fq);
+}
+
+void frame_queue_set_frame_notify(FrameQueue *fq, pthread_mutex_t *mutex, pthread_cond_t *cond) {
+    pthread_mutex_lock(&fq->mutex);
+    fq->frame_mutex = mutex;
+    fq->frame_cond = cond;
+    pthread_mutex_unlock(&fq->mutex);
 }
 
 int frame_queue_push(FrameQueue *fq, AVFrame *frame, double pts, int serial) {
@@ -142,6 +168,8 @@ int frame_queue_push(FrameQueue *fq, AVFrame *frame, double pts, int serial) {
     pthread_cond_signal(&fq->cond);
     pthread_mutex_unlock(&fq->mutex);
     
+    frame_queue_notify_frame(fq);
+    
     return 0;
 }
 
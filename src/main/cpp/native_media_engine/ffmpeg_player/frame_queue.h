@@ -59,6 +59,11 @@ typedef struct FrameQueue {
     /// Condition variable для ожидания
     pthread_cond_t cond;
     
+    /// Внешний cond consumer'а (render thread), может быть NULL
+    /// Сигналится вне fq->mutex после push / flush / abort
+    pthread_mutex_t *frame_mutex;
+    pthread_cond_t *frame_cond;
+    
     /// 🔴 КРИТИЧНО: time_base для конвертации PTS из best_effort_timestamp
     /// Используется как fallback, если переданный pts невалиден
     AVRational time_base;
@@ -102,6 +107,13 @@ void frame_queue_flush(FrameQueue *fq);
 /// @return 0 при успехе, <0 при ошибке
 int frame_queue_push(FrameQueue *fq, AVFrame *frame, double pts, int serial);
 
+/// Подписать consumer'а на появление кадров (и на flush / abort)
+///
+/// @param fq Очередь
+/// @param mutex Mutex, под которым consumer ждёт cond
+/// @param cond Cond, который будет сигналиться (broadcast); NULL — отписаться
+void frame_queue_set_frame_notify(FrameQueue *fq, pthread_mutex_t *mutex, pthread_cond_t *cond);
+
 /// Извлечь кадр из очереди (блокирующий или неблокирующий)
 ///
 /// @param fq Очередь
@@ -0,0 +1,502 @@
+/// 🔥 IO READAHEAD: custom AVIOContext с read-ahead потоком (см. io_readahead.h)
+///
+/// Кольцо из block_count блоков по block_size: блок k (0 <= k < filled) лежит
+/// в слоте (head + k) % block_count и покрывает [win_start + k * block_size, ...).
+/// Read-ahead поток дописывает блоки в хвост, AVIO read callback (demux thread)
+/// копирует из головы и освобождает прочитанные блоки. Seek вне окна сбрасывает
+/// кольцо (generation++): блок, который поток читал для старого окна, отбрасывается.
+
+#include "io_readahead.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"  // av_gettime_relative
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "platform_log.h"
+
+#define LOG_TAG "IoReadahead"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define ALOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+/// Буфер самого AVIOContext: demuxer читает из него, он — из кольца
+#define IO_READAHEAD_AVIO_BUFFER_SIZE (64 * 1024)
+#define IO_READAHEAD_MIN_BLOCK_SIZE (64 * 1024)
+#define IO_READAHEAD_PAGE_SIZE 4096
+
+/// mmap: копирование дольше 1ms считаем stall (page fault на медленном носителе)
+#define IO_READAHEAD_MMAP_STALL_US 1000
+
+struct IoReadahead {
+    int fd;
+    int64_t size;
+    IoReadaheadConfig cfg;
+    AVIOContext *avio;
+    int64_t pos;  // Позиция demuxer'а (только AVIO callbacks)
+
+    // mmap режим
+    uint8_t *map;
+    int64_t advised_start;
+    int64_t advised_end;
+
+    // Read-ahead режим (всё ниже — под mutex, кроме содержимого блоков)
+    uint8_t **blocks;
+    int *lens;
+    int head;
+    int filled;
+    int64_t win_start;
+    unsigned int generation;
+    bool error;
+    bool abort;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond_fill;  // Есть свободный слот / сброс окна / abort
+    pthread_cond_t cond_data;  // Блок готов
+    pthread_t thread;
+    bool thread_started;
+
+    IoStats stats;
+};
+
+static pthread_mutex_t g_config_mutex = PTHREAD_MUTEX_INITIALIZER;
+static IoReadaheadConfig g_config = {
+    .enabled = false,
+    .block_size = IO_READAHEAD_DEFAULT_BLOCK_SIZE,
+    .block_count = IO_READAHEAD_DEFAULT_BLOCK_COUNT,
+    .use_fadvise = true,
+    .use_mmap = false,
+};
+
+void io_readahead_set_config(const IoReadaheadConfig *cfg) {
+    IoReadaheadConfig c = {
+        .enabled = false,
+        .block_size = IO_READAHEAD_DEFAULT_BLOCK_SIZE,
+        .block_count = IO_READAHEAD_DEFAULT_BLOCK_COUNT,
+        .use_fadvise = true,
+        .use_mmap = false,
+    };
+    if (cfg) {
+        c = *cfg;
+    }
+
+    if (c.block_size <= 0) {
+        c.block_size = IO_READAHEAD_DEFAULT_BLOCK_SIZE;
+    }
+    if (c.block_size < IO_READAHEAD_MIN_BLOCK_SIZE) {
+        c.block_size = IO_READAHEAD_MIN_BLOCK_SIZE;
+    }
+    if (c.block_size > IO_READAHEAD_MAX_BLOCK_SIZE) {
+        c.block_size = IO_READAHEAD_MAX_BLOCK_SIZE;
+    }
+    // Кратно странице: окно fadvise/madvise выровнено
+    c.block_size -= c.block_size % IO_READAHEAD_PAGE_SIZE;
+
+    if (c.block_count <= 0) {
+        c.block_count = IO_READAHEAD_DEFAULT_BLOCK_COUNT;
+    }
+    if (c.block_count < 2) {
+        c.block_count = 2;
+    }
+    if (c.block_count > IO_READAHEAD_MAX_BLOCK_COUNT) {
+        c.block_count = IO_READAHEAD_MAX_BLOCK_COUNT;
+    }
+
+    pthread_mutex_lock(&g_config_mutex);
+    g_config = c;
+    pthread_mutex_unlock(&g_config_mutex);
+
+    ALOGI("💾 IO readahead: %s, block=%dKB x %d, fadvise=%d, mmap=%d",
+          c.enabled ? "enabled" : "disabled", c.block_size / 1024, c.block_count,
+          c.use_fadvise, c.use_mmap);
+}
+
+IoReadaheadConfig io_readahead_get_config(void) {
+    pthread_mutex_lock(&g_config_mutex);
+    IoReadaheadConfig c = g_config;
+    pthread_mutex_unlock(&g_config_mutex);
+    return c;
+}
+
+/// Локальный путь (file: / file:// префикс снимается), NULL для сетевых URL
+static const char *io_readahead_local_path(const char *path) {
+    if (strncmp(path, "file://", 7) == 0) {
+        return path + 7;
+    }
+    if (strncmp(path, "file:", 5) == 0) {
+        return path + 5;
+    }
+    if (strstr(path, "://")) {
+        return NULL;
+    }
+    return path;
+}
+
+/// pread до конца блока (короткое чтение возможно на pipe/FUSE)
+static ssize_t io_readahead_pread_full(int fd, uint8_t *buf, size_t size, int64_t off) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = pread(fd, buf + done, size - done, (off_t)(off + (int64_t)done));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        done += (size_t)n;
+    }
+    return (ssize_t)done;
+}
+
+static int64_t io_readahead_window(const IoReadahead *io) {
+    return (int64_t)io->cfg.block_size * io->cfg.block_count;
+}
+
+/// Подсказка ядру: окно [start, start + window) понадобится скоро
+static void io_readahead_advise_window(IoReadahead *io, int64_t start) {
+    int64_t len = io_readahead_window(io);
+    if (start + len > io->size) {
+        len = io->size - start;
+    }
+    if (len <= 0) {
+        return;
+    }
+    if (io->map) {
+        madvise(io->map + start, (size_t)len, MADV_WILLNEED);
+    } else if (io->cfg.use_fadvise) {
+        posix_fadvise(io->fd, (off_t)start, (off_t)len, POSIX_FADV_WILLNEED);
+    }
+}
+
+static void *io_readahead_thread(void *arg) {
+    IoReadahead *io = (IoReadahead *)arg;
+    const int64_t bs = io->cfg.block_size;
+
+    pthread_mutex_lock(&io->mutex);
+    for (;;) {
+        while (!io->abort &&
+               (io->error || io->filled == io->cfg.block_count ||
+                io->win_start + io->filled * bs >= io->size)) {
+            pthread_cond_wait(&io->cond_fill, &io->mutex);
+        }
+        if (io->abort) {
+            break;
+        }
+
+        int slot = (io->head + io->filled) % io->cfg.block_count;
+        int64_t off = io->win_start + io->filled * bs;
+        int64_t want = io->size - off < bs ? io->size - off : bs;
+        unsigned int generation = io->generation;
+        pthread_mutex_unlock(&io->mutex);
+
+        // Слот в хвосте кольца: demux thread его не читает, пока он не опубликован
+        ssize_t n = io_readahead_pread_full(io->fd, io->blocks[slot], (size_t)want, off);
+
+        pthread_mutex_lock(&io->mutex);
+        if (generation != io->generation) {
+            continue;  // Окно сброшено seek'ом — блок устарел
+        }
+        if (n != want) {
+            ALOGE("❌ IO readahead: pread failed at %lld (got %zd of %lld)",
+                  (long long)off, n, (long long)want);
+            io->error = true;
+        } else {
+            io->lens[slot] = (int)n;
+            io->filled++;
+            io->stats.bytes_fetched += n;
+        }
+        pthread_cond_broadcast(&io->cond_data);
+    }
+    pthread_mutex_unlock(&io->mutex);
+    return NULL;
+}
+
+/// Сбросить окно на блок, содержащий pos (под mutex)
+static void io_readahead_reset_locked(IoReadahead *io, int64_t pos) {
+    io->win_start = pos - pos % io->cfg.block_size;
+    io->filled = 0;
+    io->error = false;
+    io->generation++;
+    io->stats.seeks++;
+    if (io->cfg.use_fadvise) {
+        io_readahead_advise_window(io, io->win_start);
+    }
+    pthread_cond_broadcast(&io->cond_fill);
+}
+
+static int io_readahead_read_mmap(IoReadahead *io, uint8_t *buf, int buf_size) {
+    int64_t n = io->size - io->pos < buf_size ? io->size - io->pos : buf_size;
+
+    if (io->pos < io->advised_start || io->pos >= io->advised_end) {
+        io->advised_start = io->pos - io->pos % io->cfg.block_size;
+        io->advised_end = io->advised_start + io_readahead_window(io) / 2;
+        io_readahead_advise_window(io, io->advised_start);
+    }
+
+    int64_t t0 = av_gettime_relative();
+    memcpy(buf, io->map + io->pos, (size_t)n);
+    int64_t dt = av_gettime_relative() - t0;
+
+    pthread_mutex_lock(&io->mutex);
+    io->stats.reads++;
+    io->stats.bytes_read += n;
+    io->stats.bytes_fetched += n;
+    if (dt >= IO_READAHEAD_MMAP_STALL_US) {
+        io->stats.stalls++;
+        io->stats.stall_us += dt;
+    }
+    pthread_mutex_unlock(&io->mutex);
+
+    io->pos += n;
+    return (int)n;
+}
+
+static int io_readahead_read(void *opaque, uint8_t *buf, int buf_size) {
+    IoReadahead *io = (IoReadahead *)opaque;
+
+    if (io->pos >= io->size) {
+        return AVERROR_EOF;
+    }
+    if (io->map) {
+        return io_readahead_read_mmap(io, buf, buf_size);
+    }
+
+    const int64_t bs = io->cfg.block_size;
+    pthread_mutex_lock(&io->mutex);
+    io->stats.reads++;
+
+    if (io->pos < io->win_start || io->pos >= io->win_start + io_readahead_window(io)) {
+        io_readahead_reset_locked(io, io->pos);
+    }
+    // Прочитанные блоки → свободные слоты для потока
+    while (io->filled > 0 && io->pos >= io->win_start + bs) {
+        io->head = (io->head + 1) % io->cfg.block_count;
+        io->filled--;
+        io->win_start += bs;
+        pthread_cond_broadcast(&io->cond_fill);
+    }
+    // Прыжок вперёд внутри окна, до которого поток ещё не дошёл
+    if (io->filled == 0 && io->pos >= io->win_start + bs) {
+        io_readahead_reset_locked(io, io->pos);
+    }
+
+    if (io->filled == 0 && !io->error && !io->abort) {
+        int64_t t0 = av_gettime_relative();
+        while (io->filled == 0 && !io->error && !io->abort) {
+            pthread_cond_wait(&io->cond_data, &io->mutex);
+        }
+        io->stats.stalls++;
+        io->stats.stall_us += av_gettime_relative() - t0;
+    }
+
+    if (io->abort || io->error) {
+        int err = io->abort ? AVERROR_EXIT : AVERROR(EIO);
+        pthread_mutex_unlock(&io->mutex);
+        return err;
+    }
+
+    int slot = io->head;
+    int64_t off = io->pos - io->win_start;
+    int64_t n = io->lens[slot] - off;
+    if (n > buf_size) {
+        n = buf_size;
+    }
+    io->stats.bytes_read += n;
+    pthread_mutex_unlock(&io->mutex);
+
+    // Голова кольца принадлежит читателю: поток пишет только в хвост
+    memcpy(buf, io->blocks[slot] + off, (size_t)n);
+    io->pos += n;
+    return (int)n;
+}
+
+static int64_t io_readahead_seek(void *opaque, int64_t offset, int whence) {
+    IoReadahead *io = (IoReadahead *)opaque;
+    int64_t pos;
+
+    whence &= ~AVSEEK_FORCE;
+    switch (whence) {
+    case AVSEEK_SIZE:
+        return io->size;
+    case SEEK_SET:
+        pos = offset;
+        break;
+    case SEEK_CUR:
+        pos = io->pos + offset;
+        break;
+    case SEEK_END:
+        pos = io->size + offset;
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    if (pos < 0) {
+        return AVERROR(EINVAL);
+    }
+
+    // Окно сбрасывается лениво в read: мелкие seek'и demuxer'а внутри окна бесплатны
+    io->pos = pos;
+    return pos;
+}
+
+IoReadahead *io_readahead_open(const char *path, AVFormatContext **fmt) {
+    if (!path || !fmt || *fmt) {
+        return NULL;
+    }
+
+    IoReadaheadConfig cfg = io_readahead_get_config();
+    if (!cfg.enabled) {
+        return NULL;
+    }
+
+    const char *local = io_readahead_local_path(path);
+    if (!local) {
+        return NULL;
+    }
+
+    int fd = open(local, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ALOGW("⚠️ IO readahead: open failed (%s), fallback to file protocol", strerror(errno));
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    IoReadahead *io = calloc(1, sizeof(IoReadahead));
+    if (!io) {
+        close(fd);
+        return NULL;
+    }
+    io->fd = fd;
+    io->size = (int64_t)st.st_size;
+    io->cfg = cfg;
+    io->stats.file_size = io->size;
+    pthread_mutex_init(&io->mutex, NULL);
+    pthread_cond_init(&io->cond_fill, NULL);
+    pthread_cond_init(&io->cond_data, NULL);
+
+    if (cfg.use_fadvise) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    if (cfg.use_mmap && (uint64_t)io->size <= (uint64_t)SIZE_MAX) {
+        void *map = mmap(NULL, (size_t)io->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            io->map = map;
+            madvise(io->map, (size_t)io->size, MADV_SEQUENTIAL);
+            io->advised_end = -1;  // Первый read выставит окно
+        } else {
+            // 32-bit адресное пространство / FUSE без mmap → read-ahead поток
+            ALOGW("⚠️ IO readahead: mmap failed (%s), using read-ahead thread", strerror(errno));
+        }
+    }
+
+    if (!io->map) {
+        io->blocks = calloc((size_t)cfg.block_count, sizeof(uint8_t *));
+        io->lens = calloc((size_t)cfg.block_count, sizeof(int));
+        bool ok = io->blocks && io->lens;
+        for (int i = 0; ok && i < cfg.block_count; i++) {
+            io->blocks[i] = av_malloc((size_t)cfg.block_size);
+            ok = io->blocks[i] != NULL;
+        }
+        if (!ok || pthread_create(&io->thread, NULL, io_readahead_thread, io) != 0) {
+            ALOGE("❌ IO readahead: Failed to allocate ring / start thread");
+            io_readahead_close(&io);
+            return NULL;
+        }
+        io->thread_started = true;
+    }
+
+    uint8_t *avio_buffer = av_malloc(IO_READAHEAD_AVIO_BUFFER_SIZE);
+    if (avio_buffer) {
+        io->avio = avio_alloc_context(avio_buffer, IO_READAHEAD_AVIO_BUFFER_SIZE, 0, io,
+                                      io_readahead_read, NULL, io_readahead_seek);
+        if (!io->avio) {
+            av_free(avio_buffer);
+        }
+    }
+    *fmt = io->avio ? avformat_alloc_context() : NULL;
+    if (!*fmt) {
+        ALOGE("❌ IO readahead: Failed to allocate AVIOContext");
+        io_readahead_close(&io);
+        return NULL;
+    }
+    (*fmt)->pb = io->avio;
+    (*fmt)->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    ALOGI("💾 IO readahead: %s (%lld bytes, %s)", local, (long long)io->size,
+          io->map ? "mmap" : "read-ahead thread");
+    return io;
+}
+
+void io_readahead_get_stats(IoReadahead *io, IoStats *out) {
+    if (!io || !out) {
+        return;
+    }
+    pthread_mutex_lock(&io->mutex);
+    *out = io->stats;
+    pthread_mutex_unlock(&io->mutex);
+}
+
+void io_readahead_close(IoReadahead **pio) {
+    if (!pio || !*pio) {
+        return;
+    }
+    IoReadahead *io = *pio;
+
+    if (io->thread_started) {
+        pthread_mutex_lock(&io->mutex);
+        io->abort = true;
+        pthread_cond_broadcast(&io->cond_fill);
+        pthread_cond_broadcast(&io->cond_data);
+        pthread_mutex_unlock(&io->mutex);
+        pthread_join(io->thread, NULL);
+    }
+
+    if (io->avio) {
+        av_freep(&io->avio->buffer);
+        avio_context_free(&io->avio);
+    }
+    if (io->blocks) {
+        for (int i = 0; i < io->cfg.block_count; i++) {
+            av_free(io->blocks[i]);
+        }
+        free(io->blocks);
+    }
+    free(io->lens);
+    if (io->map) {
+        munmap(io->map, (size_t)io->size);
+    }
+    close(io->fd);
+
+    pthread_cond_destroy(&io->cond_data);
+    pthread_cond_destroy(&io->cond_fill);
+    pthread_mutex_destroy(&io->mutex);
+    free(io);
+    *pio = NULL;
+}
+
+void io_readahead_close_input(AVFormatContext **fmt, IoReadahead **io) {
+    if (fmt && *fmt) {
+        avformat_close_input(fmt);
+    }
+    if (!io || !*io) {
+        return;
+    }
+
+    IoStats s;
+    io_readahead_get_stats(*io, &s);
+    ALOGI("📊 IO readahead: read=%.1fMB fetched=%.1fMB reads=%lld seeks=%lld stalls=%lld (%.1f ms)",
+          s.bytes_read / 1048576.0, s.bytes_fetched / 1048576.0, (long long)s.reads,
+          (long long)s.seeks, (long long)s.stalls, s.stall_us / 1000.0);
+    io_readahead_close(io);
+}
@@ -0,0 +1,79 @@
+/// 🔥 IO READAHEAD: custom AVIOContext для локальных файлов
+///
+/// file protocol читает файл блоками по 32KB прямо в demux thread: на
+/// медленной SD-карте каждый промах page cache — это stall av_read_frame,
+/// и high-bitrate файлы оставляют декодеры без пакетов.
+///
+/// Read-ahead поток заполняет кольцо больших блоков (pread) впереди позиции
+/// demuxer'а, AVIO read callback только копирует из готового блока.
+/// Альтернатива — mmap всего файла (+ madvise), без потока.
+///
+/// Opt-in: по умолчанию выключено, включается io_readahead_set_config().
+
+#ifndef IO_READAHEAD_H
+#define IO_READAHEAD_H
+
+#include "libavformat/avformat.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define IO_READAHEAD_DEFAULT_BLOCK_SIZE (1024 * 1024)
+#define IO_READAHEAD_DEFAULT_BLOCK_COUNT 8
+#define IO_READAHEAD_MAX_BLOCK_SIZE (16 * 1024 * 1024)
+#define IO_READAHEAD_MAX_BLOCK_COUNT 64
+
+/// Настройки I/O слоя (глобальные: open_media и native_preview)
+typedef struct IoReadaheadConfig {
+    bool enabled;      // false → avformat_open_input(path) как раньше
+    int block_size;    // Размер блока кольца (байты)
+    int block_count;   // Число блоков (окно read-ahead = block_size * block_count)
+    bool use_fadvise;  // posix_fadvise SEQUENTIAL + WILLNEED на окно
+    bool use_mmap;     // mmap всего файла вместо read-ahead потока
+} IoReadaheadConfig;
+
+/// Статистика I/O одного файла
+typedef struct IoStats {
+    int64_t file_size;
+    int64_t bytes_read;    // Отдано demuxer'у
+    int64_t bytes_fetched; // Прочитано с диска read-ahead потоком
+    int64_t reads;         // Вызовов read callback
+    int64_t seeks;         // Сбросов окна (seek вне окна)
+    int64_t stalls;        // read ждал read-ahead поток
+    int64_t stall_us;      // Суммарное время ожидания
+} IoStats;
+
+typedef struct IoReadahead IoReadahead;
+
+/// Установить настройки (применяются к следующему open)
+///
+/// @param cfg Настройки (размеры клампятся), NULL — значения по умолчанию (выключено)
+void io_readahead_set_config(const IoReadaheadConfig *cfg);
+
+/// Текущие настройки
+IoReadaheadConfig io_readahead_get_config(void);
+
+/// Открыть файл через read-ahead слой, если он включён и путь локальный
+///
+/// При успехе *fmt — новый AVFormatContext с custom pb: вызывающий передаёт его
+/// в avformat_open_input(fmt, path, ...) как обычно.
+///
+/// @param path Путь (или file:path)
+/// @param fmt AVFormatContext (должен быть NULL)
+/// @return Слой или NULL (выключено / не локальный файл / ошибка → обычный file protocol)
+IoReadahead *io_readahead_open(const char *path, AVFormatContext **fmt);
+
+/// Статистика (можно вызывать из любого потока)
+void io_readahead_get_stats(IoReadahead *io, IoStats *out);
+
+/// Освободить слой (после avformat_close_input: custom pb он не освобождает)
+///
+/// @param io Указатель на слой (обнуляется), NULL допустим
+void io_readahead_close(IoReadahead **io);
+
+/// avformat_close_input + io_readahead_close (со сводкой статистики в лог)
+///
+/// @param fmt AVFormatContext (обнуляется)
+/// @param io Слой (обнуляется), *io == NULL — обычный file protocol
+void io_readahead_close_input(AVFormatContext **fmt, IoReadahead **io);
+
+#endif // IO_READAHEAD_H
@@ -0,0 +1,331 @@
+/// 🔥 KEYFRAME INDEX: sidecar-индекс keyframe'ов (см. keyframe_index.h)
+///
+/// Формат sidecar (<cache_dir>/<fnv1a64(path)>.kfi, native endian):
+///   char     magic[4] = "SKFI"
+///   uint32_t version
+///   int64_t  file_size, file_mtime   — проверка актуальности
+///   int32_t  stream_index, tb_num, tb_den
+///   uint32_t count
+///   KeyframeIndexEntry entries[count]
+
+#include "keyframe_index.h"
+#include "libavutil/time.h"  // av_gettime_relative
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "platform_log.h"
+
+#define LOG_TAG "KeyframeIndex"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define ALOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+#define KEYFRAME_INDEX_MAGIC "SKFI"
+#define KEYFRAME_INDEX_VERSION 1
+
+/// Защита от мусорного sidecar (24 байта на keyframe → 48MB)
+#define KEYFRAME_INDEX_MAX_ENTRIES (2 * 1024 * 1024)
+
+typedef struct KeyframeIndexHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t file_size;
+    int64_t file_mtime;
+    int32_t stream_index;
+    int32_t tb_num;
+    int32_t tb_den;
+    uint32_t count;
+} KeyframeIndexHeader;
+
+static pthread_mutex_t g_cache_dir_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char *g_cache_dir = NULL;
+
+void keyframe_index_set_cache_dir(const char *dir) {
+    if (dir && dir[0] && mkdir(dir, 0700) != 0 && errno != EEXIST) {
+        ALOGW("⚠️ Cannot create keyframe index cache dir: %s", dir);
+    }
+
+    pthread_mutex_lock(&g_cache_dir_mutex);
+    free(g_cache_dir);
+    g_cache_dir = (dir && dir[0]) ? strdup(dir) : NULL;
+    pthread_mutex_unlock(&g_cache_dir_mutex);
+
+    ALOGI("📇 Keyframe index cache dir: %s", dir ? dir : "(none)");
+}
+
+/// Путь к sidecar для файла
+///
+/// @return false если каталог не задан
+static bool sidecar_path(const char *path, char *out, size_t out_size) {
+    // FNV-1a 64: имя sidecar не зависит от длины / символов пути
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+
+    pthread_mutex_lock(&g_cache_dir_mutex);
+    bool ok = g_cache_dir != NULL;
+    if (ok) {
+        snprintf(out, out_size, "%s/%016llx.kfi", g_cache_dir, (unsigned long long)hash);
+    }
+    pthread_mutex_unlock(&g_cache_dir_mutex);
+    return ok;
+}
+
+static bool file_identity(const char *path, int64_t *size, int64_t *mtime) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return false;
+    }
+    *size = (int64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+    return true;
+}
+
+static KeyframeIndex *keyframe_index_alloc(int stream_index, AVRational time_base) {
+    KeyframeIndex *idx = (KeyframeIndex *)calloc(1, sizeof(KeyframeIndex));
+    if (idx) {
+        idx->stream_index = stream_index;
+        idx->time_base = time_base;
+    }
+    return idx;
+}
+
+static int keyframe_index_append(KeyframeIndex *idx, int64_t pts, int64_t dts, int64_t pos) {
+    if (idx->count == idx->capacity) {
+        int capacity = idx->capacity ? idx->capacity * 2 : 1024;
+        KeyframeIndexEntry *entries = realloc(idx->entries, capacity * sizeof(KeyframeIndexEntry));
+        if (!entries) {
+            return -1;
+        }
+        idx->entries = entries;
+        idx->capacity = capacity;
+    }
+    idx->entries[idx->count].pts = pts;
+    idx->entries[idx->count].dts = dts;
+    idx->entries[idx->count].pos = pos;
+    idx->count++;
+    return 0;
+}
+
+static int cmp_entry_pts(const void *a, const void *b) {
+    int64_t x = ((const KeyframeIndexEntry *)a)->pts;
+    int64_t y = ((const KeyframeIndexEntry *)b)->pts;
+    return (x > y) - (x < y);
+}
+
+bool keyframe_index_wanted(AVFormatContext *fmt, int stream_index) {
+    if (!fmt || !fmt->iformat || stream_index < 0 || stream_index >= (int)fmt->nb_streams) {
+        return false;
+    }
+    if (!fmt->pb || !(fmt->pb->seekable & AVIO_SEEKABLE_NORMAL)) {
+        return false;  // сеть / pipe: сканировать нечего
+    }
+
+    // MPEG-TS индекса не бывает: seek — бинарный поиск по байтам
+    if (strcmp(fmt->iformat->name, "mpegts") == 0) {
+        return true;
+    }
+
+    // AVI без idx1, FLV без keyframes в metadata и любой другой demuxer,
+    // который не построил индекс при открытии. Полный индекс — сканировать незачем
+    return avformat_index_get_entries_count(fmt->streams[stream_index]) < 2;
+}
+
+KeyframeIndex *keyframe_index_load(const char *path, int stream_index, AVRational time_base) {
+    char sidecar[1024];
+    int64_t size, mtime;
+    if (!path || !sidecar_path(path, sidecar, sizeof(sidecar)) || !file_identity(path, &size, &mtime)) {
+        return NULL;
+    }
+
+    FILE *f = fopen(sidecar, "rb");
+    if (!f) {
+        return NULL;
+    }
+
+    KeyframeIndex *idx = NULL;
+    KeyframeIndexHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+        memcmp(hdr.magic, KEYFRAME_INDEX_MAGIC, 4) != 0 ||
+        hdr.version != KEYFRAME_INDEX_VERSION ||
+        hdr.file_size != size || hdr.file_mtime != mtime ||
+        hdr.stream_index != stream_index ||
+        hdr.tb_num != time_base.num || hdr.tb_den != time_base.den ||
+        hdr.count == 0 || hdr.count > KEYFRAME_INDEX_MAX_ENTRIES) {
+        ALOGI("📇 Sidecar stale or invalid: %s", sidecar);
+        fclose(f);
+        return NULL;
+    }
+
+    idx = keyframe_index_alloc(stream_index, time_base);
+    if (idx) {
+        idx->entries = malloc(hdr.count * sizeof(KeyframeIndexEntry));
+        if (idx->entries && fread(idx->entries, sizeof(KeyframeIndexEntry), hdr.count, f) == hdr.count) {
+            idx->count = idx->capacity = (int)hdr.count;
+        } else {
+            keyframe_index_free(&idx);
+        }
+    }
+    fclose(f);
+
+    if (idx) {
+        ALOGI("📇 Sidecar loaded: %d keyframes (%s)", idx->count, sidecar);
+    }
+    return idx;
+}
+
+/// Сохранить sidecar (tmp + rename: читатель никогда не увидит половину файла)
+static void keyframe_index_save(const KeyframeIndex *idx, const char *path) {
+    char sidecar[1024], tmp[1040];
+    int64_t size, mtime;
+    if (!sidecar_path(path, sidecar, sizeof(sidecar)) || !file_identity(path, &size, &mtime)) {
+        return;
+    }
+    snprintf(tmp, sizeof(tmp), "%s.tmp", sidecar);
+
+    FILE *f = fopen(tmp, "wb");
+    if (!f) {
+        ALOGW("⚠️ Cannot write sidecar: %s", tmp);
+        return;
+    }
+
+    KeyframeIndexHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, KEYFRAME_INDEX_MAGIC, 4);
+    hdr.version = KEYFRAME_INDEX_VERSION;
+    hdr.file_size = size;
+    hdr.file_mtime = mtime;
+    hdr.stream_index = idx->stream_index;
+    hdr.tb_num = idx->time_base.num;
+    hdr.tb_den = idx->time_base.den;
+    hdr.count = (uint32_t)idx->count;
+
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+              fwrite(idx->entries, sizeof(KeyframeIndexEntry), idx->count, f) == (size_t)idx->count;
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok || rename(tmp, sidecar) != 0) {
+        ALOGW("⚠️ Failed to save sidecar: %s", sidecar);
+        remove(tmp);
+        return;
+    }
+    ALOGI("📇 Sidecar saved: %d keyframes (%s)", idx->count, sidecar);
+}
+
+KeyframeIndex *keyframe_index_build(const char *path, int stream_index, atomic_bool *abort) {
+    AVFormatContext *fmt = NULL;
+    if (!path || avformat_open_input(&fmt, path, NULL, NULL) < 0) {
+        ALOGE("❌ keyframe_index_build: cannot open %s", path ? path : "(null)");
+        return NULL;
+    }
+    // MPEG-TS создаёт стримы по мере чтения: без probe индекса стрима может ещё не быть
+    if (stream_index >= (int)fmt->nb_streams) {
+        avformat_find_stream_info(fmt, NULL);
+    }
+    if (stream_index < 0 || stream_index >= (int)fmt->nb_streams ||
+        fmt->streams[stream_index]->codecpar->codec_type != AVMEDIA_TYPE_VIDEO) {
+        avformat_close_input(&fmt);
+        return NULL;
+    }
+
+    // От video пакетов нужны только pts/flags (payload всё равно читается), остальные стримы пропускаем
+    for (unsigned int i = 0; i < fmt->nb_streams; i++) {
+        fmt->streams[i]->discard = ((int)i == stream_index) ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+
+    AVStream *st = fmt->streams[stream_index];
+    KeyframeIndex *idx = keyframe_index_alloc(stream_index, st->time_base);
+    AVPacket *pkt = av_packet_alloc();
+    int64_t start_us = av_gettime_relative();
+    bool aborted = false;
+    bool sorted = true;
+
+    while (idx && pkt) {
+        if (abort && atomic_load(abort)) {
+            aborted = true;
+            break;
+        }
+        if (av_read_frame(fmt, pkt) < 0) {
+            break;  // EOF или ошибка чтения: берём то, что успели
+        }
+
+        if (pkt->stream_index == stream_index && (pkt->flags & AV_PKT_FLAG_KEY) && pkt->pos >= 0) {
+            int64_t dts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
+            int64_t pts = pkt->pts != AV_NOPTS_VALUE ? pkt->pts : dts;
+            if (pts != AV_NOPTS_VALUE) {
+                if (idx->count > 0 && pts < idx->entries[idx->count - 1].pts) {
+                    sorted = false;
+                }
+                if (keyframe_index_append(idx, pts, dts, pkt->pos) < 0) {
+                    av_packet_unref(pkt);
+                    break;
+                }
+            }
+        }
+        av_packet_unref(pkt);
+    }
+
+    av_packet_free(&pkt);
+    avformat_close_input(&fmt);
+
+    if (!idx || aborted || idx->count == 0) {
+        keyframe_index_free(&idx);
+        return NULL;
+    }
+
+    if (!sorted) {
+        qsort(idx->entries, idx->count, sizeof(KeyframeIndexEntry), cmp_entry_pts);
+    }
+
+    ALOGI("📇 Keyframe index built: %d keyframes in %.1f ms (%s)",
+          idx->count, (av_gettime_relative() - start_us) / 1000.0, path);
+
+    keyframe_index_save(idx, path);
+    return idx;
+}
+
+int keyframe_index_lookup(const KeyframeIndex *idx, int64_t ts) {
+    if (!idx || idx->count == 0 || ts < idx->entries[0].pts) {
+        return -1;
+    }
+
+    int lo = 0, hi = idx->count - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (idx->entries[mid].pts <= ts) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+int keyframe_index_apply(const KeyframeIndex *idx, AVStream *st) {
+    if (!idx || !st) {
+        return 0;
+    }
+
+    int added = 0;
+    for (int i = 0; i < idx->count; i++) {
+        if (av_add_index_entry(st, idx->entries[i].pos, idx->entries[i].dts,
+                               0, 0, AVINDEX_KEYFRAME) >= 0) {
+            added++;
+        }
+    }
+    return added;
+}
+
+void keyframe_index_free(KeyframeIndex **idx) {
+    if (!idx || !*idx) {
+        return;
+    }
+    free((*idx)->entries);
+    free(*idx);
+    *idx = NULL;
+}
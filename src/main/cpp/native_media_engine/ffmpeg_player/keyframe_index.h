@@ -0,0 +1,88 @@
+/// 🔥 KEYFRAME INDEX: sidecar-индекс keyframe'ов для файлов без seek-индекса
+///
+/// AVI с битым idx1, FLV без keyframes-метаданных и MPEG-TS не дают
+/// av_seek_frame индекса → seek превращается в линейное сканирование.
+/// Индекс строится один раз (фоновым потоком), сохраняется в app cache
+/// и подаётся demuxer'у через av_add_index_entry: perform_fast_seek,
+/// step_prev_frame и preview ищут keyframe бинарным поиском.
+
+#ifndef KEYFRAME_INDEX_H
+#define KEYFRAME_INDEX_H
+
+#include "libavformat/avformat.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Keyframe в индексе (time_base стрима)
+typedef struct KeyframeIndexEntry {
+    int64_t pts;  // PTS (lookup по позиции пользователя)
+    int64_t dts;  // DTS (timestamp для av_add_index_entry, как у demuxer'ов)
+    int64_t pos;  // Байтовое смещение пакета в файле
+} KeyframeIndexEntry;
+
+/// Индекс keyframe'ов одного video стрима (отсортирован по pts)
+typedef struct KeyframeIndex {
+    KeyframeIndexEntry *entries;
+    int count;
+    int capacity;
+    int stream_index;
+    AVRational time_base;
+} KeyframeIndex;
+
+/// Установить каталог для sidecar-файлов (app cache, например getCacheDir()/kfindex)
+///
+/// Без каталога индекс строится, но не сохраняется между сессиями.
+///
+/// @param dir Каталог (копируется), NULL — отключить sidecar
+void keyframe_index_set_cache_dir(const char *dir);
+
+/// Нужен ли индекс стриму
+///
+/// @param fmt Открытый AVFormatContext
+/// @param stream_index Video стрим
+/// @return true для MPEG-TS и для стримов без собственного индекса (AVI без idx1, FLV без keyframes)
+bool keyframe_index_wanted(AVFormatContext *fmt, int stream_index);
+
+/// Загрузить sidecar (если есть и соответствует файлу: размер + mtime)
+///
+/// @param path Путь к медиафайлу
+/// @param stream_index Video стрим
+/// @param time_base time_base стрима (должен совпасть с сохранённым)
+/// @return Индекс или NULL
+KeyframeIndex *keyframe_index_load(const char *path, int stream_index, AVRational time_base);
+
+/// Построить индекс сканированием файла (отдельный AVFormatContext) и сохранить sidecar
+///
+/// Полный проход по файлу: av_read_frame читает payload каждого video пакета
+/// целиком (нужны только pts/flags), пакеты остальных стримов — AVDISCARD_ALL.
+/// I/O порядка размера video потока — запускать только в фоне.
+///
+/// @param path Путь к медиафайлу
+/// @param stream_index Video стрим
+/// @param abort Флаг прерывания (проверяется на каждом пакете), может быть NULL
+/// @return Индекс или NULL (ошибка / прервано / keyframe'ов нет)
+KeyframeIndex *keyframe_index_build(const char *path, int stream_index, atomic_bool *abort);
+
+/// Найти последний keyframe с pts <= ts (бинарный поиск)
+///
+/// @param idx Индекс
+/// @param ts Timestamp в time_base стрима
+/// @return Индекс записи или -1, если ts раньше первого keyframe
+int keyframe_index_lookup(const KeyframeIndex *idx, int64_t ts);
+
+/// Передать индекс demuxer'у (av_add_index_entry)
+///
+/// ⚠️ Только в потоке, который владеет fmt (demux thread или до его старта)
+///
+/// @param idx Индекс
+/// @param st Video стрим
+/// @return Число добавленных записей
+int keyframe_index_apply(const KeyframeIndex *idx, AVStream *st);
+
+/// Освободить индекс
+///
+/// @param idx Указатель на индекс (обнуляется)
+void keyframe_index_free(KeyframeIndex **idx);
+
+#endif // KEYFRAME_INDEX_H
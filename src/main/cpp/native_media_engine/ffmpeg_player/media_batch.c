@@ -0,0 +1,235 @@
+/// 🔥 MEDIA BATCH: пул worker'ов над MediaHandle (см. media_batch.h)
+
+#include "media_batch.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"  // av_gettime_relative
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "platform_log.h"
+
+#define LOG_TAG "MediaBatch"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+
+/// Готовый результат в очереди на доставку
+typedef struct MediaBatchItem {
+    MediaBatchResult result;
+    struct MediaBatchItem *next;
+} MediaBatchItem;
+
+typedef struct MediaBatch {
+    const char *const *paths;
+    int count;
+    const MediaBatchRequest *request;
+
+    atomic_int next_index;
+    atomic_bool abort;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;         // Результат готов / worker завершился / место в очереди
+    MediaBatchItem *head;
+    MediaBatchItem *tail;
+    int queued;
+    int max_queued;
+    int workers_running;
+} MediaBatch;
+
+int media_batch_default_threads(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1) {
+        return 1;
+    }
+    return cores > MEDIA_BATCH_MAX_THREADS ? MEDIA_BATCH_MAX_THREADS : (int)cores;
+}
+
+/// Один файл: open → запрошенные выходы → close
+static void media_batch_process(const MediaBatchRequest *request, MediaBatchResult *r) {
+    int64_t t0 = av_gettime_relative();
+    r->duration_ms = -1;
+    r->info_status = MEDIA_HANDLE_ERR_ARGS;
+    r->thumb_status = MEDIA_HANDLE_ERR_ARGS;
+
+    MediaHandle *handle = NULL;
+    r->status = media_handle_open(r->path, &handle, &r->averror);
+    if (r->status == MEDIA_HANDLE_OK) {
+        if (request->outputs & MEDIA_BATCH_DURATION) {
+            r->duration_ms = media_handle_duration_ms(handle);
+        }
+        if (request->outputs & MEDIA_BATCH_INFO) {
+            r->info_status = media_handle_get_info(handle, &r->info);
+        }
+        if (request->outputs & MEDIA_BATCH_THUMBNAIL) {
+            r->thumb_status = media_handle_thumbnail_size(handle, request->thumb_width, request->thumb_height,
+                                                          &r->thumb_width, &r->thumb_height);
+            if (r->thumb_status == MEDIA_HANDLE_OK && request->thumb_format != MEDIA_THUMB_RGBA) {
+                // Сжатие в worker'е: на вызывающий поток (JNI) уходят килобайты, а не w * h * 4
+                r->thumb_status = media_handle_thumbnail_encoded(handle, request->thumb_time_ms, r->thumb_width,
+                                                                 r->thumb_height, request->thumb_mode,
+                                                                 request->thumb_format, request->thumb_quality,
+                                                                 &r->thumb_data, &r->thumb_size);
+            } else if (r->thumb_status == MEDIA_HANDLE_OK) {
+                r->thumb_size = r->thumb_width * r->thumb_height * 4;
+                r->thumb_data = av_malloc(r->thumb_size);
+                r->thumb_status = r->thumb_data
+                    ? media_handle_thumbnail_rgba(handle, request->thumb_time_ms, r->thumb_width,
+                                                  r->thumb_height, request->thumb_mode,
+                                                  r->thumb_data, r->thumb_width * 4)
+                    : MEDIA_HANDLE_ERR_NOMEM;
+            }
+            if (r->thumb_status != MEDIA_HANDLE_OK) {
+                av_freep(&r->thumb_data);
+                r->thumb_size = 0;
+            }
+        }
+        media_handle_close(&handle);
+    }
+    r->elapsed_us = av_gettime_relative() - t0;
+}
+
+static void *media_batch_worker(void *arg) {
+    MediaBatch *b = arg;
+
+    for (;;) {
+        // Backpressure: не уходить далеко вперёд медленного callback'а
+        pthread_mutex_lock(&b->lock);
+        while (b->queued >= b->max_queued && !atomic_load(&b->abort)) {
+            pthread_cond_wait(&b->cond, &b->lock);
+        }
+        pthread_mutex_unlock(&b->lock);
+
+        if (atomic_load(&b->abort)) {
+            break;
+        }
+        int index = atomic_fetch_add(&b->next_index, 1);
+        if (index >= b->count) {
+            break;
+        }
+
+        MediaBatchItem *item = calloc(1, sizeof(MediaBatchItem));
+        if (!item) {
+            ALOGE("❌ Out of memory at %d", index);
+            atomic_store(&b->abort, true);
+            break;
+        }
+        item->result.index = index;
+        item->result.path = b->paths[index];
+        media_batch_process(b->request, &item->result);
+
+        pthread_mutex_lock(&b->lock);
+        if (b->tail) {
+            b->tail->next = item;
+        } else {
+            b->head = item;
+        }
+        b->tail = item;
+        b->queued++;
+        pthread_cond_broadcast(&b->cond);
+        pthread_mutex_unlock(&b->lock);
+    }
+
+    pthread_mutex_lock(&b->lock);
+    b->workers_running--;
+    pthread_cond_broadcast(&b->cond);
+    pthread_mutex_unlock(&b->lock);
+    return NULL;
+}
+
+int media_batch_run(const char *const *paths, int count, const MediaBatchRequest *request, int threads,
+                    MediaBatchCallback callback, void *opaque) {
+    if (!paths || count < 0 || !request) {
+        return -1;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    if (threads <= 0) {
+        threads = media_batch_default_threads();
+    }
+    if (threads > MEDIA_BATCH_MAX_THREADS) {
+        threads = MEDIA_BATCH_MAX_THREADS;
+    }
+    if (threads > count) {
+        threads = count;
+    }
+
+    MediaBatch b;
+    memset(&b, 0, sizeof(b));
+    b.paths = paths;
+    b.count = count;
+    b.request = request;
+    b.max_queued = threads * 2;
+    atomic_init(&b.next_index, 0);
+    atomic_init(&b.abort, false);
+    pthread_mutex_init(&b.lock, NULL);
+    pthread_cond_init(&b.cond, NULL);
+
+    int64_t t0 = av_gettime_relative();
+    pthread_t tids[MEDIA_BATCH_MAX_THREADS];
+    int started = 0;
+    for (; started < threads; started++) {
+        pthread_mutex_lock(&b.lock);
+        b.workers_running++;
+        pthread_mutex_unlock(&b.lock);
+        if (pthread_create(&tids[started], NULL, media_batch_worker, &b) != 0) {
+            pthread_mutex_lock(&b.lock);
+            b.workers_running--;
+            pthread_mutex_unlock(&b.lock);
+            break;
+        }
+    }
+    if (started == 0) {
+        ALOGE("❌ Could not start batch workers");
+        pthread_cond_destroy(&b.cond);
+        pthread_mutex_destroy(&b.lock);
+        return -1;
+    }
+
+    // Доставка на вызывающем потоке в порядке готовности
+    int delivered = 0;
+    pthread_mutex_lock(&b.lock);
+    for (;;) {
+        while (!b.head && b.workers_running > 0) {
+            pthread_cond_wait(&b.cond, &b.lock);
+        }
+        MediaBatchItem *item = b.head;
+        if (!item) {
+            break;
+        }
+        b.head = item->next;
+        if (!b.head) {
+            b.tail = NULL;
+        }
+        b.queued--;
+        pthread_cond_broadcast(&b.cond);
+        pthread_mutex_unlock(&b.lock);
+
+        if (!atomic_load(&b.abort)) {
+            delivered++;
+            if (callback && callback(opaque, &item->result) != 0) {
+                atomic_store(&b.abort, true);
+                pthread_mutex_lock(&b.lock);
+                pthread_cond_broadcast(&b.cond);
+                pthread_mutex_unlock(&b.lock);
+            }
+        }
+        av_free(item->result.thumb_data);
+        free(item);
+
+        pthread_mutex_lock(&b.lock);
+    }
+    pthread_mutex_unlock(&b.lock);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    pthread_cond_destroy(&b.cond);
+    pthread_mutex_destroy(&b.lock);
+
+    ALOGI("📦 Batch: %d/%d files on %d workers (%.1f ms)%s", delivered, count, started,
+          (av_gettime_relative() - t0) / 1000.0, atomic_load(&b.abort) ? ", cancelled" : "");
+    return delivered;
+}
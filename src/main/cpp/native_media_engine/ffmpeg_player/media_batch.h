@@ -0,0 +1,77 @@
+/// 🔥 MEDIA BATCH: duration / метаданные / thumbnail для списка файлов на пуле потоков
+///
+/// Галерея вызывала SmartFfmpegBridge на каждый файл из корутин: параллелизм
+/// никак не ограничен, десятки decoder'ов 4K одновременно. Batch обрабатывает
+/// файлы фиксированным числом worker'ов (по умолчанию — по числу ядер; decoder'ы
+/// handle однопоточные), каждый файл — один MediaHandle (open / probe один раз).
+///
+/// Результаты приходят в callback на вызывающем потоке в порядке готовности:
+/// JNI не нужно attach'ить worker'ы к JVM, а callback не обязан быть потокобезопасным.
+
+#ifndef MEDIA_BATCH_H
+#define MEDIA_BATCH_H
+
+#include <stdint.h>
+#include "media_handle.h"
+
+#define MEDIA_BATCH_MAX_THREADS 8
+
+/// Что извлекать из каждого файла (битовая маска)
+typedef enum MediaBatchOutput {
+    MEDIA_BATCH_DURATION = 1 << 0,
+    MEDIA_BATCH_INFO = 1 << 1,
+    MEDIA_BATCH_THUMBNAIL = 1 << 2,
+} MediaBatchOutput;
+
+/// Запрос, общий для всех файлов batch'а
+typedef struct MediaBatchRequest {
+    int outputs;                    // MediaBatchOutput
+    int64_t thumb_time_ms;
+    int thumb_width;                // 0 → исходный размер по этой оси
+    int thumb_height;
+    MediaThumbnailMode thumb_mode;
+    MediaThumbnailFormat thumb_format;  // RGBA или сжатый JPEG / WebP (thumb_encode.h)
+    int thumb_quality;                  // 1..100 для JPEG / WebP
+} MediaBatchRequest;
+
+/// Результат одного файла (действителен только внутри callback)
+typedef struct MediaBatchResult {
+    int index;                      // Индекс в paths
+    const char *path;
+    MediaHandleStatus status;       // media_handle_open; не OK → остальные поля пусты
+    int averror;                    // AVERROR причины open / probe
+    int64_t duration_ms;            // MEDIA_BATCH_DURATION, -1 если неизвестна
+    MediaHandleStatus info_status;  // MEDIA_BATCH_INFO
+    MediaInfo info;
+    MediaHandleStatus thumb_status; // MEDIA_BATCH_THUMBNAIL
+    int thumb_width;
+    int thumb_height;
+    uint8_t *thumb_data;            // RGBA или JPEG / WebP (thumb_format), NULL при ошибке
+    int thumb_size;                 // Байт в thumb_data
+    int64_t elapsed_us;             // Обработка файла worker'ом (open → close)
+} MediaBatchResult;
+
+/// Callback результата (вызывающий поток media_batch_run)
+///
+/// @return 0 — продолжать, иначе — отменить оставшиеся файлы
+typedef int (*MediaBatchCallback)(void *opaque, const MediaBatchResult *result);
+
+/// Число worker'ов по умолчанию: ядра, не больше MEDIA_BATCH_MAX_THREADS
+int media_batch_default_threads(void);
+
+/// Обработать paths на пуле worker'ов (блокирует до конца или отмены)
+///
+/// Worker'ы не уходят дальше чем на 2 * threads готовых, но не отданных
+/// результатов вперёд: медленный callback не копит thumbnail'ы в памяти.
+///
+/// @param paths Пути к файлам
+/// @param count Число файлов
+/// @param request Что извлекать
+/// @param threads Число worker'ов (<= 0 → media_batch_default_threads)
+/// @param callback Вызывается для каждого файла, может быть NULL
+/// @param opaque Аргумент callback
+/// @return Число доставленных результатов, -1 при ошибке аргументов / потоков
+int media_batch_run(const char *const *paths, int count, const MediaBatchRequest *request, int threads,
+                    MediaBatchCallback callback, void *opaque);
+
+#endif // MEDIA_BATCH_H
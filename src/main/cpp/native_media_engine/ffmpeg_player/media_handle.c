@@ -0,0 +1,685 @@
+/// 🔥 MEDIA HANDLE: open once → много запросов / thumbnails → close (см. media_handle.h)
+
+#include "media_handle.h"
+#include "io_readahead.h"
+#include "keyframe_index.h"
+#include "probe_cache.h"
+#include "rgba_convert.h"
+#include "thumb_encode.h"
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libavutil/time.h"  // av_gettime_relative
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform_log.h"
+
+#define LOG_TAG "MediaHandle"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define ALOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+#define MEDIA_SPRITE_MAX_COUNT 1024
+#define MEDIA_SPRITE_MAX_DIMENSION 16384
+
+struct MediaHandle {
+    pthread_mutex_t mutex;
+    AVFormatContext *fmt;
+    IoReadahead *io;
+    int video_stream;
+    int audio_stream;
+    int subtitle_count;
+
+    // Тёплые между вызовами (создаются при первом thumbnail)
+    AVCodecContext *dec;
+    AVFrame *frame;
+    AVPacket *pkt;
+    int decoder_failed;  // avcodec_open2 уже падал — не повторять на каждом thumbnail
+    int dec_lowres;      // lowres открытого decoder'а (меняется только переоткрытием)
+};
+
+MediaHandleStatus media_handle_open(const char *path, MediaHandle **out, int *averror) {
+    if (averror) {
+        *averror = 0;
+    }
+    if (!path || !out) {
+        return MEDIA_HANDLE_ERR_ARGS;
+    }
+    *out = NULL;
+
+    MediaHandle *h = calloc(1, sizeof(MediaHandle));
+    if (!h) {
+        return MEDIA_HANDLE_ERR_NOMEM;
+    }
+    pthread_mutex_init(&h->mutex, NULL);
+    h->video_stream = -1;
+    h->audio_stream = -1;
+
+    int64_t t0 = av_gettime_relative();
+    h->io = io_readahead_open(path, &h->fmt);
+    int ret = avformat_open_input(&h->fmt, path, NULL, NULL);
+    if (ret < 0) {
+        ALOGE("❌ Could not open: %s", path);
+        io_readahead_close(&h->io);  // avformat_open_input не освобождает custom pb
+        media_handle_close(&h);
+        if (averror) {
+            *averror = ret;
+        }
+        return MEDIA_HANDLE_ERR_OPEN;
+    }
+
+    ret = probe_cache_find_stream_info(h->fmt, path);
+    if (ret < 0) {
+        ALOGE("❌ Could not find stream info: %s", path);
+        media_handle_close(&h);
+        if (averror) {
+            *averror = ret;
+        }
+        return MEDIA_HANDLE_ERR_PROBE;
+    }
+
+    // Первый video / audio стрим (как в прежних SmartFfmpegBridge вызовах)
+    for (unsigned int i = 0; i < h->fmt->nb_streams; i++) {
+        enum AVMediaType type = h->fmt->streams[i]->codecpar->codec_type;
+        if (type == AVMEDIA_TYPE_VIDEO && h->video_stream == -1) {
+            h->video_stream = (int)i;
+        } else if (type == AVMEDIA_TYPE_AUDIO && h->audio_stream == -1) {
+            h->audio_stream = (int)i;
+        } else if (type == AVMEDIA_TYPE_SUBTITLE) {
+            h->subtitle_count++;
+        }
+    }
+
+    // 🔥 KEYFRAME INDEX: sidecar плеера (AVI / FLV / TS) → seek и hop'ы sprite sheet по индексу
+    if (h->video_stream >= 0 && keyframe_index_wanted(h->fmt, h->video_stream)) {
+        AVStream *st = h->fmt->streams[h->video_stream];
+        KeyframeIndex *kf_index = keyframe_index_load(path, h->video_stream, st->time_base);
+        if (kf_index) {
+            keyframe_index_apply(kf_index, st);
+            keyframe_index_free(&kf_index);
+        }
+    }
+
+    ALOGI("📂 Opened %s: video=%d audio=%d (%.1f ms)", path, h->video_stream, h->audio_stream,
+          (av_gettime_relative() - t0) / 1000.0);
+    *out = h;
+    return MEDIA_HANDLE_OK;
+}
+
+void media_handle_close(MediaHandle **handle) {
+    if (!handle || !*handle) {
+        return;
+    }
+    MediaHandle *h = *handle;
+
+    av_frame_free(&h->frame);
+    av_packet_free(&h->pkt);
+    avcodec_free_context(&h->dec);
+    io_readahead_close_input(&h->fmt, &h->io);
+
+    pthread_mutex_destroy(&h->mutex);
+    free(h);
+    *handle = NULL;
+}
+
+int64_t media_handle_duration_ms(MediaHandle *h) {
+    if (!h) {
+        return -1;
+    }
+    pthread_mutex_lock(&h->mutex);
+    int64_t duration = h->fmt->duration != AV_NOPTS_VALUE ? h->fmt->duration / (AV_TIME_BASE / 1000) : -1;
+    pthread_mutex_unlock(&h->mutex);
+    return duration;
+}
+
+MediaHandleStatus media_handle_get_info(MediaHandle *h, MediaInfo *out) {
+    if (!h || !out) {
+        return MEDIA_HANDLE_ERR_ARGS;
+    }
+    if (h->video_stream < 0) {
+        return MEDIA_HANDLE_ERR_NO_VIDEO;
+    }
+
+    pthread_mutex_lock(&h->mutex);
+    memset(out, 0, sizeof(*out));
+    AVStream *st = h->fmt->streams[h->video_stream];
+    const AVCodecParameters *par = st->codecpar;
+    const AVCodec *codec = avcodec_find_decoder(par->codec_id);
+
+    out->width = par->width;
+    out->height = par->height;
+    out->duration_ms = h->fmt->duration != AV_NOPTS_VALUE ? h->fmt->duration / (AV_TIME_BASE / 1000) : -1;
+    snprintf(out->codec, sizeof(out->codec), "%s", codec ? codec->name : "");
+    out->bit_rate = par->bit_rate > 0 ? par->bit_rate : 0;
+
+    AVRational frame_rate = av_guess_frame_rate(h->fmt, st, NULL);
+    if (frame_rate.num > 0 && frame_rate.den > 0) {
+        out->fps = (double)frame_rate.num / (double)frame_rate.den;
+    }
+
+    AVDictionaryEntry *rotate_tag = av_dict_get(st->metadata, "rotate", NULL, 0);
+    if (rotate_tag && rotate_tag->value) {
+        out->rotation = atoi(rotate_tag->value);
+    }
+
+    snprintf(out->container, sizeof(out->container), "%s",
+             (h->fmt->iformat && h->fmt->iformat->name) ? h->fmt->iformat->name : "");
+    out->stream_count = (int)h->fmt->nb_streams;
+    out->has_audio = h->audio_stream != -1;
+    out->has_subtitles = h->subtitle_count > 0;
+
+    if (h->audio_stream != -1) {
+        const AVCodecParameters *apar = h->fmt->streams[h->audio_stream]->codecpar;
+        const AVCodec *acodec = avcodec_find_decoder(apar->codec_id);
+        snprintf(out->audio_codec, sizeof(out->audio_codec), "%s", acodec ? acodec->name : "");
+        out->sample_rate = apar->sample_rate > 0 ? apar->sample_rate : 0;
+        out->channels = apar->ch_layout.nb_channels > 0 ? apar->ch_layout.nb_channels : 0;
+    }
+    pthread_mutex_unlock(&h->mutex);
+    return MEDIA_HANDLE_OK;
+}
+
+MediaHandleStatus media_handle_thumbnail_size(MediaHandle *h, int width, int height,
+                                              int *out_width, int *out_height) {
+    if (!h || !out_width || !out_height) {
+        return MEDIA_HANDLE_ERR_ARGS;
+    }
+    if (h->video_stream < 0) {
+        return MEDIA_HANDLE_ERR_NO_VIDEO;
+    }
+    const AVCodecParameters *par = h->fmt->streams[h->video_stream]->codecpar;
+    *out_width = width > 0 ? width : par->width;
+    *out_height = height > 0 ? height : par->height;
+    return (*out_width > 0 && *out_height > 0) ? MEDIA_HANDLE_OK : MEDIA_HANDLE_ERR_DECODE;
+}
+
+int media_thumbnail_lowres(int max_lowres, int src_width, int src_height, int width, int height) {
+    int lowres = 0;
+    while (lowres < max_lowres &&
+           (src_width >> (lowres + 1)) >= width && (src_height >> (lowres + 1)) >= height) {
+        lowres++;
+    }
+    return lowres;
+}
+
+/// lowres для thumbnail width x height (0 — полное разрешение)
+static int media_handle_lowres_for(MediaHandle *h, int width, int height) {
+    const AVCodecParameters *par = h->fmt->streams[h->video_stream]->codecpar;
+    const AVCodec *codec = avcodec_find_decoder(par->codec_id);
+    return codec ? media_thumbnail_lowres(codec->max_lowres, par->width, par->height, width, height) : 0;
+}
+
+/// Открыть video decoder (под mutex, один раз на handle; повторно — только при смене lowres)
+static MediaHandleStatus media_handle_open_decoder(MediaHandle *h, int lowres) {
+    if (h->dec && h->dec_lowres == lowres) {
+        return MEDIA_HANDLE_OK;
+    }
+    if (h->decoder_failed) {
+        return MEDIA_HANDLE_ERR_DECODE;
+    }
+    avcodec_free_context(&h->dec);
+
+    const AVCodecParameters *par = h->fmt->streams[h->video_stream]->codecpar;
+    const AVCodec *codec = avcodec_find_decoder(par->codec_id);
+    if (!codec) {
+        ALOGE("❌ Unsupported codec: %d", par->codec_id);
+        h->decoder_failed = 1;
+        return MEDIA_HANDLE_ERR_DECODE;
+    }
+
+    h->dec = avcodec_alloc_context3(codec);
+    if (!h->frame) {
+        h->frame = av_frame_alloc();
+    }
+    if (!h->pkt) {
+        h->pkt = av_packet_alloc();
+    }
+    if (!h->dec || !h->frame || !h->pkt) {
+        avcodec_free_context(&h->dec);
+        return MEDIA_HANDLE_ERR_NOMEM;
+    }
+
+    if (avcodec_parameters_to_context(h->dec, par) < 0) {
+        ALOGE("❌ Could not copy codec parameters: %s", codec->name);
+        avcodec_free_context(&h->dec);
+        h->decoder_failed = 1;
+        return MEDIA_HANDLE_ERR_DECODE;
+    }
+    h->dec->lowres = lowres;  // До avcodec_open2: после open не меняется
+    if (avcodec_open2(h->dec, codec, NULL) < 0) {
+        ALOGE("❌ Could not open codec: %s", codec->name);
+        avcodec_free_context(&h->dec);
+        h->decoder_failed = 1;
+        return MEDIA_HANDLE_ERR_DECODE;
+    }
+    h->dec_lowres = lowres;
+
+    ALOGI("✅ Decoder opened: %s %dx%d (lowres=%d)", codec->name, h->dec->width, h->dec->height, lowres);
+    return MEDIA_HANDLE_OK;
+}
+
+/// Кадр после seek (под mutex) → h->frame: пакеты → decoder, на EOF — drain
+///
+/// target == AV_NOPTS_VALUE → первый декодированный кадр (с keyframes_only —
+/// первый keyframe), иначе первый кадр с pts >= target (или последний перед EOF).
+static int media_handle_decode_frame(MediaHandle *h, int64_t target, int keyframes_only) {
+    AVFrame *last = NULL;  // Последний кадр < target (fallback на EOF)
+    int draining = 0;
+    int ret;
+
+    for (;;) {
+        if (!draining) {
+            ret = av_read_frame(h->fmt, h->pkt);
+            if (ret < 0) {
+                // EOF: кадры, задержанные decoder'ом (B-frames / frame threading)
+                avcodec_send_packet(h->dec, NULL);
+                draining = 1;
+            } else if (h->pkt->stream_index != h->video_stream ||
+                       (keyframes_only && !(h->pkt->flags & AV_PKT_FLAG_KEY))) {
+                av_packet_unref(h->pkt);
+                continue;
+            } else {
+                ret = avcodec_send_packet(h->dec, h->pkt);
+                av_packet_unref(h->pkt);
+                if (ret < 0 && ret != AVERROR(EAGAIN)) {
+                    continue;  // Битый пакет — пробуем следующий
+                }
+            }
+        }
+
+        while ((ret = avcodec_receive_frame(h->dec, h->frame)) == 0) {
+            int64_t pts = h->frame->best_effort_timestamp != AV_NOPTS_VALUE
+                ? h->frame->best_effort_timestamp : h->frame->pts;
+            if (target == AV_NOPTS_VALUE || pts == AV_NOPTS_VALUE || pts >= target) {
+                av_frame_free(&last);
+                return 0;
+            }
+            if (!last && !(last = av_frame_alloc())) {
+                av_frame_unref(h->frame);
+                return AVERROR(ENOMEM);
+            }
+            av_frame_unref(last);
+            av_frame_move_ref(last, h->frame);
+        }
+        if (ret != AVERROR(EAGAIN)) {
+            break;  // AVERROR_EOF после drain или ошибка decoder'а
+        }
+        if (draining) {
+            break;
+        }
+    }
+
+    // target за последним кадром файла — отдаём последний
+    if (last && last->buf[0]) {
+        av_frame_move_ref(h->frame, last);
+        ret = 0;
+    } else if (ret == 0 || ret == AVERROR(EAGAIN)) {
+        ret = AVERROR_EOF;
+    }
+    av_frame_free(&last);
+    return ret;
+}
+
+/// Seek + decode кадра thumbnail в h->frame (под mutex; decoder открывается здесь)
+static MediaHandleStatus media_handle_decode_thumbnail(MediaHandle *h, int64_t time_ms,
+                                                       int width, int height, MediaThumbnailMode mode) {
+    int fast = mode == MEDIA_THUMB_FAST;
+    MediaHandleStatus status = media_handle_open_decoder(h, fast ? media_handle_lowres_for(h, width, height) : 0);
+    if (status != MEDIA_HANDLE_OK) {
+        return status;
+    }
+
+    AVStream *st = h->fmt->streams[h->video_stream];
+    int64_t timestamp = av_rescale_q(time_ms, (AVRational){ 1, 1000 }, st->time_base);
+    if (st->start_time != AV_NOPTS_VALUE) {
+        timestamp += st->start_time;
+    }
+    if (av_seek_frame(h->fmt, h->video_stream, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+        ALOGW("⚠️ Could not seek to %lld ms", (long long)time_ms);
+    }
+    // Decoder тёплый, но референсы от прошлого thumbnail недействительны после seek
+    avcodec_flush_buffers(h->dec);
+
+    // 🔥 FAST: decoder отбрасывает не-ключевые кадры и deblocking (для превью незаметно)
+    h->dec->skip_frame = fast ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+    h->dec->skip_loop_filter = fast ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+
+    int ret = media_handle_decode_frame(h, fast ? AV_NOPTS_VALUE : timestamp, fast);
+    if (ret < 0 && fast) {
+        // Demuxer без флагов keyframe'ов — повтор без фильтрации пакетов
+        ALOGW("⚠️ No keyframe after %lld ms, retrying with full decode", (long long)time_ms);
+        av_seek_frame(h->fmt, h->video_stream, timestamp, AVSEEK_FLAG_BACKWARD);
+        avcodec_flush_buffers(h->dec);
+        h->dec->skip_frame = AVDISCARD_DEFAULT;
+        ret = media_handle_decode_frame(h, AV_NOPTS_VALUE, 0);
+    }
+    if (ret < 0) {
+        ALOGE("❌ Could not decode frame at %lld ms", (long long)time_ms);
+        return MEDIA_HANDLE_ERR_DECODE;
+    }
+    return MEDIA_HANDLE_OK;
+}
+
+MediaHandleStatus media_handle_thumbnail_rgba(MediaHandle *h, int64_t time_ms,
+                                              int width, int height, MediaThumbnailMode mode,
+                                              uint8_t *dst, int dst_stride) {
+    if (!h || !dst || width <= 0 || height <= 0 || dst_stride < width * 4) {
+        return MEDIA_HANDLE_ERR_ARGS;
+    }
+    if (h->video_stream < 0) {
+        return MEDIA_HANDLE_ERR_NO_VIDEO;
+    }
+
+    pthread_mutex_lock(&h->mutex);
+    int64_t t0 = av_gettime_relative();
+    MediaHandleStatus status = media_handle_decode_thumbnail(h, time_ms, width, height, mode);
+    if (status != MEDIA_HANDLE_OK) {
+        pthread_mutex_unlock(&h->mutex);
+        return status;
+    }
+
+    AVFrame *frame = h->frame;
+    int ret = rgba_convert_frame(frame, width, height, dst, dst_stride);
+    av_frame_unref(frame);
+    if (ret < 0) {
+        ALOGE("❌ Could not convert frame to RGBA");
+        pthread_mutex_unlock(&h->mutex);
+        return MEDIA_HANDLE_ERR_DECODE;
+    }
+
+    ALOGI("🖼 Thumbnail %dx%d at %lld ms (%s, %.1f ms)", width, height, (long long)time_ms,
+          mode == MEDIA_THUMB_FAST ? "fast" : "exact", (av_gettime_relative() - t0) / 1000.0);
+    pthread_mutex_unlock(&h->mutex);
+    return MEDIA_HANDLE_OK;
+}
+
+MediaHandleStatus media_handle_thumbnail_encoded(MediaHandle *h, int64_t time_ms,
+                                                 int width, int height, MediaThumbnailMode mode,
+                                                 MediaThumbnailFormat format, int quality,
+                                                 uint8_t **out_data, int *out_size) {
+    if (!h || !out_data || !out_size || width <= 0 || height <= 0 || format == MEDIA_THUMB_RGBA) {
+        return MEDIA_HANDLE_ERR_ARGS;
+    }
+    *out_data = NULL;
+    *out_size = 0;
+    if (h->video_stream < 0) {
+        return MEDIA_HANDLE_ERR_NO_VIDEO;
+    }
+    // До seek / decode: без encoder'а в сборке работа всё равно пропадёт
+    if (!thumb_encode_supported(format)) {
+        return MEDIA_HANDLE_ERR_UNSUPPORTED;
+    }
+
+    pthread_mutex_lock(&h->mutex);
+    int64_t t0 = av_gettime_relative();
+    MediaHandleStatus status = media_handle_decode_thumbnail(h, time_ms, width, height, mode);
+    if (status != MEDIA_HANDLE_OK) {
+        pthread_mutex_unlock(&h->mutex);
+        return status;
+    }
+
+    int ret = thumb_encode_frame(h->frame, width, height, format, quality, out_data, out_size);
+    av_frame_unref(h->frame);
+    pthread_mutex_unlock(&h->mutex);
+    if (ret == AVERROR_ENCODER_NOT_FOUND) {
+        return MEDIA_HANDLE_ERR_UNSUPPORTED;
+    }
+    if (ret < 0) {
+        return MEDIA_HANDLE_ERR_DECODE;
+    }
+
+    ALOGI("🖼 Thumbnail %dx%d at %lld ms → %s %d bytes (q=%d, %.1f ms)", width, height, (long long)time_ms,
+          format == MEDIA_THUMB_JPEG ? "JPEG" : "WebP", *out_size, quality,
+          (av_gettime_relative() - t0) / 1000.0);
+    return MEDIA_HANDLE_OK;
+}
+
+int media_sprite_sheet_size(const MediaSpriteSpec *spec, int *out_width, int *out_height) {
+    if (!spec || !out_width || !out_height ||
+        spec->count <= 0 || spec->count > MEDIA_SPRITE_MAX_COUNT ||
+        spec->tile_width <= 0 || spec->tile_height <= 0) {
+        return -1;
+    }
+    int columns = (spec->columns > 0 && spec->columns < spec->count) ? spec->columns : spec->count;
+    int rows = (spec->count + columns - 1) / columns;
+    if ((int64_t)columns * spec->tile_width > MEDIA_SPRITE_MAX_DIMENSION ||
+        (int64_t)rows * spec->tile_height > MEDIA_SPRITE_MAX_DIMENSION) {
+        return -1;
+    }
+    *out_width = columns * spec->tile_width;
+    *out_height = rows * spec->tile_height;
+    return 0;
+}
+
+/// Состояние одного прохода sprite sheet (под mutex handle)
+typedef struct SpritePass {
+    MediaHandle *h;
+    const MediaSpriteSpec *spec;
+    AVStream *st;
+    int columns;
+    uint8_t *dst;
+    int dst_stride;
+    int64_t *out_pts_ms;
+    int64_t *targets;       // Time base стрима, по возрастанию
+    int next;               // Следующая незаполненная ячейка
+    AVFrame *held;          // Последний декодированный кадр
+    int has_held;
+    int64_t last_read_dts;  // Последний прочитанный video пакет после seek (NOPTS — ещё нет)
+    int hops;
+} SpritePass;
+
+static int64_t sprite_frame_pts(const AVFrame *frame) {
+    return frame->best_effort_timestamp != AV_NOPTS_VALUE ? frame->best_effort_timestamp : frame->pts;
+}
+
+/// Отмасштабировать кадр в ячейку next
+static int sprite_emit(SpritePass *p, const AVFrame *frame) {
+    const MediaSpriteSpec *spec = p->spec;
+
+    int col = p->next % p->columns;
+    int row = p->next / p->columns;
+    uint8_t *cell = p->dst + (size_t)row * spec->tile_height * p->dst_stride + (size_t)col * spec->tile_width * 4;
+    if (rgba_convert_frame(frame, spec->tile_width, spec->tile_height, cell, p->dst_stride) < 0) {
+        ALOGE("❌ Could not convert frame to RGBA");
+        return -1;
+    }
+
+    if (p->out_pts_ms) {
+        int64_t pts = sprite_frame_pts(frame);
+        int64_t start = p->st->start_time != AV_NOPTS_VALUE ? p->st->start_time : 0;
+        p->out_pts_ms[p->next] = pts != AV_NOPTS_VALUE
+            ? av_rescale_q(pts - start, p->st->time_base, (AVRational){ 1, 1000 })
+            : -1;
+    }
+    p->next++;
+    return 0;
+}
+
+/// Раздать декодированный кадр ячейкам, чьи targets он закрывает
+static int sprite_process_frame(SpritePass *p, AVFrame *frame) {
+    int64_t pts = sprite_frame_pts(frame);
+    if (pts == AV_NOPTS_VALUE) {
+        pts = p->targets[p->next];  // Без timestamp — в текущую ячейку
+    }
+
+    if (p->spec->mode == MEDIA_SPRITE_EVEN) {
+        // Первый кадр с pts >= target
+        while (p->next < p->spec->count && pts >= p->targets[p->next]) {
+            if (sprite_emit(p, frame) < 0) {
+                return -1;
+            }
+        }
+    } else {
+        // Последний keyframe с pts <= target: кадр дальше target закрывает его предыдущим
+        while (p->next < p->spec->count && pts > p->targets[p->next]) {
+            if (sprite_emit(p, p->has_held ? p->held : frame) < 0) {
+                return -1;
+            }
+        }
+    }
+
+    av_frame_unref(p->held);
+    av_frame_move_ref(p->held, frame);
+    p->has_held = 1;
+    return 0;
+}
+
+/// Есть ли по индексу keyframe ≤ следующего target дальше уже прочитанного
+static int sprite_should_hop(SpritePass *p) {
+    if (p->last_read_dts == AV_NOPTS_VALUE) {
+        return 0;
+    }
+    int idx = av_index_search_timestamp(p->st, p->targets[p->next], AVSEEK_FLAG_BACKWARD);
+    if (idx < 0) {
+        return 0;
+    }
+    const AVIndexEntry *entry = avformat_index_get_entry(p->st, idx);
+    return entry && entry->timestamp > p->last_read_dts;
+}
+
+static int sprite_seek(SpritePass *p, int64_t target) {
+    int ret = av_seek_frame(p->h->fmt, p->h->video_stream, target, AVSEEK_FLAG_BACKWARD);
+    avcodec_flush_buffers(p->h->dec);
+    p->last_read_dts = AV_NOPTS_VALUE;
+    return ret;
+}
+
+MediaHandleStatus media_handle_sprite_sheet(MediaHandle *h, const MediaSpriteSpec *spec,
+                                            uint8_t *dst, int dst_stride, int64_t *out_pts_ms) {
+    int sheet_width, sheet_height;
+    if (!h || !dst || media_sprite_sheet_size(spec, &sheet_width, &sheet_height) < 0 ||
+        dst_stride < sheet_width * 4) {
+        return MEDIA_HANDLE_ERR_ARGS;
+    }
+    if (h->video_stream < 0) {
+        return MEDIA_HANDLE_ERR_NO_VIDEO;
+    }
+
+    pthread_mutex_lock(&h->mutex);
+    int keyframes = spec->mode == MEDIA_SPRITE_KEYFRAME;
+    MediaHandleStatus status = media_handle_open_decoder(
+        h, keyframes ? media_handle_lowres_for(h, spec->tile_width, spec->tile_height) : 0);
+    if (status != MEDIA_HANDLE_OK) {
+        pthread_mutex_unlock(&h->mutex);
+        return status;
+    }
+
+    SpritePass p;
+    memset(&p, 0, sizeof(p));
+    p.h = h;
+    p.spec = spec;
+    p.st = h->fmt->streams[h->video_stream];
+    p.columns = (spec->columns > 0 && spec->columns < spec->count) ? spec->columns : spec->count;
+    p.dst = dst;
+    p.dst_stride = dst_stride;
+    p.out_pts_ms = out_pts_ms;
+    p.last_read_dts = AV_NOPTS_VALUE;
+
+    // Диапазон: end_ms <= 0 → длительность файла (или стрима)
+    int64_t end_ms = spec->end_ms;
+    if (end_ms <= 0 && h->fmt->duration != AV_NOPTS_VALUE) {
+        end_ms = h->fmt->duration / (AV_TIME_BASE / 1000);
+    }
+    if (end_ms <= 0 && p.st->duration != AV_NOPTS_VALUE) {
+        end_ms = av_rescale_q(p.st->duration, p.st->time_base, (AVRational){ 1, 1000 });
+    }
+    if (end_ms <= spec->start_ms) {
+        ALOGE("❌ Sprite sheet: empty range [%lld, %lld) ms", (long long)spec->start_ms, (long long)end_ms);
+        pthread_mutex_unlock(&h->mutex);
+        return MEDIA_HANDLE_ERR_ARGS;
+    }
+
+    p.targets = malloc(sizeof(int64_t) * (size_t)spec->count);
+    p.held = av_frame_alloc();
+    if (!p.targets || !p.held) {
+        free(p.targets);
+        av_frame_free(&p.held);
+        pthread_mutex_unlock(&h->mutex);
+        return MEDIA_HANDLE_ERR_NOMEM;
+    }
+
+    // Центры count равных отрезков
+    int64_t start_ts = p.st->start_time != AV_NOPTS_VALUE ? p.st->start_time : 0;
+    int64_t span_ms = end_ms - spec->start_ms;
+    for (int i = 0; i < spec->count; i++) {
+        int64_t target_ms = spec->start_ms + span_ms * (2 * i + 1) / (2 * spec->count);
+        p.targets[i] = start_ts + av_rescale_q(target_ms, (AVRational){ 1, 1000 }, p.st->time_base);
+    }
+
+    int64_t t0 = av_gettime_relative();
+    h->dec->skip_frame = keyframes ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+    h->dec->skip_loop_filter = keyframes ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+
+    int hops_enabled = sprite_seek(&p, p.targets[0]) >= 0;
+    int hop_checked = 0;
+    int failed = 0;
+    int packets = 0;
+
+    while (!failed && p.next < spec->count) {
+        // Новая ячейка: промежуток до её keyframe'а не читаем, если индекс позволяет
+        if (hops_enabled && hop_checked != p.next) {
+            hop_checked = p.next;
+            if (sprite_should_hop(&p)) {
+                hops_enabled = sprite_seek(&p, p.targets[p.next]) >= 0;
+                p.hops++;
+            }
+        }
+
+        int ret = av_read_frame(h->fmt, h->pkt);
+        if (ret < 0) {
+            break;
+        }
+        if (h->pkt->stream_index != h->video_stream) {
+            av_packet_unref(h->pkt);
+            continue;
+        }
+        packets++;
+        int64_t dts = h->pkt->dts != AV_NOPTS_VALUE ? h->pkt->dts : h->pkt->pts;
+        if (dts != AV_NOPTS_VALUE) {
+            p.last_read_dts = dts;
+        }
+        // KEYFRAME: не-ключевые пакеты не доходят до decoder'а вовсе
+        if (keyframes && !(h->pkt->flags & AV_PKT_FLAG_KEY)) {
+            av_packet_unref(h->pkt);
+            continue;
+        }
+
+        ret = avcodec_send_packet(h->dec, h->pkt);
+        av_packet_unref(h->pkt);
+        if (ret < 0 && ret != AVERROR(EAGAIN)) {
+            continue;  // Битый пакет — пробуем следующий
+        }
+        while (!failed && p.next < spec->count && avcodec_receive_frame(h->dec, h->frame) == 0) {
+            failed = sprite_process_frame(&p, h->frame) < 0;
+        }
+    }
+
+    // EOF: кадры, задержанные decoder'ом, затем последний кадр — в оставшиеся ячейки
+    if (!failed && p.next < spec->count) {
+        avcodec_send_packet(h->dec, NULL);
+        while (!failed && p.next < spec->count && avcodec_receive_frame(h->dec, h->frame) == 0) {
+            failed = sprite_process_frame(&p, h->frame) < 0;
+        }
+    }
+    while (!failed && p.has_held && p.next < spec->count) {
+        failed = sprite_emit(&p, p.held) < 0;
+    }
+
+    avcodec_flush_buffers(h->dec);
+    av_frame_unref(h->frame);
+
+    if (failed || p.next < spec->count) {
+        status = MEDIA_HANDLE_ERR_DECODE;
+        ALOGE("❌ Sprite sheet: %d of %d tiles", p.next, spec->count);
+    } else {
+        ALOGI("🎞 Sprite sheet %dx%d: %d tiles (%s), %d video packets, %d hops, %.1f ms",
+              sheet_width, sheet_height, spec->count,
+              keyframes ? "keyframes" : "even",
+              packets, p.hops, (av_gettime_relative() - t0) / 1000.0);
+    }
+
+    av_frame_free(&p.held);
+    free(p.targets);
+    pthread_mutex_unlock(&h->mutex);
+    return status;
+}
@@ -0,0 +1,176 @@
+/// 🔥 MEDIA HANDLE: open once → много запросов / thumbnails → close
+///
+/// SmartFfmpegBridge.extractThumbnail / getVideoDuration / getVideoMetadata
+/// открывали и пробили файл на каждый вызов; галерея делает 3 вызова на файл.
+/// Handle держит AVFormatContext и video decoder открытыми (SwsContext — в общем sws_cache):
+/// повторный thumbnail платит только seek + decode.
+///
+/// Handle потокобезопасен (mutex на handle), но запросы к одному handle
+/// выполняются последовательно — для параллелизма нужны разные handle.
+
+#ifndef MEDIA_HANDLE_H
+#define MEDIA_HANDLE_H
+
+#include <stdint.h>
+
+/// Результат media_handle_open
+typedef enum MediaHandleStatus {
+    MEDIA_HANDLE_OK = 0,
+    MEDIA_HANDLE_ERR_OPEN,      // avformat_open_input
+    MEDIA_HANDLE_ERR_PROBE,     // find_stream_info (через probe cache)
+    MEDIA_HANDLE_ERR_NO_VIDEO,  // Запрос требует video стрим, а его нет
+    MEDIA_HANDLE_ERR_DECODE,    // Decoder не открылся / кадр не декодирован
+    MEDIA_HANDLE_ERR_NOMEM,
+    MEDIA_HANDLE_ERR_ARGS,
+    MEDIA_HANDLE_ERR_UNSUPPORTED,  // Encoder формата thumbnail отсутствует в сборке FFmpeg
+} MediaHandleStatus;
+
+/// Метаданные (поля SmartFfmpegBridge.getVideoMetadata)
+typedef struct MediaInfo {
+    int width;
+    int height;
+    int64_t duration_ms;   // -1, если неизвестна
+    char codec[32];        // Имя decoder'а ("" если нет)
+    int64_t bit_rate;      // Video стрим, 0 если неизвестен
+    double fps;            // 0, если неизвестен
+    int rotation;          // Тег "rotate" video стрима
+    char container[64];    // iformat->name
+    int stream_count;
+    int has_audio;
+    int has_subtitles;
+    char audio_codec[32];  // "" если нет audio
+    int sample_rate;
+    int channels;
+} MediaInfo;
+
+/// Режим thumbnail
+typedef enum MediaThumbnailMode {
+    MEDIA_THUMB_EXACT = 0,  // Первый кадр с pts >= time_ms (decode вперёд от keyframe'а)
+    MEDIA_THUMB_FAST = 1,   // Keyframe ≤ time_ms: skip_frame NONKEY, без loop filter, lowres
+} MediaThumbnailMode;
+
+/// Формат результата thumbnail
+typedef enum MediaThumbnailFormat {
+    MEDIA_THUMB_RGBA = 0,  // RGBA8888, width * height * 4
+    MEDIA_THUMB_JPEG = 1,  // MJPEG encoder libavcodec (baseline JPEG, 4:2:0)
+    MEDIA_THUMB_WEBP = 2,  // libwebp через libavcodec (только если FFmpeg собран с --enable-libwebp)
+} MediaThumbnailFormat;
+
+/// Выбор кадра для ячейки sprite sheet
+typedef enum MediaSpriteMode {
+    MEDIA_SPRITE_EVEN = 0,      // Первый кадр с pts >= target (точные интервалы, декодируется всё)
+    MEDIA_SPRITE_KEYFRAME = 1,  // Последний keyframe с pts <= target (декодируются только keyframe'ы)
+} MediaSpriteMode;
+
+/// Параметры sprite sheet: count ячеек по columns в ряд, row-major
+typedef struct MediaSpriteSpec {
+    int count;
+    int tile_width;
+    int tile_height;
+    int columns;        // <= 0 → все ячейки в один ряд (strip)
+    int64_t start_ms;   // Начало диапазона
+    int64_t end_ms;     // <= 0 → длительность файла
+    MediaSpriteMode mode;
+} MediaSpriteSpec;
+
+typedef struct MediaHandle MediaHandle;
+
+/// Открыть файл (io readahead + probe cache, если включены)
+///
+/// @param path Путь к медиафайлу
+/// @param out Handle (NULL при ошибке)
+/// @param averror AVERROR причины (для av_strerror), может быть NULL
+/// @return MEDIA_HANDLE_OK или стадия, на которой open упал
+MediaHandleStatus media_handle_open(const char *path, MediaHandle **out, int *averror);
+
+/// Закрыть handle и освободить decoder / format context
+///
+/// @param handle Указатель на handle (обнуляется), NULL допустим
+void media_handle_close(MediaHandle **handle);
+
+/// Длительность файла
+///
+/// @return Миллисекунды или -1 (работает и для файлов без video)
+int64_t media_handle_duration_ms(MediaHandle *handle);
+
+/// Метаданные video стрима (+ audio, если есть)
+///
+/// @return MEDIA_HANDLE_OK или MEDIA_HANDLE_ERR_NO_VIDEO
+MediaHandleStatus media_handle_get_info(MediaHandle *handle, MediaInfo *out);
+
+/// Размер thumbnail: 0 → исходный размер по этой оси
+///
+/// @return MEDIA_HANDLE_OK или MEDIA_HANDLE_ERR_NO_VIDEO
+MediaHandleStatus media_handle_thumbnail_size(MediaHandle *handle, int width, int height,
+                                              int *out_width, int *out_height);
+
+/// Thumbnail RGBA8888 после BACKWARD seek к time_ms
+///
+/// EXACT декодирует вперёд от keyframe'а до time_ms. FAST отдаёт сам keyframe:
+/// не-ключевые пакеты не декодируются, loop filter пропускается, а decoder
+/// с поддержкой lowres (MJPEG, MPEG-2/4 и т.п.) декодирует сразу в 1/2..1/8
+/// разрешения, если thumbnail не больше. Decoder открывается при первом вызове
+/// и переиспользуется (flush после seek; переоткрывается только при смене lowres),
+/// конвертация в RGBA — rgba_convert_frame.
+///
+/// @param handle Handle
+/// @param time_ms Позиция
+/// @param width Размер (см. media_handle_thumbnail_size)
+/// @param height Размер
+/// @param mode EXACT или FAST
+/// @param dst Буфер RGBA
+/// @param dst_stride Байт на строку (>= width * 4)
+/// @return MEDIA_HANDLE_OK или ошибка
+MediaHandleStatus media_handle_thumbnail_rgba(MediaHandle *handle, int64_t time_ms,
+                                              int width, int height, MediaThumbnailMode mode,
+                                              uint8_t *dst, int dst_stride);
+
+/// Thumbnail, сжатый в JPEG / WebP (тот же seek / decode, что media_handle_thumbnail_rgba)
+///
+/// Кадр масштабируется сразу в pix_fmt encoder'а и кодируется libavcodec:
+/// вызывающему не нужен RGBA буфер и повторное сжатие.
+///
+/// @param format MEDIA_THUMB_JPEG или MEDIA_THUMB_WEBP
+/// @param quality 1..100
+/// @param out_data Результат (av_malloc, освобождать av_free)
+/// @param out_size Размер результата в байтах
+/// @return MEDIA_HANDLE_OK, MEDIA_HANDLE_ERR_UNSUPPORTED (нет encoder'а) или ошибка
+MediaHandleStatus media_handle_thumbnail_encoded(MediaHandle *handle, int64_t time_ms,
+                                                 int width, int height, MediaThumbnailMode mode,
+                                                 MediaThumbnailFormat format, int quality,
+                                                 uint8_t **out_data, int *out_size);
+
+/// Максимальный lowres, при котором декодированный кадр ещё не меньше thumbnail
+///
+/// @param max_lowres AVCodec.max_lowres (0 — decoder не умеет lowres)
+/// @param src_width Размер кадра в стриме
+/// @param src_height Размер кадра в стриме
+/// @param width Размер thumbnail
+/// @param height Размер thumbnail
+/// @return 0..max_lowres (кадр уменьшается в 2^lowres раз по каждой оси)
+int media_thumbnail_lowres(int max_lowres, int src_width, int src_height, int width, int height);
+
+/// Размер sprite sheet в пикселях
+///
+/// @return 0 при успехе, -1 при некорректном spec
+int media_sprite_sheet_size(const MediaSpriteSpec *spec, int *out_width, int *out_height);
+
+/// 🔥 SPRITE SHEET: count превью за один упорядоченный проход
+///
+/// Targets — центры count равных отрезков [start_ms, end_ms). Один seek в начало,
+/// дальше чтение вперёд; если индекс (demuxer или keyframe sidecar) показывает
+/// keyframe ≤ следующего target дальше текущей позиции — seek вперёд вместо
+/// чтения промежутка. Без индекса — ровно одно линейное чтение файла.
+/// Ячейки после EOF повторяют последний кадр.
+/// MEDIA_SPRITE_KEYFRAME декодирует как MEDIA_THUMB_FAST (lowres по размеру ячейки).
+///
+/// @param handle Handle
+/// @param spec Параметры
+/// @param dst Буфер RGBA (media_sprite_sheet_size)
+/// @param dst_stride Байт на строку sheet
+/// @param out_pts_ms Фактическое время кадра каждой ячейки (count элементов), может быть NULL
+/// @return MEDIA_HANDLE_OK или ошибка
+MediaHandleStatus media_handle_sprite_sheet(MediaHandle *handle, const MediaSpriteSpec *spec,
+                                            uint8_t *dst, int dst_stride, int64_t *out_pts_ms);
+
+#endif // MEDIA_HANDLE_H
@@ -1740,6 +1740,156 @@ Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeSeek(
     ALOGI("✅ nativeSeek: Seek completed");
 }
 
+/// 🔥 KEYFRAME INDEX: каталог sidecar-индексов (app cache), вызывается один раз при старте
+JNIEXPORT void JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeSetKeyframeIndexCacheDir(
+    JNIEnv *env, jobject thiz, jstring dir) {
+    if (!dir) {
+        keyframe_index_set_cache_dir(NULL);
+        return;
+    }
+    const char *dir_str = (*env)->GetStringUTFChars(env, dir, NULL);
+    if (!dir_str) {
+        return;
+    }
+    keyframe_index_set_cache_dir(dir_str);
+    (*env)->ReleaseStringUTFChars(env, dir, dir_str);
+}
+
+/// 🔥 PROBE CACHE: каталог кэша find_stream_info (app cache), вызывается один раз при старте
+///
+/// Общий для плеера, preview и SmartFfmpegBridge (thumbnail / metadata)
+JNIEXPORT void JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeSetProbeCacheDir(
+    JNIEnv *env, jobject thiz, jstring dir) {
+    if (!dir) {
+        probe_cache_set_dir(NULL);
+        return;
+    }
+    const char *dir_str = (*env)->GetStringUTFChars(env, dir, NULL);
+    if (!dir_str) {
+        return;
+    }
+    probe_cache_set_dir(dir_str);
+    (*env)->ReleaseStringUTFChars(env, dir, dir_str);
+}
+
+/// 🔥 PROBE CACHE: счётчики с момента запуска процесса
+///
+/// @return [hits, misses, fallbacks, stores, probe_us]
+JNIEXPORT jlongArray JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeGetProbeCacheStats(
+    JNIEnv *env, jobject thiz) {
+    ProbeCacheStats s;
+    probe_cache_get_stats(&s);
+
+    jlong values[5] = { s.hits, s.misses, s.fallbacks, s.stores, s.probe_us };
+    jlongArray result = (*env)->NewLongArray(env, 5);
+    if (result) {
+        (*env)->SetLongArrayRegion(env, result, 0, 5, values);
+    }
+    return result;
+}
+
+/// Политика потоков software video decoder'а (для следующих nativeCreatePlayerContext)
+///
+/// mode: 0 = auto, 1 = frame, 2 = slice, 3 = low latency (покадровый шаг)
+/// threads: 0 = auto (online CPU + разрешение)
+JNIEXPORT void JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeSetDecodeThreadPolicy(
+    JNIEnv *env, jobject thiz, jint mode, jint threads) {
+    ALOGI("🎬 nativeSetDecodeThreadPolicy: mode=%d, threads=%d", (int)mode, (int)threads);
+    player_set_decode_thread_policy((VideoDecodeThreadMode)mode, (int)threads);
+}
+
+/// 🔥 IO READAHEAD: opt-in I/O слой для локальных файлов (плеер и preview, следующий open)
+///
+/// blockKb / blocks: размер и число блоков кольца (0 = по умолчанию 1024KB x 8)
+/// useMmap: mmap всего файла вместо read-ahead потока
+JNIEXPORT void JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeSetIoReadahead(
+    JNIEnv *env, jobject thiz, jboolean enabled, jint blockKb, jint blocks,
+    jboolean useFadvise, jboolean useMmap) {
+    IoReadaheadConfig cfg = {
+        .enabled = enabled == JNI_TRUE,
+        .block_size = blockKb > 0 ? (int)blockKb * 1024 : 0,
+        .block_count = (int)blocks,
+        .use_fadvise = useFadvise == JNI_TRUE,
+        .use_mmap = useMmap == JNI_TRUE,
+    };
+    io_readahead_set_config(&cfg);
+}
+
+/// 🔥 IO READAHEAD: статистика I/O текущего файла
+///
+/// @return [file_size, bytes_read, bytes_fetched, reads, seeks, stalls, stall_us]
+///         или null, если файл открыт без read-ahead слоя
+JNIEXPORT jlongArray JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeGetIoStats(
+    JNIEnv *env, jobject thiz, jlong playerContext) {
+    PlayerContext *ctx = (PlayerContext *)playerContext;
+    IoStats s;
+    if (!ctx || player_get_io_stats(ctx, &s) < 0) {
+        return NULL;
+    }
+
+    jlong values[7] = {
+        s.file_size, s.bytes_read, s.bytes_fetched, s.reads, s.seeks, s.stalls, s.stall_us,
+    };
+    jlongArray result = (*env)->NewLongArray(env, 7);
+    if (result) {
+        (*env)->SetLongArrayRegion(env, result, 0, 7, values);
+    }
+    return result;
+}
+
+/// 🔥 PACKET QUEUE: переиспользование узлов demux → decoder очередей
+///
+/// @return [video_node_allocs, video_free_nodes, video_packets_put,
+///          audio_node_allocs, audio_free_nodes, audio_packets_put]
+///         или null, если файл не открыт
+JNIEXPORT jlongArray JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeGetPacketQueueStats(
+    JNIEnv *env, jobject thiz, jlong playerContext) {
+    PlayerContext *ctx = (PlayerContext *)playerContext;
+    PacketQueueStats video, audio;
+    if (!ctx || player_get_packet_queue_stats(ctx, &video, &audio) < 0) {
+        return NULL;
+    }
+
+    jlong values[6] = {
+        (jlong)video.node_allocs, video.nb_free_nodes, (jlong)video.packets_put,
+        (jlong)audio.node_allocs, audio.nb_free_nodes, (jlong)audio.packets_put,
+    };
+    jlongArray result = (*env)->NewLongArray(env, 6);
+    if (result) {
+        (*env)->SetLongArrayRegion(env, result, 0, 6, values);
+    }
+    return result;
+}
+
+/// 🔥 SCRUB: начало/конец перетаскивания seek bar
+///
+/// Во время scrub nativeSeek выполняется как fast seek и схлопывается в последний target,
+/// на scrubbing=false выполняется точный seek в последнюю позицию.
+JNIEXPORT void JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeSetScrubbing(
+    JNIEnv *env, jobject thiz, jlong playerContext, jboolean scrubbing, jboolean keyframesOnly) {
+    PlayerContext *ctx = (PlayerContext *)playerContext;
+    if (!ctx) {
+        ALOGE("❌ nativeSetScrubbing: PlayerContext is NULL");
+        return;
+    }
+
+    ALOGI("🔍 nativeSetScrubbing: scrubbing=%d, keyframesOnly=%d", (int)scrubbing, (int)keyframesOnly);
+
+    if (scrubbing) {
+        player_scrub_begin(ctx, keyframesOnly == JNI_TRUE);
+    } else {
+        player_scrub_end(ctx);
+    }
+}
+
 /// 🔥 PATCH 11: Установка скорости воспроизведения
 JNIEXPORT void JNICALL
 Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeSetPlaybackSpeed(
@@ -2382,27 +2532,14 @@ Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeClearSubtitles(
     ALOGI("✅ nativeClearSubtitles: Subtitles cleared");
 }
 
-/// 🔥 КРИТИЧЕСКИЙ FIX: JNI функция для получения preview кадра (RGBA8888 bitmap)
-/// 
-/// Preview полностью независим от PlayerContext:
-/// - Не использует EGL / Surface
-/// - Не использует render loop
-/// - Не использует threads
-/// - CPU-only декодирование
-/// 
-/// @param path Путь к видео файлу
-/// @param target_ms Целевая позиция в миллисекундах
-/// @param out_w Ширина выходного bitmap
-/// @param out_h Высота выходного bitmap
-/// @return jbyteArray с RGBA8888 данными (размер = out_w * out_h * 4) или NULL при ошибке
-JNIEXPORT jbyteArray JNICALL
-Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeGetPreviewFrame(
+/// Preview кадр → jbyteArray (общая часть nativeGetPreviewFrame / nativeGetPreviewFrameFast)
+static jbyteArray preview_frame_to_byte_array(
     JNIEnv *env,
-    jobject thiz,
     jstring path,
     jlong target_ms,
     jint out_w,
-    jint out_h
+    jint out_h,
+    MediaThumbnailMode mode
 ) {
     if (!path || out_w <= 0 || out_h <= 0) {
         ALOGE("❌ nativeGetPreviewFrame: Invalid arguments");
@@ -2429,6 +2566,7 @@ Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeGetPreviewFrame
         (int64_t)target_ms,
         (int)out_w,
         (int)out_h,
+        mode,
         buffer,
         buffer_size
     );
@@ -2452,12 +2590,53 @@ Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeGetPreviewFrame
     (*env)->SetByteArrayRegion(env, result, 0, buffer_size, (jbyte *)buffer);
     free(buffer);
     
-    ALOGI("✅ nativeGetPreviewFrame: Preview frame extracted successfully (%dx%d)", 
-          out_w, out_h);
+    ALOGI("✅ nativeGetPreviewFrame: Preview frame extracted successfully (%dx%d, %s)", 
+          out_w, out_h, mode == MEDIA_THUMB_FAST ? "fast" : "exact");
     
     return result;
 }
 
+/// 🔥 КРИТИЧЕСКИЙ FIX: JNI функция для получения preview кадра (RGBA8888 bitmap)
+/// 
+/// Preview полностью независим от PlayerContext:
+/// - Не использует EGL / Surface
+/// - Не использует render loop
+/// - Не использует threads
+/// - CPU-only декодирование
+/// 
+/// @param path Путь к видео файлу
+/// @param target_ms Целевая позиция в миллисекундах
+/// @param out_w Ширина выходного bitmap
+/// @param out_h Высота выходного bitmap
+/// @return jbyteArray с RGBA8888 данными (размер = out_w * out_h * 4) или NULL при ошибке
+JNIEXPORT jbyteArray JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeGetPreviewFrame(
+    JNIEnv *env,
+    jobject thiz,
+    jstring path,
+    jlong target_ms,
+    jint out_w,
+    jint out_h
+) {
+    return preview_frame_to_byte_array(env, path, target_ms, out_w, out_h, MEDIA_THUMB_EXACT);
+}
+
+/// 🔥 FEATURE: Быстрый preview для сеток галереи — ближайший keyframe ≤ target_ms
+/// 
+/// Только keyframe'ы, без loop filter, lowres у decoder'ов, которые его поддерживают.
+/// Параметры и результат — как у nativeGetPreviewFrame.
+JNIEXPORT jbyteArray JNICALL
+Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeGetPreviewFrameFast(
+    JNIEnv *env,
+    jobject thiz,
+    jstring path,
+    jlong target_ms,
+    jint out_w,
+    jint out_h
+) {
+    return preview_frame_to_byte_array(env, path, target_ms, out_w, out_h, MEDIA_THUMB_FAST);
+}
+
 /// 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 12.4: Native API для background playback
 JNIEXPORT void JNICALL
 Java_com_media_video_music_player_NativeFfmpegPlayerPlugin_nativeOnAppBackground(
@@ -2618,6 +2797,28 @@ void native_player_emit_diagnostic_event(const char *type, const char *key, cons
     }
 }
 
+/// Уведомить Flutter о событии (Шаг 22)
+void notify_flutter_event(PlayerContext *ctx, const char *event) {
+    if (!ctx || !ctx->jvm || !ctx->jniCallback) {
+        return;
+    }
+    
+    JNIEnv *env = NULL;
+    if ((*ctx->jvm)->GetEnv(ctx->jvm, (void **)&env, JNI_VERSION_1_6) != JNI_OK) {
+        (*ctx->jvm)->AttachCurrentThread(ctx->jvm, &env, NULL);
+    }
+    
+    if (!env || !ctx->onEndedMethod) {
+        return;
+    }
+    
+    jstring jevent = (*env)->NewStringUTF(env, event);
+    (*env)->CallVoidMethod(env, ctx->jniCallback, ctx->onEndedMethod, jevent);
+    (*env)->DeleteLocalRef(env, jevent);
+    
+    ALOGI("Notified Flutter: %s", event);
+}
+
 /// 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 13.8: Эмит события frameStepped
 void native_player_emit_frame_stepped_event(int64_t pts_ms) {
     if (!g_event_callback || !g_on_event_method) {
@@ -8,8 +8,10 @@
 #include "libavformat/avformat.h"
 #include "libavcodec/avcodec.h"
 #include "libavutil/avutil.h"
-#include "libavutil/imgutils.h"
-#include "libswscale/swscale.h"
+#include "keyframe_index.h"  // 🔥 KEYFRAME INDEX: sidecar вместо отступа -1 sec
+#include "io_readahead.h"  // 🔥 IO READAHEAD: opt-in custom AVIOContext
+#include "probe_cache.h"  // 🔥 PROBE CACHE: probe из кэша для повторных preview
+#include "rgba_convert.h"  // 🔥 RGBA CONVERT: SIMD box-downscale / кэш SwsContext
 
 #define LOG_TAG "NativePreview"
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
@@ -30,6 +32,7 @@ int native_preview_get_frame(
     int64_t target_ms,
     int out_w,
     int out_h,
+    MediaThumbnailMode mode,
     uint8_t *buffer,
     int buffer_size
 ) {
@@ -57,23 +60,26 @@ int native_preview_get_frame(
         ALOGW("⚠️ Preview: target_ms <= 0, clamped to 100ms");
     }
     
-    ALOGI("🎬 Preview: Opening file '%s', target=%lld ms, size=%dx%d", 
-          path, (long long)target_ms, out_w, out_h);
+    int fast = mode == MEDIA_THUMB_FAST;
+    ALOGI("🎬 Preview: Opening file '%s', target=%lld ms, size=%dx%d, mode=%s", 
+          path, (long long)target_ms, out_w, out_h, fast ? "fast" : "exact");
     
     // === ШАГ 1: Открыть файл ===
     AVFormatContext *fmt = NULL;
+    IoReadahead *io = io_readahead_open(path, &fmt);
     int ret = avformat_open_input(&fmt, path, NULL, NULL);
     if (ret < 0) {
         char errbuf[AV_ERROR_MAX_STRING_SIZE];
         av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
         ALOGE("❌ Preview: Failed to open file: %s", errbuf);
+        io_readahead_close(&io);
         return -1;
     }
     
-    ret = avformat_find_stream_info(fmt, NULL);
+    ret = probe_cache_find_stream_info(fmt, path);
     if (ret < 0) {
         ALOGE("❌ Preview: Failed to find stream info");
-        avformat_close_input(&fmt);
+        io_readahead_close_input(&fmt, &io);
         return -1;
     }
     
@@ -88,7 +94,7 @@ int native_preview_get_frame(
     
     if (video_stream < 0) {
         ALOGE("❌ Preview: No video stream found");
-        avformat_close_input(&fmt);
+        io_readahead_close_input(&fmt, &io);
         return -1;
     }
     
@@ -100,14 +106,14 @@ int native_preview_get_frame(
     const AVCodec *codec = avcodec_find_decoder(stream->codecpar->codec_id);
     if (!codec) {
         ALOGE("❌ Preview: Codec not found");
-        avformat_close_input(&fmt);
+        io_readahead_close_input(&fmt, &io);
         return -1;
     }
     
     AVCodecContext *dec = avcodec_alloc_context3(codec);
     if (!dec) {
         ALOGE("❌ Preview: Failed to allocate codec context");
-        avformat_close_input(&fmt);
+        io_readahead_close_input(&fmt, &io);
         return -1;
     }
     
@@ -115,29 +121,54 @@ int native_preview_get_frame(
     if (ret < 0) {
         ALOGE("❌ Preview: Failed to copy codec parameters");
         avcodec_free_context(&dec);
-        avformat_close_input(&fmt);
+        io_readahead_close_input(&fmt, &io);
         return -1;
     }
     
+    // 🔥 FAST: decoder с lowres (MJPEG, MPEG-2/4...) сразу декодирует в 1/2..1/8 размера
+    if (fast) {
+        dec->lowres = media_thumbnail_lowres(codec->max_lowres, stream->codecpar->width,
+                                             stream->codecpar->height, out_w, out_h);
+    }
+    
     ret = avcodec_open2(dec, codec, NULL);
     if (ret < 0) {
         char errbuf[AV_ERROR_MAX_STRING_SIZE];
         av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
         ALOGE("❌ Preview: Failed to open codec: %s", errbuf);
         avcodec_free_context(&dec);
-        avformat_close_input(&fmt);
+        io_readahead_close_input(&fmt, &io);
         return -1;
     }
     
-    ALOGI("✅ Preview: Decoder opened (size=%dx%d)", dec->width, dec->height);
+    ALOGI("✅ Preview: Decoder opened (size=%dx%d, lowres=%d)", dec->width, dec->height, dec->lowres);
+    
+    // 🔥 FAST: только keyframe'ы, без deblocking
+    if (fast) {
+        dec->skip_frame = AVDISCARD_NONKEY;
+        dec->skip_loop_filter = AVDISCARD_ALL;
+    }
     
     // === ШАГ 4: Seek BACKWARD к target_ms ===
     // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 11.4: КРИТИЧЕСКИЙ SEEK (AVI / FLV)
     // ⚠️ НИКОГДА не seek точно в target
     // Почему: AVI / FLV → ключевые кадры далеко, иначе получишь чёрный кадр
+    // 🔥 KEYFRAME INDEX: если плеер уже построил sidecar, demuxer знает все keyframe'ы
+    // и BACKWARD seek попадает точно в keyframe ≤ target — отступ не нужен
     double target_sec = target_ms / 1000.0;
+    double seek_offset_sec = 1.0;  // 🔥 Отступ -1 секунда
+    KeyframeIndex *kf_index = keyframe_index_load(path, video_stream, stream->time_base);
+    if (kf_index) {
+        keyframe_index_apply(kf_index, stream);
+        keyframe_index_free(&kf_index);
+        seek_offset_sec = 0.0;
+    }
+    // 🔥 FAST: нужен ближайший keyframe ≤ target, отступ увёл бы на keyframe раньше
+    if (fast) {
+        seek_offset_sec = 0.0;
+    }
     int64_t seek_ts = av_rescale_q(
-        (int64_t)((target_sec - 1.0) * AV_TIME_BASE),  // 🔥 Отступ -1 секунда
+        (int64_t)((target_sec - seek_offset_sec) * AV_TIME_BASE),
         AV_TIME_BASE_Q,
         stream->time_base
     );
@@ -151,8 +182,8 @@ int native_preview_get_frame(
         ALOGW("⚠️ Preview: Seek failed: %s (will decode from start)", errbuf);
         // Продолжаем - попробуем декодировать с начала
     } else {
-        ALOGI("✅ Preview: Seek to %.3f sec (ts=%lld, offset=-1.0 sec for AVI/FLV)", 
-              target_sec, (long long)seek_ts);
+        ALOGI("✅ Preview: Seek to %.3f sec (ts=%lld, offset=-%.1f sec for AVI/FLV)", 
+              target_sec, (long long)seek_ts, seek_offset_sec);
     }
     
     // 🔥 КРИТИЧЕСКИЙ FIX: Flush codec buffers после seek
@@ -160,47 +191,14 @@ int native_preview_get_frame(
     
     // === ШАГ 5: Декодировать кадры вперёд до первого >= target_ms ===
     AVFrame *frame = av_frame_alloc();
-    AVFrame *rgb = av_frame_alloc();
     AVPacket *pkt = av_packet_alloc();
-    struct SwsContext *sws = NULL;
     
-    if (!frame || !rgb || !pkt) {
+    if (!frame || !pkt) {
         ALOGE("❌ Preview: Failed to allocate frames/packet");
         if (frame) av_frame_free(&frame);
-        if (rgb) av_frame_free(&rgb);
         if (pkt) av_packet_free(&pkt);
         avcodec_free_context(&dec);
-        avformat_close_input(&fmt);
-        return -1;
-    }
-    
-    // Выделяем буфер для RGBA
-    int rgb_size = av_image_get_buffer_size(AV_PIX_FMT_RGBA, out_w, out_h, 1);
-    uint8_t *rgb_buffer = (uint8_t *)av_malloc(rgb_size);
-    if (!rgb_buffer) {
-        ALOGE("❌ Preview: Failed to allocate RGB buffer");
-        av_frame_free(&frame);
-        av_frame_free(&rgb);
-        av_packet_free(&pkt);
-        avcodec_free_context(&dec);
-        avformat_close_input(&fmt);
-        return -1;
-    }
-    
-    ret = av_image_fill_arrays(
-        rgb->data, rgb->linesize,
-        rgb_buffer,
-        AV_PIX_FMT_RGBA,
-        out_w, out_h, 1
-    );
-    if (ret < 0) {
-        ALOGE("❌ Preview: Failed to fill RGB image");
-        av_free(rgb_buffer);
-        av_frame_free(&frame);
-        av_frame_free(&rgb);
-        av_packet_free(&pkt);
-        avcodec_free_context(&dec);
-        avformat_close_input(&fmt);
+        io_readahead_close_input(&fmt, &io);
         return -1;
     }
     
@@ -224,6 +222,12 @@ int native_preview_get_frame(
             continue;
         }
         
+        // 🔥 FAST: не-ключевые пакеты даже не отправляем в decoder
+        if (fast && !(pkt->flags & AV_PKT_FLAG_KEY)) {
+            av_packet_unref(pkt);
+            continue;
+        }
+        
         ret = avcodec_send_packet(dec, pkt);
         if (ret < 0) {
             av_packet_unref(pkt);
@@ -263,57 +267,26 @@ int native_preview_get_frame(
             
             // 🔥 КРИТИЧЕСКИЙ FIX: Берём первый валидный кадр >= target
             // ✔️ PTS ≥ target — единственный критерий
-            if (pts_sec >= target_sec) {
+            // 🔥 FAST: первый keyframe после BACKWARD seek и есть ответ
+            if (fast || pts_sec >= target_sec) {
                 // Кадр >= target - это то, что нужно
                 ALOGI("✅ Preview: Frame found (pts=%.3f sec >= target=%.3f sec, attempt=%d)", 
                       pts_sec, target_sec, decode_attempts);
                 
                 // === ШАГ 6: Конвертировать в RGBA ===
                 // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 11.7: SCALE (CPU, стабильно)
-                if (!sws) {
-                    sws = sws_getContext(
-                        frame->width, frame->height, (enum AVPixelFormat)frame->format,
-                        out_w, out_h, AV_PIX_FMT_RGBA,
-                        SWS_BILINEAR,
-                        NULL, NULL, NULL
-                    );
-                    
-                    if (!sws) {
-                        ALOGE("❌ Preview: Failed to create SwsContext");
-                        av_free(rgb_buffer);
-                        av_frame_free(&frame);
-                        av_frame_free(&rgb);
-                        av_packet_free(&pkt);
-                        avcodec_free_context(&dec);
-                        avformat_close_input(&fmt);
-                        return -1;
-                    }
-                }
-                
-                ret = sws_scale(
-                    sws,
-                    (const uint8_t *const *)frame->data,
-                    frame->linesize,
-                    0,
-                    frame->height,
-                    rgb->data,
-                    rgb->linesize
-                );
-                
+                // 🔥 RGBA CONVERT: сразу в выходной буфер, без промежуточного RGBA кадра;
+                // SwsContext (если быстрый путь не подошёл) берётся из sws_cache
+                ret = rgba_convert_frame(frame, out_w, out_h, buffer, out_w * 4);
                 if (ret < 0) {
-                    ALOGE("❌ Preview: Failed to scale frame");
-                    sws_freeContext(sws);
-                    av_free(rgb_buffer);
+                    ALOGE("❌ Preview: Failed to convert frame to RGBA");
                     av_frame_free(&frame);
-                    av_frame_free(&rgb);
                     av_packet_free(&pkt);
                     avcodec_free_context(&dec);
-                    avformat_close_input(&fmt);
+                    io_readahead_close_input(&fmt, &io);
                     return -1;
                 }
                 
-                // === ШАГ 7: Копируем RGBA в выходной буфер ===
-                memcpy(buffer, rgb->data[0], required_size);
                 frame_found = 1;
                 
                 av_packet_unref(pkt);
@@ -334,22 +307,16 @@ int native_preview_get_frame(
     
     // === ШАГ 8: Cleanup (ОБЯЗАТЕЛЬНО) ===
     // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 11.8: Memory contract
-    // open_input → close_input
+    // open_input → close_input (+ read-ahead слой, если был)
     // open_codec → free_codec
     // alloc_frame → free_frame
     // alloc_packet → unref_packet
-    // alloc_sws → free_sws
     // ⛔ Если пропустишь — утечка гарантирована
     
-    if (sws) {
-        sws_freeContext(sws);
-    }
-    av_free(rgb_buffer);
     av_frame_free(&frame);
-    av_frame_free(&rgb);
     av_packet_free(&pkt);
     avcodec_free_context(&dec);
-    avformat_close_input(&fmt);
+    io_readahead_close_input(&fmt, &io);
     
     if (!frame_found) {
         ALOGE("❌ Preview: No frame found after %d attempts", decode_attempts);
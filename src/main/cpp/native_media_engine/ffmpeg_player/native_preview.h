@@ -2,6 +2,7 @@
 #define NATIVE_PREVIEW_H
 
 #include <stdint.h>
+#include "media_handle.h"  // MediaThumbnailMode
 
 /// 🔥 КРИТИЧЕСКИЙ FIX: PreviewContext - отдельный контекст для preview (не зависит от PlayerContext)
 /// PreviewContext используется ТОЛЬКО для генерации превью кадров (CPU-only, без EGL/Surface/threads)
@@ -24,6 +25,7 @@ typedef struct PreviewContext {
 /// 3. Открыть декодер
 /// 4. Seek BACKWARD к target_ms
 /// 5. Декодировать кадры вперёд до первого >= target_ms
+///    (MEDIA_THUMB_FAST: первый keyframe — lowres, skip_frame NONKEY, без loop filter)
 /// 6. Конвертировать в RGBA
 /// 7. Вернуть bitmap
 /// 
@@ -39,6 +41,7 @@ typedef struct PreviewContext {
 /// @param target_ms Целевая позиция в миллисекундах
 /// @param out_w Ширина выходного bitmap
 /// @param out_h Высота выходного bitmap
+/// @param mode MEDIA_THUMB_EXACT (кадр >= target_ms) или MEDIA_THUMB_FAST (ближайший keyframe ≤ target_ms)
 /// @param buffer Выходной буфер (RGBA8888, размер = out_w * out_h * 4)
 /// @param buffer_size Размер буфера (должен быть >= out_w * out_h * 4)
 /// @return 0 при успехе, < 0 при ошибке
@@ -47,6 +50,7 @@ int native_preview_get_frame(
     int64_t target_ms,
     int out_w,
     int out_h,
+    MediaThumbnailMode mode,
     uint8_t *buffer,
     int buffer_size
 );
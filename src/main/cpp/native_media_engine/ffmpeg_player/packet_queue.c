@@ -1,12 +1,61 @@
 #include "packet_queue.h"
+
+// Linked-list реализация; SPSC-вариант — packet_queue_spsc.c
+#if !defined(PACKET_QUEUE_SPSC)
+
 #include <stdlib.h>
 #include <string.h>
 
-/// Освободить узел пакета
-static void packet_node_free(PacketNode *node) {
-    if (!node) return;
-    av_packet_unref(&node->pkt);
-    free(node);
+/// Взять узел из freelist или выделить новый (вызывать под q->mutex)
+static PacketNode *packet_node_alloc_locked(PacketQueue *q) {
+    PacketNode *node = q->free_nodes;
+    if (node) {
+        q->free_nodes = node->next;
+        q->nb_free_nodes--;
+    } else {
+        node = malloc(sizeof(PacketNode));
+        if (!node) {
+            return NULL;
+        }
+        memset(&node->pkt, 0, sizeof(node->pkt));
+        q->node_allocs++;
+    }
+    node->next = NULL;
+    return node;
+}
+
+/// Вернуть узел во freelist (вызывать под q->mutex, node->pkt уже пустой)
+static void packet_node_recycle_locked(PacketQueue *q, PacketNode *node) {
+    node->next = q->free_nodes;
+    q->free_nodes = node;
+    q->nb_free_nodes++;
+}
+
+/// Заполнена ли очередь (вызывать под q->mutex)
+static bool packet_queue_is_full_locked(PacketQueue *q) {
+    if (q->abort_request) {
+        return true;  // aborted очередь никто не читает
+    }
+    if (q->max_packets > 0 && q->nb_packets >= q->max_packets) {
+        return true;
+    }
+    if (q->max_bytes > 0 && q->size >= q->max_bytes) {
+        return true;
+    }
+    if (q->max_duration > 0 && q->duration >= q->max_duration) {
+        return true;
+    }
+    return false;
+}
+
+/// Разбудить producer'а (вызывать БЕЗ q->mutex: producer держит space_mutex и берёт q->mutex)
+static void packet_queue_notify_space(PacketQueue *q) {
+    if (!q->space_mutex || !q->space_cond) {
+        return;
+    }
+    pthread_mutex_lock(q->space_mutex);
+    pthread_cond_broadcast(q->space_cond);
+    pthread_mutex_unlock(q->space_mutex);
 }
 
 void packet_queue_init(PacketQueue *q) {
@@ -18,6 +67,16 @@ void packet_queue_init(PacketQueue *q) {
 
 void packet_queue_destroy(PacketQueue *q) {
     packet_queue_flush(q);
+    
+    PacketNode *node = q->free_nodes;
+    while (node) {
+        PacketNode *next = node->next;
+        free(node);
+        node = next;
+    }
+    q->free_nodes = NULL;
+    q->nb_free_nodes = 0;
+    
     pthread_mutex_destroy(&q->mutex);
     pthread_cond_destroy(&q->cond);
 }
@@ -27,6 +86,8 @@ void packet_queue_abort(PacketQueue *q) {
     q->abort_request = true;
     pthread_cond_signal(&q->cond);
     pthread_mutex_unlock(&q->mutex);
+    
+    packet_queue_notify_space(q);
 }
 
 void packet_queue_reset_abort(PacketQueue *q) {
@@ -42,7 +103,8 @@ void packet_queue_flush(PacketQueue *q) {
     PacketNode *node = q->first_pkt;
     while (node) {
         PacketNode *next = node->next;
-        packet_node_free(node);
+        av_packet_unref(&node->pkt);
+        packet_node_recycle_locked(q, node);
         node = next;
     }
     
@@ -50,33 +112,41 @@ void packet_queue_flush(PacketQueue *q) {
     q->last_pkt = NULL;
     q->nb_packets = 0;
     q->size = 0;
+    q->duration = 0;
     
     pthread_cond_signal(&q->cond);
     pthread_mutex_unlock(&q->mutex);
+    
+    packet_queue_notify_space(q);
 }
 
-int packet_queue_put(PacketQueue *q, AVPacket *pkt) {
-    PacketNode *node = malloc(sizeof(PacketNode));
-    if (!node) {
-        return -1;
-    }
-    
-    av_init_packet(&node->pkt);
-    if (av_packet_ref(&node->pkt, pkt) < 0) {
-        free(node);
+int packet_queue_put(PacketQueue *q, AVPacket *pkt, int serial) {
+    // av_read_frame отдаёт refcounted пакеты; не-refcounted данные принадлежат
+    // demuxer'у и будут перезаписаны следующим чтением — такие копируем
+    if (!pkt->buf && av_packet_make_refcounted(pkt) < 0) {
+        av_packet_unref(pkt);
         return -1;
     }
     
-    node->next = NULL;
-    
     pthread_mutex_lock(&q->mutex);
     
     if (q->abort_request) {
         pthread_mutex_unlock(&q->mutex);
-        packet_node_free(node);
+        av_packet_unref(pkt);
         return -1;
     }
     
+    PacketNode *node = packet_node_alloc_locked(q);
+    if (!node) {
+        pthread_mutex_unlock(&q->mutex);
+        av_packet_unref(pkt);
+        return -1;
+    }
+    
+    av_packet_move_ref(&node->pkt, pkt);  // zero-copy: забираем ссылку на буфер
+    node->serial = serial;
+    q->packets_put++;
+    
     if (!q->last_pkt) {
         q->first_pkt = node;
     } else {
@@ -86,6 +156,7 @@ int packet_queue_put(PacketQueue *q, AVPacket *pkt) {
     q->last_pkt = node;
     q->nb_packets++;
     q->size += node->pkt.size;
+    q->duration += node->pkt.duration;
     
     pthread_cond_signal(&q->cond);
     pthread_mutex_unlock(&q->mutex);
@@ -93,7 +164,7 @@ int packet_queue_put(PacketQueue *q, AVPacket *pkt) {
     return 0;
 }
 
-int packet_queue_get(PacketQueue *q, AVPacket *pkt, bool block) {
+int packet_queue_get(PacketQueue *q, AVPacket *pkt, bool block, int *serial) {
     pthread_mutex_lock(&q->mutex);
     
     for (;;) {
@@ -104,6 +175,8 @@ int packet_queue_get(PacketQueue *q, AVPacket *pkt, bool block) {
         
         PacketNode *node = q->first_pkt;
         if (node) {
+            bool was_full = packet_queue_is_full_locked(q);
+            
             q->first_pkt = node->next;
             if (!q->first_pkt) {
                 q->last_pkt = NULL;
@@ -111,11 +184,21 @@ int packet_queue_get(PacketQueue *q, AVPacket *pkt, bool block) {
             
             q->nb_packets--;
             q->size -= node->pkt.size;
+            q->duration -= node->pkt.duration;
             
-            *pkt = node->pkt; // ownership переходит вызывающему
-            free(node);
+            av_packet_move_ref(pkt, &node->pkt); // ownership переходит вызывающему
+            if (serial) {
+                *serial = node->serial;
+            }
+            packet_node_recycle_locked(q, node);
             
+            // Будим demux только на переходах: "заполнена → есть место" и "опустела"
+            bool notify = (was_full && !packet_queue_is_full_locked(q)) || q->nb_packets == 0;
             pthread_mutex_unlock(&q->mutex);
+            
+            if (notify) {
+                packet_queue_notify_space(q);
+            }
             return 1;
         } else if (!block) {
             pthread_mutex_unlock(&q->mutex);
@@ -125,3 +208,53 @@ int packet_queue_get(PacketQueue *q, AVPacket *pkt, bool block) {
         }
     }
 }
+
+void packet_queue_set_limits(PacketQueue *q, int max_bytes, int max_packets,
+                             double max_duration_sec, AVRational time_base) {
+    pthread_mutex_lock(&q->mutex);
+    q->max_bytes = max_bytes;
+    q->max_packets = max_packets;
+    q->time_base = time_base;
+    q->max_duration = 0;
+    if (max_duration_sec > 0 && time_base.num > 0 && time_base.den > 0) {
+        q->max_duration = av_rescale_q((int64_t)(max_duration_sec * AV_TIME_BASE),
+                                       AV_TIME_BASE_Q, time_base);
+    }
+    pthread_mutex_unlock(&q->mutex);
+    
+    packet_queue_notify_space(q);
+}
+
+void packet_queue_set_space_notify(PacketQueue *q, pthread_mutex_t *mutex, pthread_cond_t *cond) {
+    pthread_mutex_lock(&q->mutex);
+    q->space_mutex = mutex;
+    q->space_cond = cond;
+    pthread_mutex_unlock(&q->mutex);
+}
+
+bool packet_queue_is_full(PacketQueue *q) {
+    pthread_mutex_lock(&q->mutex);
+    bool full = packet_queue_is_full_locked(q);
+    pthread_mutex_unlock(&q->mutex);
+    return full;
+}
+
+int packet_queue_nb_packets(PacketQueue *q) {
+    pthread_mutex_lock(&q->mutex);
+    int n = q->nb_packets;
+    pthread_mutex_unlock(&q->mutex);
+    return n;
+}
+
+void packet_queue_get_stats(PacketQueue *q, PacketQueueStats *stats) {
+    pthread_mutex_lock(&q->mutex);
+    stats->nb_packets = q->nb_packets;
+    stats->size = q->size;
+    stats->duration = q->duration;
+    stats->nb_free_nodes = q->nb_free_nodes;
+    stats->node_allocs = q->node_allocs;
+    stats->packets_put = q->packets_put;
+    pthread_mutex_unlock(&q->mutex);
+}
+
+#endif // !PACKET_QUEUE_SPSC
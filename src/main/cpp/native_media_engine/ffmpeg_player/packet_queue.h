@@ -2,11 +2,111 @@
 
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "libavcodec/avcodec.h"
 
+/// Лимиты по умолчанию (demux backpressure)
+///
+/// Очередь считается заполненной, когда достигнут ЛЮБОЙ из лимитов.
+/// Видео: 16MB покрывает ~2.5s 4K HEVC @ 50Mbps, аудио — несколько секунд с запасом.
+#define PACKET_QUEUE_VIDEO_MAX_BYTES    (16 * 1024 * 1024)
+#define PACKET_QUEUE_AUDIO_MAX_BYTES    (2 * 1024 * 1024)
+#define PACKET_QUEUE_DEFAULT_MAX_PACKETS 600
+#define PACKET_QUEUE_DEFAULT_MAX_DURATION_SEC 3.0
+
+#if defined(PACKET_QUEUE_SPSC)
+
+#include <stdatomic.h>
+
+/// Ёмкость кольца SPSC-очереди (степень двойки)
+///
+/// С запасом больше PACKET_QUEUE_DEFAULT_MAX_PACKETS: demux пишет в заполненную
+/// по лимитам очередь, пока другая не заполнена (плохой interleave).
+/// Физически полное кольцо put не блокирует: пакеты уходят в overflow-список.
+#define PACKET_QUEUE_SPSC_CAPACITY 2048
+
+/// Слот кольца
+///
+/// cum_* — накопленные суммы на момент ПОСЛЕ этого пакета: по ним любой поток
+/// считает size/duration очереди без общего счётчика, который пишут оба потока.
+typedef struct PacketSlot {
+    AVPacket pkt;
+    int serial;            // seek_serial эпохи на момент put
+    uint64_t cum_bytes;
+    int64_t cum_duration;
+} PacketSlot;
+
+/// Узел overflow-списка (кольцо физически заполнено)
+typedef struct PacketOverflowNode {
+    PacketSlot slot;
+    struct PacketOverflowNode *next;
+} PacketOverflowNode;
+
+/// Очередь пакетов (lock-free SPSC ring)
+///
+/// Сборка с -DPACKET_QUEUE_SPSC (CMake: SMART_FFMPEG_SPSC_PACKET_QUEUE=ON).
+/// Тот же API, что у linked-list версии, но рассчитана ровно на одного producer'а
+/// (demux_thread) и одного consumer'а (decode thread):
+/// - put/get без mutex: head пишет только consumer, tail — только producer
+/// - consumer ждёт через futex только при пустой очереди; put не блокируется никогда:
+///   demux_thread ждёт места сам (demux_wait_while, с обработкой seek/abort)
+/// - кольцо физически заполнено → put дописывает в overflow-список под mutex,
+///   и пока список не опустеет, новые пакеты идут туда же (порядок FIFO)
+/// - flush не трогает слоты consumer'а: сдвигает discard_until,
+///   consumer сам освобождает устаревшие пакеты при следующем get
+/// - лимиты и space_cond — как в linked-list версии (сигнал только на переходах)
+typedef struct PacketQueue {
+    PacketSlot *ring;
+    uint32_t capacity;
+    uint32_t mask;
+    
+    atomic_uint head;           // пишет consumer
+    atomic_uint tail;           // пишет producer
+    atomic_uint discard_until;  // flush: всё до этого индекса — устаревшее
+    
+    /// Накопленные суммы (для size/duration без общего счётчика)
+    atomic_uint_fast64_t put_bytes;     // producer
+    atomic_int_fast64_t put_duration;   // producer
+    atomic_uint_fast64_t got_bytes;     // consumer
+    atomic_int_fast64_t got_duration;   // consumer
+    atomic_uint_fast64_t flush_bytes;   // flush
+    atomic_int_fast64_t flush_duration; // flush
+    
+    atomic_bool abort_request;
+    
+    /// futex-слово: счётчик событий + флаг ожидания consumer'а
+    atomic_uint data_seq;
+    atomic_int consumer_waiting;
+    
+    /// Overflow-список: пакеты новее всех пакетов кольца
+    pthread_mutex_t overflow_mutex;
+    PacketOverflowNode *overflow_first;
+    PacketOverflowNode *overflow_last;
+    atomic_int overflow_count;
+    PacketOverflowNode *overflow_free;  // переиспользуемые узлы (под overflow_mutex)
+    int nb_overflow_free;
+    
+    /// Лимиты (0 = без лимита)
+    int max_packets;
+    int max_bytes;
+    int64_t max_duration;  // в time_base
+    AVRational time_base;
+    
+    /// Внешний cond producer'а (demux_thread), может быть NULL
+    pthread_mutex_t *space_mutex;
+    pthread_cond_t *space_cond;
+    
+    /// Счётчики для stats API
+    uint64_t node_allocs;  // malloc узлов overflow-списка (под overflow_mutex)
+    atomic_uint_fast64_t packets_put;
+} PacketQueue;
+
+#else
+
 /// Узел очереди пакетов
 typedef struct PacketNode {
     AVPacket pkt;
+    int serial;            // seek_serial эпохи на момент put (как в ffplay)
     struct PacketNode *next;
 } PacketNode;
 
@@ -17,16 +117,51 @@ typedef struct PacketNode {
 /// - thread-safe через mutex + cond
 /// - linked list (packets разного размера)
 /// - abort-safe (можно прервать из любого потока)
+/// - bounded: put не блокируется, но очередь сообщает "заполнена" по лимитам,
+///   а consumer будит producer'а через space_cond, когда место освободилось
+/// - узлы переиспользуются через freelist: в steady-state put/get не делают malloc/free
 typedef struct PacketQueue {
     PacketNode *first_pkt;
     PacketNode *last_pkt;
     int nb_packets;
     int size;              // bytes
+    int64_t duration;      // сумма pkt.duration (в time_base)
     bool abort_request;
     pthread_mutex_t mutex;
     pthread_cond_t cond;
+    
+    /// Лимиты (0 = без лимита)
+    int max_packets;
+    int max_bytes;
+    int64_t max_duration;  // в time_base
+    AVRational time_base;
+    
+    /// Внешний cond producer'а (demux_thread), может быть NULL
+    /// Сигналится вне q->mutex, когда очередь перестала быть заполненной или опустела
+    pthread_mutex_t *space_mutex;
+    pthread_cond_t *space_cond;
+    
+    /// Freelist освобождённых узлов (под q->mutex)
+    PacketNode *free_nodes;
+    int nb_free_nodes;
+    
+    /// Счётчики для stats API
+    uint64_t node_allocs;  // malloc узлов за всё время жизни очереди
+    uint64_t packets_put;
 } PacketQueue;
 
+#endif // PACKET_QUEUE_SPSC
+
+/// Статистика очереди (snapshot)
+typedef struct PacketQueueStats {
+    int nb_packets;
+    int size;
+    int64_t duration;
+    int nb_free_nodes;
+    uint64_t node_allocs;
+    uint64_t packets_put;
+} PacketQueueStats;
+
 /// Инициализировать очередь пакетов
 ///
 /// @param q Очередь для инициализации
@@ -52,21 +187,63 @@ void packet_queue_reset_abort(PacketQueue *q);
 /// @param q Очередь
 void packet_queue_flush(PacketQueue *q);
 
-/// Добавить пакет в очередь
+/// Добавить пакет в очередь (move-семантика)
+///
+/// Данные пакета переносятся в очередь через av_packet_move_ref без копирования:
+/// после вызова pkt пустой (и при ошибке тоже — пакет освобождается).
 ///
 /// @param q Очередь
-/// @param pkt Пакет для добавления (будет скопирован через av_packet_ref)
+/// @param pkt Пакет для добавления (ownership переходит очереди)
+/// @param serial Эпоха seek (ctx->seek_serial), к которой относится пакет
 /// @return 0 при успехе, <0 при ошибке
-int packet_queue_put(PacketQueue *q, AVPacket *pkt);
+int packet_queue_put(PacketQueue *q, AVPacket *pkt, int serial);
+
+/// Задать лимиты очереди
+///
+/// @param q Очередь
+/// @param max_bytes Максимум байт (0 = без лимита)
+/// @param max_packets Максимум пакетов (0 = без лимита)
+/// @param max_duration_sec Максимальная суммарная длительность пакетов (0 = без лимита)
+/// @param time_base Time base стрима (для pkt.duration)
+void packet_queue_set_limits(PacketQueue *q, int max_bytes, int max_packets,
+                             double max_duration_sec, AVRational time_base);
+
+/// Подписать producer'а на освобождение места в очереди
+///
+/// @param q Очередь
+/// @param mutex Mutex, под которым producer ждёт cond
+/// @param cond Cond, который будет сигналиться (broadcast)
+void packet_queue_set_space_notify(PacketQueue *q, pthread_mutex_t *mutex, pthread_cond_t *cond);
+
+/// Достигнут ли хотя бы один лимит очереди
+///
+/// @param q Очередь
+/// @return true если очередь заполнена
+bool packet_queue_is_full(PacketQueue *q);
+
+/// Количество пакетов в очереди
+///
+/// @param q Очередь
+/// @return Количество пакетов
+int packet_queue_nb_packets(PacketQueue *q);
+
+/// Получить статистику очереди
+///
+/// node_allocs не растёт в steady-state: рост означает, что freelist не покрывает поток пакетов.
+///
+/// @param q Очередь
+/// @param stats Буфер для статистики
+void packet_queue_get_stats(PacketQueue *q, PacketQueueStats *stats);
 
 /// Извлечь пакет из очереди (блокирующий или неблокирующий)
 ///
 /// @param q Очередь
 /// @param pkt Буфер для пакета (ownership переходит вызывающему)
 /// @param block true = блокирующий (ждёт пакет), false = неблокирующий
+/// @param serial Куда записать эпоху seek пакета (может быть NULL)
 /// @return 1 при успехе, 0 если очередь пуста (block=false), <0 при abort
-int packet_queue_get(PacketQueue *q, AVPacket *pkt, bool block);
+int packet_queue_get(PacketQueue *q, AVPacket *pkt, bool block, int *serial);
 
 // Алиасы для совместимости
 #define packet_queue_push packet_queue_put
-#define packet_queue_pop(q, pkt) packet_queue_get(q, pkt, true)
+#define packet_queue_pop(q, pkt) packet_queue_get(q, pkt, true, NULL)
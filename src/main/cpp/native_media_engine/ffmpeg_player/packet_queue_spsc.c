@@ -0,0 +1,413 @@
+#include "packet_queue.h"
+
+// Lock-free SPSC реализация; по умолчанию собирается linked-list (packet_queue.c)
+#if defined(PACKET_QUEUE_SPSC)
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/// futex wait: спим, пока *addr == expected (spurious wakeup допустим — вызывающий перепроверяет)
+static void spsc_futex_wait(atomic_uint *addr, unsigned int expected) {
+    syscall(SYS_futex, (unsigned int *)addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void spsc_futex_wake(atomic_uint *addr) {
+    syscall(SYS_futex, (unsigned int *)addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+/// Разбудить consumer'а (producer опубликовал пакет / flush / abort)
+///
+/// seq меняется ДО проверки waiting: если consumer уже прочитал старый seq,
+/// futex_wait вернётся сразу (EAGAIN), wakeup не теряется.
+/// waiting сбрасывает сам будящий: syscall делает только первый put после засыпания.
+static void spsc_wake_consumer(PacketQueue *q) {
+    atomic_fetch_add(&q->data_seq, 1);
+    if (atomic_exchange(&q->consumer_waiting, 0)) {
+        spsc_futex_wake(&q->data_seq);
+    }
+}
+
+/// Разбудить demux через внешний cond (только на переходах, как в linked-list версии)
+static void packet_queue_notify_space(PacketQueue *q) {
+    if (!q->space_mutex || !q->space_cond) {
+        return;
+    }
+    pthread_mutex_lock(q->space_mutex);
+    pthread_cond_broadcast(q->space_cond);
+    pthread_mutex_unlock(q->space_mutex);
+}
+
+/// Первый актуальный индекс: head, либо discard_until, если flush ушёл дальше
+static uint32_t spsc_live_head(PacketQueue *q) {
+    uint32_t head = atomic_load(&q->head);
+    uint32_t discard = atomic_load(&q->discard_until);
+    return (int32_t)(discard - head) > 0 ? discard : head;
+}
+
+static int spsc_ring_packets(PacketQueue *q) {
+    uint32_t tail = atomic_load(&q->tail);
+    int32_t n = (int32_t)(tail - spsc_live_head(q));
+    return n > 0 ? n : 0;
+}
+
+static int spsc_nb_packets(PacketQueue *q) {
+    return spsc_ring_packets(q) + atomic_load(&q->overflow_count);
+}
+
+static uint64_t spsc_bytes(PacketQueue *q) {
+    uint64_t put = atomic_load(&q->put_bytes);
+    uint64_t got = atomic_load(&q->got_bytes);
+    uint64_t flushed = atomic_load(&q->flush_bytes);
+    uint64_t base = got > flushed ? got : flushed;
+    return put > base ? put - base : 0;
+}
+
+static int64_t spsc_duration(PacketQueue *q) {
+    int64_t put = atomic_load(&q->put_duration);
+    int64_t got = atomic_load(&q->got_duration);
+    int64_t flushed = atomic_load(&q->flush_duration);
+    int64_t base = got > flushed ? got : flushed;
+    return put > base ? put - base : 0;
+}
+
+static bool spsc_is_full(PacketQueue *q) {
+    if (atomic_load(&q->abort_request)) {
+        return true;  // aborted очередь никто не читает
+    }
+    if (q->max_packets > 0 && spsc_nb_packets(q) >= q->max_packets) {
+        return true;
+    }
+    if (q->max_bytes > 0 && spsc_bytes(q) >= (uint64_t)q->max_bytes) {
+        return true;
+    }
+    if (q->max_duration > 0 && spsc_duration(q) >= q->max_duration) {
+        return true;
+    }
+    return false;
+}
+
+/// Освободить устаревшие (до discard_until) пакеты — выполняет consumer
+///
+/// @return true если что-то было отброшено
+static bool spsc_consume_discarded(PacketQueue *q) {
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint32_t discard = atomic_load_explicit(&q->discard_until, memory_order_acquire);
+    if ((int32_t)(discard - head) <= 0) {
+        return false;
+    }
+
+    PacketSlot *last = NULL;
+    for (uint32_t i = head; i != discard; i++) {
+        last = &q->ring[i & q->mask];
+        av_packet_unref(&last->pkt);
+    }
+    atomic_store(&q->got_bytes, last->cum_bytes);
+    atomic_store(&q->got_duration, last->cum_duration);
+    atomic_store(&q->head, discard);
+    return true;
+}
+
+/// Дописать пакет в overflow-список (producer; кольцо заполнено или список не пуст)
+static int spsc_overflow_put(PacketQueue *q, AVPacket *pkt, int serial,
+                             uint64_t cum_bytes, int64_t cum_duration) {
+    pthread_mutex_lock(&q->overflow_mutex);
+    PacketOverflowNode *node = q->overflow_free;
+    if (node) {
+        q->overflow_free = node->next;
+        q->nb_overflow_free--;
+    } else {
+        node = malloc(sizeof(PacketOverflowNode));
+        if (!node) {
+            pthread_mutex_unlock(&q->overflow_mutex);
+            av_packet_unref(pkt);
+            return -1;
+        }
+        memset(&node->slot.pkt, 0, sizeof(node->slot.pkt));
+        q->node_allocs++;
+    }
+    av_packet_move_ref(&node->slot.pkt, pkt);  // zero-copy
+    node->slot.serial = serial;
+    node->slot.cum_bytes = cum_bytes;
+    node->slot.cum_duration = cum_duration;
+    node->next = NULL;
+    if (q->overflow_last) {
+        q->overflow_last->next = node;
+    } else {
+        q->overflow_first = node;
+    }
+    q->overflow_last = node;
+
+    atomic_store(&q->put_bytes, cum_bytes);
+    atomic_store(&q->put_duration, cum_duration);
+    atomic_fetch_add_explicit(&q->packets_put, 1, memory_order_relaxed);
+    atomic_fetch_add(&q->overflow_count, 1);
+    pthread_mutex_unlock(&q->overflow_mutex);
+
+    spsc_wake_consumer(q);
+    return 0;
+}
+
+/// Взять пакет из overflow-списка (consumer) — только при пустом кольце:
+/// в кольце пакеты старше любого пакета списка
+///
+/// @return false, если кольцо уже не пустое или список сброшен flush'ем
+static bool spsc_overflow_get(PacketQueue *q, uint32_t head, AVPacket *pkt, int *serial) {
+    pthread_mutex_lock(&q->overflow_mutex);
+    PacketOverflowNode *node = q->overflow_first;
+    if (!node || atomic_load(&q->tail) != head) {
+        pthread_mutex_unlock(&q->overflow_mutex);
+        return false;
+    }
+    q->overflow_first = node->next;
+    if (!q->overflow_first) {
+        q->overflow_last = NULL;
+    }
+    av_packet_move_ref(pkt, &node->slot.pkt);  // ownership переходит вызывающему
+    if (serial) {
+        *serial = node->slot.serial;
+    }
+    atomic_store(&q->got_bytes, node->slot.cum_bytes);
+    atomic_store(&q->got_duration, node->slot.cum_duration);
+    atomic_fetch_sub(&q->overflow_count, 1);
+
+    node->next = q->overflow_free;
+    q->overflow_free = node;
+    q->nb_overflow_free++;
+    pthread_mutex_unlock(&q->overflow_mutex);
+    return true;
+}
+
+void packet_queue_init(PacketQueue *q) {
+    memset(q, 0, sizeof(PacketQueue));
+    q->capacity = PACKET_QUEUE_SPSC_CAPACITY;
+    q->mask = PACKET_QUEUE_SPSC_CAPACITY - 1;
+    q->ring = calloc(q->capacity, sizeof(PacketSlot));
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->discard_until, 0);
+    atomic_init(&q->abort_request, false);
+    atomic_init(&q->overflow_count, 0);
+    pthread_mutex_init(&q->overflow_mutex, NULL);
+}
+
+void packet_queue_destroy(PacketQueue *q) {
+    if (q->ring) {
+        uint32_t tail = atomic_load(&q->tail);
+        for (uint32_t i = atomic_load(&q->head); i != tail; i++) {
+            av_packet_unref(&q->ring[i & q->mask].pkt);
+        }
+        free(q->ring);
+        q->ring = NULL;
+    }
+
+    pthread_mutex_lock(&q->overflow_mutex);
+    while (q->overflow_first) {
+        PacketOverflowNode *node = q->overflow_first;
+        q->overflow_first = node->next;
+        av_packet_unref(&node->slot.pkt);
+        free(node);
+    }
+    q->overflow_last = NULL;
+    atomic_store(&q->overflow_count, 0);
+    while (q->overflow_free) {
+        PacketOverflowNode *node = q->overflow_free;
+        q->overflow_free = node->next;
+        free(node);
+    }
+    q->nb_overflow_free = 0;
+    pthread_mutex_unlock(&q->overflow_mutex);
+    pthread_mutex_destroy(&q->overflow_mutex);
+}
+
+void packet_queue_abort(PacketQueue *q) {
+    atomic_store(&q->abort_request, true);
+    spsc_wake_consumer(q);
+    packet_queue_notify_space(q);
+}
+
+void packet_queue_reset_abort(PacketQueue *q) {
+    atomic_store(&q->abort_request, false);
+    spsc_wake_consumer(q);
+}
+
+void packet_queue_flush(PacketQueue *q) {
+    pthread_mutex_lock(&q->overflow_mutex);
+
+    // Суммы берём из последнего опубликованного пакета (конец overflow-списка
+    // или слот перед tail) и публикуем ДО discard_until
+    uint32_t tail = atomic_load(&q->tail);
+    const PacketSlot *last = NULL;
+    if (q->overflow_last) {
+        last = &q->overflow_last->slot;
+    } else if (q->ring && atomic_load(&q->packets_put) > 0) {
+        last = &q->ring[(tail - 1) & q->mask];
+    }
+    if (last) {
+        atomic_store(&q->flush_bytes, last->cum_bytes);
+        atomic_store(&q->flush_duration, last->cum_duration);
+    }
+    atomic_store_explicit(&q->discard_until, tail, memory_order_release);
+
+    // Overflow-список consumer не читает без mutex: узлы освобождаем здесь
+    while (q->overflow_first) {
+        PacketOverflowNode *node = q->overflow_first;
+        q->overflow_first = node->next;
+        av_packet_unref(&node->slot.pkt);
+        node->next = q->overflow_free;
+        q->overflow_free = node;
+        q->nb_overflow_free++;
+    }
+    q->overflow_last = NULL;
+    atomic_store(&q->overflow_count, 0);
+    pthread_mutex_unlock(&q->overflow_mutex);
+
+    spsc_wake_consumer(q);
+    packet_queue_notify_space(q);
+}
+
+int packet_queue_put(PacketQueue *q, AVPacket *pkt, int serial) {
+    if (!q->ring || atomic_load(&q->abort_request)) {
+        av_packet_unref(pkt);
+        return -1;
+    }
+
+    // av_read_frame отдаёт refcounted пакеты; не-refcounted данные принадлежат demuxer'у
+    if (!pkt->buf && av_packet_make_refcounted(pkt) < 0) {
+        av_packet_unref(pkt);
+        return -1;
+    }
+
+    int64_t duration = pkt->duration > 0 ? pkt->duration : 0;
+    uint64_t cum_bytes = atomic_load_explicit(&q->put_bytes, memory_order_relaxed) + (uint64_t)pkt->size;
+    int64_t cum_duration = atomic_load_explicit(&q->put_duration, memory_order_relaxed) + duration;
+
+    // Кольцо физически заполнено (плохой interleave: demux читает дальше ради другого
+    // стрима) → overflow-список. Ждать consumer'а здесь нельзя: он может стоять на
+    // AV-sync gate, которому нужны пакеты другого стрима, а seek/close не обработаются
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    if (atomic_load(&q->overflow_count) > 0 || tail - atomic_load(&q->head) >= q->capacity) {
+        return spsc_overflow_put(q, pkt, serial, cum_bytes, cum_duration);
+    }
+
+    PacketSlot *slot = &q->ring[tail & q->mask];
+    av_packet_move_ref(&slot->pkt, pkt);  // zero-copy
+    slot->serial = serial;
+    slot->cum_bytes = cum_bytes;
+    slot->cum_duration = cum_duration;
+
+    atomic_store(&q->put_bytes, cum_bytes);
+    atomic_store(&q->put_duration, cum_duration);
+    atomic_fetch_add_explicit(&q->packets_put, 1, memory_order_relaxed);
+    atomic_store(&q->tail, tail + 1);  // публикация слота
+
+    spsc_wake_consumer(q);
+    return 0;
+}
+
+int packet_queue_get(PacketQueue *q, AVPacket *pkt, bool block, int *serial) {
+    for (;;) {
+        if (atomic_load(&q->abort_request)) {
+            return -1;
+        }
+
+        // discard_until ≤ tail на момент flush, поэтому tail читаем ПОСЛЕ сброса
+        // устаревших пакетов: head никогда не обгоняет tail
+        bool was_full = spsc_is_full(q);
+        bool discarded = spsc_consume_discarded(q);
+        uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+        uint32_t tail = atomic_load(&q->tail);
+
+        if (head != tail) {
+            PacketSlot *slot = &q->ring[head & q->mask];
+            av_packet_move_ref(pkt, &slot->pkt);  // ownership переходит вызывающему
+            if (serial) {
+                *serial = slot->serial;
+            }
+            atomic_store(&q->got_bytes, slot->cum_bytes);
+            atomic_store(&q->got_duration, slot->cum_duration);
+            atomic_store(&q->head, head + 1);
+
+            // Будим demux только на переходах: "заполнена → есть место" и "опустела"
+            if ((was_full && !spsc_is_full(q)) || spsc_nb_packets(q) == 0) {
+                packet_queue_notify_space(q);
+            }
+            return 1;
+        }
+
+        if (atomic_load(&q->overflow_count) > 0) {
+            if (!spsc_overflow_get(q, head, pkt, serial)) {
+                continue;  // Кольцо успело пополниться или flush сбросил список
+            }
+            if ((was_full && !spsc_is_full(q)) || spsc_nb_packets(q) == 0) {
+                packet_queue_notify_space(q);
+            }
+            return 1;
+        }
+
+        if (discarded) {
+            packet_queue_notify_space(q);
+        }
+
+        if (!block) {
+            return 0;
+        }
+
+        // Очередь пустая → futex wait
+        unsigned int seq = atomic_load(&q->data_seq);
+        atomic_store(&q->consumer_waiting, 1);
+        if (atomic_load(&q->tail) == head &&
+            atomic_load(&q->overflow_count) == 0 &&
+            (int32_t)(atomic_load(&q->discard_until) - head) <= 0 &&
+            !atomic_load(&q->abort_request)) {
+            spsc_futex_wait(&q->data_seq, seq);
+        }
+        atomic_store(&q->consumer_waiting, 0);
+    }
+}
+
+void packet_queue_set_limits(PacketQueue *q, int max_bytes, int max_packets,
+                             double max_duration_sec, AVRational time_base) {
+    q->max_bytes = max_bytes;
+    q->max_packets = max_packets;
+    q->time_base = time_base;
+    q->max_duration = 0;
+    if (max_duration_sec > 0 && time_base.num > 0 && time_base.den > 0) {
+        q->max_duration = av_rescale_q((int64_t)(max_duration_sec * AV_TIME_BASE),
+                                       AV_TIME_BASE_Q, time_base);
+    }
+
+    packet_queue_notify_space(q);
+}
+
+void packet_queue_set_space_notify(PacketQueue *q, pthread_mutex_t *mutex, pthread_cond_t *cond) {
+    q->space_mutex = mutex;
+    q->space_cond = cond;
+}
+
+bool packet_queue_is_full(PacketQueue *q) {
+    return spsc_is_full(q);
+}
+
+int packet_queue_nb_packets(PacketQueue *q) {
+    return spsc_nb_packets(q);
+}
+
+void packet_queue_get_stats(PacketQueue *q, PacketQueueStats *stats) {
+    stats->nb_packets = spsc_nb_packets(q);
+    stats->size = (int)spsc_bytes(q);
+    stats->duration = spsc_duration(q);
+    stats->packets_put = atomic_load(&q->packets_put);
+
+    // Слоты кольца выделены один раз: аллокации — только узлы overflow-списка
+    pthread_mutex_lock(&q->overflow_mutex);
+    stats->nb_free_nodes = (int)q->capacity - spsc_ring_packets(q) + q->nb_overflow_free;
+    stats->node_allocs = q->node_allocs;
+    pthread_mutex_unlock(&q->overflow_mutex);
+}
+
+#endif // PACKET_QUEUE_SPSC
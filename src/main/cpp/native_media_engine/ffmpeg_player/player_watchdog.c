@@ -0,0 +1,253 @@
+/// 🔥 КРИТИЧЕСКИЙ FIX: AVSYNC / SEEK watchdog threads
+///
+/// Вынесены из ffmpeg_player_lifecycle.c: не зависят от EGL/JNI и
+/// собираются в host-ядре плеера (ffmpeg_player_core).
+
+#include "player_watchdog.h"
+#include "avsync_gate.h"
+#include "player_events.h"  // Для native_player_emit_error_event
+#include <pthread.h>
+#include <time.h>    // clock_gettime для seek watchdog
+#include <unistd.h>  // Для usleep
+#include "libavutil/time.h"  // Для av_gettime
+#include "platform_log.h"
+
+#define LOG_TAG "PlayerWatchdog"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define ALOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+#define ALOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+/// 🔥 КРИТИЧЕСКИЙ FIX: AVSYNC-CODE-DIFF - AVSYNC Watchdog thread
+///
+/// Проверяет clock stall каждые 500ms
+/// Если master clock не обновляется > 500ms → инвалидирует AVSYNC и останавливает playback
+///
+/// 🔥 КРИТИЧЕСКИЙ FIX: Watchdog должен быть контекстно-осознанным
+/// - Не проверяет stall если state != PLAYING
+/// - Не проверяет stall если первый кадр ещё не отрисован
+/// - Для video-only разрешает idle clock до первого frame
+static void *avsync_watchdog_thread(void *arg) {
+    PlayerContext *ctx = (PlayerContext *)arg;
+    if (!ctx) {
+        return NULL;
+    }
+    
+    ALOGI("🔄 AVSYNC Watchdog: Thread started");
+    
+    while (!ctx->abort && !ctx->shutting_down) {
+        usleep(500000); // 500ms
+        
+        if (ctx->abort || ctx->shutting_down) {
+            break;
+        }
+        
+        // 🔥 КРИТИЧЕСКИЙ FIX: AUTO-NEXT - EOF ≠ STALL
+        // Если EOF достигнут, watchdog должен быть отключён
+        // EOF - это нормальное завершение playback, не ошибка
+        if (ctx->eof_reached) {
+            continue; // ❌ EOF достигнут - не проверяем stall
+        }
+        
+        // 🔥 FIX 3: Watchdog должен знать FSM state
+        // Не проверяем stall если state != PLAYING
+        if (ctx->state.state != PLAYBACK_RUNNING || ctx->paused) {
+            continue; // ❌ не проверяем stall если не playing
+        }
+        
+        // 🔥 FIX 4: Первому кадру — special handling
+        // Clock не считается stalled, пока не отрисован первый frame
+        // Это КРИТИЧНО для AVI / FLV (часто первый frame приходит с задержкой)
+        if (ctx->video && !ctx->video->first_frame_rendered) {
+            continue; // ❌ не проверяем stall до первого frame
+        }
+        
+        // 🔥 FIX 2: Video-only → разрешить "idle clock"
+        // Для video-only режима до первого frame clock = IDLE (это нормально)
+        bool is_video_only = (ctx->has_audio == 0);
+        if (is_video_only && ctx->video && !ctx->video->clock.valid) {
+            continue; // ❌ video-only: clock может быть idle до первого frame
+        }
+        
+        // Проверяем clock stall (только если все условия выполнены)
+        if (avsync_gate_check_stall(&ctx->avsync_gate, 500000)) { // 500ms threshold
+            // 🔒 ЗАЩИТНЫЙ ASSERT (ОБЯЗАТЕЛЬНО)
+            #ifdef DEBUG
+            if (ctx->eof_reached) {
+                ALOGE("❌ AVSYNC Watchdog ASSERT FAILED: STALL and EOF cannot happen together (FATAL)");
+                abort();
+            }
+            #endif
+            
+            // Clock stall обнаружен → инвалидируем AVSYNC и эмитим error
+            avsync_gate_invalidate(&ctx->avsync_gate, "MASTER CLOCK STALLED");
+            
+            extern void native_player_emit_error_event(const char *message);
+            native_player_emit_error_event("CLOCK_STALL");
+            
+            // Останавливаем playback
+            player_pause(ctx);
+            
+            ALOGE("❌ AVSYNC Watchdog: Clock stall detected - playback stopped");
+        }
+    }
+    
+    ALOGI("✅ AVSYNC Watchdog: Thread stopped");
+    return NULL;
+}
+
+/// 🔥 КРИТИЧЕСКИЙ FIX: AVSYNC-CODE-DIFF - запустить AVSYNC watchdog thread
+///
+/// 🔥 КРИТИЧЕСКИЙ FIX: Вызывается ТОЛЬКО после play()
+/// Watchdog должен стартовать когда clocks начали тикать
+/// Иначе для video-only файлов watchdog будет считать idle clock как stall
+int avsync_watchdog_start(PlayerContext *ctx) {
+    if (!ctx) {
+        return -1;
+    }
+    
+    // Проверяем, не запущен ли уже
+    if (ctx->avsyncWatchdogThread != 0) {
+        ALOGD("⚠️ avsync_watchdog_start: Watchdog already running");
+        return 0;
+    }
+    
+    int ret = pthread_create(&ctx->avsyncWatchdogThread, NULL, avsync_watchdog_thread, ctx);
+    if (ret != 0) {
+        ALOGE("❌ avsync_watchdog_start: Failed to create watchdog thread: %d", ret);
+        return -1;
+    }
+    
+    ALOGI("✅ AVSYNC Watchdog: Thread started");
+    return 0;
+}
+
+/// 🔥 КРИТИЧЕСКИЙ FIX: AUTO-NEXT - остановить AVSYNC watchdog thread
+///
+/// Вызывается при EOF для предотвращения ложных срабатываний
+/// EOF ≠ STALL - это нормальное завершение playback
+void avsync_watchdog_stop(PlayerContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+    
+    // Проверяем, запущен ли watchdog
+    if (ctx->avsyncWatchdogThread == 0) {
+        ALOGD("⚠️ avsync_watchdog_stop: Watchdog not running");
+        return;
+    }
+    
+    // Останавливаем watchdog thread
+    // Thread сам завершится при следующей проверке abort/shutting_down
+    // Мы просто ждём его завершения
+    ALOGI("🛑 avsync_watchdog_stop: Stopping AVSYNC watchdog thread...");
+    pthread_join(ctx->avsyncWatchdogThread, NULL);
+    ctx->avsyncWatchdogThread = 0;
+    ALOGI("✅ avsync_watchdog_stop: AVSYNC watchdog thread stopped");
+}
+
+/// 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - Seek Watchdog thread
+///
+/// Проверяет seek deadlock каждые 1200ms
+/// Если seek_in_progress > 1200ms и нет firstFrameAfterSeek → эмитим error и останавливаем playback
+static void *seek_watchdog_thread(void *arg) {
+    PlayerContext *ctx = (PlayerContext *)arg;
+    if (!ctx) {
+        return NULL;
+    }
+    
+    ALOGI("🔄 Seek Watchdog: Thread started");
+    
+    int64_t seek_start_ms = av_gettime() / 1000;  // миллисекунды
+    
+    // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - PATCH 4: Hard deadlock guard
+    // Ждём 1000ms (уменьшено с 1200ms для более быстрой детекции)
+    // 🔥 SCRUB: ожидание прерываемое — seek_watchdog_stop/start (firstFrameAfterSeek,
+    // следующий seek) не должны блокироваться на join до конца таймаута
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 1;  // 1000ms
+    
+    pthread_mutex_lock(&ctx->state.seek_watchdog_mutex);
+    while (!ctx->state.seek_watchdog_cancel) {
+        if (pthread_cond_timedwait(&ctx->state.seek_watchdog_cond,
+                                   &ctx->state.seek_watchdog_mutex, &deadline) != 0) {
+            break;  // ETIMEDOUT
+        }
+    }
+    int cancelled = ctx->state.seek_watchdog_cancel;
+    pthread_mutex_unlock(&ctx->state.seek_watchdog_mutex);
+    
+    // Проверяем, завершился ли seek
+    if (cancelled || ctx->abort || ctx->shutting_down) {
+        ALOGI("✅ Seek Watchdog: Thread stopped (abort/shutdown)");
+        return NULL;
+    }
+    
+    // Проверяем, идёт ли ещё seek
+    if (avsync_gate_is_seek_in_progress(&ctx->avsync_gate) || ctx->waiting_first_frame_after_seek) {
+        int64_t elapsed_ms = (av_gettime() / 1000) - seek_start_ms;
+        // Seek deadlock обнаружен → эмитим error
+        // ❌ Никаких silent fails, ❌ Никаких infinite waits
+        ALOGE("❌ SEEK DEADLOCK: no frame after seek (%lld ms timeout) - SEEK_FRAME_ASSERT_FAILED", 
+              (long long)elapsed_ms);
+        
+        extern void native_player_emit_error_event(const char *message);
+        native_player_emit_error_event("SEEK_FRAME_ASSERT_FAILED");
+        
+        // Останавливаем playback
+        player_pause(ctx);
+        
+        ALOGE("❌ Seek Watchdog: Deadlock detected - playback stopped");
+    }
+    
+    ALOGI("✅ Seek Watchdog: Thread stopped");
+    return NULL;
+}
+
+/// 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - запустить seek watchdog thread
+///
+/// Вызывается при начале seek для мониторинга deadlock
+int seek_watchdog_start(PlayerContext *ctx) {
+    if (!ctx) {
+        return -1;
+    }
+    
+    // Останавливаем предыдущий watchdog если он запущен
+    if (ctx->seekWatchdogThread != 0) {
+        ALOGD("⚠️ seek_watchdog_start: Stopping previous watchdog");
+        seek_watchdog_stop(ctx);
+    }
+    
+    pthread_mutex_lock(&ctx->state.seek_watchdog_mutex);
+    ctx->state.seek_watchdog_cancel = 0;
+    pthread_mutex_unlock(&ctx->state.seek_watchdog_mutex);
+    
+    int ret = pthread_create(&ctx->seekWatchdogThread, NULL, seek_watchdog_thread, ctx);
+    if (ret != 0) {
+        ALOGE("❌ seek_watchdog_start: Failed to create watchdog thread: %d", ret);
+        return -1;
+    }
+    
+    ALOGI("✅ Seek Watchdog: Thread started");
+    return 0;
+}
+
+/// Остановить seek watchdog thread
+void seek_watchdog_stop(PlayerContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+    
+    if (ctx->seekWatchdogThread != 0) {
+        ALOGI("🛑 seek_watchdog_stop: Stopping seek watchdog thread...");
+        pthread_mutex_lock(&ctx->state.seek_watchdog_mutex);
+        ctx->state.seek_watchdog_cancel = 1;
+        pthread_cond_broadcast(&ctx->state.seek_watchdog_cond);
+        pthread_mutex_unlock(&ctx->state.seek_watchdog_mutex);
+        pthread_join(ctx->seekWatchdogThread, NULL);
+        ctx->seekWatchdogThread = 0;
+        ALOGI("✅ seek_watchdog_stop: Seek watchdog thread stopped");
+    }
+}
+
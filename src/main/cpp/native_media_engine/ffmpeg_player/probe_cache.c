@@ -0,0 +1,459 @@
+/// 🔥 PROBE CACHE: persistent кэш find_stream_info (см. probe_cache.h)
+///
+/// Формат (<cache_dir>/<fnv1a64(path)>.prb, native endian):
+///   ProbeCacheHeader
+///   { ProbeCacheStream, uint8_t extradata[extradata_size] } x nb_streams
+
+#include "probe_cache.h"
+#include "libavutil/time.h"  // av_gettime_relative
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "platform_log.h"
+
+#define LOG_TAG "ProbeCache"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define ALOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+#define PROBE_CACHE_MAGIC "SPRB"
+#define PROBE_CACHE_VERSION 1
+#define PROBE_CACHE_MAX_STREAMS 64
+#define PROBE_CACHE_MAX_EXTRADATA (1024 * 1024)
+
+typedef struct ProbeCacheHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t file_size;
+    int64_t file_mtime;
+    int64_t duration;     // AVFormatContext.duration (AV_TIME_BASE)
+    int64_t start_time;
+    int64_t bit_rate;
+    char iformat[32];     // Имя demuxer'а: другой demuxer → кэш не годится
+    uint32_t nb_streams;
+    uint32_t reserved;
+} ProbeCacheHeader;
+
+/// Стрим: поля AVCodecParameters + тайминги AVStream
+typedef struct ProbeCacheStream {
+    int32_t codec_type;
+    int32_t codec_id;
+    uint32_t codec_tag;
+    int32_t format;
+    int64_t bit_rate;
+    int32_t bits_per_coded_sample;
+    int32_t bits_per_raw_sample;
+    int32_t profile;
+    int32_t level;
+    int32_t width;
+    int32_t height;
+    int32_t sar_num, sar_den;
+    int32_t field_order;
+    int32_t color_range;
+    int32_t color_primaries;
+    int32_t color_trc;
+    int32_t color_space;
+    int32_t chroma_location;
+    int32_t video_delay;
+    int32_t ch_order;
+    int32_t nb_channels;
+    uint64_t ch_mask;
+    int32_t sample_rate;
+    int32_t block_align;
+    int32_t frame_size;
+    int32_t initial_padding;
+    int32_t trailing_padding;
+    int32_t seek_preroll;
+    int32_t avg_fr_num, avg_fr_den;
+    int32_t r_fr_num, r_fr_den;
+    int64_t start_time;
+    int64_t duration;
+    uint32_t extradata_size;
+    uint32_t reserved;
+} ProbeCacheStream;
+
+typedef struct ProbeCacheEntry {
+    ProbeCacheHeader hdr;
+    ProbeCacheStream streams[PROBE_CACHE_MAX_STREAMS];
+    uint8_t *extradata[PROBE_CACHE_MAX_STREAMS];
+} ProbeCacheEntry;
+
+static pthread_mutex_t g_cache_dir_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char *g_cache_dir = NULL;
+
+static atomic_llong g_hits;
+static atomic_llong g_misses;
+static atomic_llong g_fallbacks;
+static atomic_llong g_stores;
+static atomic_llong g_probe_us;
+
+void probe_cache_set_dir(const char *dir) {
+    if (dir && dir[0] && mkdir(dir, 0700) != 0 && errno != EEXIST) {
+        ALOGW("⚠️ Cannot create probe cache dir: %s", dir);
+    }
+
+    pthread_mutex_lock(&g_cache_dir_mutex);
+    free(g_cache_dir);
+    g_cache_dir = (dir && dir[0]) ? strdup(dir) : NULL;
+    pthread_mutex_unlock(&g_cache_dir_mutex);
+
+    ALOGI("🧭 Probe cache dir: %s", dir ? dir : "(none)");
+}
+
+void probe_cache_get_stats(ProbeCacheStats *out) {
+    if (!out) {
+        return;
+    }
+    out->hits = atomic_load(&g_hits);
+    out->misses = atomic_load(&g_misses);
+    out->fallbacks = atomic_load(&g_fallbacks);
+    out->stores = atomic_load(&g_stores);
+    out->probe_us = atomic_load(&g_probe_us);
+}
+
+/// Путь к файлу кэша
+///
+/// @return false если каталог не задан
+static bool cache_path(const char *path, char *out, size_t out_size) {
+    // FNV-1a 64 (как у keyframe index sidecar)
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+
+    pthread_mutex_lock(&g_cache_dir_mutex);
+    bool ok = g_cache_dir != NULL;
+    if (ok) {
+        snprintf(out, out_size, "%s/%016llx.prb", g_cache_dir, (unsigned long long)hash);
+    }
+    pthread_mutex_unlock(&g_cache_dir_mutex);
+    return ok;
+}
+
+static bool file_identity(const char *path, int64_t *size, int64_t *mtime) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return false;
+    }
+    *size = (int64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+    return true;
+}
+
+static void probe_cache_entry_free(ProbeCacheEntry **pe) {
+    if (!pe || !*pe) {
+        return;
+    }
+    for (uint32_t i = 0; i < (*pe)->hdr.nb_streams; i++) {
+        free((*pe)->extradata[i]);
+    }
+    free(*pe);
+    *pe = NULL;
+}
+
+static ProbeCacheEntry *probe_cache_load(const char *path, const char *iformat) {
+    char file[1024];
+    int64_t size, mtime;
+    if (!cache_path(path, file, sizeof(file)) || !file_identity(path, &size, &mtime)) {
+        return NULL;
+    }
+
+    FILE *f = fopen(file, "rb");
+    if (!f) {
+        return NULL;
+    }
+
+    char name[sizeof(((ProbeCacheHeader *)0)->iformat)];
+    snprintf(name, sizeof(name), "%s", iformat);  // Обрезается так же, как при save
+
+    ProbeCacheEntry *e = calloc(1, sizeof(ProbeCacheEntry));
+    if (!e || fread(&e->hdr, sizeof(e->hdr), 1, f) != 1 ||
+        memcmp(e->hdr.magic, PROBE_CACHE_MAGIC, 4) != 0 ||
+        e->hdr.version != PROBE_CACHE_VERSION ||
+        e->hdr.file_size != size || e->hdr.file_mtime != mtime ||
+        strncmp(e->hdr.iformat, name, sizeof(name)) != 0 ||
+        e->hdr.nb_streams == 0 || e->hdr.nb_streams > PROBE_CACHE_MAX_STREAMS) {
+        free(e);
+        fclose(f);
+        return NULL;
+    }
+
+    bool ok = true;
+    uint32_t n = e->hdr.nb_streams;
+    e->hdr.nb_streams = 0;  // Для entry_free: освобождать только прочитанное
+    for (uint32_t i = 0; ok && i < n; i++) {
+        ProbeCacheStream *s = &e->streams[i];
+        ok = fread(s, sizeof(*s), 1, f) == 1 && s->extradata_size <= PROBE_CACHE_MAX_EXTRADATA;
+        if (ok && s->extradata_size > 0) {
+            e->extradata[i] = malloc(s->extradata_size);
+            ok = e->extradata[i] && fread(e->extradata[i], s->extradata_size, 1, f) == 1;
+        }
+        e->hdr.nb_streams = i + 1;
+    }
+    fclose(f);
+
+    if (!ok) {
+        ALOGW("⚠️ Probe cache corrupted: %s", file);
+        probe_cache_entry_free(&e);
+    }
+    return e;
+}
+
+/// Сохранить результат probe (tmp + rename; tmp уникален на поток —
+/// batch thumbnails могут открывать один файл параллельно)
+static void probe_cache_save(AVFormatContext *fmt, const char *path) {
+    char file[1024], tmp[1060];
+    int64_t size, mtime;
+    if (!cache_path(path, file, sizeof(file)) || !file_identity(path, &size, &mtime) ||
+        fmt->nb_streams == 0 || fmt->nb_streams > PROBE_CACHE_MAX_STREAMS) {
+        return;
+    }
+    snprintf(tmp, sizeof(tmp), "%s.%lx.tmp", file, (unsigned long)pthread_self());
+
+    FILE *f = fopen(tmp, "wb");
+    if (!f) {
+        ALOGW("⚠️ Cannot write probe cache: %s", tmp);
+        return;
+    }
+
+    ProbeCacheHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, PROBE_CACHE_MAGIC, 4);
+    hdr.version = PROBE_CACHE_VERSION;
+    hdr.file_size = size;
+    hdr.file_mtime = mtime;
+    hdr.duration = fmt->duration;
+    hdr.start_time = fmt->start_time;
+    hdr.bit_rate = fmt->bit_rate;
+    snprintf(hdr.iformat, sizeof(hdr.iformat), "%s", fmt->iformat->name);
+    hdr.nb_streams = fmt->nb_streams;
+
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+    for (unsigned int i = 0; ok && i < fmt->nb_streams; i++) {
+        const AVStream *st = fmt->streams[i];
+        const AVCodecParameters *par = st->codecpar;
+        ProbeCacheStream s;
+        memset(&s, 0, sizeof(s));
+        s.codec_type = par->codec_type;
+        s.codec_id = par->codec_id;
+        s.codec_tag = par->codec_tag;
+        s.format = par->format;
+        s.bit_rate = par->bit_rate;
+        s.bits_per_coded_sample = par->bits_per_coded_sample;
+        s.bits_per_raw_sample = par->bits_per_raw_sample;
+        s.profile = par->profile;
+        s.level = par->level;
+        s.width = par->width;
+        s.height = par->height;
+        s.sar_num = par->sample_aspect_ratio.num;
+        s.sar_den = par->sample_aspect_ratio.den;
+        s.field_order = par->field_order;
+        s.color_range = par->color_range;
+        s.color_primaries = par->color_primaries;
+        s.color_trc = par->color_trc;
+        s.color_space = par->color_space;
+        s.chroma_location = par->chroma_location;
+        s.video_delay = par->video_delay;
+        s.ch_order = par->ch_layout.order;
+        s.nb_channels = par->ch_layout.nb_channels;
+        s.ch_mask = par->ch_layout.order == AV_CHANNEL_ORDER_NATIVE ? par->ch_layout.u.mask : 0;
+        s.sample_rate = par->sample_rate;
+        s.block_align = par->block_align;
+        s.frame_size = par->frame_size;
+        s.initial_padding = par->initial_padding;
+        s.trailing_padding = par->trailing_padding;
+        s.seek_preroll = par->seek_preroll;
+        s.avg_fr_num = st->avg_frame_rate.num;
+        s.avg_fr_den = st->avg_frame_rate.den;
+        s.r_fr_num = st->r_frame_rate.num;
+        s.r_fr_den = st->r_frame_rate.den;
+        s.start_time = st->start_time;
+        s.duration = st->duration;
+        s.extradata_size = (par->extradata && par->extradata_size > 0 &&
+                            par->extradata_size <= PROBE_CACHE_MAX_EXTRADATA) ? (uint32_t)par->extradata_size : 0;
+
+        ok = fwrite(&s, sizeof(s), 1, f) == 1 &&
+             (s.extradata_size == 0 || fwrite(par->extradata, s.extradata_size, 1, f) == 1);
+    }
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok || rename(tmp, file) != 0) {
+        ALOGW("⚠️ Failed to save probe cache: %s", file);
+        remove(tmp);
+        return;
+    }
+    atomic_fetch_add(&g_stores, 1);
+}
+
+/// Стрим из заголовка / короткого probe соответствует кэшу
+static bool probe_cache_stream_matches(const AVStream *st, const ProbeCacheStream *s) {
+    return (int32_t)st->codecpar->codec_type == s->codec_type &&
+           (int32_t)st->codecpar->codec_id == s->codec_id;
+}
+
+/// Восстановить codecpar / тайминги стрима из кэша
+///
+/// Скаляры перезаписываются (кэш — результат полного probe того же файла),
+/// extradata из заголовка demuxer'а не трогаем. time_base задаёт demuxer.
+static void probe_cache_apply_stream(AVStream *st, const ProbeCacheStream *s, const uint8_t *extradata) {
+    AVCodecParameters *par = st->codecpar;
+    par->codec_tag = s->codec_tag;
+    par->format = s->format;
+    par->bit_rate = s->bit_rate;
+    par->bits_per_coded_sample = s->bits_per_coded_sample;
+    par->bits_per_raw_sample = s->bits_per_raw_sample;
+    par->profile = s->profile;
+    par->level = s->level;
+
+    if (par->codec_type == AVMEDIA_TYPE_VIDEO) {
+        par->width = s->width;
+        par->height = s->height;
+        par->sample_aspect_ratio = (AVRational){ s->sar_num, s->sar_den };
+        par->field_order = (enum AVFieldOrder)s->field_order;
+        par->color_range = (enum AVColorRange)s->color_range;
+        par->color_primaries = (enum AVColorPrimaries)s->color_primaries;
+        par->color_trc = (enum AVColorTransferCharacteristic)s->color_trc;
+        par->color_space = (enum AVColorSpace)s->color_space;
+        par->chroma_location = (enum AVChromaLocation)s->chroma_location;
+        par->video_delay = s->video_delay;
+    } else if (par->codec_type == AVMEDIA_TYPE_AUDIO) {
+        av_channel_layout_uninit(&par->ch_layout);
+        if (s->ch_order == AV_CHANNEL_ORDER_NATIVE && s->ch_mask) {
+            av_channel_layout_from_mask(&par->ch_layout, s->ch_mask);
+        } else if (s->nb_channels > 0) {
+            av_channel_layout_default(&par->ch_layout, s->nb_channels);
+        }
+        par->sample_rate = s->sample_rate;
+        par->block_align = s->block_align;
+        par->frame_size = s->frame_size;
+        par->initial_padding = s->initial_padding;
+        par->trailing_padding = s->trailing_padding;
+        par->seek_preroll = s->seek_preroll;
+    }
+
+    if (s->extradata_size > 0 && extradata && par->extradata_size == 0) {
+        par->extradata = av_mallocz(s->extradata_size + AV_INPUT_BUFFER_PADDING_SIZE);
+        if (par->extradata) {
+            memcpy(par->extradata, extradata, s->extradata_size);
+            par->extradata_size = (int)s->extradata_size;
+        }
+    }
+
+    if (st->avg_frame_rate.num == 0 && s->avg_fr_den != 0) {
+        st->avg_frame_rate = (AVRational){ s->avg_fr_num, s->avg_fr_den };
+    }
+    if (st->r_frame_rate.num == 0 && s->r_fr_den != 0) {
+        st->r_frame_rate = (AVRational){ s->r_fr_num, s->r_fr_den };
+    }
+    if (st->start_time == AV_NOPTS_VALUE) {
+        st->start_time = s->start_time;
+    }
+    if (st->duration == AV_NOPTS_VALUE) {
+        st->duration = s->duration;
+    }
+}
+
+static void probe_cache_apply_format(AVFormatContext *fmt, const ProbeCacheHeader *hdr) {
+    if (fmt->duration == AV_NOPTS_VALUE) {
+        fmt->duration = hdr->duration;
+    }
+    if (fmt->start_time == AV_NOPTS_VALUE) {
+        fmt->start_time = hdr->start_time;
+    }
+    if (fmt->bit_rate <= 0) {
+        fmt->bit_rate = hdr->bit_rate;
+    }
+}
+
+/// Нужны ли стриму данные из кэша после короткого probe
+static bool probe_cache_stream_incomplete(const AVStream *st) {
+    const AVCodecParameters *par = st->codecpar;
+    if (par->codec_type == AVMEDIA_TYPE_VIDEO) {
+        return par->width <= 0 || par->height <= 0 || par->format < 0;
+    }
+    if (par->codec_type == AVMEDIA_TYPE_AUDIO) {
+        return par->sample_rate <= 0 || par->ch_layout.nb_channels <= 0 || par->format < 0;
+    }
+    return false;
+}
+
+/// Попадание: пропустить или урезать probe
+///
+/// @return >= 0 — кэш применён, < 0 — кэш не подошёл (нужен полный probe)
+static int probe_cache_apply(AVFormatContext *fmt, const ProbeCacheEntry *e) {
+    // Стримы известны из заголовка и совпадают → probe не нужен
+    if (!(fmt->ctx_flags & AVFMTCTX_NOHEADER) && fmt->nb_streams == e->hdr.nb_streams) {
+        bool match = true;
+        for (unsigned int i = 0; match && i < fmt->nb_streams; i++) {
+            match = probe_cache_stream_matches(fmt->streams[i], &e->streams[i]);
+        }
+        if (match) {
+            for (unsigned int i = 0; i < fmt->nb_streams; i++) {
+                probe_cache_apply_stream(fmt->streams[i], &e->streams[i], e->extradata[i]);
+            }
+            probe_cache_apply_format(fmt, &e->hdr);
+            return 0;
+        }
+    }
+
+    // Стримы появляются при чтении (TS / FLV) → короткий probe
+    int64_t probesize = fmt->probesize;
+    int64_t analyze = fmt->max_analyze_duration;
+    fmt->probesize = PROBE_CACHE_PROBESIZE;
+    fmt->max_analyze_duration = PROBE_CACHE_ANALYZE_DURATION_US;
+    int ret = avformat_find_stream_info(fmt, NULL);
+    fmt->probesize = probesize;
+    fmt->max_analyze_duration = analyze;
+    if (ret < 0 || fmt->nb_streams < e->hdr.nb_streams) {
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < e->hdr.nb_streams; i++) {
+        if (!probe_cache_stream_matches(fmt->streams[i], &e->streams[i])) {
+            return -1;
+        }
+    }
+    for (unsigned int i = 0; i < e->hdr.nb_streams; i++) {
+        if (probe_cache_stream_incomplete(fmt->streams[i])) {
+            probe_cache_apply_stream(fmt->streams[i], &e->streams[i], e->extradata[i]);
+        }
+    }
+    probe_cache_apply_format(fmt, &e->hdr);
+    return ret;
+}
+
+int probe_cache_find_stream_info(AVFormatContext *fmt, const char *path) {
+    if (!fmt) {
+        return AVERROR(EINVAL);
+    }
+
+    int64_t t0 = av_gettime_relative();
+    ProbeCacheEntry *e = path ? probe_cache_load(path, fmt->iformat->name) : NULL;
+    int ret;
+
+    if (e && probe_cache_apply(fmt, e) >= 0) {
+        atomic_fetch_add(&g_hits, 1);
+        ret = 0;
+        ALOGI("🧭 Probe cache hit: %u streams (%s), %.1f ms", e->hdr.nb_streams,
+              (fmt->ctx_flags & AVFMTCTX_NOHEADER) ? "short probe" : "probe skipped",
+              (av_gettime_relative() - t0) / 1000.0);
+    } else {
+        atomic_fetch_add(e ? &g_fallbacks : &g_misses, 1);
+        ret = avformat_find_stream_info(fmt, NULL);
+        if (ret >= 0 && path) {
+            probe_cache_save(fmt, path);
+        }
+        ALOGI("🧭 Probe cache %s: full probe %.1f ms", e ? "mismatch" : "miss",
+              (av_gettime_relative() - t0) / 1000.0);
+    }
+
+    probe_cache_entry_free(&e);
+    atomic_fetch_add(&g_probe_us, av_gettime_relative() - t0);
+    return ret;
+}
@@ -0,0 +1,49 @@
+/// 🔥 PROBE CACHE: persistent кэш результата avformat_find_stream_info
+///
+/// find_stream_info для MKV / TS / AVI читает мегабайты и декодирует кадры,
+/// чтобы узнать pix_fmt, channel layout, frame rate — сотни ms на каждый
+/// open_media, thumbnail и запрос метаданных одного и того же файла.
+///
+/// Кэш (<cache_dir>/<fnv1a64(path)>.prb, ключ: путь + размер + mtime) хранит
+/// раскладку стримов, codecpar и extradata. При попадании:
+///   - demuxer с заголовком (MKV / MP4 / AVI) и совпавшими стримами →
+///     find_stream_info не вызывается, codecpar восстанавливаются из кэша;
+///   - остальные (TS / FLV: стримы появляются по ходу чтения) → короткий
+///     probe (probesize / analyzeduration урезаны), пробелы — из кэша.
+/// Расхождение с кэшем → полный probe и перезапись кэша.
+
+#ifndef PROBE_CACHE_H
+#define PROBE_CACHE_H
+
+#include "libavformat/avformat.h"
+#include <stdint.h>
+
+/// Урезанный probe при попадании (по умолчанию FFmpeg: 5MB / 5 sec)
+#define PROBE_CACHE_PROBESIZE (512 * 1024)
+#define PROBE_CACHE_ANALYZE_DURATION_US 500000
+
+/// Счётчики (с момента запуска процесса)
+typedef struct ProbeCacheStats {
+    int64_t hits;       // Кэш применён (probe пропущен или урезан)
+    int64_t misses;     // Кэша нет / устарел → полный probe
+    int64_t fallbacks;  // Кэш не совпал с файлом → полный probe после попытки
+    int64_t stores;     // Записано в кэш
+    int64_t probe_us;   // Суммарное время probe_cache_find_stream_info
+} ProbeCacheStats;
+
+/// Установить каталог кэша (app cache, например getCacheDir()/probe)
+///
+/// @param dir Каталог (копируется, создаётся), NULL — отключить кэш
+void probe_cache_set_dir(const char *dir);
+
+/// Замена avformat_find_stream_info(fmt, NULL) с кэшем
+///
+/// @param fmt AVFormatContext после avformat_open_input
+/// @param path Путь к файлу (ключ кэша), NULL — без кэша
+/// @return >= 0 при успехе, AVERROR как у avformat_find_stream_info
+int probe_cache_find_stream_info(AVFormatContext *fmt, const char *path);
+
+/// Текущие счётчики
+void probe_cache_get_stats(ProbeCacheStats *out);
+
+#endif // PROBE_CACHE_H
@@ -0,0 +1,236 @@
+/// 🔥 RGBA CONVERT: box-downscale YUV → RGBA (NEON / SSE2) + swscale fallback (см. rgba_convert.h)
+
+#include "rgba_convert.h"
+#include "sws_cache.h"
+#include "libavutil/frame.h"
+#include "libavutil/pixfmt.h"
+#include "libswscale/swscale.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/// Максимальный коэффициент: f строк * 255 должно помещаться в uint16 аккумулятор
+#define RGBA_FAST_MAX_FACTOR 32
+
+/// Аккумулятор на стеке (16 KB): хватает до 4K включительно, без malloc на кадр
+#define RGBA_FAST_STACK_ACC 8192
+
+/// YUV → RGB в fixed point (x256): R = cy*(Y - y_off) + crv*V, G = ... - cgu*U - cgv*V, B = ... + cbu*U
+typedef struct YuvCoeffs {
+    int y_off;
+    int cy;
+    int crv;
+    int cgu;
+    int cgv;
+    int cbu;
+} YuvCoeffs;
+
+static const YuvCoeffs k_bt601_limited = { 16, 298, 409, 100, 208, 516 };
+static const YuvCoeffs k_bt709_limited = { 16, 298, 459, 55, 136, 541 };
+static const YuvCoeffs k_bt601_full = { 0, 256, 359, 88, 183, 454 };
+static const YuvCoeffs k_bt709_full = { 0, 256, 403, 48, 120, 475 };
+
+static atomic_bool g_fast_enabled = true;
+static atomic_llong g_fast_frames;
+static atomic_llong g_sws_frames;
+
+static inline uint8_t clamp_u8(int v) {
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+/// acc[x] = src[x] (u8 → u16)
+static void widen_row(uint16_t *acc, const uint8_t *src, int width) {
+    int x = 0;
+#if defined(__ARM_NEON)
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t v = vld1q_u8(src + x);
+        vst1q_u16(acc + x, vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(acc + x + 8, vmovl_u8(vget_high_u8(v)));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 16 <= width; x += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + x));
+        _mm_storeu_si128((__m128i *)(acc + x), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i *)(acc + x + 8), _mm_unpackhi_epi8(v, zero));
+    }
+#endif
+    for (; x < width; x++) {
+        acc[x] = src[x];
+    }
+}
+
+/// acc[x] += src[x]
+static void add_row(uint16_t *acc, const uint8_t *src, int width) {
+    int x = 0;
+#if defined(__ARM_NEON)
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t v = vld1q_u8(src + x);
+        vst1q_u16(acc + x, vaddw_u8(vld1q_u16(acc + x), vget_low_u8(v)));
+        vst1q_u16(acc + x + 8, vaddw_u8(vld1q_u16(acc + x + 8), vget_high_u8(v)));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 16 <= width; x += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + x));
+        __m128i lo = _mm_loadu_si128((const __m128i *)(acc + x));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(acc + x + 8));
+        _mm_storeu_si128((__m128i *)(acc + x), _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero)));
+        _mm_storeu_si128((__m128i *)(acc + x + 8), _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero)));
+    }
+#endif
+    for (; x < width; x++) {
+        acc[x] += src[x];
+    }
+}
+
+/// Вертикальная сумма rows строк (row-major: аккумулятор остаётся в L1)
+static void accumulate_rows(uint16_t *acc, const uint8_t *src, ptrdiff_t linesize, int rows, int width) {
+    widen_row(acc, src, width);
+    for (int r = 1; r < rows; r++) {
+        add_row(acc, src + r * linesize, width);
+    }
+}
+
+/// Box-downscale + конвертация; -1 — кадр не подходит для быстрого пути
+static int rgba_convert_fast(const AVFrame *frame, int dst_w, int dst_h, uint8_t *dst, int dst_stride) {
+    int nv12 = frame->format == AV_PIX_FMT_NV12;
+    if (!nv12 && frame->format != AV_PIX_FMT_YUV420P && frame->format != AV_PIX_FMT_YUVJ420P) {
+        return -1;
+    }
+
+    // Целый чётный коэффициент, одинаковый по осям (чётный — чтобы блок 4:2:0 chroma был целым)
+    int f = frame->width / dst_w;
+    if (f < 2 || (f & 1) || f > RGBA_FAST_MAX_FACTOR || frame->height / dst_h != f) {
+        return -1;
+    }
+    // Остаток меньше одного выходного пикселя обрезается по центру; больше — другой аспект, это к swscale
+    int rem_x = frame->width - dst_w * f;
+    int rem_y = frame->height - dst_h * f;
+    if (rem_x >= f || rem_y >= f || frame->linesize[0] <= 0 || frame->linesize[1] <= 0 ||
+        (!nv12 && frame->linesize[2] <= 0)) {
+        return -1;
+    }
+    int x0 = (rem_x / 2) & ~1;
+    int y0 = (rem_y / 2) & ~1;
+
+    int full_range = frame->format == AV_PIX_FMT_YUVJ420P || frame->color_range == AVCOL_RANGE_JPEG;
+    int bt709 = frame->colorspace == AVCOL_SPC_BT709;
+    const YuvCoeffs *k = full_range ? (bt709 ? &k_bt709_full : &k_bt601_full)
+                                    : (bt709 ? &k_bt709_limited : &k_bt601_limited);
+
+    int cf = f / 2;
+    int luma_cols = dst_w * f;
+    int chroma_cols = dst_w * cf * (nv12 ? 2 : 1);  // NV12: U и V чередуются в одном аккумуляторе
+    int acc_size = luma_cols + chroma_cols * (nv12 ? 1 : 2);
+    uint16_t stack_acc[RGBA_FAST_STACK_ACC];
+    uint16_t *acc = acc_size <= RGBA_FAST_STACK_ACC ? stack_acc : malloc(sizeof(uint16_t) * (size_t)acc_size);
+    if (!acc) {
+        return -1;
+    }
+    uint16_t *acc_y = acc;
+    uint16_t *acc_u = acc + luma_cols;
+    uint16_t *acc_v = acc_u + chroma_cols;
+
+    // Деление суммы блока на его площадь — умножением (x2^24)
+    uint64_t inv_y = ((1ull << 24) + (uint64_t)(f * f) / 2) / (uint64_t)(f * f);
+    uint64_t inv_c = ((1ull << 24) + (uint64_t)(cf * cf) / 2) / (uint64_t)(cf * cf);
+
+    for (int j = 0; j < dst_h; j++) {
+        int luma_row = y0 + j * f;
+        int chroma_row = luma_row / 2;
+        accumulate_rows(acc_y, frame->data[0] + (ptrdiff_t)luma_row * frame->linesize[0] + x0,
+                        frame->linesize[0], f, luma_cols);
+        if (nv12) {
+            accumulate_rows(acc_u, frame->data[1] + (ptrdiff_t)chroma_row * frame->linesize[1] + x0,
+                            frame->linesize[1], cf, chroma_cols);
+        } else {
+            accumulate_rows(acc_u, frame->data[1] + (ptrdiff_t)chroma_row * frame->linesize[1] + x0 / 2,
+                            frame->linesize[1], cf, chroma_cols);
+            accumulate_rows(acc_v, frame->data[2] + (ptrdiff_t)chroma_row * frame->linesize[2] + x0 / 2,
+                            frame->linesize[2], cf, chroma_cols);
+        }
+
+        uint8_t *out = dst + (ptrdiff_t)j * dst_stride;
+        for (int i = 0; i < dst_w; i++) {
+            uint32_t sum_y = 0;
+            const uint16_t *py = acc_y + i * f;
+            for (int n = 0; n < f; n++) {
+                sum_y += py[n];
+            }
+            uint32_t sum_u = 0;
+            uint32_t sum_v = 0;
+            if (nv12) {
+                const uint16_t *puv = acc_u + i * cf * 2;
+                for (int n = 0; n < cf; n++) {
+                    sum_u += puv[2 * n];
+                    sum_v += puv[2 * n + 1];
+                }
+            } else {
+                const uint16_t *pu = acc_u + i * cf;
+                const uint16_t *pv = acc_v + i * cf;
+                for (int n = 0; n < cf; n++) {
+                    sum_u += pu[n];
+                    sum_v += pv[n];
+                }
+            }
+
+            int y = (int)((sum_y * inv_y + (1u << 23)) >> 24);
+            int u = (int)((sum_u * inv_c + (1u << 23)) >> 24) - 128;
+            int v = (int)((sum_v * inv_c + (1u << 23)) >> 24) - 128;
+            int c = (y - k->y_off) * k->cy + 128;
+            out[4 * i + 0] = clamp_u8((c + k->crv * v) >> 8);
+            out[4 * i + 1] = clamp_u8((c - k->cgu * u - k->cgv * v) >> 8);
+            out[4 * i + 2] = clamp_u8((c + k->cbu * u) >> 8);
+            out[4 * i + 3] = 255;
+        }
+    }
+
+    if (acc != stack_acc) {
+        free(acc);
+    }
+    return 0;
+}
+
+int rgba_convert_frame(const AVFrame *frame, int dst_w, int dst_h, uint8_t *dst, int dst_stride) {
+    if (!frame || !dst || dst_w <= 0 || dst_h <= 0 || dst_stride < dst_w * 4 ||
+        frame->width <= 0 || frame->height <= 0) {
+        return -1;
+    }
+
+    if (atomic_load(&g_fast_enabled) && rgba_convert_fast(frame, dst_w, dst_h, dst, dst_stride) == 0) {
+        atomic_fetch_add(&g_fast_frames, 1);
+        return 0;
+    }
+
+    struct SwsContext *sws = sws_cache_acquire(frame->width, frame->height, (enum AVPixelFormat)frame->format,
+                                               dst_w, dst_h, AV_PIX_FMT_RGBA, SWS_BILINEAR);
+    if (!sws) {
+        return -1;
+    }
+    uint8_t *dst_data[4] = { dst, NULL, NULL, NULL };
+    int dst_linesize[4] = { dst_stride, 0, 0, 0 };
+    int ret = sws_scale(sws, (const uint8_t *const *)frame->data, frame->linesize, 0, frame->height,
+                        dst_data, dst_linesize);
+    sws_cache_release(sws);
+    atomic_fetch_add(&g_sws_frames, 1);
+    return ret < 0 ? ret : 0;
+}
+
+void rgba_convert_set_fast_path(bool enabled) {
+    atomic_store(&g_fast_enabled, enabled);
+}
+
+void rgba_convert_get_stats(RgbaConvertStats *out) {
+    if (!out) {
+        return;
+    }
+    out->fast_frames = atomic_load(&g_fast_frames);
+    out->sws_frames = atomic_load(&g_sws_frames);
+}
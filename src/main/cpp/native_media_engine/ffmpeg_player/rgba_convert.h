@@ -0,0 +1,42 @@
+/// 🔥 RGBA CONVERT: декодированный кадр → RGBA8888 thumbnail (preview / MediaHandle)
+///
+/// Быстрый путь: YUV420P / YUVJ420P / NV12 с целым чётным коэффициентом
+/// уменьшения (1920x1080 → 320x180 = 6, 3840x2160 → 320x180 = 12,
+/// 1280x720 → 160x90 = 8). Box-фильтр f x f встроен в конвертацию: строки
+/// суммируются NEON / SSE2 в uint16 аккумулятор, затем одна YUV → RGB
+/// конвертация на выходной пиксель. Исходник читается ровно один раз, без
+/// промежуточного кадра и без setup'а SwsContext.
+///
+/// Остальное (другие форматы, нецелый коэффициент, увеличение) — swscale
+/// через sws_cache (SWS_BILINEAR, как было).
+
+#ifndef RGBA_CONVERT_H
+#define RGBA_CONVERT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct AVFrame;
+
+/// Счётчики с момента запуска процесса
+typedef struct RgbaConvertStats {
+    int64_t fast_frames;  // Box-фильтр NEON / SSE2
+    int64_t sws_frames;   // swscale (sws_cache)
+} RgbaConvertStats;
+
+/// Кадр → RGBA8888 dst_w x dst_h
+///
+/// @param frame Декодированный кадр (software pix_fmt)
+/// @param dst_w Размер результата
+/// @param dst_h Размер результата
+/// @param dst Буфер RGBA
+/// @param dst_stride Байт на строку (>= dst_w * 4)
+/// @return 0 при успехе, < 0 при ошибке
+int rgba_convert_frame(const struct AVFrame *frame, int dst_w, int dst_h, uint8_t *dst, int dst_stride);
+
+/// Разрешить быстрый путь (по умолчанию включён; выключение — для сравнения в bench)
+void rgba_convert_set_fast_path(bool enabled);
+
+void rgba_convert_get_stats(RgbaConvertStats *out);
+
+#endif // RGBA_CONVERT_H
@@ -1,6 +1,7 @@
 #ifndef SUBTITLE_MANAGER_H
 #define SUBTITLE_MANAGER_H
 
+#include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
 
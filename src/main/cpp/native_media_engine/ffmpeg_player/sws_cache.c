@@ -0,0 +1,171 @@
+/// 🔥 SWS CACHE: idle SwsContext'ы по ключу формата (см. sws_cache.h)
+
+#include "sws_cache.h"
+#include "libavutil/pixdesc.h"  // av_get_pix_fmt_name
+#include "libavutil/time.h"  // av_gettime_relative
+#include "libswscale/swscale.h"
+#include <pthread.h>
+#include <string.h>
+#include "platform_log.h"
+
+#define LOG_TAG "SwsCache"
+#define ALOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+typedef struct SwsCacheKey {
+    int src_w;
+    int src_h;
+    enum AVPixelFormat src_fmt;
+    int dst_w;
+    int dst_h;
+    enum AVPixelFormat dst_fmt;
+    int flags;
+} SwsCacheKey;
+
+/// Выданный контекст: ключ нужен, чтобы release положил его в правильный слот
+typedef struct SwsCacheLease {
+    struct SwsContext *sws;
+    SwsCacheKey key;
+} SwsCacheLease;
+
+typedef struct SwsCacheEntry {
+    struct SwsContext *sws;  // NULL — слот свободен
+    SwsCacheKey key;
+    uint64_t last_used;
+} SwsCacheEntry;
+
+/// Выданных одновременно контекстов больше этого числа не бывает на практике
+/// (batch worker'ы + preview); сверх — контекст просто освобождается на release
+#define SWS_CACHE_MAX_LEASES 32
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static SwsCacheEntry g_idle[SWS_CACHE_CAPACITY];
+static SwsCacheLease g_leases[SWS_CACHE_MAX_LEASES];
+static uint64_t g_tick;
+static SwsCacheStats g_stats;
+
+static int key_equal(const SwsCacheKey *a, const SwsCacheKey *b) {
+    return a->src_w == b->src_w && a->src_h == b->src_h && a->src_fmt == b->src_fmt &&
+           a->dst_w == b->dst_w && a->dst_h == b->dst_h && a->dst_fmt == b->dst_fmt &&
+           a->flags == b->flags;
+}
+
+/// Запомнить выданный контекст (под g_lock)
+static void lease_add(struct SwsContext *sws, const SwsCacheKey *key) {
+    for (int i = 0; i < SWS_CACHE_MAX_LEASES; i++) {
+        if (!g_leases[i].sws) {
+            g_leases[i].sws = sws;
+            g_leases[i].key = *key;
+            return;
+        }
+    }
+}
+
+struct SwsContext *sws_cache_acquire(int src_w, int src_h, enum AVPixelFormat src_fmt,
+                                     int dst_w, int dst_h, enum AVPixelFormat dst_fmt, int flags) {
+    SwsCacheKey key;
+    memset(&key, 0, sizeof(key));
+    key.src_w = src_w;
+    key.src_h = src_h;
+    key.src_fmt = src_fmt;
+    key.dst_w = dst_w;
+    key.dst_h = dst_h;
+    key.dst_fmt = dst_fmt;
+    key.flags = flags;
+
+    pthread_mutex_lock(&g_lock);
+    for (int i = 0; i < SWS_CACHE_CAPACITY; i++) {
+        if (g_idle[i].sws && key_equal(&g_idle[i].key, &key)) {
+            struct SwsContext *sws = g_idle[i].sws;
+            g_idle[i].sws = NULL;
+            lease_add(sws, &key);
+            g_stats.hits++;
+            pthread_mutex_unlock(&g_lock);
+            return sws;
+        }
+    }
+    g_stats.misses++;
+    pthread_mutex_unlock(&g_lock);
+
+    // sws_getContext вне lock'а: init фильтров — самая дорогая часть
+    int64_t t0 = av_gettime_relative();
+    struct SwsContext *sws = sws_getContext(src_w, src_h, src_fmt, dst_w, dst_h, dst_fmt,
+                                            flags, NULL, NULL, NULL);
+    int64_t setup_us = av_gettime_relative() - t0;
+
+    pthread_mutex_lock(&g_lock);
+    g_stats.setup_us += setup_us;
+    if (sws) {
+        lease_add(sws, &key);
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    ALOGD("🆕 SwsContext %dx%d %s → %dx%d %s (%.2f ms)", src_w, src_h, av_get_pix_fmt_name(src_fmt),
+          dst_w, dst_h, av_get_pix_fmt_name(dst_fmt), setup_us / 1000.0);
+    return sws;
+}
+
+void sws_cache_release(struct SwsContext *sws) {
+    if (!sws) {
+        return;
+    }
+
+    struct SwsContext *evicted = NULL;
+    pthread_mutex_lock(&g_lock);
+    int lease = -1;
+    for (int i = 0; i < SWS_CACHE_MAX_LEASES; i++) {
+        if (g_leases[i].sws == sws) {
+            lease = i;
+            break;
+        }
+    }
+    if (lease < 0) {
+        // Не из кэша (или таблица выдач была полна) — просто освободить
+        evicted = sws;
+    } else {
+        // Свободный слот или LRU idle
+        int slot = 0;
+        for (int i = 0; i < SWS_CACHE_CAPACITY; i++) {
+            if (!g_idle[i].sws) {
+                slot = i;
+                break;
+            }
+            if (g_idle[i].last_used < g_idle[slot].last_used) {
+                slot = i;
+            }
+        }
+        if (g_idle[slot].sws) {
+            evicted = g_idle[slot].sws;
+            g_stats.evictions++;
+        }
+        g_idle[slot].sws = sws;
+        g_idle[slot].key = g_leases[lease].key;
+        g_idle[slot].last_used = ++g_tick;
+        g_leases[lease].sws = NULL;
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    sws_freeContext(evicted);
+}
+
+void sws_cache_flush(void) {
+    struct SwsContext *idle[SWS_CACHE_CAPACITY];
+    pthread_mutex_lock(&g_lock);
+    for (int i = 0; i < SWS_CACHE_CAPACITY; i++) {
+        idle[i] = g_idle[i].sws;
+        g_idle[i].sws = NULL;
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    for (int i = 0; i < SWS_CACHE_CAPACITY; i++) {
+        sws_freeContext(idle[i]);
+    }
+}
+
+void sws_cache_get_stats(SwsCacheStats *out) {
+    if (!out) {
+        return;
+    }
+    pthread_mutex_lock(&g_lock);
+    *out = g_stats;
+    pthread_mutex_unlock(&g_lock);
+}
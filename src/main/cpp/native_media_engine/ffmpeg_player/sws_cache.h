@@ -0,0 +1,45 @@
+/// 🔥 SWS CACHE: общий на процесс пул SwsContext для preview / thumbnail путей
+///
+/// native_preview и one-shot thumbnail'ы создавали SwsContext на каждый вызов:
+/// sws_getContext (фильтры, init) стоит столько же, сколько само масштабирование
+/// маленького превью. Кэш хранит idle контексты по ключу
+/// (src fmt, src w/h, dst fmt, dst w/h, flags).
+///
+/// SwsContext не потокобезопасен, поэтому контекст выдаётся эксклюзивно:
+/// acquire → sws_scale → release. Параллельные запросы с одним ключом получают
+/// разные контексты (второй создаётся и тоже попадает в кэш после release).
+
+#ifndef SWS_CACHE_H
+#define SWS_CACHE_H
+
+#include <stdint.h>
+#include "libavutil/pixfmt.h"
+
+/// Idle контекстов в кэше (LRU вытеснение)
+#define SWS_CACHE_CAPACITY 8
+
+struct SwsContext;
+
+/// Счётчики с момента запуска процесса
+typedef struct SwsCacheStats {
+    int64_t hits;       // acquire отдал idle контекст
+    int64_t misses;     // acquire создал новый контекст
+    int64_t evictions;  // release вытеснил LRU контекст
+    int64_t setup_us;   // Суммарное время sws_getContext на промахах
+} SwsCacheStats;
+
+/// Получить контекст в эксклюзивное пользование
+///
+/// @return SwsContext или NULL (sws_getContext не смог)
+struct SwsContext *sws_cache_acquire(int src_w, int src_h, enum AVPixelFormat src_fmt,
+                                     int dst_w, int dst_h, enum AVPixelFormat dst_fmt, int flags);
+
+/// Вернуть контекст в кэш (NULL допустим)
+void sws_cache_release(struct SwsContext *sws);
+
+/// Освободить все idle контексты
+void sws_cache_flush(void);
+
+void sws_cache_get_stats(SwsCacheStats *out);
+
+#endif // SWS_CACHE_H
@@ -0,0 +1,142 @@
+/// 🔥 THUMB ENCODE: кадр → JPEG / WebP (см. thumb_encode.h)
+
+#include "thumb_encode.h"
+#include "sws_cache.h"
+#include "libavcodec/avcodec.h"
+#include "libavutil/frame.h"
+#include "libavutil/mem.h"
+#include "libswscale/swscale.h"
+#include <string.h>
+#include "platform_log.h"
+
+#define LOG_TAG "ThumbEncode"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const AVCodec *thumb_encoder(MediaThumbnailFormat format) {
+    switch (format) {
+    case MEDIA_THUMB_JPEG:
+        return avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+    case MEDIA_THUMB_WEBP:
+        return avcodec_find_encoder(AV_CODEC_ID_WEBP);
+    default:
+        return NULL;
+    }
+}
+
+/// pix_fmt, в который swscale пишет кадр для encoder'а
+static enum AVPixelFormat thumb_encoder_pix_fmt(const AVCodec *codec) {
+    if (codec->id == AV_CODEC_ID_MJPEG) {
+        return AV_PIX_FMT_YUVJ420P;  // Baseline JPEG: full range 4:2:0, читается любым декодером
+    }
+    for (const enum AVPixelFormat *p = codec->pix_fmts; p && *p != AV_PIX_FMT_NONE; p++) {
+        if (sws_isSupportedOutput(*p)) {
+            return *p;
+        }
+    }
+    return AV_PIX_FMT_NONE;
+}
+
+int thumb_encode_supported(MediaThumbnailFormat format) {
+    if (format == MEDIA_THUMB_RGBA) {
+        return 1;
+    }
+    const AVCodec *codec = thumb_encoder(format);
+    return codec && thumb_encoder_pix_fmt(codec) != AV_PIX_FMT_NONE;
+}
+
+int thumb_encode_frame(const AVFrame *frame, int width, int height, MediaThumbnailFormat format,
+                       int quality, uint8_t **out_data, int *out_size) {
+    if (!frame || width <= 0 || height <= 0 || !out_data || !out_size) {
+        return AVERROR(EINVAL);
+    }
+    *out_data = NULL;
+    *out_size = 0;
+
+    const AVCodec *codec = thumb_encoder(format);
+    enum AVPixelFormat pix_fmt = codec ? thumb_encoder_pix_fmt(codec) : AV_PIX_FMT_NONE;
+    if (pix_fmt == AV_PIX_FMT_NONE) {
+        return AVERROR_ENCODER_NOT_FOUND;
+    }
+
+    if (quality < 1) {
+        quality = 1;
+    } else if (quality > 100) {
+        quality = 100;
+    }
+
+    AVCodecContext *enc = avcodec_alloc_context3(codec);
+    AVFrame *scaled = av_frame_alloc();
+    AVPacket *pkt = av_packet_alloc();
+    int ret = (enc && scaled && pkt) ? 0 : AVERROR(ENOMEM);
+
+    if (ret == 0) {
+        enc->width = width;
+        enc->height = height;
+        enc->pix_fmt = pix_fmt;
+        enc->time_base = (AVRational){ 1, 25 };
+        enc->flags |= AV_CODEC_FLAG_QSCALE;
+        if (codec->id == AV_CODEC_ID_MJPEG) {
+            // quality 100..1 → qscale 2..31 (меньше — лучше)
+            int qscale = 2 + (100 - quality) * 29 / 99;
+            enc->qmin = qscale;
+            enc->qmax = qscale;
+            enc->global_quality = qscale * FF_QP2LAMBDA;
+            enc->color_range = AVCOL_RANGE_JPEG;
+        } else {
+            // libwebp: global_quality / FF_QP2LAMBDA — quality 0..100
+            enc->global_quality = quality * FF_QP2LAMBDA;
+        }
+        ret = avcodec_open2(enc, codec, NULL);
+    }
+
+    if (ret == 0) {
+        scaled->format = pix_fmt;
+        scaled->width = width;
+        scaled->height = height;
+        ret = av_frame_get_buffer(scaled, 0);
+    }
+
+    if (ret == 0) {
+        struct SwsContext *sws = sws_cache_acquire(frame->width, frame->height, (enum AVPixelFormat)frame->format,
+                                                   width, height, pix_fmt, SWS_BILINEAR);
+        if (sws) {
+            ret = sws_scale(sws, (const uint8_t *const *)frame->data, frame->linesize, 0, frame->height,
+                            scaled->data, scaled->linesize);
+            sws_cache_release(sws);
+            ret = ret < 0 ? ret : 0;
+        } else {
+            ret = AVERROR(EINVAL);
+        }
+    }
+
+    if (ret == 0) {
+        scaled->pts = 0;
+        scaled->color_range = enc->color_range;
+        scaled->quality = enc->global_quality;  // MJPEG с QSCALE берёт lambda из кадра, не из контекста
+        ret = avcodec_send_frame(enc, scaled);
+    }
+    if (ret == 0) {
+        avcodec_send_frame(enc, NULL);  // Один кадр: flush, чтобы encoder с задержкой отдал пакет
+        ret = avcodec_receive_packet(enc, pkt);
+    }
+    if (ret == 0) {
+        *out_data = av_malloc(pkt->size);
+        if (*out_data) {
+            memcpy(*out_data, pkt->data, pkt->size);
+            *out_size = pkt->size;
+        } else {
+            ret = AVERROR(ENOMEM);
+        }
+    }
+
+    if (ret < 0) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        ALOGE("❌ Could not encode %dx%d %s thumbnail: %s", width, height, codec->name, errbuf);
+    }
+
+    av_packet_free(&pkt);
+    av_frame_free(&scaled);
+    avcodec_free_context(&enc);
+    return ret;
+}
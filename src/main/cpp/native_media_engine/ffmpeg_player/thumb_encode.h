@@ -0,0 +1,36 @@
+/// 🔥 THUMB ENCODE: декодированный кадр → JPEG / WebP thumbnail через libavcodec
+///
+/// Галерея получала RGBA (width * height * 4 байт) и сжимала его второй раз
+/// в Kotlin для дискового кэша: двойная работа CPU и мегабайты через JNI.
+/// Здесь кадр масштабируется сразу в pix_fmt encoder'а (sws_cache, без
+/// промежуточного RGBA) и кодируется встроенным MJPEG encoder'ом или libwebp,
+/// если FFmpeg собран с ним. Наличие encoder'а проверяется в runtime.
+
+#ifndef THUMB_ENCODE_H
+#define THUMB_ENCODE_H
+
+#include <stdint.h>
+#include "media_handle.h"  // MediaThumbnailFormat
+
+struct AVFrame;
+
+/// Качество по умолчанию (1..100)
+#define THUMB_ENCODE_DEFAULT_QUALITY 80
+
+/// Есть ли encoder формата в этой сборке FFmpeg (MEDIA_THUMB_RGBA — всегда)
+int thumb_encode_supported(MediaThumbnailFormat format);
+
+/// Кадр → сжатый thumbnail width x height
+///
+/// @param frame Декодированный кадр (любой pix_fmt, который понимает swscale)
+/// @param width Размер результата
+/// @param height Размер результата
+/// @param format MEDIA_THUMB_JPEG или MEDIA_THUMB_WEBP
+/// @param quality 1..100 (вне диапазона — ограничивается)
+/// @param out_data Результат (av_malloc, освобождать av_free)
+/// @param out_size Размер результата в байтах
+/// @return 0, AVERROR_ENCODER_NOT_FOUND (нет encoder'а) или другой AVERROR
+int thumb_encode_frame(const struct AVFrame *frame, int width, int height, MediaThumbnailFormat format,
+                       int quality, uint8_t **out_data, int *out_size);
+
+#endif // THUMB_ENCODE_H
@@ -77,7 +77,7 @@ static void *mediacodec_decode_thread(void *arg) {
         
         // Шаг 29.5: Feed packets в MediaCodec
         AVPacket pkt;
-        if (packet_queue_get(backend->packet_queue, &pkt, false) > 0) {
+        if (packet_queue_get(backend->packet_queue, &pkt, false, NULL) > 0) {
             // Dequeue input buffer
             jint input_index = (*env)->CallIntMethod(env, backend->media_codec, dequeue_input_mid, (jlong)10000); // 10ms timeout
             
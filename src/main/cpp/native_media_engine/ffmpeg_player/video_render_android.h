@@ -1,7 +1,6 @@
 #pragma once
 
-#include <jni.h>
-#include <android/native_window.h>
+#include "platform_jni.h"  // JavaVM / ANativeWindow (непрозрачные типы на host)
 #include "libavutil/frame.h"
 #include "libswscale/swscale.h"
 #include <stdbool.h>
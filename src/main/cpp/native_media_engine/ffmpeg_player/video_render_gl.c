@@ -11,15 +11,18 @@
 #include "video_color_info.h"
 #include "native_player_jni.h"  // JNI TextureRegistry glue и доступ к g_player_context
 #include "libavutil/frame.h"  // для av_frame_get_best_effort_timestamp
+#include "libavutil/pixdesc.h"  // av_get_pix_fmt_name
 #include "video_render_gl.h"  // Включаем последним, чтобы использовать полные определения
+#include <EGL/eglext.h>  // EGL_OPENGL_ES3_BIT_KHR
 #include <android/log.h>
 #include <android/native_window.h>
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
-#include <unistd.h>  // для usleep
 #include <time.h>    // для clock_gettime
 #include "libavutil/time.h"  // для av_gettime_relative
+#include "platform_time.h"  // platform_now_us (deadline'ы render loop)
+#include "vsync_source.h"  // AChoreographer → VsyncClock (показ по vsync)
 
 #define LOG_TAG "VideoRenderGL"
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
@@ -701,41 +704,46 @@ static int init_egl_context(VideoRenderGL *vr) {
     
     ALOGI("EGL initialized: %d.%d", major, minor);
     
-    // Выбираем конфигурацию
-    EGLint attribs[] = {
-        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
-        EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
-        EGL_BLUE_SIZE, 8,
-        EGL_GREEN_SIZE, 8,
-        EGL_RED_SIZE, 8,
-        EGL_ALPHA_SIZE, 8,
-        EGL_NONE
-    };
-    
-    EGLint num_configs;
-    if (!eglChooseConfig(vr->egl_display, attribs, &vr->egl_config, 1, &num_configs)) {
-        ALOGE("Failed to choose EGL config");
-        return -1;
-    }
-    
-    if (num_configs == 0) {
-        ALOGE("No matching EGL config found");
-        return -1;
+    // Выбираем конфигурацию и создаём EGL context (Шаг 35.2 - без surface)
+    // Сначала GLES3 (PBO для асинхронной загрузки кадров, video_render_pbo.c), затем GLES2.
+    // Shader'ы — GLSL ES 1.00, работают в обоих.
+    static const EGLint client_versions[] = { 3, 2 };
+    vr->egl_context = EGL_NO_CONTEXT;
+    for (size_t v = 0; v < sizeof(client_versions) / sizeof(client_versions[0]); v++) {
+        EGLint attribs[] = {
+            EGL_RENDERABLE_TYPE, client_versions[v] == 3 ? EGL_OPENGL_ES3_BIT_KHR : EGL_OPENGL_ES2_BIT,
+            EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
+            EGL_BLUE_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_RED_SIZE, 8,
+            EGL_ALPHA_SIZE, 8,
+            EGL_NONE
+        };
+        
+        EGLint num_configs = 0;
+        if (!eglChooseConfig(vr->egl_display, attribs, &vr->egl_config, 1, &num_configs) || num_configs == 0) {
+            ALOGW("⚠️ No EGL config for GLES%d", client_versions[v]);
+            continue;
+        }
+        
+        EGLint context_attribs[] = {
+            EGL_CONTEXT_CLIENT_VERSION, client_versions[v],
+            EGL_NONE
+        };
+        
+        vr->egl_context = eglCreateContext(
+            vr->egl_display,
+            vr->egl_config,
+            EGL_NO_CONTEXT,  // No shared context
+            context_attribs
+        );
+        if (vr->egl_context != EGL_NO_CONTEXT) {
+            ALOGI("EGL context created: GLES%d", client_versions[v]);
+            break;
+        }
+        ALOGW("⚠️ Failed to create GLES%d context: EGL error 0x%x", client_versions[v], eglGetError());
     }
     
-    // Создаём EGL context (Шаг 35.2 - без surface)
-    EGLint context_attribs[] = {
-        EGL_CONTEXT_CLIENT_VERSION, 2,
-        EGL_NONE
-    };
-    
-    vr->egl_context = eglCreateContext(
-        vr->egl_display,
-        vr->egl_config,
-        EGL_NO_CONTEXT,  // No shared context
-        context_attribs
-    );
-    
     if (vr->egl_context == EGL_NO_CONTEXT) {
         ALOGE("Failed to create EGL context");
         return -1;
@@ -761,6 +769,23 @@ static int init_gl_resources(VideoRenderGL *vr) {
         return -1;
     }
     
+    // Программы для NV12 / NV21 / P010 / YUV420P10: компилируются один раз, выбираются по формату кадра
+    // I420 рисует эталонный shader_program
+    vr_yuv_program_init(&vr->yuv_programs[VR_YUV_LAYOUT_I420], vr->shader_program);
+    vr_yuv_uploader_init(&vr->yuv_uploader);
+    vr_pbo_ring_init(&vr->pbo_ring);
+    ALOGI("Frame upload: %s, stride via %s", (const char *)glGetString(GL_VERSION),
+          vr->pbo_ring.available ? "PBO ring (async)"
+                                 : vr->yuv_uploader.row_length ? "GL_UNPACK_ROW_LENGTH" : "staging buffer");
+    for (int layout = VR_YUV_LAYOUT_I420 + 1; layout < VR_YUV_LAYOUT_COUNT; layout++) {
+        GLuint program = create_program(vertex_shader_source, vr_yuv_fragment_source(layout));
+        if (!program) {
+            ALOGW("⚠️ %s shader unavailable, frames in this format will be rejected", vr_yuv_layout_name(layout));
+            continue;
+        }
+        vr_yuv_program_init(&vr->yuv_programs[layout], program);
+    }
+    
     // Шаг 41.4: Создаём YUV textures для frame0 и frame1
     glGenTextures(1, &vr->tex_y0);
     glGenTextures(1, &vr->tex_u0);
@@ -900,6 +925,20 @@ int video_render_gl_init(VideoRenderGL *vr,
     vr->last_frame = NULL;
     vr->jitter_buffer_ready = false; // 🔴 ШАГ 4: Jitter buffer сбрасывается при init
     pthread_mutex_init(&vr->render_mutex, NULL);
+    if (vr_waiter_init(&vr->waiter) < 0) {
+        ALOGE("❌ Failed to init render loop waiter");
+        pthread_mutex_destroy(&vr->render_mutex);
+        return -1;
+    }
+    vr->present_pts = NAN;
+    if (vsync_clock_init(&vr->vsync_clock) < 0) {
+        ALOGE("❌ Failed to init vsync clock");
+        vr_waiter_destroy(&vr->waiter);
+        pthread_mutex_destroy(&vr->render_mutex);
+        return -1;
+    }
+    video_scheduler_init(&vr->scheduler);
+    atomic_init(&vr->scheduler_reset_pending, false);
     
     // 🔴 ШАГ 3: Инициализация Flutter ImageTexture полей
     vr->flutter_texture_id = -1;
@@ -1391,233 +1430,36 @@ int video_render_gl_unregister_image_texture(VideoRenderGL *vr) {
 /// Загрузить один AVFrame в YUV текстуры (ШАГ 10.1 - persistent textures, ШАГ 11.1 - исправлено)
 static void upload_yuv_frame(VideoRenderGL *vr, GLuint tex_y, GLuint tex_u, GLuint tex_v,
                               AVFrame *frame, int width, int height) {
-    if (!vr) {
+    if (!vr || !frame) {
         return;
     }
     
-    // ШАГ 11.1: Используем vr->textures_initialized вместо static
-    // ШАГ 10.1: Инициализируем текстуры один раз (persistent textures)
-    if (!vr->textures_initialized || vr->tex_w != width || vr->tex_h != height) {
-        // Y plane - выделяем память один раз
-        glBindTexture(GL_TEXTURE_2D, tex_y);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_LUMINANCE,
-            width,
-            height,
-            0,
-            GL_LUMINANCE,
-            GL_UNSIGNED_BYTE,
-            NULL  // ШАГ 10.1: Выделяем память без данных
-        );
-        
-        // U plane (половинный размер)
-        glBindTexture(GL_TEXTURE_2D, tex_u);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_LUMINANCE,
-            width / 2,
-            height / 2,
-            0,
-            GL_LUMINANCE,
-            GL_UNSIGNED_BYTE,
-            NULL  // ШАГ 10.1: Выделяем память без данных
-        );
-        
-        // V plane (половинный размер)
-        glBindTexture(GL_TEXTURE_2D, tex_v);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_LUMINANCE,
-            width / 2,
-            height / 2,
-            0,
-            GL_LUMINANCE,
-            GL_UNSIGNED_BYTE,
-            NULL  // ШАГ 10.1: Выделяем память без данных
-        );
-        
-        vr->textures_initialized = true;
-        vr->tex_w = width;
-        vr->tex_h = height;
+    // 🔴 ЭТАЛОН: GL_LUMINANCE / GL_LUMINANCE_ALPHA для совместимости с HiSilicon/Kirin
+    // (GL_RED может не работать на старых устройствах) — раскладки в video_render_yuv.c
+    VrYuvLayout layout = vr_yuv_layout_for_format(frame->format);
+    if (layout == VR_YUV_LAYOUT_NONE) {
+        return;
     }
     
-    // 🔴 ЭТАЛОН: Используем GL_LUMINANCE для совместимости с HiSilicon/Kirin
-    // GL_RED может не работать на старых устройствах
-    // Для теста используем ТОЛЬКО GL_LUMINANCE
-    GLenum format = GL_LUMINANCE;
+    // ШАГ 10.1: persistent textures — glTexImage2D только при смене размера или раскладки
+    GLuint tex[VR_YUV_MAX_PLANES] = { tex_y, tex_u, tex_v };
+    bool allocate = !vr->textures_initialized || vr->tex_w != width || vr->tex_h != height ||
+                    vr->tex_layout != layout;
     
-    // ШАГ 11.1: Определяем формат для GLES3+ (закомментировано для теста)
-    /*
-    #ifdef GL_ES_VERSION_3_0
-    GLenum format = GL_RED;
-    #else
-    GLenum format = GL_LUMINANCE;
-    #endif
-    */
-    
-    // 🔴 ФИКС №2: Загрузка YUV с учётом stride (КРИТИЧНО для GLES2)
-    // GL_UNPACK_ROW_LENGTH недоступен в GLES2, поэтому копируем данные построчно
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    
-    // Y plane
-    glBindTexture(GL_TEXTURE_2D, tex_y);
-    if (frame->linesize[0] != width) {
-        // Stride отличается от width - копируем построчно
-        uint8_t *temp_buffer = (uint8_t *)malloc(width * height);
-        if (temp_buffer) {
-            const uint8_t *src = frame->data[0];
-            uint8_t *dst = temp_buffer;
-            for (int y = 0; y < height; y++) {
-                memcpy(dst, src, width);
-                src += frame->linesize[0];
-                dst += width;
-            }
-            glTexSubImage2D(
-                GL_TEXTURE_2D,
-                0,
-                0, 0,
-                width,
-                height,
-                format,
-                GL_UNSIGNED_BYTE,
-                temp_buffer
-            );
-            free(temp_buffer);
-        } else {
-            // Fallback: загружаем без учета stride (может быть "лесенка")
-            glTexSubImage2D(
-                GL_TEXTURE_2D,
-                0,
-                0, 0,
-                width,
-                height,
-                format,
-                GL_UNSIGNED_BYTE,
-                frame->data[0]
-            );
-        }
-    } else {
-        // Stride равен width - загружаем напрямую
-        glTexSubImage2D(
-            GL_TEXTURE_2D,
-            0,
-            0, 0,
-            width,
-            height,
-            format,
-            GL_UNSIGNED_BYTE,
-            frame->data[0]
-        );
-    }
-    
-    // U plane (половинный размер)
-    glBindTexture(GL_TEXTURE_2D, tex_u);
-    int u_width = width / 2;
-    int u_height = height / 2;
-    if (frame->linesize[1] != u_width) {
-        // Stride отличается от width - копируем построчно
-        uint8_t *temp_buffer = (uint8_t *)malloc(u_width * u_height);
-        if (temp_buffer) {
-            const uint8_t *src = frame->data[1];
-            uint8_t *dst = temp_buffer;
-            for (int y = 0; y < u_height; y++) {
-                memcpy(dst, src, u_width);
-                src += frame->linesize[1];
-                dst += u_width;
-            }
-            glTexSubImage2D(
-                GL_TEXTURE_2D,
-                0,
-                0, 0,
-                u_width,
-                u_height,
-                format,
-                GL_UNSIGNED_BYTE,
-                temp_buffer
-            );
-            free(temp_buffer);
-        } else {
-            // Fallback: загружаем без учета stride
-            glTexSubImage2D(
-                GL_TEXTURE_2D,
-                0,
-                0, 0,
-                u_width,
-                u_height,
-                format,
-                GL_UNSIGNED_BYTE,
-                frame->data[1]
-            );
-        }
-    } else {
-        // Stride равен width - загружаем напрямую
-        glTexSubImage2D(
-            GL_TEXTURE_2D,
-            0,
-            0, 0,
-            u_width,
-            u_height,
-            format,
-            GL_UNSIGNED_BYTE,
-            frame->data[1]
-        );
+    // GLES3: из PBO (кадр обычно уже скопирован туда после предыдущего swap'а — render_stage_next_frame),
+    // glTexSubImage2D только ставит копию в очередь GPU
+    // 🔴 ФИКС №2: иначе stride (linesize > width) без malloc на кадр:
+    // GL_UNPACK_ROW_LENGTH или persistent staging + SIMD упаковка
+    if (vr_pbo_ring_upload(&vr->pbo_ring, layout, tex, frame, width, height, allocate) < 0 &&
+        vr_yuv_upload_frame(&vr->yuv_uploader, layout, tex, frame, width, height, allocate) < 0) {
+        ALOGE("❌ Failed to upload %s frame (staging alloc)", vr_yuv_layout_name(layout));
+        return;
     }
-    
-    // V plane (половинный размер)
-    glBindTexture(GL_TEXTURE_2D, tex_v);
-    int v_width = width / 2;
-    int v_height = height / 2;
-    if (frame->linesize[2] != v_width) {
-        // Stride отличается от width - копируем построчно
-        uint8_t *temp_buffer = (uint8_t *)malloc(v_width * v_height);
-        if (temp_buffer) {
-            const uint8_t *src = frame->data[2];
-            uint8_t *dst = temp_buffer;
-            for (int y = 0; y < v_height; y++) {
-                memcpy(dst, src, v_width);
-                src += frame->linesize[2];
-                dst += v_width;
-            }
-            glTexSubImage2D(
-                GL_TEXTURE_2D,
-                0,
-                0, 0,
-                v_width,
-                v_height,
-                format,
-                GL_UNSIGNED_BYTE,
-                temp_buffer
-            );
-            free(temp_buffer);
-        } else {
-            // Fallback: загружаем без учета stride
-            glTexSubImage2D(
-                GL_TEXTURE_2D,
-                0,
-                0, 0,
-                v_width,
-                v_height,
-                format,
-                GL_UNSIGNED_BYTE,
-                frame->data[2]
-            );
-        }
-    } else {
-        // Stride равен width - загружаем напрямую
-        glTexSubImage2D(
-            GL_TEXTURE_2D,
-            0,
-            0, 0,
-            v_width,
-            v_height,
-            format,
-            GL_UNSIGNED_BYTE,
-            frame->data[2]
-        );
+    if (allocate) {
+        vr->textures_initialized = true;
+        vr->tex_w = width;
+        vr->tex_h = height;
+        vr->tex_layout = layout;
     }
 }
 
@@ -1758,9 +1600,11 @@ int video_render_gl_frame(VideoRenderGL *vr, AVFrame *frame, double master_clock
         }
     }
     
-    // Проверяем формат (должен быть YUV420P)
-    if (frame->format != AV_PIX_FMT_YUV420P) {
-        ALOGE("Unsupported pixel format: %d (expected YUV420P)", frame->format);
+    // Проверяем формат: YUV420P — эталонный shader, NV12 / NV21 / P010 / YUV420P10 — video_render_yuv.c
+    VrYuvLayout layout = vr_yuv_layout_for_format(frame->format);
+    if (layout == VR_YUV_LAYOUT_NONE || !vr->yuv_programs[layout].program) {
+        const char *fmt_name = av_get_pix_fmt_name((enum AVPixelFormat)frame->format);
+        ALOGE("Unsupported pixel format: %s (%d)", fmt_name ? fmt_name : "unknown", frame->format);
         pthread_mutex_unlock(&vr->render_mutex);
         return -1;
     }
@@ -1806,74 +1650,82 @@ int video_render_gl_frame(VideoRenderGL *vr, AVFrame *frame, double master_clock
     // ШАГ 11.1: Используем upload_yuv_frame вместо upload_yuv_plane (persistent textures)
     upload_yuv_frame(vr, vr->tex_y, vr->tex_u, vr->tex_v, frame, frame->width, frame->height);
     
-    // Используем shader program
-    glUseProgram(vr->shader_program);
+    const VrYuvProgram *prog = &vr->yuv_programs[layout];
+    VideoColorInfo color_info;
+    video_color_info_from_frame(frame, &color_info);
     
-    // 🔴 ШАГ 6: Передаём scale в shader (делается при каждом resize/rotate, не каждый frame)
-    if (vr->uniforms.uScaleX >= 0 && vr->uniforms.uScaleY >= 0) {
-        glUniform1f(vr->uniforms.uScaleX, vr->scale_x);
-        glUniform1f(vr->uniforms.uScaleY, vr->scale_y);
+    if (layout != VR_YUV_LAYOUT_I420) {
+        GLuint tex[VR_YUV_MAX_PLANES] = { vr->tex_y, vr->tex_u, vr->tex_v };
+        vr_yuv_program_use(prog, layout, tex, vr->scale_x, vr->scale_y,
+                           video_color_info_get_colorspace_index(&color_info),
+                           video_color_info_get_range_index(&color_info));
     } else {
-        ALOGW("⚠️ ШАГ 6: uScaleX or uScaleY uniform not found (shader may not support aspect ratio)");
-    }
-    
-    // 🔴 ЭТАЛОН: Проверяем uniform locations для простого shader (texY, texU, texV)
-    // Это критично для правильной работы на HiSilicon/Kirin
-    GLint texY_loc = glGetUniformLocation(vr->shader_program, "texY");
-    GLint texU_loc = glGetUniformLocation(vr->shader_program, "texU");
-    GLint texV_loc = glGetUniformLocation(vr->shader_program, "texV");
-    
-    // ✅ ШАГ 6.6: Убираем log-spam - логируем только в debug режиме
-    #ifdef VIDEO_RENDER_DEBUG
-    ALOGD("🔍 Legacy shader uniforms: texY=%d, texU=%d, texV=%d", texY_loc, texU_loc, texV_loc);
-    #endif
-    
-    // Если простой shader (эталонный) - используем texY/texU/texV
-    if (texY_loc >= 0 && texU_loc >= 0 && texV_loc >= 0) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_y);
-        glUniform1i(texY_loc, 0);
+        // Используем shader program
+        glUseProgram(vr->shader_program);
         
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_u);
-        glUniform1i(texU_loc, 1);
+        // 🔴 ШАГ 6: Передаём scale в shader (делается при каждом resize/rotate, не каждый frame)
+        if (vr->uniforms.uScaleX >= 0 && vr->uniforms.uScaleY >= 0) {
+            glUniform1f(vr->uniforms.uScaleX, vr->scale_x);
+            glUniform1f(vr->uniforms.uScaleY, vr->scale_y);
+        } else {
+            ALOGW("⚠️ ШАГ 6: uScaleX or uScaleY uniform not found (shader may not support aspect ratio)");
+        }
         
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_v);
-        glUniform1i(texV_loc, 2);
-    } else {
-        // Fallback на кешированные uniform locations (сложный shader)
-        ALOGI("⚠️ Using cached uniform locations (complex shader)");
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_y);
-        if (vr->uniforms.tex_y0 >= 0) glUniform1i(vr->uniforms.tex_y0, 0);
+        // 🔴 ЭТАЛОН: Проверяем uniform locations для простого shader (texY, texU, texV)
+        // Это критично для правильной работы на HiSilicon/Kirin
+        GLint texY_loc = glGetUniformLocation(vr->shader_program, "texY");
+        GLint texU_loc = glGetUniformLocation(vr->shader_program, "texU");
+        GLint texV_loc = glGetUniformLocation(vr->shader_program, "texV");
         
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_u);
-        if (vr->uniforms.tex_u0 >= 0) glUniform1i(vr->uniforms.tex_u0, 1);
+        // ✅ ШАГ 6.6: Убираем log-spam - логируем только в debug режиме
+        #ifdef VIDEO_RENDER_DEBUG
+        ALOGD("🔍 Legacy shader uniforms: texY=%d, texU=%d, texV=%d", texY_loc, texU_loc, texV_loc);
+        #endif
         
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_v);
-        if (vr->uniforms.tex_v0 >= 0) glUniform1i(vr->uniforms.tex_v0, 2);
-    }
-    
-    // ШАГ 11.1: Используем кешированные colorspace uniforms
-    VideoColorInfo color_info;
-    video_color_info_from_frame(frame, &color_info);
-    
-    if (vr->uniforms.u_colorspace >= 0) {
-        glUniform1i(vr->uniforms.u_colorspace, video_color_info_get_colorspace_index(&color_info));
-    }
-    if (vr->uniforms.u_range >= 0) {
-        glUniform1i(vr->uniforms.u_range, video_color_info_get_range_index(&color_info));
-    }
-    if (vr->uniforms.u_is_hdr >= 0) {
-        glUniform1i(vr->uniforms.u_is_hdr, video_color_info_is_hdr(&color_info) ? 1 : 0);
+        // Если простой shader (эталонный) - используем texY/texU/texV
+        if (texY_loc >= 0 && texU_loc >= 0 && texV_loc >= 0) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_y);
+            glUniform1i(texY_loc, 0);
+        
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_u);
+            glUniform1i(texU_loc, 1);
+        
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_v);
+            glUniform1i(texV_loc, 2);
+        } else {
+            // Fallback на кешированные uniform locations (сложный shader)
+            ALOGI("⚠️ Using cached uniform locations (complex shader)");
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_y);
+            if (vr->uniforms.tex_y0 >= 0) glUniform1i(vr->uniforms.tex_y0, 0);
+        
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_u);
+            if (vr->uniforms.tex_u0 >= 0) glUniform1i(vr->uniforms.tex_u0, 1);
+        
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_v);
+            if (vr->uniforms.tex_v0 >= 0) glUniform1i(vr->uniforms.tex_v0, 2);
+        }
+        
+        // ШАГ 11.1: Используем кешированные colorspace uniforms
+        if (vr->uniforms.u_colorspace >= 0) {
+            glUniform1i(vr->uniforms.u_colorspace, video_color_info_get_colorspace_index(&color_info));
+        }
+        if (vr->uniforms.u_range >= 0) {
+            glUniform1i(vr->uniforms.u_range, video_color_info_get_range_index(&color_info));
+        }
+        if (vr->uniforms.u_is_hdr >= 0) {
+            glUniform1i(vr->uniforms.u_is_hdr, video_color_info_is_hdr(&color_info) ? 1 : 0);
+        }
     }
     
     // Устанавливаем vertex attributes
-    GLint pos_loc = glGetAttribLocation(vr->shader_program, "aPosition");
-    GLint tex_loc = glGetAttribLocation(vr->shader_program, "aTexCoord");
+    GLint pos_loc = prog->a_position;
+    GLint tex_loc = prog->a_tex_coord;
     
     glBindBuffer(GL_ARRAY_BUFFER, vr->vbo);
     glEnableVertexAttribArray(pos_loc);
@@ -2168,137 +2020,155 @@ int video_render_gl_draw(VideoRenderGL *vr, AVFrame *frame0, AVFrame *frame1, do
         glViewport(0, 0, frame0->width, frame0->height);
     }
     
+    // Раскладка frame0 выбирает программу: YUV420P — эталонный shader, остальные — video_render_yuv.c
+    VrYuvLayout layout = vr_yuv_layout_for_format(frame0->format);
+    if (layout == VR_YUV_LAYOUT_NONE || !vr->yuv_programs[layout].program) {
+        const char *fmt_name = av_get_pix_fmt_name((enum AVPixelFormat)frame0->format);
+        ALOGE("Unsupported pixel format: %s (%d)", fmt_name ? fmt_name : "unknown", frame0->format);
+        pthread_mutex_unlock(&vr->render_mutex);
+        return -1;
+    }
+    
     // Шаг 41.4: Загружаем frame0 в текстуры (ШАГ 11.1 - исправлено)
     upload_yuv_frame(vr, vr->tex_y0, vr->tex_u0, vr->tex_v0, frame0, vr->video_width, vr->video_height);
     
     // Шаг 41.4: Загружаем frame1 в текстуры (если есть)
-    bool has_next = (frame1 != NULL);
+    // Interpolation — только в эталонном I420 пути (shader'ы video_render_yuv.c рисуют один кадр)
+    bool has_next = (frame1 != NULL) && layout == VR_YUV_LAYOUT_I420 && frame1->format == frame0->format;
     if (has_next) {
         upload_yuv_frame(vr, vr->tex_y1, vr->tex_u1, vr->tex_v1, frame1, vr->video_width, vr->video_height);
     }
     vr->has_next_frame = has_next;
     
-    // Используем shader program
-    glUseProgram(vr->shader_program);
+    const VrYuvProgram *prog = &vr->yuv_programs[layout];
+    VideoColorInfo color_info;
+    video_color_info_from_frame(frame0, &color_info);
     
-    // 🔴 ШАГ 6: Передаём scale в shader (делается при каждом resize/rotate, не каждый frame)
-    if (vr->uniforms.uScaleX >= 0 && vr->uniforms.uScaleY >= 0) {
-        glUniform1f(vr->uniforms.uScaleX, vr->scale_x);
-        glUniform1f(vr->uniforms.uScaleY, vr->scale_y);
+    if (layout != VR_YUV_LAYOUT_I420) {
+        GLuint tex[VR_YUV_MAX_PLANES] = { vr->tex_y0, vr->tex_u0, vr->tex_v0 };
+        vr_yuv_program_use(prog, layout, tex, vr->scale_x, vr->scale_y,
+                           video_color_info_get_colorspace_index(&color_info),
+                           video_color_info_get_range_index(&color_info));
     } else {
-        ALOGW("⚠️ ШАГ 6: uScaleX or uScaleY uniform not found (shader may not support aspect ratio)");
-    }
-    
-    // 🔴 ЭТАЛОН: Bind текстур для простого shader (texY, texU, texV)
-    // Для сложного shader используй tex_y0/u0/v0
-    GLint texY_loc = glGetUniformLocation(vr->shader_program, "texY");
-    GLint texU_loc = glGetUniformLocation(vr->shader_program, "texU");
-    GLint texV_loc = glGetUniformLocation(vr->shader_program, "texV");
-    
-    // ✅ ШАГ 6.6: Убираем log-spam - логируем только в debug режиме
-    #ifdef VIDEO_RENDER_DEBUG
-    ALOGI("🔍 Shader uniforms: texY=%d, texU=%d, texV=%d", texY_loc, texU_loc, texV_loc);
-    #endif
-    if (texY_loc < 0 || texU_loc < 0 || texV_loc < 0) {
-        ALOGE("❌ CRITICAL: Invalid uniform locations for simple shader (texY/texU/texV)");
-        ALOGE("   This means shader compilation failed or wrong shader is used");
-    }
-    
-    // Если простой shader (эталонный) - используем texY/texU/texV
-    if (texY_loc >= 0 && texU_loc >= 0 && texV_loc >= 0) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_y0);
-        glUniform1i(texY_loc, 0);
+        // Используем shader program
+        glUseProgram(vr->shader_program);
+        
+        // 🔴 ШАГ 6: Передаём scale в shader (делается при каждом resize/rotate, не каждый frame)
+        if (vr->uniforms.uScaleX >= 0 && vr->uniforms.uScaleY >= 0) {
+            glUniform1f(vr->uniforms.uScaleX, vr->scale_x);
+            glUniform1f(vr->uniforms.uScaleY, vr->scale_y);
+        } else {
+            ALOGW("⚠️ ШАГ 6: uScaleX or uScaleY uniform not found (shader may not support aspect ratio)");
+        }
         
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_u0);
-        glUniform1i(texU_loc, 1);
+        // 🔴 ЭТАЛОН: Bind текстур для простого shader (texY, texU, texV)
+        // Для сложного shader используй tex_y0/u0/v0
+        GLint texY_loc = glGetUniformLocation(vr->shader_program, "texY");
+        GLint texU_loc = glGetUniformLocation(vr->shader_program, "texU");
+        GLint texV_loc = glGetUniformLocation(vr->shader_program, "texV");
         
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_v0);
-        glUniform1i(texV_loc, 2);
-    } else {
-        // Сложный shader (с интерполяцией) - используем кешированные uniform locations
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_y0);
-        if (vr->uniforms.tex_y0 >= 0) glUniform1i(vr->uniforms.tex_y0, 0);
+        // ✅ ШАГ 6.6: Убираем log-spam - логируем только в debug режиме
+        #ifdef VIDEO_RENDER_DEBUG
+        ALOGI("🔍 Shader uniforms: texY=%d, texU=%d, texV=%d", texY_loc, texU_loc, texV_loc);
+        #endif
+        if (texY_loc < 0 || texU_loc < 0 || texV_loc < 0) {
+            ALOGE("❌ CRITICAL: Invalid uniform locations for simple shader (texY/texU/texV)");
+            ALOGE("   This means shader compilation failed or wrong shader is used");
+        }
+        
+        // Если простой shader (эталонный) - используем texY/texU/texV
+        if (texY_loc >= 0 && texU_loc >= 0 && texV_loc >= 0) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_y0);
+            glUniform1i(texY_loc, 0);
         
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_u0);
-        if (vr->uniforms.tex_u0 >= 0) glUniform1i(vr->uniforms.tex_u0, 1);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_u0);
+            glUniform1i(texU_loc, 1);
         
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, vr->tex_v0);
-        if (vr->uniforms.tex_v0 >= 0) glUniform1i(vr->uniforms.tex_v0, 2);
-    }
-    
-    glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_2D, has_next ? vr->tex_y1 : vr->tex_y0);
-    if (vr->uniforms.tex_y1 >= 0) glUniform1i(vr->uniforms.tex_y1, 3);
-    
-    glActiveTexture(GL_TEXTURE4);
-    glBindTexture(GL_TEXTURE_2D, has_next ? vr->tex_u1 : vr->tex_u0);
-    if (vr->uniforms.tex_u1 >= 0) glUniform1i(vr->uniforms.tex_u1, 4);
-    
-    glActiveTexture(GL_TEXTURE5);
-    glBindTexture(GL_TEXTURE_2D, has_next ? vr->tex_v1 : vr->tex_v0);
-    if (vr->uniforms.tex_v1 >= 0) glUniform1i(vr->uniforms.tex_v1, 5);
-    
-    // ШАГ 11.1: Используем кешированные interpolation uniforms
-    if (vr->uniforms.uAlpha >= 0) {
-        // 🔴 ШАГ 8: Защита от NaN/Inf (КРИТИЧНО для стабильности)
-        float clamped_alpha = (float)alpha;
-        if (isnan(clamped_alpha) || isinf(clamped_alpha)) {
-            ALOGE("❌ Alpha is NaN/Inf in video_render_gl_draw: %.3f, forcing to 0.0", clamped_alpha);
-            clamped_alpha = 0.0f;
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_v0);
+            glUniform1i(texV_loc, 2);
         } else {
-            // Clamp alpha в [0..1]
-            if (clamped_alpha < 0.0f) clamped_alpha = 0.0f;
-            if (clamped_alpha > 1.0f) clamped_alpha = 1.0f;
+            // Сложный shader (с интерполяцией) - используем кешированные uniform locations
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_y0);
+            if (vr->uniforms.tex_y0 >= 0) glUniform1i(vr->uniforms.tex_y0, 0);
+        
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_u0);
+            if (vr->uniforms.tex_u0 >= 0) glUniform1i(vr->uniforms.tex_u0, 1);
+        
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, vr->tex_v0);
+            if (vr->uniforms.tex_v0 >= 0) glUniform1i(vr->uniforms.tex_v0, 2);
+        }
+        
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, has_next ? vr->tex_y1 : vr->tex_y0);
+        if (vr->uniforms.tex_y1 >= 0) glUniform1i(vr->uniforms.tex_y1, 3);
+        
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, has_next ? vr->tex_u1 : vr->tex_u0);
+        if (vr->uniforms.tex_u1 >= 0) glUniform1i(vr->uniforms.tex_u1, 4);
+        
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_2D, has_next ? vr->tex_v1 : vr->tex_v0);
+        if (vr->uniforms.tex_v1 >= 0) glUniform1i(vr->uniforms.tex_v1, 5);
+        
+        // ШАГ 11.1: Используем кешированные interpolation uniforms
+        if (vr->uniforms.uAlpha >= 0) {
+            // 🔴 ШАГ 8: Защита от NaN/Inf (КРИТИЧНО для стабильности)
+            float clamped_alpha = (float)alpha;
+            if (isnan(clamped_alpha) || isinf(clamped_alpha)) {
+                ALOGE("❌ Alpha is NaN/Inf in video_render_gl_draw: %.3f, forcing to 0.0", clamped_alpha);
+                clamped_alpha = 0.0f;
+            } else {
+                // Clamp alpha в [0..1]
+                if (clamped_alpha < 0.0f) clamped_alpha = 0.0f;
+                if (clamped_alpha > 1.0f) clamped_alpha = 1.0f;
+            }
+            glUniform1f(vr->uniforms.uAlpha, clamped_alpha);
+        }
+        if (vr->uniforms.uHasNextFrame >= 0) {
+            // 🔴 ШАГ 8: has_next должен быть false, если frame1 == NULL
+            // Это гарантирует, что shader использует только frame0
+            glUniform1i(vr->uniforms.uHasNextFrame, has_next ? 1 : 0);
+        }
+        
+        // ШАГ 11.1: Используем кешированные colorspace uniforms
+        if (vr->uniforms.u_colorspace >= 0) {
+            glUniform1i(vr->uniforms.u_colorspace, video_color_info_get_colorspace_index(&color_info));
+        }
+        if (vr->uniforms.u_range >= 0) {
+            glUniform1i(vr->uniforms.u_range, video_color_info_get_range_index(&color_info));
+        }
+        if (vr->uniforms.u_is_hdr >= 0) {
+            glUniform1i(vr->uniforms.u_is_hdr, video_color_info_is_hdr(&color_info) ? 1 : 0);
+        }
+        
+        // Resize/Rotation: Вычисляем и применяем transform matrix
+        if (vr->uniforms.uTransform >= 0) {
+            float transform_mat[16];
+            compute_transform(vr, transform_mat);
+            glUniformMatrix4fv(vr->uniforms.uTransform, 1, GL_FALSE, transform_mat);
+        }
+        if (vr->uniforms.uRotation >= 0) {
+            glUniform1i(vr->uniforms.uRotation, vr->layout.rotation);
+        }
+        
+        // Gestures: Применяем scale и pan
+        if (vr->uniforms.uGestureScale >= 0) {
+            glUniform1f(vr->uniforms.uGestureScale, vr->transform.scale);
+        }
+        if (vr->uniforms.uGestureOffset >= 0) {
+            glUniform2f(vr->uniforms.uGestureOffset, vr->transform.offset_x, vr->transform.offset_y);
         }
-        glUniform1f(vr->uniforms.uAlpha, clamped_alpha);
-    }
-    if (vr->uniforms.uHasNextFrame >= 0) {
-        // 🔴 ШАГ 8: has_next должен быть false, если frame1 == NULL
-        // Это гарантирует, что shader использует только frame0
-        glUniform1i(vr->uniforms.uHasNextFrame, has_next ? 1 : 0);
-    }
-    
-    // ШАГ 11.1: Используем кешированные colorspace uniforms
-    VideoColorInfo color_info;
-    video_color_info_from_frame(frame0, &color_info);
-    
-    if (vr->uniforms.u_colorspace >= 0) {
-        glUniform1i(vr->uniforms.u_colorspace, video_color_info_get_colorspace_index(&color_info));
-    }
-    if (vr->uniforms.u_range >= 0) {
-        glUniform1i(vr->uniforms.u_range, video_color_info_get_range_index(&color_info));
-    }
-    if (vr->uniforms.u_is_hdr >= 0) {
-        glUniform1i(vr->uniforms.u_is_hdr, video_color_info_is_hdr(&color_info) ? 1 : 0);
-    }
-    
-    // Resize/Rotation: Вычисляем и применяем transform matrix
-    if (vr->uniforms.uTransform >= 0) {
-        float transform_mat[16];
-        compute_transform(vr, transform_mat);
-        glUniformMatrix4fv(vr->uniforms.uTransform, 1, GL_FALSE, transform_mat);
-    }
-    if (vr->uniforms.uRotation >= 0) {
-        glUniform1i(vr->uniforms.uRotation, vr->layout.rotation);
-    }
-    
-    // Gestures: Применяем scale и pan
-    if (vr->uniforms.uGestureScale >= 0) {
-        glUniform1f(vr->uniforms.uGestureScale, vr->transform.scale);
-    }
-    if (vr->uniforms.uGestureOffset >= 0) {
-        glUniform2f(vr->uniforms.uGestureOffset, vr->transform.offset_x, vr->transform.offset_y);
     }
     
     // Устанавливаем vertex attributes
-    GLint pos_loc = glGetAttribLocation(vr->shader_program, "aPosition");
-    GLint tex_loc = glGetAttribLocation(vr->shader_program, "aTexCoord");
+    GLint pos_loc = prog->a_position;
+    GLint tex_loc = prog->a_tex_coord;
     
     glBindBuffer(GL_ARRAY_BUFFER, vr->vbo);
     glEnableVertexAttribArray(pos_loc);
@@ -2485,6 +2355,9 @@ void video_render_gl_clear(VideoRenderGL *vr, double seek_target) {
         vr->last_frame = NULL;
     }
     
+    // Подготовленные до seek'а кадры больше не покажутся
+    vr_pbo_ring_reset(&vr->pbo_ring);
+    
     // ШАГ 6: Сброс статистики при seek
     memset(&vr->interp_stats, 0, sizeof(vr->interp_stats));
     vr->interp_stats.toggle_cooldown = 0; // ШАГ 6.5: Сброс cooldown
@@ -2525,7 +2398,14 @@ void video_render_gl_clear(VideoRenderGL *vr, double seek_target) {
     vr->tex_w = 0;
     vr->tex_h = 0;
     
+    // Якорь video clock и пауза относятся к кадрам до seek'а
+    vr->present_pts = NAN;
+    vr->present_us = 0;
+    vr->paused_frame_shown = false;
+    atomic_store(&vr->scheduler_reset_pending, true);  // Сбросит render thread
+    
     pthread_mutex_unlock(&vr->render_mutex);
+    video_render_gl_wake(vr);
     
     ALOGI("✅ video_render_gl_clear: All flags reset (jitter_buffer, first_frame, clock)");
 }
@@ -2610,7 +2490,9 @@ void video_render_gl_set_fit_mode(VideoRenderGL *vr, int fit_mode) {
     pthread_mutex_lock(&vr->render_mutex);
     vr->fit_mode = fit_mode;
     video_render_gl_update_aspect(vr);
+    vr->redraw_requested = true;  // На паузе кадр перерисовывается только по запросу
     pthread_mutex_unlock(&vr->render_mutex);
+    video_render_gl_wake(vr);
     
     ALOGI("✅ video_render_gl_set_fit_mode: mode=%d (scale=%.3fx%.3f)", 
           fit_mode, vr->scale_x, vr->scale_y);
@@ -2633,9 +2515,13 @@ void video_render_gl_set_paused(VideoRenderGL *vr, bool paused) {
         vr->interp_alpha.alpha_valid = false;
         vr->interp_alpha.last_alpha = 0.0f;
     }
+    vr->paused_frame_shown = false;
     
     pthread_mutex_unlock(&vr->render_mutex);
     
+    // Render loop спит на паузе до этого сигнала
+    video_render_gl_wake(vr);
+    
     ALOGD("Video render paused: %s", paused ? "true" : "false");
 }
 
@@ -2651,18 +2537,209 @@ void video_render_gl_set_prepared(VideoRenderGL *vr, bool prepared) {
     pthread_mutex_lock(&vr->render_mutex);
     vr->player_prepared = prepared;
     pthread_mutex_unlock(&vr->render_mutex);
+    video_render_gl_wake(vr);
     
     ALOGI("🔴 ШАГ 4: Player prepared flag set: %s", prepared ? "true" : "false");
 }
 
-/// 🔴 ШАГ 5: Вспомогательная функция для ожидания (БЕЗ swap)
-/// 
-/// ❌ НЕЛЬЗЯ делать eglSwapBuffers без кадра - это ломает тайминг
-/// VSync ожидание происходит ТОЛЬКО через eglSwapBuffers при реальном рендере
-static void wait_for_vsync(VideoRenderGL *vr) {
-    // НИЧЕГО не делаем
-    // VSync ожидание происходит ТОЛЬКО через eglSwapBuffers при реальном рендере
-    usleep(1000); // 1ms — мягкий yield CPU
+void video_render_gl_wake(VideoRenderGL *vr) {
+    if (!vr || !vr->initialized) {
+        return;
+    }
+    vr_waiter_wake(&vr->waiter);
+}
+
+// === 🔥 Event-driven render loop: ожидания вместо usleep ===
+//
+// ❌ НЕЛЬЗЯ делать eglSwapBuffers без кадра - это ломает тайминг.
+// Пока кадр показывать рано (или нечего), render thread спит на vr->waiter:
+// - новые кадры / flush / abort очереди будят через frame_queue_set_frame_notify;
+// - pause / resume / prepared / clear / stop — через video_render_gl_wake;
+// - кадр с известным PTS ждёт своего deadline'а (timedwait по CLOCK_MONOTONIC).
+// Флаги, которые выставляются без wake (seek, audio clock, AVSYNC gate),
+// перепроверяются по страховочному таймауту.
+
+/// Флаги без wake перепроверяются с тем же шагом, что раньше давал usleep
+#define RENDER_WAIT_FLAG_US      2000
+/// AVSYNC gate закрыт (раньше usleep 5ms)
+#define RENDER_WAIT_GATE_US      5000
+/// Страховка для ожиданий, у которых есть событие (кадр, wake)
+#define RENDER_WAIT_SAFETY_US    100000
+/// Background (MODE_AUDIO_ONLY): render loop обычно остановлен, ждём редко
+#define RENDER_WAIT_IDLE_US      50000
+/// Квант ожидания HOLD (video отстаёт от audio, раньше usleep 5ms)
+#define RENDER_WAIT_HOLD_SLICE_US 20000
+/// Дальше deadline'а не спим за раз: clock мог прыгнуть, пересчитываем
+#define RENDER_PRESENT_MAX_WAIT_US  100000
+/// Период лога точности показа (в кадрах)
+#define RENDER_PRESENT_LOG_FRAMES   600
+
+/// Условие ожидания: в очереди не меньше min_frames кадров
+typedef struct RenderWaitFrames {
+    FrameQueue *fq;
+    int min_frames;
+} RenderWaitFrames;
+
+static bool render_wait_frames_ready(void *arg) {
+    RenderWaitFrames *w = arg;
+    return frame_queue_size(w->fq) >= w->min_frames;
+}
+
+/// Условие ожидания: голова очереди сменилась (flush / drop) — ждать дальше незачем
+typedef struct RenderWaitHead {
+    FrameQueue *fq;
+    Frame *head;
+    AVFrame *frame;
+} RenderWaitHead;
+
+static bool render_wait_head_changed(void *arg) {
+    RenderWaitHead *w = arg;
+    Frame *head = frame_queue_peek_ptr(w->fq);
+    return head != w->head || !head || head->frame != w->frame;
+}
+
+/// Ждать, пока в очереди не наберётся min_frames кадров (или wake / abort / таймаут)
+static void render_wait_frames(VideoRenderGL *vr, uint64_t seq, FrameQueue *fq, int min_frames,
+                               int64_t timeout_us, const int *abort) {
+    RenderWaitFrames w = { fq, min_frames };
+    vr_waiter_wait(&vr->waiter, seq, render_wait_frames_ready, &w, platform_now_us() + timeout_us, abort);
+}
+
+/// Ждать wake / abort не дольше timeout_us (флаги, которые меняются без сигнала)
+static void render_wait_state(VideoRenderGL *vr, uint64_t seq, int64_t timeout_us, const int *abort) {
+    vr_waiter_wait(&vr->waiter, seq, NULL, NULL, platform_now_us() + timeout_us, abort);
+}
+
+/// Ждать deadline текущего кадра очереди (или wake / abort / смены головы очереди)
+static void render_wait_until(VideoRenderGL *vr, uint64_t seq, FrameQueue *fq, Frame *head,
+                              int64_t deadline_us, const int *abort) {
+    RenderWaitHead w = { fq, head, head ? head->frame : NULL };
+    vr_waiter_wait(&vr->waiter, seq, render_wait_head_changed, &w, deadline_us, abort);
+}
+
+/// Монотонное время (us), когда кадр с PTS pts должен быть на экране
+///
+/// Audio master: audio clock экстраполируется от момента его последнего
+/// обновления (AudioClock.last_update_us, тот же CLOCK_MONOTONIC).
+/// Video master: от якоря последнего показанного кадра (present_pts / present_us).
+/// @return 0, если deadline не определён — кадр показывается сразу
+static int64_t render_present_deadline_us(VideoRenderGL *vr, PlayerContext *ctx, AudioState *as,
+                                          double pts, int64_t now_us) {
+    if (isnan(pts) || pts < 0.0) {
+        return 0;
+    }
+    
+    if (ctx->avsync.master == CLOCK_MASTER_AUDIO && ctx->avsync.audio_healthy) {
+        if (!as || !as->clock.valid || as->clock.last_update_us <= 0) {
+            return 0;
+        }
+        double elapsed = (double)(now_us - as->clock.last_update_us) / 1000000.0;
+        if (elapsed < 0.0 || elapsed > 0.5) {
+            elapsed = 0.0;  // clock давно не обновлялся: не экстраполируем
+        }
+        double master_now = ctx->avsync.audio_clock + elapsed;
+        return now_us + (int64_t)((pts - master_now) * 1000000.0);
+    }
+    
+    if (isnan(vr->present_pts) || vr->present_us <= 0) {
+        return 0;
+    }
+    double delta = pts - vr->present_pts;
+    if (delta <= 0.0 || delta > 1.0) {
+        return 0;  // Разрыв PTS: показываем сразу, якорь обновится после swap'а
+    }
+    return vr->present_us + (int64_t)(delta * 1000000.0);
+}
+
+/// Источник vsync работает, пока кадры показываются по PTS: на паузе и при выходе
+/// из render loop останавливается (иначе callback на каждый vsync будит процесс)
+static void render_vsync_set_active(VideoRenderGL *vr, bool active) {
+    if (!active) {
+        vsync_source_stop(vr->vsync_source);
+        vr->vsync_source = NULL;
+        return;
+    }
+    if (vr->vsync_source || vr->vsync_source_failed) {
+        return;
+    }
+    vr->vsync_source = vsync_source_start(&vr->vsync_clock, 0);
+    if (!vr->vsync_source) {
+        vr->vsync_source_failed = true;  // Не пытаемся на каждом кадре
+        ALOGW("⚠️ Vsync source unavailable: frames are presented at their deadlines");
+    }
+}
+
+/// Кадр показан: обновить якорь video clock, статистику точности (если кадр ждал
+/// deadline) и оценку draw + swap в VideoScheduler
+///
+/// @param plan План показа, NULL — показ вне планировщика (первый кадр, seek)
+/// @param draw_start_us Начало draw, <= 0 — без замера
+static void render_note_present(VideoRenderGL *vr, double pts, int64_t deadline_us,
+                                const VsPlan *plan, int64_t draw_start_us) {
+    int64_t now_us = platform_now_us();
+    // Vsync-locked показ: кадр на экране с target vsync, а не с момента возврата swap'а
+    int64_t present_us = plan && plan->target_vsync_us > 0 ? plan->target_vsync_us : now_us;
+    bool new_frame = pts != vr->present_pts;
+    if (!new_frame) {
+        deadline_us = 0;  // Тот же кадр ещё раз (interpolation): в статистике и якоре один раз
+    } else if (!isnan(pts) && pts >= 0.0) {
+        vr->present_pts = pts;
+        vr->present_us = present_us;
+    }
+    
+    VideoScheduler *sched = &vr->scheduler;
+    video_scheduler_on_present(sched, plan, new_frame, draw_start_us, now_us);
+    if (plan && plan->period_us > 0 && new_frame && sched->stats.presented % RENDER_PRESENT_LOG_FRAMES == 0) {
+        const VsStats *vst = &sched->stats;
+        ALOGI("📊 Vsync cadence: period=%.2fms latency=%.2fms presented=%lld redraws=%lld dropped=%lld "
+              "missed=%lld vsyncs/frame[1 2 3 4 5 >=6]=%lld %lld %lld %lld %lld %lld",
+              (double)plan->period_us / 1000.0, (double)video_scheduler_latency_us(sched, plan->period_us) / 1000.0,
+              (long long)vst->presented, (long long)vst->redraws, (long long)vst->dropped, (long long)vst->missed,
+              (long long)vst->cadence[0], (long long)vst->cadence[1], (long long)vst->cadence[2],
+              (long long)vst->cadence[3], (long long)vst->cadence[4], (long long)vst->cadence[5]);
+    }
+    if (new_frame && vr->pbo_ring.available && sched->stats.presented % RENDER_PRESENT_LOG_FRAMES == 0) {
+        const VrPboStats *pst = &vr->pbo_ring.stats;
+        ALOGI("📊 PBO upload: staged_ahead=%lld hits=%lld misses=%lld busy=%lld",
+              (long long)pst->staged_ahead, (long long)pst->hits, (long long)pst->misses, (long long)pst->busy);
+    }
+    if (deadline_us <= 0) {
+        return;
+    }
+    
+    VrPresentStats *st = &vr->present_stats;
+    vr_present_stats_add(st, present_us, deadline_us);
+    if (st->frames % RENDER_PRESENT_LOG_FRAMES == 0) {
+        ALOGI("📊 Present vs PTS: frames=%lld mean=%.2fms max=%.2fms early=%lld late=%lld "
+              "hist[<0.25 <0.5 <1 <2 <4 <8 <16 >=16ms]=%lld %lld %lld %lld %lld %lld %lld %lld",
+              (long long)st->frames, (double)st->sum_abs_us / (double)st->frames / 1000.0,
+              (double)st->max_abs_us / 1000.0, (long long)st->early, (long long)st->late,
+              (long long)st->hist[0], (long long)st->hist[1], (long long)st->hist[2], (long long)st->hist[3],
+              (long long)st->hist[4], (long long)st->hist[5], (long long)st->hist[6], (long long)st->hist[7]);
+    }
+}
+
+/// Скопировать следующий кадр очереди в PBO сразу после swap'а, пока render thread
+/// всё равно ждёт vsync: на следующем draw его загрузка не стоит на пути к eglSwapBuffers
+///
+/// Не зависит от interpolation: без неё draw получает только frame0, и следующий
+/// кадр иначе копировался бы в PBO на критическом пути. С interpolation он уже
+/// в кольце (загружен как frame1) — stage ничего не делает.
+static void render_stage_next_frame(VideoRenderGL *vr, const AVFrame *next) {
+    if (!next || !vr->pbo_ring.available) {
+        return;
+    }
+    VrYuvLayout layout = vr_yuv_layout_for_format(next->format);
+    if (layout == VR_YUV_LAYOUT_NONE) {
+        return;
+    }
+    
+    pthread_mutex_lock(&vr->render_mutex);
+    // Context мог быть отпущен (surface destroyed) между draw и stage
+    if (vr->egl_current && (vr->state == VR_STATE_READY || vr->state == VR_STATE_RENDERING)) {
+        vr_pbo_ring_stage(&vr->pbo_ring, layout, next, vr->video_width, vr->video_height);
+    }
+    pthread_mutex_unlock(&vr->render_mutex);
 }
 
 // 🔴 УДАЛЕНО: mark_frame_available больше не нужен для SurfaceTexture
@@ -2833,7 +2910,21 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
     ALOGI("VSync-driven render loop started (interpolation: %s, mode: %d)", 
           interp_status, vr->interp_mode);
     
+    // Новые кадры / flush / abort очереди будят render thread (вместо поллинга размера очереди)
+    FrameQueue *fq = (FrameQueue *)frame_queue;
+    frame_queue_set_frame_notify(fq, &vr->waiter.mutex, &vr->waiter.cond);
+    vr->paused_frame_shown = false;
+    vr->vsync_source_failed = false;
+    
     while (!*abort) {
+        // Снимок до проверок: wake, пришедший между проверкой и ожиданием, не теряется
+        uint64_t wake_seq = vr_waiter_seq(&vr->waiter);
+        
+        // Scheduler трогает только render thread: сброс после seek / clear — здесь
+        if (atomic_exchange(&vr->scheduler_reset_pending, false)) {
+            video_scheduler_reset(&vr->scheduler);
+        }
+        
         // 🔥 КРИТИЧЕСКИЙ FIX: SEEK-GATE - drop frames во время seek
         // Это критично для scrub (10-30 seek/сек) и предотвращает отрисовку "грязных" кадров
         if (vs && vs->player_ctx) {
@@ -2858,8 +2949,8 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                         continue; // Пропускаем рендер
                     }
                 } else {
-                    // Нет кадра - ждём
-                    av_usleep(1000); // 1ms
+                    // Нет кадра - ждём push'а (или wake / abort)
+                    render_wait_frames(vr, wake_seq, fq, 1, RENDER_WAIT_SAFETY_US, abort);
                     continue;
                 }
             }
@@ -2871,7 +2962,8 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
             
             if (is_seeking && !ctx->seek_in_progress) {
                 // Seek выполняется (legacy) - ждём, не рендерим
-                av_usleep(1000); // 1ms
+                // seek_req.seeking сбрасывается без wake: перепроверяем по таймауту
+                render_wait_state(vr, wake_seq, RENDER_WAIT_FLAG_US, abort);
                 continue;
             }
         }
@@ -2880,7 +2972,8 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
         // 🔴 ШАГ 4: Это главный фикс против ускорения и зависания
         // 🔴 ШАГ 5: НЕТ КАДРОВ → НЕТ РЕНДЕРА → НЕТ SWAP
         if (!vr->player_prepared) {
-            usleep(2000); // 2ms
+            // video_render_gl_set_prepared будит
+            render_wait_state(vr, wake_seq, RENDER_WAIT_SAFETY_US, abort);
             continue;
         }
         
@@ -2892,9 +2985,9 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
             // Ждём накопления кадров через VSync (не busy-wait)
             // Проверяем только в начале каждого VSync цикла
             if (frame_queue_size((FrameQueue *)frame_queue) < JITTER_BUFFER_MIN) {
-                // Ещё не накопилось - ждём
+                // Ещё не накопилось - ждём, пока decoder не положит JITTER_BUFFER_MIN кадров
                 // 🔴 ШАГ 5: НЕТ КАДРОВ → НЕТ РЕНДЕРА → НЕТ SWAP
-                usleep(2000); // 2ms
+                render_wait_frames(vr, wake_seq, fq, JITTER_BUFFER_MIN, RENDER_WAIT_SAFETY_US, abort);
                 continue;
             }
             // Накопилось достаточно кадров - готовы к рендерингу
@@ -2907,16 +3000,19 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
         // Это гарантирует, что цикл не крутится в busy-wait
         
         // Шаг 33.8: Pause handling
+        // Последний кадр показывается один раз (и по запросу перерисовки: viewport / transform),
+        // дальше render thread спит до resume / wake — без swap'а на каждый vsync
         if (vr->paused) {
-            if (vr->last_frame) {
-                // Рендерим последний кадр
+            if (vr->last_frame && (!vr->paused_frame_shown || vr->redraw_requested)) {
+                vr->redraw_requested = false;
                 // 🔴 КРИТИЧНО: video_render_gl_draw() уже вызывает markFrameAvailable() внутри
-                video_render_gl_draw(vr, vr->last_frame, NULL, 0.0f);
-            } else {
-                // Нет кадра для паузы - просто ждём
-                // 🔴 ШАГ 5: НЕТ КАДРОВ → НЕТ РЕНДЕРА → НЕТ SWAP
-                usleep(2000); // 2ms
+                if (video_render_gl_draw(vr, vr->last_frame, NULL, 0.0f) == 0) {
+                    vr->paused_frame_shown = true;
+                }
             }
+            render_vsync_set_active(vr, false);
+            // 🔴 ШАГ 5: НЕТ КАДРОВ → НЕТ РЕНДЕРА → НЕТ SWAP
+            render_wait_state(vr, wake_seq, RENDER_WAIT_SAFETY_US, abort);
             continue;
         }
         
@@ -2926,7 +3022,7 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
         // Шаг 34.4: Audio starvation guard (video-only safe)
         // 🔴 ШАГ 5: Audio ещё не стартовал → не рендерим, но и не swap'аем
         if (audio_state && !((AudioState *)audio_state)->clock.valid) {
-            usleep(2000); // 2ms
+            render_wait_state(vr, wake_seq, RENDER_WAIT_FLAG_US, abort);
             continue;
         }
 
@@ -2984,7 +3080,7 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                 // ⛔ Background mode - НЕ рендерим видео
                 // ❌ НЕ делаем eglSwapBuffers
                 // ❌ НЕ обновляем video_clock
-                usleep(10000); // 10ms
+                render_wait_state(vr, wake_seq, RENDER_WAIT_IDLE_US, abort);
                 continue;
             }
         }
@@ -2994,16 +3090,16 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
         if (vs && vs->player_ctx) {
             PlayerContext *ctx = (PlayerContext *)vs->player_ctx;
             if (!avsync_gate_is_open(&ctx->avsync_gate)) {
-                // ⛔ WAIT, но НЕ spin
-                usleep(5000); // 5ms
+                // ⛔ WAIT, но НЕ spin (gate открывается без wake — перепроверяем по таймауту)
+                render_wait_state(vr, wake_seq, RENDER_WAIT_GATE_US, abort);
                 continue;
             }
         }
         
         // Шаг 34.3: Renderer starvation guard
         // 🔴 ШАГ 5: НЕТ КАДРОВ → НЕТ РЕНДЕРА → НЕТ SWAP
-        if (frame_queue_size((FrameQueue *)frame_queue) == 0) {
-            usleep(2000); // 2ms
+        if (frame_queue_size(fq) == 0) {
+            render_wait_frames(vr, wake_seq, fq, 1, RENDER_WAIT_SAFETY_US, abort);
             continue;
         }
         
@@ -3031,9 +3127,9 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
         // Шаг 41.1, 41.5: Получаем текущий и следующий кадр
         Frame *f0 = frame_queue_peek_ptr((FrameQueue *)frame_queue);
         if (!f0 || !f0->frame) {
-            // Нет кадра - ждём
+            // Нет кадра - ждём push'а
             // 🔴 ШАГ 5: НЕТ КАДРОВ → НЕТ РЕНДЕРА → НЕТ SWAP
-            usleep(2000); // 2ms
+            render_wait_frames(vr, wake_seq, fq, 1, RENDER_WAIT_SAFETY_US, abort);
             continue;
         }
         
@@ -3087,7 +3183,9 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
         if (first_frame_not_rendered) {
             // 🔥 SAFETY-NET: render ЛЮБОЙ кадр для первого frame
             // Это обязательный фикс против: чёрного экрана, вечного waitingFirstFrame, deadlock при seek
-            video_render_gl_draw(vr, f0->frame, f1 ? f1->frame : NULL, 0.0f);
+            if (video_render_gl_draw(vr, f0->frame, f1 ? f1->frame : NULL, 0.0f) == 0) {
+                render_note_present(vr, pts0, 0, NULL, 0);
+            }
             
             // 🔥 КРИТИЧЕСКИЙ FIX: VIDEO CLOCK SOURCE UNIFICATION - ШАГ 17.5: FIRST FRAME = VIDEO CLOCK INIT
             // Обновляем clock после eglSwapBuffers (уже выполнено в video_render_gl_draw)
@@ -3133,9 +3231,11 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
             
             // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 10.6: ЖЁСТКАЯ защита seek target
             // Если seek в процессе, дропаем кадры до тех пор, пока не найдём первый >= target
+            // 🔥 SCRUB: keyframe-only preview показывает keyframe ≤ target без decode до target
             if (ctx->seek.in_progress) {
                 double seek_target_sec = ctx->seek.target_ms / 1000.0;
-                if (!isnan(pts0) && pts0 >= 0.0 && pts0 + 0.002 < seek_target_sec) {
+                bool keyframe_preview = player_scrub_keyframe_preview(ctx);
+                if (!keyframe_preview && !isnan(pts0) && pts0 >= 0.0 && pts0 + 0.002 < seek_target_sec) {
                     // ❌ ещё не достигли target → drop
                     ALOGD("🔍 SEEK MODE: dropping frame pts=%.3f < target=%.3f", pts0, seek_target_sec);
                     frame_queue_next((FrameQueue *)frame_queue);
@@ -3143,7 +3243,9 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                 }
                 
                 // 🔥 ПЕРВЫЙ КАДР >= target — РЕНДЕР
-                video_render_gl_draw(vr, f0->frame, f1 ? f1->frame : NULL, 0.0f);
+                if (video_render_gl_draw(vr, f0->frame, f1 ? f1->frame : NULL, 0.0f) == 0) {
+                    render_note_present(vr, pts0, 0, NULL, 0);
+                }
                 
                 // 🔥 КРИТИЧЕСКИЙ FIX: VIDEO CLOCK SOURCE UNIFICATION - ШАГ 17.3
                 // Обновляем clock после eglSwapBuffers (уже выполнено в video_render_gl_draw)
@@ -3169,7 +3271,7 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                 
                 // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 10.9: ASSERT
                 #ifdef DEBUG
-                if (pts0 < seek_target_sec - 0.01) {
+                if (!keyframe_preview && pts0 < seek_target_sec - 0.01) {
                     ALOGE("❌ SEEK_ASSERT FAILED: first_frame_pts=%.3f < seek_target=%.3f - 0.01 (FATAL)", 
                           pts0, seek_target_sec);
                     abort(); // 🔥 FATAL в debug
@@ -3177,20 +3279,8 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                 #endif
                 
                 // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 15.7: Scrub Spam Protection
-                // Проверяем pending seek и выполняем его, если есть
-                if (ctx->has_pending_seek) {
-                    double pending_seconds = ctx->pending_seek_seconds;
-                    bool pending_exact = ctx->pending_seek_exact;
-                    ctx->has_pending_seek = false;
-                    ctx->pending_seek_seconds = 0.0;
-                    ctx->pending_seek_exact = false;
-                    
-                    ALOGI("🔍 SEEK: Executing pending seek to %.3f sec", pending_seconds);
-                    
-                    // Выполняем pending seek
-                    extern int player_seek(PlayerContext *ctx, double seconds, bool exact);
-                    player_seek(ctx, pending_seconds, pending_exact);
-                    
+                // Проверяем pending seek и выполняем его, если есть (забирается под seek_mutex)
+                if (player_seek_run_pending(ctx)) {
                     frame_queue_next((FrameQueue *)frame_queue);
                     continue; // Продолжаем с новым seek
                 }
@@ -3209,7 +3299,7 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
             // Проверяем AVSYNC gate перед использованием master clock
             if (!avsync_gate_is_open(&ctx->avsync_gate)) {
                 // ⛔ AVSYNC gate закрыт → ждём, но НЕ spin
-                usleep(5000); // 5ms
+                render_wait_state(vr, wake_seq, RENDER_WAIT_GATE_US, abort);
                 continue;
             }
             
@@ -3273,7 +3363,8 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
         }
         
         // ✅ Кадр прошёл drop policy → рендерим
-        // 🔥 PATCH 7: УДАЛЕНО "sleep until pts", "delay rendering" - кадр рендерится немедленно
+        // 🔥 PATCH 7: УДАЛЕНО "sleep until pts", "delay rendering" - ожидание PTS теперь
+        // блокирующее (render_wait_until после проверок sync), без sleep-поллинга
         
         // 🔥 КРИТИЧНО: Определяем, есть ли аудио (для правильного выбора master clock)
         bool has_audio_active = false;
@@ -3344,7 +3435,6 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                             consecutive_drops = 0;
                         }
                         
-                        usleep(2000); // 2ms
                         continue;
                     }
                 }
@@ -3381,7 +3471,12 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                         // HOLD: ждём, пока video не догонит audio
                         ALOGD("⏸ FRAME HOLD: video behind audio (diff=%.3f, hold=%.3f)", 
                               diff, hold_duration);
-                        usleep(5000); // 5ms
+                        // Спим до FORCE_RENDER deadline'а (квантами: clock'и перечитываются),
+                        // flush / seek / pause будят раньше
+                        int64_t hold_deadline_us = (int64_t)((hold_start_time + MAX_FRAME_HOLD_SEC) * 1000000.0) + 1000;
+                        int64_t hold_wake_us = platform_now_us() + RENDER_WAIT_HOLD_SLICE_US;
+                        render_wait_until(vr, wake_seq, fq, f0,
+                                          hold_wake_us < hold_deadline_us ? hold_wake_us : hold_deadline_us, abort);
                         continue; // Пропускаем этот кадр, ждём следующего
                     }
                 } else {
@@ -3408,7 +3503,6 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                             // Кадр всё ещё < audio_clock → drop
                             ALOGW("⚠️ VIDEO RESYNC: dropping frame @ %.3f (< audio_clock %.3f)", pts0, audio_clock);
                             frame_queue_next((FrameQueue *)frame_queue);
-                            usleep(2000);
                             continue;
                         }
                     } else if (abs_diff > 0.300) {
@@ -3427,7 +3521,6 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                             consecutive_drops = 0;
                         }
                         
-                        usleep(2000); // 2ms
                         continue;
                     } else {
                         // 150-300ms → ❌ DROP video frames (до догоняния)
@@ -3445,7 +3538,6 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
                             consecutive_drops = 0;
                         }
                         
-                        usleep(2000); // 2ms
                         continue;
                     }
                 }
@@ -3480,10 +3572,52 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
             frame_queue_next((FrameQueue *)frame_queue);
             vr->interp_stats.drop_count++;
             // 🔴 ШАГ 5: НЕТ КАДРОВ → НЕТ РЕНДЕРА → НЕТ SWAP
-            usleep(2000); // 2ms
             continue;
         }
         
+        // 🔥 Vsync-locked показ (video_scheduler.h): кадр рисуется к тому vsync'у, который
+        // ближе всего к его deadline'у, render thread спит до vsync - (draw + swap).
+        // Следующий кадр успевает к тому же vsync'у → текущий дропается; кадру рано →
+        // на экране остаётся прошлый (repeat). Без vsync — показ в deadline.
+        // Первый кадр и seek показываются сразу (см. выше)
+        int64_t present_deadline_us = 0;
+        VsPlan plan;
+        const VsPlan *present_plan = NULL;
+        if (vr->first_frame_rendered && vs && vs->player_ctx) {
+            PlayerContext *ctx = (PlayerContext *)vs->player_ctx;
+            if (!ctx->seek.in_progress && !ctx->waiting_first_frame_after_seek) {
+                render_vsync_set_active(vr, true);
+                int64_t now_us = platform_now_us();
+                present_deadline_us = render_present_deadline_us(vr, ctx, (AudioState *)audio_state, pts0, now_us);
+                int64_t next_deadline_us = 0;
+                if (f1 && f1->frame && !isnan(pts1) && pts1 > pts0) {
+                    next_deadline_us = render_present_deadline_us(vr, ctx, (AudioState *)audio_state, pts1, now_us);
+                }
+                bool head_shown = pts0 == vr->present_pts;  // Interpolation: f0 уже на экране
+                
+                VsyncTiming vt;
+                bool have_vsync = vsync_clock_get(&vr->vsync_clock, now_us, &vt);
+                VsDecision decision = video_scheduler_plan(&vr->scheduler, have_vsync ? &vt : NULL, now_us,
+                                                           present_deadline_us, next_deadline_us, head_shown, &plan);
+                if (decision == VS_NEXT) {
+                    frame_queue_next(fq);
+                    if (!head_shown) {
+                        vr->interp_stats.drop_count++;
+                    }
+                    continue;
+                }
+                if (decision == VS_WAIT) {
+                    int64_t wake_at_us = plan.wake_at_us;
+                    if (wake_at_us - now_us > RENDER_PRESENT_MAX_WAIT_US) {
+                        wake_at_us = now_us + RENDER_PRESENT_MAX_WAIT_US;
+                    }
+                    render_wait_until(vr, wake_seq, fq, f0, wake_at_us, abort);
+                    continue;
+                }
+                present_plan = &plan;
+            }
+        }
+        
         // 🔴 ШАГ 8: Обновляем has_next_frame ПЕРЕД проверкой интерполяции
         // Это критично для правильной работы AUTO-логики
         bool has_next = (f1 && f1->frame && !isnan(pts1) && pts1 > pts0);
@@ -3597,6 +3731,7 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
         
         // Шаг 41.6: Рендерим с interpolation (или без, если fallback)
         // 🔴 КРИТИЧНО: video_render_gl_draw всегда получает валидный alpha (0.0 если нет интерполяции)
+        int64_t draw_start_us = platform_now_us();
         int ret = video_render_gl_draw(vr, f0->frame, frame1_ptr, alpha);
         
         // Шаг 41.9: Субтитры рисуются ПОСЛЕ видео (по master clock, не по video pts)
@@ -3620,6 +3755,9 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
         }
         
         if (ret == 0) {
+            render_note_present(vr, pts0, present_deadline_us, present_plan, draw_start_us);
+            render_stage_next_frame(vr, f1 ? f1->frame : NULL);
+            
             // 🔥 КРИТИЧЕСКИЙ FIX: VIDEO CLOCK SOURCE FIX - PATCH 4: update clock ТОЛЬКО после eglSwapBuffers
             // video_clock_pts обновляется внутри video_render_gl_draw() после eglSwapBuffers
             // Здесь только обновляем last_pts для frame drop policy
@@ -3834,6 +3972,8 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
     
     // 🔴 ШАГ 5: Render loop вышел из цикла (abort установлен)
     ALOGI("🛑 VSync-driven render loop stopped (abort requested)");
+    frame_queue_set_frame_notify(fq, NULL, NULL);
+    render_vsync_set_active(vr, false);
     
     // 🔥 КРИТИЧНО: EGLContext ОБЯЗАН быть уничтожен в render thread (где он был создан)
     // Это единственный правильный способ избежать "call to OpenGL ES API with no current context"
@@ -3864,6 +4004,9 @@ void video_render_gl_render_loop(VideoRenderGL *vr,
             ALOGI("✅ Render thread: EGL context destroyed");
         }
         
+        // PBO и fence'ы удалены вместе с context'ом
+        memset(&vr->pbo_ring, 0, sizeof(vr->pbo_ring));
+        
         // 🔥 ШАГ 4: Завершаем display
         eglTerminate(vr->egl_display);
         vr->egl_display = EGL_NO_DISPLAY;
@@ -3927,6 +4070,11 @@ void video_render_gl_release(VideoRenderGL *vr) {
                 if (vr->tex_v) glDeleteTextures(1, &vr->tex_v);
                 if (vr->vbo) glDeleteBuffers(1, &vr->vbo);
                 if (vr->shader_program) glDeleteProgram(vr->shader_program);
+                for (int layout = VR_YUV_LAYOUT_I420 + 1; layout < VR_YUV_LAYOUT_COUNT; layout++) {
+                    if (vr->yuv_programs[layout].program) glDeleteProgram(vr->yuv_programs[layout].program);
+                }
+                memset(vr->yuv_programs, 0, sizeof(vr->yuv_programs));
+                vr_pbo_ring_release(&vr->pbo_ring);
                 
                 // Отвязываем context после очистки
                 eglMakeCurrent(vr->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
@@ -3942,6 +4090,7 @@ void video_render_gl_release(VideoRenderGL *vr) {
         if (vr->last_frame) {
             av_frame_free(&vr->last_frame);
         }
+        vr_yuv_uploader_free(&vr->yuv_uploader);
         
         // 🔥 КРИТИЧНО: EGL ресурсы НЕ уничтожаем здесь (в JNI потоке)
         // EGLContext ОБЯЗАН быть уничтожен в render thread (где он был создан)
@@ -3968,6 +4117,8 @@ void video_render_gl_release(VideoRenderGL *vr) {
     
     pthread_mutex_unlock(&vr->render_mutex);
     pthread_mutex_destroy(&vr->render_mutex);
+    vr_waiter_destroy(&vr->waiter);
+    vsync_clock_destroy(&vr->vsync_clock);
     
     // Очищаем JNI callback
     native_player_cleanup();
@@ -4050,11 +4201,13 @@ void video_render_gl_set_viewport(VideoRenderGL *vr,
         vr->layout.video_w = (float)vr->video_width;
         vr->layout.video_h = (float)vr->video_height;
     }
+    vr->redraw_requested = true;
     
     pthread_mutex_unlock(&vr->render_mutex);
     
     // 🔴 ЭТАЛОН: Пересчитываем aspect ratio при изменении viewport
     video_render_gl_update_aspect(vr);
+    video_render_gl_wake(vr);
     
     ALOGD("✅ Viewport set: view=%fx%f, video=%fx%f, rotation=%d, scaleMode=%d",
           view_w, view_h, vr->layout.video_w, vr->layout.video_h, rotation, scale_mode);
@@ -4107,8 +4260,10 @@ void video_render_gl_set_transform(VideoRenderGL *vr,
         vr->transform.offset_x = 0.0f;
         vr->transform.offset_y = 0.0f;
     }
+    vr->redraw_requested = true;
     
     pthread_mutex_unlock(&vr->render_mutex);
+    video_render_gl_wake(vr);
     
     ALOGD("✅ Transform set: scale=%.2f, offset=(%.3f, %.3f)",
           vr->transform.scale, vr->transform.offset_x, vr->transform.offset_y);
@@ -11,7 +11,12 @@
 #include "libavutil/rational.h"
 #include "clock.h"
 #include "video_color_info.h"
+#include "video_render_yuv.h"
+#include "video_render_pbo.h"
+#include "video_render_wait.h"
+#include "video_scheduler.h"
 #include <stdbool.h>
+#include <stdatomic.h>
 
 // Forward declarations
 
@@ -108,6 +113,10 @@ typedef struct VideoRenderGL {
     /// Fragment shader
     GLuint fragment_shader;
     
+    /// Программы по раскладке кадра (NV12 / NV21 / P010 / YUV420P10), компилируются в init_gl_resources
+    /// I420 — обёртка над shader_program; program == 0 → формат не поддерживается этим GPU
+    VrYuvProgram yuv_programs[VR_YUV_LAYOUT_COUNT];
+    
     /// YUV textures (Frame 0 - current, Шаг 41.4)
     GLuint tex_y0;
     GLuint tex_u0;
@@ -254,6 +263,15 @@ typedef struct VideoRenderGL {
     /// Высота текстур (ШАГ 11.1)
     int tex_h;
     
+    /// Раскладка, под которую размещены текстуры (VrYuvLayout)
+    int tex_layout;
+    
+    /// Загрузка плоскостей: GL_UNPACK_ROW_LENGTH или persistent staging (без malloc на кадр)
+    VrYuvUploader yuv_uploader;
+    
+    /// GLES3: кольцо PBO, кадр копируется заранее и загружается асинхронно (иначе available = false)
+    VrPboRing pbo_ring;
+    
     /// Флаг, что EGL context текущий (ШАГ 11.2 - оптимизация eglMakeCurrent)
     bool egl_current;
     
@@ -262,6 +280,43 @@ typedef struct VideoRenderGL {
     /// Флаг готовности jitter buffer (сбрасывается при seek)
     bool jitter_buffer_ready;
     
+    // === Event-driven render loop ===
+    
+    /// Точка ожидания render thread: новые кадры (frame_queue_set_frame_notify),
+    /// pause / resume / prepared / clear / abort (video_render_gl_wake) и deadline показа
+    VrWaiter waiter;
+    
+    /// Кадр нужно перерисовать на паузе (изменились viewport / transform / fit mode)
+    bool redraw_requested;
+    
+    /// last_frame показан после входа в паузу (на паузе не перерисовываем каждый vsync)
+    bool paused_frame_shown;
+    
+    /// Якорь video clock: PTS последнего показанного кадра и монотонное время его swap'а (us)
+    double present_pts;
+    int64_t present_us;
+    
+    /// Точность показа относительно deadline'ов (только кадры, которые ждали своего PTS)
+    VrPresentStats present_stats;
+    
+    // === Vsync-locked показ (video_scheduler.h) ===
+    
+    /// Фаза и период vsync дисплея (тикает источник из platform/vsync_source.h)
+    VsyncClock vsync_clock;
+    
+    /// Источник vsync: работает, пока кадры показываются по PTS (на паузе остановлен)
+    struct VsyncSource *vsync_source;
+    
+    /// Источник не запустился в этом render loop: показ в deadline, без повторных попыток
+    bool vsync_source_failed;
+    
+    /// Выбор vsync'а для кадра, drop / repeat, оценка draw + swap
+    VideoScheduler scheduler;
+    
+    /// Запрос сброса scheduler'а (video_render_gl_clear): scheduler принадлежит render thread,
+    /// сброс выполняется им в начале итерации render loop
+    atomic_bool scheduler_reset_pending;
+    
     // === ШАГ 11.1: Кешированные uniform locations ===
     
     /// Uniform locations (кешируются при init)
@@ -480,6 +535,12 @@ void video_render_gl_set_paused(VideoRenderGL *vr, bool paused);
 /// Без этого флага render loop не будет рендерить кадры.
 void video_render_gl_set_prepared(VideoRenderGL *vr, bool prepared);
 
+/// Разбудить render loop, если он ждёт (abort, смена режима и т.п.)
+///
+/// Флаги, при изменении которых render loop должен перепроверить состояние,
+/// выставляются до вызова.
+void video_render_gl_wake(VideoRenderGL *vr);
+
 /// 🔴 ШАГ 3: Уведомляет Flutter о новом кадре (после рендеринга в FBO)
 ///
 /// Вызывается из render loop после того, как кадр отрендерен в flutter_buffers[write_index]
@@ -0,0 +1,228 @@
+/// 🔥 VIDEO RENDER PBO: кольцо pixel buffer objects (см. video_render_pbo.h)
+
+#include "video_render_pbo.h"
+#include "libavutil/avutil.h"  // AV_NOPTS_VALUE
+#include "libavutil/frame.h"
+#include <EGL/egl.h>
+#include <stdio.h>
+#include <string.h>
+
+// GLES3 функции берутся через eglGetProcAddress: библиотека линкуется с GLESv2,
+// а context может оказаться GLES2 — тогда кольцо просто недоступно
+typedef void *(GL_APIENTRYP VrPfnMapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length,
+                                                 GLbitfield access);
+typedef GLboolean (GL_APIENTRYP VrPfnUnmapBuffer)(GLenum target);
+typedef GLsync (GL_APIENTRYP VrPfnFenceSync)(GLenum condition, GLbitfield flags);
+typedef GLenum (GL_APIENTRYP VrPfnClientWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+typedef void (GL_APIENTRYP VrPfnDeleteSync)(GLsync sync);
+
+static VrPfnMapBufferRange gl_map_buffer_range = NULL;
+static VrPfnUnmapBuffer gl_unmap_buffer = NULL;
+static VrPfnFenceSync gl_fence_sync = NULL;
+static VrPfnClientWaitSync gl_client_wait_sync = NULL;
+static VrPfnDeleteSync gl_delete_sync = NULL;
+
+static bool init_gles3_functions(void) {
+    gl_map_buffer_range = (VrPfnMapBufferRange)eglGetProcAddress("glMapBufferRange");
+    gl_unmap_buffer = (VrPfnUnmapBuffer)eglGetProcAddress("glUnmapBuffer");
+    gl_fence_sync = (VrPfnFenceSync)eglGetProcAddress("glFenceSync");
+    gl_client_wait_sync = (VrPfnClientWaitSync)eglGetProcAddress("glClientWaitSync");
+    gl_delete_sync = (VrPfnDeleteSync)eglGetProcAddress("glDeleteSync");
+    return gl_map_buffer_range && gl_unmap_buffer && gl_fence_sync && gl_client_wait_sync && gl_delete_sync;
+}
+
+void vr_pbo_ring_init(VrPboRing *ring) {
+    memset(ring, 0, sizeof(*ring));
+
+    const char *version = (const char *)glGetString(GL_VERSION);
+    int major = 0;
+    if (!version || sscanf(version, "OpenGL ES %d", &major) != 1 || major < 3) {
+        return;
+    }
+    ring->available = init_gles3_functions();
+}
+
+void vr_pbo_ring_release(VrPboRing *ring) {
+    if (!ring) {
+        return;
+    }
+    for (int s = 0; s < VR_PBO_RING_SIZE; s++) {
+        VrPboSlot *slot = &ring->slot[s];
+        if (slot->fence) {
+            gl_delete_sync(slot->fence);
+        }
+        for (int i = 0; i < VR_YUV_MAX_PLANES; i++) {
+            if (slot->pbo[i]) {
+                glDeleteBuffers(1, &slot->pbo[i]);
+            }
+        }
+    }
+    memset(ring, 0, sizeof(*ring));
+}
+
+void vr_pbo_ring_reset(VrPboRing *ring) {
+    if (!ring) {
+        return;
+    }
+    for (int s = 0; s < VR_PBO_RING_SIZE; s++) {
+        ring->slot[s].staged = false;
+    }
+}
+
+/// Ключ кадра: буфер + timestamp. Без timestamp'а кадр не кешируется — буферы из пула
+/// декодера переиспользуются, и один data[0] может принадлежать разным кадрам
+static bool frame_key(const AVFrame *frame, int64_t *pts) {
+    *pts = frame->pts != AV_NOPTS_VALUE ? frame->pts : frame->best_effort_timestamp;
+    return *pts != AV_NOPTS_VALUE;
+}
+
+static int find_staged(const VrPboRing *ring, VrYuvLayout layout, const AVFrame *frame, int width, int height) {
+    int64_t pts;
+    if (!frame_key(frame, &pts)) {
+        return -1;
+    }
+    for (int s = 0; s < VR_PBO_RING_SIZE; s++) {
+        const VrPboSlot *slot = &ring->slot[s];
+        if (slot->staged && slot->layout == layout && slot->width == width && slot->height == height &&
+            slot->key_data == frame->data[0] && slot->key_pts == pts) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+/// Слот свободен, если GPU дочитал его PBO (проверка без ожидания)
+static bool slot_idle(VrPboSlot *slot) {
+    if (!slot->fence) {
+        return true;
+    }
+    GLenum status = gl_client_wait_sync(slot->fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        return false;
+    }
+    gl_delete_sync(slot->fence);
+    slot->fence = 0;
+    return true;
+}
+
+/// Скопировать плоскости кадра в PBO слота
+static bool stage_into(VrPboSlot *slot, VrYuvLayout layout, const AVFrame *frame, int width, int height) {
+    slot->staged = false;
+    for (int i = 0; i < vr_yuv_layout_planes(layout); i++) {
+        VrYuvPlaneSize size;
+        vr_yuv_plane_size(layout, i, width, height, &size);
+        GLsizeiptr bytes = (GLsizeiptr)size.row_bytes * size.height;
+
+        if (!slot->pbo[i]) {
+            glGenBuffers(1, &slot->pbo[i]);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->pbo[i]);
+        if (slot->capacity[i] < bytes) {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+            slot->capacity[i] = bytes;
+        }
+        // Fence слота уже сработал: синхронизация драйвера не нужна
+        uint8_t *dst = gl_map_buffer_range(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                           GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT |
+                                           GL_MAP_UNSYNCHRONIZED_BIT);
+        if (!dst) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+        vr_yuv_pack_frame_plane(layout, i, dst, frame, &size);
+        if (!gl_unmap_buffer(GL_PIXEL_UNPACK_BUFFER)) {
+            // Содержимое buffer store потеряно (например, смена видеорежима)
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // Кадр без timestamp'а годится только для немедленного upload'а
+    slot->staged = frame_key(frame, &slot->key_pts);
+    slot->layout = layout;
+    slot->width = width;
+    slot->height = height;
+    slot->key_data = frame->data[0];
+    return true;
+}
+
+/// Подготовить кадр в первом свободном слоте начиная с ring->next
+static int stage_frame(VrPboRing *ring, VrYuvLayout layout, const AVFrame *frame, int width, int height) {
+    for (int n = 0; n < VR_PBO_RING_SIZE; n++) {
+        int s = (ring->next + n) % VR_PBO_RING_SIZE;
+        VrPboSlot *slot = &ring->slot[s];
+        if (!slot_idle(slot)) {
+            continue;
+        }
+        if (!stage_into(slot, layout, frame, width, height)) {
+            return -1;
+        }
+        ring->next = (s + 1) % VR_PBO_RING_SIZE;
+        return s;
+    }
+    return -1;
+}
+
+bool vr_pbo_ring_stage(VrPboRing *ring, VrYuvLayout layout, const AVFrame *frame, int width, int height) {
+    if (!ring || !ring->available || !frame || layout < 0 || layout >= VR_YUV_LAYOUT_COUNT) {
+        return false;
+    }
+    int64_t pts;
+    if (!frame_key(frame, &pts)) {
+        return false;
+    }
+    if (find_staged(ring, layout, frame, width, height) >= 0) {
+        return true;
+    }
+    if (stage_frame(ring, layout, frame, width, height) < 0) {
+        return false;
+    }
+    ring->stats.staged_ahead++;
+    return true;
+}
+
+int vr_pbo_ring_upload(VrPboRing *ring, VrYuvLayout layout, const GLuint *tex, const AVFrame *frame,
+                       int width, int height, bool allocate) {
+    if (!ring || !ring->available || !frame || layout < 0 || layout >= VR_YUV_LAYOUT_COUNT) {
+        return -1;
+    }
+
+    int s = find_staged(ring, layout, frame, width, height);
+    if (s >= 0) {
+        ring->stats.hits++;
+    } else {
+        s = stage_frame(ring, layout, frame, width, height);
+        if (s < 0) {
+            ring->stats.busy++;
+            return -1;
+        }
+        ring->stats.misses++;
+    }
+    VrPboSlot *slot = &ring->slot[s];
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < vr_yuv_layout_planes(layout); i++) {
+        VrYuvPlaneSize size;
+        vr_yuv_plane_size(layout, i, width, height, &size);
+
+        glBindTexture(GL_TEXTURE_2D, tex[i]);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (allocate) {
+            glTexImage2D(GL_TEXTURE_2D, 0, size.format, size.width, size.height, 0, size.format,
+                         GL_UNSIGNED_BYTE, NULL);
+        }
+        // С привязанным PBO указатель — смещение в buffer store: копию выполняет GPU
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->pbo[i]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.width, size.height, size.format, GL_UNSIGNED_BYTE,
+                        (const void *)0);
+    }
+    // 🔴 КРИТИЧНО: иначе следующие glTexSubImage2D из памяти CPU прочитают указатель как смещение в PBO
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (slot->fence) {
+        gl_delete_sync(slot->fence);
+    }
+    slot->fence = gl_fence_sync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/// 🔥 VIDEO RENDER PBO: асинхронная загрузка кадров через кольцо pixel buffer objects (GLES3)
+///
+/// glTexSubImage2D из памяти кадра синхронный: драйвер копирует данные до
+/// возврата, и эта копия стоит в render thread прямо перед eglSwapBuffers.
+///
+/// Здесь загрузка разделена на две фазы:
+/// - stage: кадр копируется (vr_yuv_pack_frame_plane) в mapped PBO заранее —
+///   после swap'а текущего кадра, пока render thread всё равно ждёт vsync;
+/// - upload: glTexSubImage2D из PBO только ставит копию в очередь GPU и
+///   возвращается сразу, CPU-копии на пути к swap'у нет.
+///
+/// Кольцо из VR_PBO_RING_SIZE слотов (по PBO на плоскость): в одном слоте
+/// кадр, который GPU ещё копирует в текстуру, в другом — подготовленный
+/// следующий, третий свободен. Слот перезаписывается только после того,
+/// как сработал его fence (GPU закончил читать PBO).
+///
+/// На GLES2 context'ах (нет PBO / fence) available = false: вызывающий
+/// грузит кадр через vr_yuv_upload_frame.
+
+#ifndef VIDEO_RENDER_PBO_H
+#define VIDEO_RENDER_PBO_H
+
+#include "video_render_yuv.h"
+#include <GLES3/gl3.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+struct AVFrame;
+
+/// Тройная буферизация
+#define VR_PBO_RING_SIZE 3
+
+/// Слот кольца: PBO на каждую плоскость и подготовленный в них кадр
+typedef struct VrPboSlot {
+    GLuint pbo[VR_YUV_MAX_PLANES];
+    GLsizeiptr capacity[VR_YUV_MAX_PLANES];  // Размер buffer store (растёт только вверх)
+    GLsync fence;                            // После последнего чтения PBO GPU'ом, 0 — слот свободен
+    bool staged;                             // В PBO лежит кадр key_*
+    VrYuvLayout layout;
+    int width;
+    int height;
+    const uint8_t *key_data;                 // frame->data[0]: кадр идентифицируется буфером + pts
+    int64_t key_pts;
+} VrPboSlot;
+
+/// Счётчики (с момента vr_pbo_ring_init)
+typedef struct VrPboStats {
+    int64_t staged_ahead;  // Кадров подготовлено заранее (vr_pbo_ring_stage)
+    int64_t hits;          // Загрузок из заранее подготовленного слота (без CPU-копии)
+    int64_t misses;        // Кадр копировался в PBO на критическом пути
+    int64_t busy;          // Все слоты заняты GPU: вызывающий грузил синхронно
+} VrPboStats;
+
+/// Кольцо PBO одного GL context'а, используется только из render thread
+typedef struct VrPboRing {
+    bool available;  // GLES3: PBO + glMapBufferRange + fence
+    int next;        // Следующий слот для stage (round-robin)
+    VrPboSlot slot[VR_PBO_RING_SIZE];
+    VrPboStats stats;
+} VrPboRing;
+
+/// Определить поддержку PBO текущим GL context'ом (context должен быть current)
+///
+/// Буферы создаются лениво, при первом stage.
+void vr_pbo_ring_init(VrPboRing *ring);
+
+/// Удалить PBO и fence'ы (context должен быть current)
+void vr_pbo_ring_release(VrPboRing *ring);
+
+/// Забыть подготовленные кадры (seek / clear). GL не вызывается, буферы остаются
+void vr_pbo_ring_reset(VrPboRing *ring);
+
+/// Подготовить кадр заранее: скопировать плоскости в свободный слот
+///
+/// @return true, если кадр в кольце (подготовлен сейчас или раньше)
+bool vr_pbo_ring_stage(VrPboRing *ring, VrYuvLayout layout, const struct AVFrame *frame, int width, int height);
+
+/// Загрузить кадр в текстуры из PBO
+///
+/// Если кадр не был подготовлен, копируется в PBO сейчас. После glTexSubImage2D
+/// ставится fence слота.
+/// @param allocate Переразместить текстуры (glTexImage2D) — при смене размера или раскладки
+/// @return 0, -1 если кольцо недоступно или все слоты заняты GPU (грузить через vr_yuv_upload_frame)
+int vr_pbo_ring_upload(VrPboRing *ring, VrYuvLayout layout, const GLuint *tex, const struct AVFrame *frame,
+                       int width, int height, bool allocate);
+
+#endif // VIDEO_RENDER_PBO_H
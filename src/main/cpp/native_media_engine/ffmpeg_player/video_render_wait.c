@@ -0,0 +1,120 @@
+/// 🔥 VIDEO RENDER WAIT: блокирующие ожидания render thread (см. video_render_wait.h)
+
+#include "video_render_wait.h"
+#include "platform_time.h"
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+/// Верхние границы корзин гистограммы (последняя — без границы)
+static const int64_t k_bucket_limit_us[VR_PRESENT_HIST_BUCKETS - 1] = {
+    250, 500, 1000, 2000, 4000, 8000, 16000
+};
+
+int vr_waiter_init(VrWaiter *w) {
+    memset(w, 0, sizeof(*w));
+    if (pthread_mutex_init(&w->mutex, NULL) != 0) {
+        return -1;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    // Deadline'ы в platform_now_us(): cond должен считать по тем же часам
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    int ret = pthread_cond_init(&w->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (ret != 0) {
+        pthread_mutex_destroy(&w->mutex);
+        return -1;
+    }
+    return 0;
+}
+
+void vr_waiter_destroy(VrWaiter *w) {
+    pthread_cond_destroy(&w->cond);
+    pthread_mutex_destroy(&w->mutex);
+}
+
+void vr_waiter_wake(VrWaiter *w) {
+    pthread_mutex_lock(&w->mutex);
+    w->seq++;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->mutex);
+}
+
+uint64_t vr_waiter_seq(VrWaiter *w) {
+    pthread_mutex_lock(&w->mutex);
+    uint64_t seq = w->seq;
+    pthread_mutex_unlock(&w->mutex);
+    return seq;
+}
+
+VrWaitResult vr_waiter_wait(VrWaiter *w, uint64_t seq, VrWaitPredicate ready, void *arg,
+                            int64_t deadline_us, const int *abort) {
+    struct timespec ts;
+    if (deadline_us > 0) {
+        ts.tv_sec = (time_t)(deadline_us / 1000000);
+        ts.tv_nsec = (long)(deadline_us % 1000000) * 1000;
+    }
+
+    VrWaitResult result;
+    pthread_mutex_lock(&w->mutex);
+    for (;;) {
+        if (abort && *abort) {
+            result = VR_WAIT_ABORT;
+            break;
+        }
+        if (w->seq != seq) {
+            result = VR_WAIT_WOKEN;
+            break;
+        }
+        if (ready && ready(arg)) {
+            result = VR_WAIT_READY;
+            break;
+        }
+        if (deadline_us <= 0) {
+            pthread_cond_wait(&w->cond, &w->mutex);
+            continue;
+        }
+        if (platform_now_us() >= deadline_us ||
+            pthread_cond_timedwait(&w->cond, &w->mutex, &ts) == ETIMEDOUT) {
+            result = VR_WAIT_TIMEOUT;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&w->mutex);
+    return result;
+}
+
+int vr_present_stats_bucket(int64_t abs_error_us) {
+    for (int i = 0; i < VR_PRESENT_HIST_BUCKETS - 1; i++) {
+        if (abs_error_us < k_bucket_limit_us[i]) {
+            return i;
+        }
+    }
+    return VR_PRESENT_HIST_BUCKETS - 1;
+}
+
+int64_t vr_present_stats_bucket_limit_us(int bucket) {
+    if (bucket < 0 || bucket >= VR_PRESENT_HIST_BUCKETS - 1) {
+        return INT64_MAX;
+    }
+    return k_bucket_limit_us[bucket];
+}
+
+void vr_present_stats_add(VrPresentStats *s, int64_t present_us, int64_t deadline_us) {
+    int64_t error_us = present_us - deadline_us;
+    int64_t abs_us = error_us < 0 ? -error_us : error_us;
+
+    s->frames++;
+    if (error_us < 0) {
+        s->early++;
+    } else if (error_us > 0) {
+        s->late++;
+    }
+    s->sum_abs_us += abs_us;
+    if (abs_us > s->max_abs_us) {
+        s->max_abs_us = abs_us;
+    }
+    s->hist[vr_present_stats_bucket(abs_us)]++;
+}
@@ -0,0 +1,90 @@
+/// 🔥 VIDEO RENDER WAIT: блокирующие ожидания render thread
+///
+/// Render loop ждал всё через usleep(1..10 ms): пустую очередь, паузу,
+/// HOLD по AVSYNC. Поток просыпался сотни раз в секунду даже на паузе,
+/// а момент показа кадра квантовался шагом sleep'а.
+///
+/// VrWaiter — одна точка ожидания render thread'а:
+/// - cond на CLOCK_MONOTONIC: deadline задаётся в тех же микросекундах,
+///   что platform_now_us(), и не зависит от перевода системных часов;
+/// - seq: каждый vr_waiter_wake() увеличивает счётчик. Вызывающий берёт
+///   seq ДО проверки своих условий, поэтому wake между проверкой и
+///   ожиданием не теряется;
+/// - predicate: проверяется под mutex'ом waiter'а, так что источник события,
+///   который будит cond под тем же mutex'ом (frame_queue_set_frame_notify),
+///   тоже не теряется.
+///
+/// VrPresentStats — гистограмма |время показа - запланированный deadline|:
+/// по ней видно, насколько точно кадры попадают в свой PTS.
+///
+/// Зависит только от pthread и platform_time.h (проверяется на host:
+/// bench/bench_render_wait.c).
+
+#ifndef VIDEO_RENDER_WAIT_H
+#define VIDEO_RENDER_WAIT_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Точка ожидания render thread'а
+typedef struct VrWaiter {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;   // CLOCK_MONOTONIC
+    uint64_t seq;          // Под mutex
+} VrWaiter;
+
+/// Почему vr_waiter_wait вернулся
+typedef enum VrWaitResult {
+    VR_WAIT_ABORT = 0,     // *abort установлен
+    VR_WAIT_WOKEN,         // vr_waiter_wake после снимка seq
+    VR_WAIT_READY,         // predicate вернул true
+    VR_WAIT_TIMEOUT        // Наступил deadline
+} VrWaitResult;
+
+/// Условие ожидания, проверяется под mutex'ом waiter'а
+typedef bool (*VrWaitPredicate)(void *arg);
+
+/// Корзин гистограммы: < 0.25, 0.5, 1, 2, 4, 8, 16 ms и >= 16 ms
+#define VR_PRESENT_HIST_BUCKETS 8
+
+/// Точность показа кадров относительно deadline'ов
+typedef struct VrPresentStats {
+    int64_t frames;
+    int64_t early;          // Показан раньше deadline'а
+    int64_t late;           // Показан позже
+    int64_t sum_abs_us;
+    int64_t max_abs_us;
+    int64_t hist[VR_PRESENT_HIST_BUCKETS];
+} VrPresentStats;
+
+/// @return 0, <0 при ошибке pthread
+int vr_waiter_init(VrWaiter *w);
+
+void vr_waiter_destroy(VrWaiter *w);
+
+/// Разбудить ожидающего (seq++, broadcast)
+void vr_waiter_wake(VrWaiter *w);
+
+/// Снимок seq: брать перед проверкой условий, по которым потом ждать
+uint64_t vr_waiter_seq(VrWaiter *w);
+
+/// Ждать, пока не выполнится одно из: *abort, wake после снимка seq,
+/// ready(arg), deadline
+///
+/// @param ready Может быть NULL
+/// @param deadline_us Монотонное время (platform_now_us), <= 0 — без deadline'а
+/// @param abort Может быть NULL
+VrWaitResult vr_waiter_wait(VrWaiter *w, uint64_t seq, VrWaitPredicate ready, void *arg,
+                            int64_t deadline_us, const int *abort);
+
+/// Учесть кадр: present_us — фактическое время показа, deadline_us — запланированное
+void vr_present_stats_add(VrPresentStats *s, int64_t present_us, int64_t deadline_us);
+
+/// Корзина гистограммы для |ошибки|
+int vr_present_stats_bucket(int64_t abs_error_us);
+
+/// Верхняя граница корзины в микросекундах (INT64_MAX у последней)
+int64_t vr_present_stats_bucket_limit_us(int bucket);
+
+#endif // VIDEO_RENDER_WAIT_H
@@ -0,0 +1,398 @@
+/// 🔥 VIDEO RENDER YUV: shader'ы и загрузка NV12 / NV21 / P010 / YUV420P10 (см. video_render_yuv.h)
+
+#include "video_render_yuv.h"
+#include "libavutil/frame.h"
+#include "libavutil/pixfmt.h"
+#include "libavutil/mem.h"
+#include <GLES2/gl2ext.h>  // GL_UNPACK_ROW_LENGTH_EXT (== GLES3 GL_UNPACK_ROW_LENGTH)
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/// Плоскость раскладки: делитель размера, GL формат, байт на texel
+typedef struct VrYuvPlane {
+    int shift;      // 0 — полный размер, 1 — половина (chroma 4:2:0)
+    GLenum format;
+    int bpp;
+} VrYuvPlane;
+
+typedef struct VrYuvLayoutDesc {
+    const char *name;
+    int planes;
+    int bit_depth;       // 8 или 10 (для offset'ов limited range)
+    float bit_scale[2];  // texel (lo, hi) → code / (2^bit_depth - 1), 0 — 8-битная раскладка
+    VrYuvPlane plane[VR_YUV_MAX_PLANES];
+} VrYuvLayoutDesc;
+
+static const VrYuvLayoutDesc k_layouts[VR_YUV_LAYOUT_COUNT] = {
+    [VR_YUV_LAYOUT_I420] = { "i420", 3, 8, { 0.0f, 0.0f },
+        { { 0, GL_LUMINANCE, 1 }, { 1, GL_LUMINANCE, 1 }, { 1, GL_LUMINANCE, 1 } } },
+    [VR_YUV_LAYOUT_NV12] = { "nv12", 2, 8, { 0.0f, 0.0f },
+        { { 0, GL_LUMINANCE, 1 }, { 1, GL_LUMINANCE_ALPHA, 2 } } },
+    [VR_YUV_LAYOUT_NV21] = { "nv21", 2, 8, { 0.0f, 0.0f },
+        { { 0, GL_LUMINANCE, 1 }, { 1, GL_LUMINANCE_ALPHA, 2 } } },
+    // MSB-aligned: 10 бит в старших разрядах 16-битного слова → делим ещё на 64
+    [VR_YUV_LAYOUT_P010] = { "p010", 2, 10, { 255.0f / (1023.0f * 64.0f), 65280.0f / (1023.0f * 64.0f) },
+        { { 0, GL_LUMINANCE_ALPHA, 2 }, { 1, GL_RGBA, 4 } } },
+    // Сэмплы сдвигаются в старшие разряды при загрузке → тот же масштаб, что у P010
+    [VR_YUV_LAYOUT_I420_10] = { "i420p10", 3, 10, { 255.0f / (1023.0f * 64.0f), 65280.0f / (1023.0f * 64.0f) },
+        { { 0, GL_LUMINANCE_ALPHA, 2 }, { 1, GL_LUMINANCE_ALPHA, 2 }, { 1, GL_LUMINANCE_ALPHA, 2 } } },
+};
+
+// Общая часть fragment shader'ов: highp нужен 16-битным сэмплам (mediump — 11 бит мантиссы)
+#define VR_YUV_FS_PRELUDE \
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH\n" \
+    "precision highp float;\n" \
+    "#else\n" \
+    "precision mediump float;\n" \
+    "#endif\n" \
+    "varying vec2 vTexCoord;\n" \
+    "uniform mat3 uYuvMatrix;\n" \
+    "uniform vec3 uYuvOffset;\n" \
+    "\n" \
+    "vec4 yuv_to_rgba(vec3 yuv) {\n" \
+    "    vec3 rgb = uYuvMatrix * (yuv - uYuvOffset);\n" \
+    "    return vec4(clamp(rgb, 0.0, 1.0), 1.0);\n" \
+    "}\n"
+
+static const char *fragment_shader_nv12 =
+    VR_YUV_FS_PRELUDE
+    "uniform sampler2D texY;\n"
+    "uniform sampler2D texU;  // interleaved UV: U в .r, V в .a\n"
+    "\n"
+    "void main() {\n"
+    "    float y = texture2D(texY, vTexCoord).r;\n"
+    "    vec4 uv = texture2D(texU, vTexCoord);\n"
+    "    gl_FragColor = yuv_to_rgba(vec3(y, uv.r, uv.a));\n"
+    "}\n";
+
+static const char *fragment_shader_nv21 =
+    VR_YUV_FS_PRELUDE
+    "uniform sampler2D texY;\n"
+    "uniform sampler2D texU;  // interleaved VU: V в .r, U в .a\n"
+    "\n"
+    "void main() {\n"
+    "    float y = texture2D(texY, vTexCoord).r;\n"
+    "    vec4 vu = texture2D(texU, vTexCoord);\n"
+    "    gl_FragColor = yuv_to_rgba(vec3(y, vu.a, vu.r));\n"
+    "}\n";
+
+// lo / hi байты фильтруются линейно по отдельности: lerp(lo) + 256 * lerp(hi) == lerp(lo + 256 * hi).
+// GPU может округлить результат фильтрации до 8 бит на канал, поэтому значение MSB-aligned:
+// ошибка hi канала тогда не больше половины 8-битного шага
+static const char *fragment_shader_p010 =
+    VR_YUV_FS_PRELUDE
+    "uniform sampler2D texY;  // (lo, hi) в .r / .a\n"
+    "uniform sampler2D texU;  // U lo, U hi, V lo, V hi\n"
+    "uniform vec2 uBitScale;\n"
+    "\n"
+    "void main() {\n"
+    "    float y = dot(texture2D(texY, vTexCoord).ra, uBitScale);\n"
+    "    vec4 uv = texture2D(texU, vTexCoord);\n"
+    "    gl_FragColor = yuv_to_rgba(vec3(y, dot(uv.rg, uBitScale), dot(uv.ba, uBitScale)));\n"
+    "}\n";
+
+static const char *fragment_shader_i420_10 =
+    VR_YUV_FS_PRELUDE
+    "uniform sampler2D texY;  // (lo, hi) в .r / .a\n"
+    "uniform sampler2D texU;\n"
+    "uniform sampler2D texV;\n"
+    "uniform vec2 uBitScale;\n"
+    "\n"
+    "void main() {\n"
+    "    float y = dot(texture2D(texY, vTexCoord).ra, uBitScale);\n"
+    "    float u = dot(texture2D(texU, vTexCoord).ra, uBitScale);\n"
+    "    float v = dot(texture2D(texV, vTexCoord).ra, uBitScale);\n"
+    "    gl_FragColor = yuv_to_rgba(vec3(y, u, v));\n"
+    "}\n";
+
+VrYuvLayout vr_yuv_layout_for_format(int pix_fmt) {
+    switch (pix_fmt) {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        return VR_YUV_LAYOUT_I420;
+    case AV_PIX_FMT_NV12:
+        return VR_YUV_LAYOUT_NV12;
+    case AV_PIX_FMT_NV21:
+        return VR_YUV_LAYOUT_NV21;
+    case AV_PIX_FMT_P010LE:
+        return VR_YUV_LAYOUT_P010;
+    case AV_PIX_FMT_YUV420P10LE:
+        return VR_YUV_LAYOUT_I420_10;
+    default:
+        return VR_YUV_LAYOUT_NONE;
+    }
+}
+
+const char *vr_yuv_layout_name(VrYuvLayout layout) {
+    if (layout < 0 || layout >= VR_YUV_LAYOUT_COUNT) {
+        return "none";
+    }
+    return k_layouts[layout].name;
+}
+
+int vr_yuv_layout_planes(VrYuvLayout layout) {
+    if (layout < 0 || layout >= VR_YUV_LAYOUT_COUNT) {
+        return 0;
+    }
+    return k_layouts[layout].planes;
+}
+
+const char *vr_yuv_fragment_source(VrYuvLayout layout) {
+    switch (layout) {
+    case VR_YUV_LAYOUT_NV12:
+        return fragment_shader_nv12;
+    case VR_YUV_LAYOUT_NV21:
+        return fragment_shader_nv21;
+    case VR_YUV_LAYOUT_P010:
+        return fragment_shader_p010;
+    case VR_YUV_LAYOUT_I420_10:
+        return fragment_shader_i420_10;
+    default:
+        return NULL;
+    }
+}
+
+void vr_yuv_program_init(VrYuvProgram *p, GLuint program) {
+    p->program = program;
+    p->tex[0] = glGetUniformLocation(program, "texY");
+    p->tex[1] = glGetUniformLocation(program, "texU");
+    p->tex[2] = glGetUniformLocation(program, "texV");
+    p->u_scale_x = glGetUniformLocation(program, "uScaleX");
+    p->u_scale_y = glGetUniformLocation(program, "uScaleY");
+    p->u_yuv_matrix = glGetUniformLocation(program, "uYuvMatrix");
+    p->u_yuv_offset = glGetUniformLocation(program, "uYuvOffset");
+    p->u_bit_scale = glGetUniformLocation(program, "uBitScale");
+    p->a_position = glGetAttribLocation(program, "aPosition");
+    p->a_tex_coord = glGetAttribLocation(program, "aTexCoord");
+}
+
+/// YUV → RGB: column-major mat3 (для glUniformMatrix3fv) и offset'ы под разрядность
+static void yuv_matrix(int colorspace_index, int full_range, int bit_depth, float m[9], float offset[3]) {
+    float kr, kb;
+    switch (colorspace_index) {
+    case 0:  kr = 0.299f;  kb = 0.114f;  break;  // BT.601
+    case 2:  kr = 0.2627f; kb = 0.0593f; break;  // BT.2020
+    default: kr = 0.2126f; kb = 0.0722f; break;  // BT.709
+    }
+    float kg = 1.0f - kr - kb;
+    float max = (float)((1 << bit_depth) - 1);
+    float unit = (float)(1 << (bit_depth - 8));  // 1 для 8 бит, 4 для 10
+
+    float ys = full_range ? 1.0f : max / (219.0f * unit);
+    float cs = full_range ? 1.0f : max / (224.0f * unit);
+    offset[0] = full_range ? 0.0f : 16.0f * unit / max;
+    offset[1] = 128.0f * unit / max;
+    offset[2] = offset[1];
+
+    // Столбец Y
+    m[0] = ys;
+    m[1] = ys;
+    m[2] = ys;
+    // Столбец U
+    m[3] = 0.0f;
+    m[4] = -cs * 2.0f * kb * (1.0f - kb) / kg;
+    m[5] = cs * 2.0f * (1.0f - kb);
+    // Столбец V
+    m[6] = cs * 2.0f * (1.0f - kr);
+    m[7] = -cs * 2.0f * kr * (1.0f - kr) / kg;
+    m[8] = 0.0f;
+}
+
+void vr_yuv_program_use(const VrYuvProgram *p, VrYuvLayout layout, const GLuint *tex,
+                        float scale_x, float scale_y, int colorspace_index, int full_range) {
+    const VrYuvLayoutDesc *desc = &k_layouts[layout];
+    glUseProgram(p->program);
+
+    for (int i = 0; i < desc->planes; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, tex[i]);
+        if (p->tex[i] >= 0) {
+            glUniform1i(p->tex[i], i);
+        }
+    }
+
+    if (p->u_scale_x >= 0 && p->u_scale_y >= 0) {
+        glUniform1f(p->u_scale_x, scale_x);
+        glUniform1f(p->u_scale_y, scale_y);
+    }
+    if (p->u_yuv_matrix >= 0) {
+        float m[9];
+        float offset[3];
+        yuv_matrix(colorspace_index, full_range, desc->bit_depth, m, offset);
+        glUniformMatrix3fv(p->u_yuv_matrix, 1, GL_FALSE, m);
+        glUniform3fv(p->u_yuv_offset, 1, offset);
+    }
+    if (p->u_bit_scale >= 0) {
+        glUniform2fv(p->u_bit_scale, 1, desc->bit_scale);
+    }
+}
+
+void vr_yuv_uploader_init(VrYuvUploader *u) {
+    memset(u, 0, sizeof(*u));
+
+    // GLES3 (контекст, запрошенный как ES 2, драйвер вправе поднять до 3.x) или GL_EXT_unpack_subimage
+    const char *version = (const char *)glGetString(GL_VERSION);
+    const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+    int major = 0;
+    if (version && sscanf(version, "OpenGL ES %d", &major) == 1 && major >= 3) {
+        u->row_length = true;
+    } else if (extensions && strstr(extensions, "GL_EXT_unpack_subimage")) {
+        u->row_length = true;
+    }
+}
+
+void vr_yuv_uploader_free(VrYuvUploader *u) {
+    if (!u) {
+        return;
+    }
+    av_freep(&u->staging);
+    u->staging_size = 0;
+}
+
+/// Staging растёт только вверх: после первого кадра аллокаций нет
+static int staging_reserve(VrYuvUploader *u, size_t size) {
+    if (u->staging_size >= size) {
+        return 0;
+    }
+    uint8_t *data = av_realloc(u->staging, size);
+    if (!data) {
+        return -1;
+    }
+    u->staging = data;
+    u->staging_size = size;
+    return 0;
+}
+
+void vr_yuv_pack_plane(uint8_t *dst, const uint8_t *src, ptrdiff_t src_stride, int row_bytes, int rows) {
+    for (int y = 0; y < rows; y++, src += src_stride, dst += row_bytes) {
+        int x = 0;
+#if defined(__ARM_NEON)
+        for (; x + 64 <= row_bytes; x += 64) {
+            uint8x16_t a = vld1q_u8(src + x);
+            uint8x16_t b = vld1q_u8(src + x + 16);
+            uint8x16_t c = vld1q_u8(src + x + 32);
+            uint8x16_t d = vld1q_u8(src + x + 48);
+            vst1q_u8(dst + x, a);
+            vst1q_u8(dst + x + 16, b);
+            vst1q_u8(dst + x + 32, c);
+            vst1q_u8(dst + x + 48, d);
+        }
+        for (; x + 16 <= row_bytes; x += 16) {
+            vst1q_u8(dst + x, vld1q_u8(src + x));
+        }
+#elif defined(__SSE2__)
+        for (; x + 64 <= row_bytes; x += 64) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(src + x));
+            __m128i b = _mm_loadu_si128((const __m128i *)(src + x + 16));
+            __m128i c = _mm_loadu_si128((const __m128i *)(src + x + 32));
+            __m128i d = _mm_loadu_si128((const __m128i *)(src + x + 48));
+            _mm_storeu_si128((__m128i *)(dst + x), a);
+            _mm_storeu_si128((__m128i *)(dst + x + 16), b);
+            _mm_storeu_si128((__m128i *)(dst + x + 32), c);
+            _mm_storeu_si128((__m128i *)(dst + x + 48), d);
+        }
+        for (; x + 16 <= row_bytes; x += 16) {
+            _mm_storeu_si128((__m128i *)(dst + x), _mm_loadu_si128((const __m128i *)(src + x)));
+        }
+#endif
+        if (x < row_bytes) {
+            memcpy(dst + x, src + x, row_bytes - x);
+        }
+    }
+}
+
+void vr_yuv_pack_plane_msb10(uint8_t *dst, const uint8_t *src, ptrdiff_t src_stride, int samples, int rows) {
+    for (int y = 0; y < rows; y++, src += src_stride, dst += (size_t)samples * 2) {
+        const uint16_t *s = (const uint16_t *)src;
+        uint16_t *d = (uint16_t *)dst;
+        int x = 0;
+#if defined(__ARM_NEON)
+        for (; x + 16 <= samples; x += 16) {
+            vst1q_u16(d + x, vshlq_n_u16(vld1q_u16(s + x), 6));
+            vst1q_u16(d + x + 8, vshlq_n_u16(vld1q_u16(s + x + 8), 6));
+        }
+#elif defined(__SSE2__)
+        for (; x + 16 <= samples; x += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(s + x));
+            __m128i b = _mm_loadu_si128((const __m128i *)(s + x + 8));
+            _mm_storeu_si128((__m128i *)(d + x), _mm_slli_epi16(a, 6));
+            _mm_storeu_si128((__m128i *)(d + x + 8), _mm_slli_epi16(b, 6));
+        }
+#endif
+        for (; x < samples; x++) {
+            d[x] = (uint16_t)(s[x] << 6);
+        }
+    }
+}
+
+int vr_yuv_plane_size(VrYuvLayout layout, int plane, int width, int height, VrYuvPlaneSize *out) {
+    if (layout < 0 || layout >= VR_YUV_LAYOUT_COUNT || plane < 0 || plane >= k_layouts[layout].planes || !out) {
+        return -1;
+    }
+    const VrYuvPlane *p = &k_layouts[layout].plane[plane];
+    out->width = (width + p->shift) >> p->shift;
+    out->height = (height + p->shift) >> p->shift;
+    out->row_bytes = out->width * p->bpp;
+    out->bpp = p->bpp;
+    out->format = p->format;
+    return 0;
+}
+
+void vr_yuv_pack_frame_plane(VrYuvLayout layout, int plane, uint8_t *dst, const AVFrame *frame,
+                             const VrYuvPlaneSize *size) {
+    if (layout == VR_YUV_LAYOUT_I420_10) {
+        vr_yuv_pack_plane_msb10(dst, frame->data[plane], frame->linesize[plane], size->width, size->height);
+    } else {
+        vr_yuv_pack_plane(dst, frame->data[plane], frame->linesize[plane], size->row_bytes, size->height);
+    }
+}
+
+int vr_yuv_upload_frame(VrYuvUploader *u, VrYuvLayout layout, const GLuint *tex, const AVFrame *frame,
+                        int width, int height, bool allocate) {
+    if (!u || layout < 0 || layout >= VR_YUV_LAYOUT_COUNT || !frame) {
+        return -1;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < k_layouts[layout].planes; i++) {
+        VrYuvPlaneSize size;
+        vr_yuv_plane_size(layout, i, width, height, &size);
+        int linesize = frame->linesize[i];
+        const uint8_t *pixels = frame->data[i];
+
+        glBindTexture(GL_TEXTURE_2D, tex[i]);
+        if (allocate) {
+            glTexImage2D(GL_TEXTURE_2D, 0, size.format, size.width, size.height, 0, size.format,
+                         GL_UNSIGNED_BYTE, NULL);
+        }
+
+        if (layout != VR_YUV_LAYOUT_I420_10 && linesize == size.row_bytes) {
+            u->stats.direct_planes++;
+        } else if (layout != VR_YUV_LAYOUT_I420_10 && u->row_length && linesize > 0 && linesize % size.bpp == 0) {
+            // Драйвер сам пропускает padding: без копии на CPU
+            glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, linesize / size.bpp);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.width, size.height, size.format, GL_UNSIGNED_BYTE, pixels);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0);
+            u->stats.row_length_planes++;
+            continue;
+        } else {
+            // GLES2 с padding'ом или YUV420P10 (сдвиг в старшие разряды): упаковка в persistent staging,
+            // один glTexSubImage2D на плоскость
+            if (staging_reserve(u, (size_t)size.row_bytes * size.height) < 0) {
+                return -1;
+            }
+            vr_yuv_pack_frame_plane(layout, i, u->staging, frame, &size);
+            pixels = u->staging;
+            u->stats.staged_planes++;
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.width, size.height, size.format, GL_UNSIGNED_BYTE, pixels);
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+/// 🔥 VIDEO RENDER YUV: GPU-пути для semi-planar и 10-bit кадров
+///
+/// video_render_gl рисовал только AV_PIX_FMT_YUV420P: 10-bit HEVC, NV12
+/// из hwaccel-декодеров и часть MKV отбрасывались ("Unsupported pixel format")
+/// или требовали бы CPU-конвертации через swscale.
+///
+/// Здесь — раскладка плоскостей по текстурам, fragment shader'ы и загрузка
+/// для каждого формата. Цвет конвертируется на GPU матрицей (BT.601 / 709 /
+/// 2020, limited / full), 16-битные сэмплы раскладываются в 8-битные каналы
+/// (lo / hi байт) и собираются в shader'е — работает на чистом GLES2 без
+/// расширений. 10 бит должны лежать в старших разрядах (как в P010): GPU
+/// вправе округлить результат фильтрации 8-битного канала, и основную часть
+/// значения должен нести hi байт. YUV420P10 (младшие разряды) сдвигается
+/// при загрузке (vr_yuv_pack_plane_msb10).
+///
+/// Зависит только от GLES2 и libavutil, поэтому проверяется на host без
+/// устройства (Mesa llvmpipe, EGL surfaceless — bench/bench_gl_yuv.c).
+///
+/// Программы компилирует вызывающий (один раз при init), выбор — по формату кадра.
+
+#ifndef VIDEO_RENDER_YUV_H
+#define VIDEO_RENDER_YUV_H
+
+#include <GLES2/gl2.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct AVFrame;
+
+/// Раскладка кадра по текстурам
+typedef enum VrYuvLayout {
+    VR_YUV_LAYOUT_NONE = -1,
+    VR_YUV_LAYOUT_I420 = 0,   // YUV420P / YUVJ420P: Y, U, V — GL_LUMINANCE (эталонный shader video_render_gl)
+    VR_YUV_LAYOUT_NV12,       // Y — GL_LUMINANCE, UV — GL_LUMINANCE_ALPHA (U в .r, V в .a)
+    VR_YUV_LAYOUT_NV21,       // Как NV12, VU вместо UV
+    VR_YUV_LAYOUT_P010,       // Y — GL_LUMINANCE_ALPHA (lo, hi), UV — GL_RGBA (U lo, U hi, V lo, V hi)
+    VR_YUV_LAYOUT_I420_10,    // YUV420P10LE: Y, U, V — GL_LUMINANCE_ALPHA (lo, hi), сдвиг в старшие разряды при загрузке
+    VR_YUV_LAYOUT_COUNT
+} VrYuvLayout;
+
+/// Максимум текстур на кадр
+#define VR_YUV_MAX_PLANES 3
+
+/// Геометрия плоскости раскладки для кадра width x height
+typedef struct VrYuvPlaneSize {
+    int width;       // texel'ей
+    int height;
+    int row_bytes;   // плотная строка (без padding'а)
+    int bpp;         // байт на texel
+    GLenum format;   // GL_LUMINANCE / GL_LUMINANCE_ALPHA / GL_RGBA
+} VrYuvPlaneSize;
+
+/// Счётчики загрузки плоскостей (с момента vr_yuv_uploader_init)
+typedef struct VrYuvUploadStats {
+    int64_t direct_planes;      // linesize == ширине строки: один glTexSubImage2D из кадра
+    int64_t row_length_planes;  // padding пропускает драйвер (GL_UNPACK_ROW_LENGTH)
+    int64_t staged_planes;      // упаковка в staging (GLES2 с padding'ом, YUV420P10)
+} VrYuvUploadStats;
+
+/// Состояние загрузки кадров: один на GL context, используется только из render thread
+///
+/// Декодеры выравнивают linesize (padding справа), а GLES2 не умеет
+/// GL_UNPACK_ROW_LENGTH. Вместо malloc + memcpy на каждую плоскость каждого
+/// кадра: на GLES3 (или с GL_EXT_unpack_subimage) stride отдаётся драйверу,
+/// на GLES2 плоскость упаковывается SIMD-ядром в persistent staging буфер.
+typedef struct VrYuvUploader {
+    bool row_length;           // GL_UNPACK_ROW_LENGTH доступен
+    uint8_t *staging;          // Растёт до размера наибольшей плоскости, не сжимается
+    size_t staging_size;
+    VrYuvUploadStats stats;
+} VrYuvUploader;
+
+/// Программа одного формата с кешированными locations
+typedef struct VrYuvProgram {
+    GLuint program;
+    GLint tex[VR_YUV_MAX_PLANES];  // texY, texU, texV (для semi-planar texU — interleaved chroma)
+    GLint u_scale_x;
+    GLint u_scale_y;
+    GLint u_yuv_matrix;            // mat3, -1 у эталонного I420 shader'а
+    GLint u_yuv_offset;            // vec3
+    GLint u_bit_scale;             // vec2, только 16-битные раскладки
+    GLint a_position;
+    GLint a_tex_coord;
+} VrYuvProgram;
+
+/// Раскладка для AVPixelFormat кадра
+///
+/// @return VR_YUV_LAYOUT_NONE, если формат не поддерживается
+VrYuvLayout vr_yuv_layout_for_format(int pix_fmt);
+
+/// Имя раскладки для логов
+const char *vr_yuv_layout_name(VrYuvLayout layout);
+
+/// Количество текстур раскладки (2 или 3)
+int vr_yuv_layout_planes(VrYuvLayout layout);
+
+/// Fragment shader раскладки (sampler'ы texY / texU / texV, varying vTexCoord)
+///
+/// @return NULL для VR_YUV_LAYOUT_I420 — его рисует эталонный shader video_render_gl
+const char *vr_yuv_fragment_source(VrYuvLayout layout);
+
+/// Закешировать locations слинкованной программы
+void vr_yuv_program_init(VrYuvProgram *p, GLuint program);
+
+/// glUseProgram + текстуры на units 0..planes-1 + scale + цветовая матрица
+///
+/// @param colorspace_index 0=BT.601, 1=BT.709, 2=BT.2020 (video_color_info_get_colorspace_index)
+/// @param full_range 1=FULL (JPEG), 0=LIMITED
+void vr_yuv_program_use(const VrYuvProgram *p, VrYuvLayout layout, const GLuint *tex,
+                        float scale_x, float scale_y, int colorspace_index, int full_range);
+
+/// Геометрия плоскости plane раскладки layout
+///
+/// @return 0, -1 если у раскладки нет такой плоскости
+int vr_yuv_plane_size(VrYuvLayout layout, int plane, int width, int height, VrYuvPlaneSize *out);
+
+/// Упаковать плоскость кадра в плотный dst (size->row_bytes * size->height байт)
+///
+/// Для YUV420P10 — со сдвигом в старшие разряды. dst может быть mapped PBO.
+void vr_yuv_pack_frame_plane(VrYuvLayout layout, int plane, uint8_t *dst, const struct AVFrame *frame,
+                             const VrYuvPlaneSize *size);
+
+/// Определить возможности загрузки текущего GL context'а (context должен быть current)
+void vr_yuv_uploader_init(VrYuvUploader *u);
+
+/// Освободить staging буфер (GL context не нужен)
+void vr_yuv_uploader_free(VrYuvUploader *u);
+
+/// Загрузить плоскости кадра в текстуры раскладки
+///
+/// Без аллокаций после первого кадра данного размера.
+/// @param tex VR_YUV_MAX_PLANES текстур (лишние не трогаются)
+/// @param allocate Переразместить текстуры (glTexImage2D) — при смене размера или раскладки
+/// @return 0, -1 если не удалось выделить staging
+int vr_yuv_upload_frame(VrYuvUploader *u, VrYuvLayout layout, const GLuint *tex, const struct AVFrame *frame,
+                        int width, int height, bool allocate);
+
+/// Скопировать rows строк по row_bytes из src с шагом src_stride в плотный dst (NEON / SSE2)
+void vr_yuv_pack_plane(uint8_t *dst, const uint8_t *src, ptrdiff_t src_stride, int row_bytes, int rows);
+
+/// То же для 10 бит в младших разрядах 16-битного слова: сдвиг в старшие (YUV420P10LE → как P010)
+void vr_yuv_pack_plane_msb10(uint8_t *dst, const uint8_t *src, ptrdiff_t src_stride, int samples, int rows);
+
+#endif // VIDEO_RENDER_YUV_H
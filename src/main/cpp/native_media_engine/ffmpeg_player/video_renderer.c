@@ -9,7 +9,8 @@
 #include <string.h>
 #include <stdatomic.h>
 #include <pthread.h>
-#include <android/log.h>
+#include <unistd.h>  // sysconf(_SC_NPROCESSORS_ONLN)
+#include "platform_log.h"
 
 #define LOG_TAG "VideoRenderer"
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
@@ -240,12 +241,76 @@ double video_get_clock(VideoState *vs) {
     return vs->clock.pts_sec;
 }
 
+int video_decode_thread_count(const VideoDecodeThreadPolicy *policy, int width, int height) {
+    int count = policy ? policy->thread_count : 0;
+    
+    if (count <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cpus < 1) {
+            cpus = 1;
+        }
+        
+        // Маленьким кадрам много потоков не нужно: синхронизация съедает выигрыш,
+        // а ядра нужны demux / audio / render. 4K HEVC получает все ядра.
+        int64_t pixels = (int64_t)width * height;
+        int cap = (int)cpus;
+        if (pixels <= 640 * 480) {
+            cap = 2;
+        } else if (pixels <= 1920 * 1088) {
+            cap = 4;
+        }
+        count = (int)cpus < cap ? (int)cpus : cap;
+    }
+    
+    if (count > VIDEO_DECODE_MAX_THREADS) {
+        count = VIDEO_DECODE_MAX_THREADS;
+    }
+    return count < 1 ? 1 : count;
+}
+
+/// Применить политику потоков к codec context (до avcodec_open2)
+static void video_decoder_apply_thread_policy(AVCodecContext *avctx, const AVCodec *codec,
+                                              const VideoDecodeThreadPolicy *policy) {
+    VideoDecodeThreadMode mode = policy ? policy->mode : VIDEO_DECODE_THREADS_AUTO;
+    bool has_frame = (codec->capabilities & AV_CODEC_CAP_FRAME_THREADS) != 0;
+    bool has_slice = (codec->capabilities & AV_CODEC_CAP_SLICE_THREADS) != 0;
+    
+    int thread_type = 0;
+    switch (mode) {
+        case VIDEO_DECODE_THREADS_FRAME:
+            thread_type = has_frame ? FF_THREAD_FRAME : FF_THREAD_SLICE;
+            break;
+        case VIDEO_DECODE_THREADS_SLICE:
+            thread_type = FF_THREAD_SLICE;
+            break;
+        case VIDEO_DECODE_THREADS_LOW_LATENCY:
+            // Frame threading держит N-1 кадров внутри декодера → шаг назад/вперёд
+            // и первый кадр после seek ждут заполнения конвейера
+            thread_type = FF_THREAD_SLICE;
+            avctx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+            break;
+        case VIDEO_DECODE_THREADS_AUTO:
+        default:
+            thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;  // FFmpeg выберет frame, если кодек умеет
+            break;
+    }
+    
+    if (!has_frame && !has_slice) {
+        avctx->thread_count = 1;  // кодек однопоточный — не плодим пустые потоки
+        return;
+    }
+    
+    avctx->thread_count = video_decode_thread_count(policy, avctx->width, avctx->height);
+    avctx->thread_type = thread_type;
+}
+
 /// Инициализировать видео декодер
 ///
 /// @param vs Состояние видео
 /// @param stream Видео стрим из AVFormatContext
+/// @param policy Политика потоков декодера (NULL = auto)
 /// @return 0 при успехе, <0 при ошибке
-int video_decoder_init(VideoState *vs, AVStream *stream) {
+int video_decoder_init(VideoState *vs, AVStream *stream, const VideoDecodeThreadPolicy *policy) {
     if (!vs || !stream) {
         ALOGE("❌ video_decoder_init: Invalid parameters");
         return -1;
@@ -274,6 +339,9 @@ int video_decoder_init(VideoState *vs, AVStream *stream) {
         return -1;
     }
     
+    // 🔥 Многопоточный software decode: без thread_count FFmpeg не использует все ядра
+    video_decoder_apply_thread_policy(vs->codecCtx, codec, policy);
+    
     // Открываем декодер
     if (avcodec_open2(vs->codecCtx, codec, NULL) < 0) {
         ALOGE("❌ video_decoder_init: Failed to open video decoder");
@@ -281,8 +349,11 @@ int video_decoder_init(VideoState *vs, AVStream *stream) {
         return -1;
     }
     
-    ALOGI("✅ Video decoder opened: width=%d, height=%d, format=%d",
-          vs->codecCtx->width, vs->codecCtx->height, vs->codecCtx->pix_fmt);
+    ALOGI("✅ Video decoder opened: width=%d, height=%d, format=%d, threads=%d (%s)",
+          vs->codecCtx->width, vs->codecCtx->height, vs->codecCtx->pix_fmt,
+          vs->codecCtx->thread_count,
+          (vs->codecCtx->active_thread_type & FF_THREAD_FRAME) ? "frame" :
+          (vs->codecCtx->active_thread_type & FF_THREAD_SLICE) ? "slice" : "none");
     
     return 0;
 }
@@ -303,6 +374,84 @@ void video_decoder_destroy(VideoState *vs) {
     ALOGI("✅ Video decoder destroyed");
 }
 
+/// Забрать из декодера все готовые кадры и положить их в FrameQueue
+///
+/// @param decoder_serial Эпоха пакетов, находящихся в декодере
+static void video_decoder_receive_frames(VideoState *vs, AVFrame *frame, int decoder_serial) {
+    int ret;
+    
+    while (!vs->abort) {
+        ret = avcodec_receive_frame(vs->codecCtx, frame);
+        
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+            break;
+        }
+        
+        if (ret < 0) {
+            ALOGW("⚠️ video_decode_thread: Decode error %d", ret);
+            break;
+        }
+        
+        vs->frames_decoded++;
+        
+        // 🔎 DIAGNOSTIC: Log frame decoded
+        double pts_sec = NAN;
+        if (vs->video_stream && vs->video_stream->time_base.num > 0 && vs->video_stream->time_base.den > 0) {
+            if (frame->pts != AV_NOPTS_VALUE) {
+                pts_sec = frame->pts * av_q2d(vs->video_stream->time_base);
+            } else if (frame->best_effort_timestamp != AV_NOPTS_VALUE) {
+                pts_sec = frame->best_effort_timestamp * av_q2d(vs->video_stream->time_base);
+            }
+        }
+        ALOGI("🖼 VideoDecoder: frame decoded pts=%.3f size=%dx%d format=%d",
+              pts_sec,
+              frame->width,
+              frame->height,
+              frame->format);
+        
+        // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 10.5: Передаём serial эпохи
+        // Кадр относится к эпохе пакетов в декодере, а не к текущему seek_serial:
+        // кадр из старого пакета, пойманный во время seek, уйдёт со старым serial
+        int current_serial = decoder_serial;
+        
+        // Вычисляем PTS в секундах
+        double frame_pts = pts_sec;
+        if (isnan(frame_pts) && vs->video_stream) {
+            // Fallback на best_effort_timestamp или frame_index
+            if (frame->best_effort_timestamp != AV_NOPTS_VALUE) {
+                frame_pts = frame->best_effort_timestamp * av_q2d(vs->video_stream->time_base);
+            } else {
+                // Используем frame_index как fallback
+                double fps = 25.0; // fallback FPS
+                if (vs->video_stream->avg_frame_rate.num > 0 && vs->video_stream->avg_frame_rate.den > 0) {
+                    fps = av_q2d(vs->video_stream->avg_frame_rate);
+                }
+                frame_pts = vs->frame_index / fps;
+                vs->frame_index++;
+            }
+        }
+        
+        // Добавляем кадр в очередь (клонируется внутри frame_queue_push)
+        // frame_queue_push принимает ownership кадра и клонирует его
+        if (frame_queue_push(vs->frameQueue, frame, frame_pts, current_serial) < 0) {
+            continue;
+        }
+        
+        // 🔥 КРИТИЧЕСКИЙ FIX: Сохраняем первый кадр для гарантированного рендера
+        // Это критично для AVI и коротких файлов - первый кадр может быть потерян
+        if (!vs->first_frame_ready) {
+            if (vs->first_frame) {
+                av_frame_free(&vs->first_frame);
+            }
+            vs->first_frame = av_frame_clone(frame);
+            if (vs->first_frame) {
+                vs->first_frame_ready = 1;
+                ALOGI("✅ video_decode_thread: First frame buffered (safety-net)");
+            }
+        }
+    }
+}
+
 /// Поток декодирования видео
 ///
 /// Декодирует пакеты из PacketQueue и помещает decoded frames в FrameQueue
@@ -320,14 +469,27 @@ static void *video_decode_thread(void *arg) {
     
     PlayerContext *ctx = (PlayerContext *)vs->player_ctx;
     
+    // Эпоха, пакеты которой сейчас в декодере
+    int decoder_serial = ctx ? atomic_load(&ctx->seek_serial) : 0;
+    bool skip_to_keyframe = false;  // SCRUB: keyframe-only preview
+    
     ALOGI("🎞 Video decode loop started");
     
     while (!vs->abort) {
         // Извлекаем пакет из очереди (блокирующий)
-        int ret = packet_queue_get(vs->packetQueue, &pkt, true);
+        int pkt_serial = 0;
+        int ret = packet_queue_get(vs->packetQueue, &pkt, true, &pkt_serial);
         if (ret <= 0) {
             // EOF или abort (Шаг 22)
-            // Помечаем video как завершённый
+            // 🔥 EOF-DRAIN: на EOF (очередь закрыта demux'ом, а не video_threads_stop)
+            // выталкиваем кадры, задержанные декодером (B-frames / frame threading),
+            // иначе последние кадры файла теряются. На abort — выходим сразу
+            if (!vs->abort) {
+                avcodec_send_packet(vs->codecCtx, NULL);
+                video_decoder_receive_frames(vs, frame, decoder_serial);
+            }
+            
+            // Помечаем video как завершённый (только после drain)
             if (ctx) {
                 ctx->state.video_finished = 1;
                 // Проверяем EOF (если и audio завершился)
@@ -341,16 +503,35 @@ static void *video_decode_thread(void *arg) {
         ALOGD("🎞 VideoDecoder: got packet pts=%lld", pkt.pts);
         
         // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 10.4: Фильтрация старых эпох
-        // Если пакет из старой эпохи (serial не совпадает), дропаем его
-        // Это предотвращает декодирование старых пакетов после seek
+        // Пакет несёт serial эпохи, в которой его прочитал demux:
+        // дропаем только пакеты старой эпохи, новая декодируется сразу
         if (ctx) {
-            int current_serial = atomic_load(&ctx->seek_serial);
-            // Пакеты не имеют serial, но мы проверяем seek.in_progress
-            // Если seek в процессе, дропаем пакеты до тех пор, пока не найдём первый >= target
-            if (ctx->seek.in_progress && ctx->seek.drop_video) {
+            if (pkt_serial != atomic_load(&ctx->seek_serial)) {
                 av_packet_unref(&pkt);
                 continue;  // Дропаем пакет из старой эпохи
             }
+            
+            if (pkt_serial != decoder_serial) {
+                // Первый пакет новой эпохи: сбрасываем декодер в СВОЁМ потоке
+                avcodec_flush_buffers(vs->codecCtx);
+                decoder_serial = pkt_serial;
+                ctx->seek.drop_video = false;
+                ALOGI("🔍 SEEK: video decoder entered serial=%d", pkt_serial);
+            }
+            
+            // 🔥 SCRUB: keyframe-only preview — non-key пакеты не декодируем.
+            // После пропуска ждём следующий keyframe даже если scrub уже закончился,
+            // иначе декодер получит P/B кадры без референсов
+            if (player_scrub_keyframe_preview(ctx)) {
+                skip_to_keyframe = true;
+            }
+            if (skip_to_keyframe) {
+                if (!(pkt.flags & AV_PKT_FLAG_KEY)) {
+                    av_packet_unref(&pkt);
+                    continue;
+                }
+                skip_to_keyframe = player_scrub_keyframe_preview(ctx);
+            }
         }
         
         // Отправляем пакет в декодер
@@ -360,78 +541,10 @@ static void *video_decode_thread(void *arg) {
         }
         
         av_packet_unref(&pkt);
+        vs->packets_decoded++;
         
         // Получаем декодированные кадры
-        while (!vs->abort) {
-            ret = avcodec_receive_frame(vs->codecCtx, frame);
-            
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-                break;
-            }
-            
-            if (ret < 0) {
-                ALOGW("⚠️ video_decode_thread: Decode error %d", ret);
-                break;
-            }
-            
-            // 🔎 DIAGNOSTIC: Log frame decoded
-            double pts_sec = NAN;
-            if (vs->video_stream && vs->video_stream->time_base.num > 0 && vs->video_stream->time_base.den > 0) {
-                if (frame->pts != AV_NOPTS_VALUE) {
-                    pts_sec = frame->pts * av_q2d(vs->video_stream->time_base);
-                } else if (frame->best_effort_timestamp != AV_NOPTS_VALUE) {
-                    pts_sec = frame->best_effort_timestamp * av_q2d(vs->video_stream->time_base);
-                }
-            }
-            ALOGI("🖼 VideoDecoder: frame decoded pts=%.3f size=%dx%d format=%d",
-                  pts_sec,
-                  frame->width,
-                  frame->height,
-                  frame->format);
-            
-            // 🔥 КРИТИЧЕСКИЙ FIX: SEEK + AVSYNC PATCH - ШАГ 10.5: Передаём serial эпохи
-            // Получаем текущий seek_serial из PlayerContext
-            int current_serial = 0;
-            if (ctx) {
-                current_serial = atomic_load(&ctx->seek_serial);
-            }
-            
-            // Вычисляем PTS в секундах
-            double frame_pts = pts_sec;
-            if (isnan(frame_pts) && vs->video_stream) {
-                // Fallback на best_effort_timestamp или frame_index
-                if (frame->best_effort_timestamp != AV_NOPTS_VALUE) {
-                    frame_pts = frame->best_effort_timestamp * av_q2d(vs->video_stream->time_base);
-                } else {
-                    // Используем frame_index как fallback
-                    double fps = 25.0; // fallback FPS
-                    if (vs->video_stream->avg_frame_rate.num > 0 && vs->video_stream->avg_frame_rate.den > 0) {
-                        fps = av_q2d(vs->video_stream->avg_frame_rate);
-                    }
-                    frame_pts = vs->frame_index / fps;
-                    vs->frame_index++;
-                }
-            }
-            
-            // Добавляем кадр в очередь (клонируется внутри frame_queue_push)
-            // frame_queue_push принимает ownership кадра и клонирует его
-            if (frame_queue_push(vs->frameQueue, frame, frame_pts, current_serial) < 0) {
-                continue;
-            }
-            
-            // 🔥 КРИТИЧЕСКИЙ FIX: Сохраняем первый кадр для гарантированного рендера
-            // Это критично для AVI и коротких файлов - первый кадр может быть потерян
-            if (!vs->first_frame_ready) {
-                if (vs->first_frame) {
-                    av_frame_free(&vs->first_frame);
-                }
-                vs->first_frame = av_frame_clone(frame);
-                if (vs->first_frame) {
-                    vs->first_frame_ready = 1;
-                    ALOGI("✅ video_decode_thread: First frame buffered (safety-net)");
-                }
-            }
-        }
+        video_decoder_receive_frames(vs, frame, decoder_serial);
     }
     
     av_frame_free(&frame);
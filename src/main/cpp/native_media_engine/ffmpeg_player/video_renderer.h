@@ -93,6 +93,23 @@ typedef struct {
 /// @return 0 при успехе, <0 при ошибке
 int video_handle_mediacodec_frame(struct VideoState *vs, AVFrame *frame);
 
+/// Режим многопоточного software-декодирования (video_decoder_init)
+typedef enum {
+    VIDEO_DECODE_THREADS_AUTO = 0,     // frame + slice (что поддерживает кодек), число по CPU и разрешению
+    VIDEO_DECODE_THREADS_FRAME = 1,    // frame threading: максимум throughput, задержка +N-1 кадров
+    VIDEO_DECODE_THREADS_SLICE = 2,    // slice threading: без доп. задержки, выигрыш зависит от числа slice'ов
+    VIDEO_DECODE_THREADS_LOW_LATENCY = 3  // slice + AV_CODEC_FLAG_LOW_DELAY: покадровый шаг / scrub
+} VideoDecodeThreadMode;
+
+/// Политика потоков декодера
+typedef struct {
+    VideoDecodeThreadMode mode;
+    int thread_count;  // 0 = auto (online CPU + разрешение), иначе явное значение
+} VideoDecodeThreadPolicy;
+
+/// Максимум потоков декодера (больше FFmpeg не выигрывает на мобильных SoC)
+#define VIDEO_DECODE_MAX_THREADS 16
+
 /// Состояние видео декодера и рендерера
 ///
 /// Управляет:
@@ -242,14 +259,28 @@ typedef struct {
     AVFrame *first_frame;  // Буферизованный первый кадр
     int first_frame_ready;  // Флаг, что первый кадр сохранён
     int first_frame_rendered;  // Флаг, что первый кадр отрисован
+    
+    /// Счётчики decode thread (bench_decode, диагностика)
+    /// Пишутся только decode thread, читаются снаружи без блокировки
+    int64_t packets_decoded;  // Пакетов отправлено в avcodec_send_packet
+    int64_t frames_decoded;   // Кадров получено из avcodec_receive_frame
 } VideoState;
 
 /// Инициализировать видео декодер
 ///
 /// @param vs Состояние видео
 /// @param stream Видео стрим из AVFormatContext
+/// @param policy Политика потоков декодера (NULL = VIDEO_DECODE_THREADS_AUTO)
 /// @return 0 при успехе, <0 при ошибке
-int video_decoder_init(VideoState *vs, AVStream *stream);
+int video_decoder_init(VideoState *vs, AVStream *stream, const VideoDecodeThreadPolicy *policy);
+
+/// Число потоков декодера для политики (auto: online CPU + разрешение)
+///
+/// @param policy Политика (NULL = auto)
+/// @param width Ширина кадра
+/// @param height Высота кадра
+/// @return Число потоков, 1..VIDEO_DECODE_MAX_THREADS
+int video_decode_thread_count(const VideoDecodeThreadPolicy *policy, int width, int height);
 
 /// Инициализировать SwsContext для конвертации пикселей
 ///
@@ -1,278 +1,250 @@
-/// ШАГ 1-4: VSync-driven video scheduler с frame interpolation
-///
-/// ШАГ 1: VSync-aligned frame scheduling через AChoreographer
-/// ШАГ 2: Frame interpolation (linear) в shader
-/// ШАГ 3: Audio clock = master clock
-/// ШАГ 4: Точный audio clock с учётом latency AudioTrack
+/// 🔥 VIDEO SCHEDULER: показ кадров по vsync (см. video_scheduler.h)
 
 #include "video_scheduler.h"
-#include "clock.h"
-#include "frame_queue.h"
-#include <android/log.h>
-#include <android/choreographer.h>
-#include <time.h>
 #include <string.h>
-#include <math.h>
-#include <unistd.h>
 
-#define LOG_TAG "VideoScheduler"
-#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
-#define ALOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+/// Допустимый период vsync: 20..250 Hz (остальное — мусор в timestamp'ах)
+#define VSYNC_PERIOD_MIN_US     4000
+#define VSYNC_PERIOD_MAX_US     50000
+/// Интервал до скольких пропущенных vsync'ов ещё уточняет период
+#define VSYNC_CLOCK_MAX_SKIP    4
+/// Вес нового интервала в оценке периода: 1/16
+#define VSYNC_CLOCK_EWMA_SHIFT  4
+/// Интервал "по сетке", если отличается от n * period не больше чем на period / 8
+#define VSYNC_CLOCK_GRID_DIV    8
+/// Столько одинаковых интервалов подряд не по периоду — новый период
+#define VSYNC_CLOCK_RESEED_TICKS 3
 
-// ШАГ 1: Пороги для frame scheduling
-#define FRAME_LATE_THRESHOLD   0.050   // 50 ms → drop
-#define VSYNC_INTERVAL         0.016   // ~60 Hz (16.67 ms)
+/// Пока draw + swap не измерены
+#define VS_LATENCY_INIT_US      4000
+#define VS_LATENCY_DEV_INIT_US  1000
+/// Запас сверх EWMA + 2 * отклонение
+#define VS_LATENCY_MARGIN_US    1000
+#define VS_LATENCY_MIN_US       1000
+/// Замер дольше этого — не draw + swap (поток стоял), в оценку не идёт
+#define VS_LATENCY_MAX_SAMPLE_US 200000
+/// Вес нового замера в EWMA: 1/8
+#define VS_LATENCY_EWMA_DIV     8
+/// До момента рисования меньше этого — рисуем сразу
+#define VS_PRESENT_TOLERANCE_US 500
+/// Ожидание перед рисованием заканчивается раньше на столько: иначе опоздание
+/// пробуждения сдвигает now + latency за target, и кадр уезжает на следующий vsync
+#define VS_WAKE_SLACK_US        1000
+/// Зона "посередине" между vsync'ами (не больше четверти периода): ±2 шума master clock
+#define VS_SLOT_ZONE_US         1000
 
-/// Получить текущее время (monotonic clock, секунды)
-static double now_sec() {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec / 1e9;
+int vsync_clock_init(VsyncClock *c) {
+    memset(c, 0, sizeof(*c));
+    return pthread_mutex_init(&c->mutex, NULL) == 0 ? 0 : -1;
 }
 
-/// ШАГ 3, 4: Получить master clock (audio clock с учётом latency)
-static double get_master_clock(VideoScheduler *scheduler) {
-    if (!scheduler || !scheduler->audio_state) {
-        // Fallback: system time
-        return now_sec();
-    }
-    
-    AudioState *as = scheduler->audio_state;
-    
-    // ШАГ 4: Получаем точный audio clock с учётом latency
-    if (clock_is_active(&as->clock)) {
-        // ШАГ 4: Используем clock_get_time, который учитывает latency
-        return clock_get_time(&as->clock);
-    }
-    
-    // Fallback: system time
-    return now_sec();
+void vsync_clock_destroy(VsyncClock *c) {
+    pthread_mutex_destroy(&c->mutex);
+}
+
+static bool period_sane(int64_t period_us) {
+    return period_us >= VSYNC_PERIOD_MIN_US && period_us <= VSYNC_PERIOD_MAX_US;
 }
 
-/// ШАГ 1: VSync callback (вызывается на каждом VSync)
-static void vsync_callback(long frameTimeNanos, void *userData) {
-    VideoScheduler *scheduler = (VideoScheduler *)userData;
-    
-    if (!scheduler || scheduler->abort) {
+void vsync_clock_set_period(VsyncClock *c, int64_t period_us) {
+    if (!period_sane(period_us)) {
         return;
     }
-    
-    VideoState *vs = scheduler->video_state;
-    VideoRenderGL *vr = scheduler->video_render;
-    
-    if (!vs || !vr || !vs->frameQueue) {
-        goto repost;
-    }
-    
-    // ШАГ 1: Конвертируем VSync время в секунды
-    double vsync_time = frameTimeNanos / 1e9;
-    
-    // ШАГ 3, 4: Получаем master clock (audio clock)
-    double master_clock = get_master_clock(scheduler);
-    
-    // ШАГ 1: Peek текущий кадр (без извлечения)
-    Frame *f0 = frame_queue_peek_ptr(vs->frameQueue);
-    if (!f0 || !f0->frame) {
-        goto repost;
-    }
-    
-    // ШАГ 1: Получаем PTS кадра в секундах
-    double frame_pts = f0->pts;
-    if (isnan(frame_pts)) {
-        goto repost;
-    }
-    
-    // ШАГ 1: Проверяем, готов ли кадр к показу
-    double diff = frame_pts - master_clock;
-    
-    if (diff < -FRAME_LATE_THRESHOLD) {
-        // Кадр сильно опоздал → drop
-        ALOGD("Frame too late: pts=%.3f clock=%.3f diff=%.3f (drop)", 
-              frame_pts, master_clock, diff);
-        frame_queue_next(vs->frameQueue);
-        goto repost;
+    pthread_mutex_lock(&c->mutex);
+    c->period_us = period_us;
+    pthread_mutex_unlock(&c->mutex);
+}
+
+static int64_t abs64(int64_t v) {
+    return v < 0 ? -v : v;
+}
+
+/// Интервал не по текущему периоду: после VSYNC_CLOCK_RESEED_TICKS похожих подряд
+/// он и есть период. Пропущенный callback так не повторяется, а смена частоты —
+/// да: 120 → 60 Hz выглядит как "пропущен каждый второй vsync" (n == 2),
+/// 90 → 60 Hz — как интервал вне сетки, и EWMA по delta / n ушла бы к 120 Hz
+static void vsync_clock_reseed_candidate(VsyncClock *c, int64_t delta) {
+    if (c->reseed_count > 0 && abs64(delta - c->reseed_interval_us) <= delta / VSYNC_CLOCK_GRID_DIV) {
+        c->reseed_count++;
+    } else {
+        c->reseed_interval_us = delta;
+        c->reseed_count = 1;
+    }
+    if (c->reseed_count >= VSYNC_CLOCK_RESEED_TICKS) {
+        c->period_us = delta;
+        c->reseed_count = 0;
     }
-    
-    // ШАГ 2: Frame interpolation (linear)
-    Frame *f1 = frame_queue_peek_next_ptr(vs->frameQueue);
-    double alpha = 0.0;
-    AVFrame *frame1_ptr = NULL;
-    
-    if (f1 && f1->frame && !isnan(f1->pts) && f1->pts > frame_pts) {
-        double gap = f1->pts - frame_pts;
-        
-        // ШАГ 2: Interpolation только если gap > VSync interval
-        if (gap > VSYNC_INTERVAL) {
-            // ШАГ 2: Расчёт alpha для interpolation
-            alpha = (master_clock - frame_pts) / gap;
-            
-            // Clamp alpha
-            if (alpha < 0.0) alpha = 0.0;
-            if (alpha >= 1.0) {
-                // Переходим к следующему кадру
-                frame_queue_next(vs->frameQueue);
-                alpha = 0.0;
-                frame1_ptr = NULL;
-            } else {
-                frame1_ptr = f1->frame;
-            }
+}
+
+void vsync_clock_tick(VsyncClock *c, int64_t vsync_us) {
+    pthread_mutex_lock(&c->mutex);
+    if (c->ticks > 0 && vsync_us > c->last_vsync_us) {
+        int64_t delta = vsync_us - c->last_vsync_us;
+        int64_t n = c->period_us > 0 ? (delta + c->period_us / 2) / c->period_us : 0;
+        bool on_grid = n >= 1 && n <= VSYNC_CLOCK_MAX_SKIP &&
+                       abs64(delta - n * c->period_us) <= c->period_us / VSYNC_CLOCK_GRID_DIV;
+        if (on_grid) {
+            // Пропущенные callback'и: интервал делится на число vsync'ов
+            int64_t sample = delta / n;
+            c->period_us += (sample - c->period_us) / (1 << VSYNC_CLOCK_EWMA_SHIFT);
         }
-    }
-    
-    // ШАГ 1, 2: Рендерим кадр (с interpolation если нужно)
-    if (diff <= 0.0 || alpha > 0.0) {
-        // Время показывать кадр
-        int ret = video_render_gl_draw(vr, f0->frame, frame1_ptr, alpha);
-        
-        if (ret == 0) {
-            ALOGD("Frame rendered: pts=%.3f clock=%.3f alpha=%.3f", 
-                  frame_pts, master_clock, alpha);
-            
-            // Продвигаем очередь, если alpha >= 1.0 или кадр полностью показан
-            if (alpha >= 1.0 || diff <= -VSYNC_INTERVAL) {
-                frame_queue_next(vs->frameQueue);
-            }
+        if (on_grid && n == 1) {
+            c->reseed_count = 0;
+        } else if (!period_sane(delta)) {
+            c->reseed_count = 0;  // Пауза источника / потерянные vsync'и
+        } else if (n == 0) {
+            // Первый интервал или частота дисплея выросла (60 → 120 Hz)
+            c->period_us = delta;
+            c->reseed_count = 0;
         } else {
-            ALOGE("Error rendering frame, dropping. PTS: %.3f", frame_pts);
-            frame_queue_next(vs->frameQueue);
+            vsync_clock_reseed_candidate(c, delta);
         }
     }
-    
-repost:
-    // ШАГ 1: Регистрируем следующий VSync callback
-    if (!scheduler->abort && scheduler->active) {
-        AChoreographer_postFrameCallback(
-            (AChoreographer *)scheduler->choreographer,
-            vsync_callback,
-            scheduler
-        );
+    if (vsync_us > c->last_vsync_us) {
+        c->last_vsync_us = vsync_us;
     }
+    c->ticks++;
+    pthread_mutex_unlock(&c->mutex);
+}
+
+bool vsync_clock_get(VsyncClock *c, int64_t now_us, VsyncTiming *out) {
+    pthread_mutex_lock(&c->mutex);
+    bool valid = c->ticks > 0 && c->period_us > 0 && now_us - c->last_vsync_us <= VSYNC_CLOCK_STALE_US;
+    out->last_vsync_us = c->last_vsync_us;
+    out->period_us = c->period_us;
+    pthread_mutex_unlock(&c->mutex);
+    return valid;
+}
+
+int64_t vsync_timing_next(const VsyncTiming *vt, int64_t t_us) {
+    int64_t d = t_us - vt->last_vsync_us;
+    int64_t n = d > 0 ? (d + vt->period_us - 1) / vt->period_us : -((-d) / vt->period_us);
+    return vt->last_vsync_us + n * vt->period_us;
+}
+
+void video_scheduler_init(VideoScheduler *s) {
+    memset(s, 0, sizeof(*s));
+    s->latency_us = VS_LATENCY_INIT_US;
+    s->latency_dev_us = VS_LATENCY_DEV_INIT_US;
+}
+
+void video_scheduler_reset(VideoScheduler *s) {
+    s->last_target_us = 0;
+    s->last_new_target_us = 0;
 }
 
-/// ШАГ 1: VSync thread (получает AChoreographer)
-static void *vsync_thread(void *arg) {
-    VideoScheduler *scheduler = (VideoScheduler *)arg;
-    
-    ALOGI("VSync thread started");
-    
-    // ШАГ 1: Получаем AChoreographer для текущего thread
-    AChoreographer *choreographer = AChoreographer_getInstance();
-    if (!choreographer) {
-        ALOGE("Failed to get AChoreographer instance");
-        return NULL;
+int64_t video_scheduler_latency_us(const VideoScheduler *s, int64_t period_us) {
+    int64_t latency = s->latency_us + 2 * s->latency_dev_us + VS_LATENCY_MARGIN_US;
+    if (latency < VS_LATENCY_MIN_US) {
+        latency = VS_LATENCY_MIN_US;
     }
-    
-    scheduler->choreographer = choreographer;
-    
-    // ШАГ 1: Регистрируем первый VSync callback
-    AChoreographer_postFrameCallback(
-        choreographer,
-        vsync_callback,
-        scheduler
-    );
-    
-    // Ждём завершения
-    while (!scheduler->abort) {
-        usleep(100000); // 100ms
+    // Дольше двух периодов не закладываем: медленный draw всё равно пропустит vsync
+    if (period_us > 0 && latency > 2 * period_us) {
+        latency = 2 * period_us;
     }
-    
-    ALOGI("VSync thread stopped");
-    return NULL;
+    return latency;
 }
 
-int video_scheduler_init(VideoScheduler *scheduler,
-                         VideoState *video_state,
-                         AudioState *audio_state,
-                         VideoRenderGL *video_render) {
-    if (!scheduler || !video_state || !video_render) {
-        return -1;
-    }
-    
-    memset(scheduler, 0, sizeof(VideoScheduler));
-    
-    scheduler->video_state = video_state;
-    scheduler->audio_state = audio_state;
-    scheduler->video_render = video_render;
-    scheduler->active = false;
-    scheduler->abort = false;
-    
-    pthread_mutex_init(&scheduler->mutex, NULL);
-    
-    ALOGI("Video scheduler initialized");
-    return 0;
+/// Ближайший к deadline'у vsync; посередине между двумя (± зона шума) — всегда более ранний
+static int64_t vsync_slot(const VsyncTiming *vt, int64_t due_us) {
+    int64_t period = vt->period_us;
+    int64_t zone = VS_SLOT_ZONE_US < period / 4 ? VS_SLOT_ZONE_US : period / 4;
+    return vsync_timing_next(vt, due_us - period / 2 - zone);
+}
+
+static VsDecision plan_wait(VsPlan *plan, int64_t wake_at_us) {
+    plan->decision = VS_WAIT;
+    plan->wake_at_us = wake_at_us;
+    return VS_WAIT;
 }
 
-int video_scheduler_start(VideoScheduler *scheduler) {
-    if (!scheduler) {
-        return -1;
+VsDecision video_scheduler_plan(VideoScheduler *s, const VsyncTiming *vt, int64_t now_us,
+                                int64_t due0_us, int64_t due1_us, bool head_shown, VsPlan *plan) {
+    memset(plan, 0, sizeof(*plan));
+
+    if (!vt || vt->period_us <= 0) {
+        // Без vsync: кадр показывается в свой deadline
+        if (due0_us > 0 && due0_us - now_us > VS_PRESENT_TOLERANCE_US) {
+            return plan_wait(plan, due0_us);
+        }
+        plan->decision = VS_PRESENT;
+        return VS_PRESENT;
     }
-    
-    pthread_mutex_lock(&scheduler->mutex);
-    
-    if (scheduler->active) {
-        pthread_mutex_unlock(&scheduler->mutex);
-        return 0; // Уже запущен
+
+    int64_t period = vt->period_us;
+    int64_t latency = video_scheduler_latency_us(s, period);
+    int64_t earliest = now_us + latency;
+    if (s->last_target_us > 0 && earliest < s->last_target_us + period / 2) {
+        earliest = s->last_target_us + period / 2;  // Vsync предыдущего показа занят
+    }
+    int64_t target = vsync_timing_next(vt, earliest);
+    plan->period_us = period;
+    plan->target_vsync_us = target;
+
+    if (due1_us > 0 && vsync_slot(vt, due1_us) <= target) {
+        plan->decision = VS_NEXT;
+        if (!head_shown) {
+            s->stats.dropped++;
+        }
+        return VS_NEXT;
+    }
+
+    if (due0_us > 0) {
+        int64_t slot = vsync_slot(vt, due0_us);
+        if (slot > target) {
+            // Рано: на экране остаётся прошлый кадр (repeat)
+            plan->target_vsync_us = slot;
+            return plan_wait(plan, slot - latency - VS_WAKE_SLACK_US);
+        }
     }
-    
-    scheduler->active = true;
-    scheduler->abort = false;
-    
-    // ШАГ 1: Запускаем VSync thread
-    int ret = pthread_create(&scheduler->vsync_thread, NULL, vsync_thread, scheduler);
-    if (ret != 0) {
-        ALOGE("Failed to create VSync thread: %d", ret);
-        scheduler->active = false;
-        pthread_mutex_unlock(&scheduler->mutex);
-        return -1;
+
+    int64_t draw_at = target - latency;
+    if (draw_at - now_us > VS_WAKE_SLACK_US + VS_PRESENT_TOLERANCE_US) {
+        return plan_wait(plan, draw_at - VS_WAKE_SLACK_US);
     }
-    
-    pthread_mutex_unlock(&scheduler->mutex);
-    
-    ALOGI("Video scheduler started");
-    return 0;
+    plan->decision = VS_PRESENT;
+    return VS_PRESENT;
 }
 
-void video_scheduler_stop(VideoScheduler *scheduler) {
-    if (!scheduler) {
-        return;
+void video_scheduler_on_present(VideoScheduler *s, const VsPlan *plan, bool new_frame,
+                                int64_t draw_start_us, int64_t swap_done_us) {
+    if (draw_start_us > 0 && swap_done_us >= draw_start_us &&
+        swap_done_us - draw_start_us < VS_LATENCY_MAX_SAMPLE_US) {
+        int64_t err = (swap_done_us - draw_start_us) - s->latency_us;
+        int64_t abs_err = err < 0 ? -err : err;
+        s->latency_us += err / VS_LATENCY_EWMA_DIV;
+        s->latency_dev_us += (abs_err - s->latency_dev_us) / VS_LATENCY_EWMA_DIV;
     }
-    
-    pthread_mutex_lock(&scheduler->mutex);
-    
-    if (!scheduler->active) {
-        pthread_mutex_unlock(&scheduler->mutex);
-        return;
+
+    if (new_frame) {
+        s->stats.presented++;
+    } else {
+        s->stats.redraws++;
     }
-    
-    scheduler->abort = true;
-    scheduler->active = false;
-    
-    pthread_mutex_unlock(&scheduler->mutex);
-    
-    // Ждём завершения VSync thread
-    if (scheduler->vsync_thread) {
-        pthread_join(scheduler->vsync_thread, NULL);
-        scheduler->vsync_thread = 0;
+
+    if (!plan || plan->target_vsync_us <= 0 || plan->period_us <= 0) {
+        // Показ вне vsync: на какой vsync попал кадр, неизвестно
+        video_scheduler_reset(s);
+        return;
     }
-    
-    scheduler->choreographer = NULL;
-    
-    ALOGI("Video scheduler stopped");
-}
 
-void video_scheduler_release(VideoScheduler *scheduler) {
-    if (!scheduler) {
+    int64_t shown_us = plan->target_vsync_us;
+    if (draw_start_us > 0 && swap_done_us > shown_us) {
+        // Кадр выйдет на первом vsync'е после swap'а: следующий планируется от него,
+        // иначе очередь swap'а так и держит лишний кадр (следующий кадр дропнется)
+        s->stats.missed++;
+        shown_us += (swap_done_us - shown_us + plan->period_us - 1) / plan->period_us * plan->period_us;
+    }
+    s->last_target_us = shown_us;
+    if (!new_frame) {
         return;
     }
-    
-    video_scheduler_stop(scheduler);
-    pthread_mutex_destroy(&scheduler->mutex);
-    
-    ALOGI("Video scheduler released");
-}
 
-double video_scheduler_get_master_clock(VideoScheduler *scheduler) {
-    return get_master_clock(scheduler);
+    if (s->last_new_target_us > 0) {
+        int64_t n = (shown_us - s->last_new_target_us + plan->period_us / 2) / plan->period_us;
+        if (n >= 1) {
+            s->stats.cadence[(n < VS_CADENCE_BUCKETS ? n : VS_CADENCE_BUCKETS) - 1]++;
+        }
+    }
+    s->last_new_target_us = shown_us;
 }
-
@@ -1,78 +1,137 @@
+/// 🔥 VIDEO SCHEDULER: показ кадров по vsync
+///
+/// Render loop показывал кадр, когда наступал его deadline (PTS по master
+/// clock), а на экран кадр попадал на первом vsync после eglSwapBuffers.
+/// Если deadline близко к границе vsync, разброс времени draw + swap
+/// переносил кадр то на один vsync, то на следующий: 24 fps на 60 Hz вместо
+/// ровного 3:2 давали 3:3:1:2..., на 90/120 Hz — такие же сбои каденса.
+///
+/// VideoScheduler выбирает vsync для кадра ДО рисования:
+/// - VsyncClock: фаза и период vsync от любого источника
+///   (platform/vsync_source.h: AChoreographer на устройстве, симулированные
+///   60/90/120 Hz на Linux);
+/// - slot кадра — ближайший к его deadline'у vsync;
+/// - target — первый vsync, к которому успевает draw + swap (EWMA
+///   измеренного времени draw + swap плюс запас на разброс), и не раньше
+///   vsync'а после предыдущего показа: два swap'а на один vsync не бывает;
+/// - решение детерминировано:
+///   следующий кадр тоже успевает к target → NEXT (текущий дропается);
+///   slot текущего позже target → WAIT (на экране остаётся прошлый кадр) до
+///   slot - latency; иначе WAIT до target - latency и PRESENT — рисовать сейчас.
+///   Ожидание заканчивается чуть раньше (запас на опоздание пробуждения), чтобы
+///   после WAIT target не сдвигался;
+/// - deadline почти посередине между vsync'ами: шум master clock перебрасывал бы
+///   кадры то на один, то на другой vsync — там всегда выбирается более ранний;
+/// - swap не успел к target: дальше планирование идёт от vsync'а, на котором кадр
+///   реально выйдет, и очередь swap'а не копит лишний кадр задержки.
+///
+/// Нет vsync (источник не запущен / не тикает) — показ в deadline, как раньше.
+///
+/// Только pthread и platform_time.h: проверяется на host
+/// (bench/bench_vsync_cadence.c).
+
 #pragma once
 
+#include <pthread.h>
 #include <stdbool.h>
-#include "video_renderer.h"
-#include "audio_renderer.h"
-#include "frame_queue.h"
-#include "video_render_gl.h"
+#include <stdint.h>
 
-/// VSync-driven video scheduler (ШАГ 1)
-///
-/// Управляет выводом кадров строго по времени экрана через AChoreographer.
-/// Обеспечивает:
-/// - VSync-aligned frame scheduling
-/// - Frame interpolation (ШАГ 2)
-/// - Audio clock как master clock (ШАГ 3)
-/// - Точный audio clock с учётом latency (ШАГ 4)
-
-/// Состояние VSync scheduler
-typedef struct VideoScheduler {
-    /// Video state (для доступа к frame_queue)
-    VideoState *video_state;
-    
-    /// Audio state (для master clock)
-    AudioState *audio_state;
-    
-    /// Video renderer (OpenGL)
-    VideoRenderGL *video_render;
-    
-    /// AChoreographer instance (для VSync)
-    void *choreographer; // AChoreographer*
-    
-    /// Флаг активности
-    bool active;
-    
-    /// Флаг прерывания
-    bool abort;
-    
-    /// Thread для VSync callback
-    pthread_t vsync_thread;
-    
-    /// Mutex для синхронизации
+/// Vsync старше этого считается потерянным (источник остановлен, экран выключен)
+#define VSYNC_CLOCK_STALE_US 250000
+
+/// Гистограмма каденса: кадр на экране 1, 2, 3, 4, 5 и >= 6 vsync'ов
+#define VS_CADENCE_BUCKETS 6
+
+/// Снимок VsyncClock
+typedef struct VsyncTiming {
+    int64_t last_vsync_us;  // Монотонное время (platform_now_us) последнего vsync
+    int64_t period_us;
+} VsyncTiming;
+
+/// Фаза и период vsync. Источник вызывает vsync_clock_tick из своего потока,
+/// render thread читает снимок через vsync_clock_get
+typedef struct VsyncClock {
     pthread_mutex_t mutex;
+    int64_t last_vsync_us;
+    int64_t period_us;      // Оценка по интервалам между tick'ами (или от источника)
+    uint64_t ticks;
+    /// Интервалы подряд не по текущему периоду (кратные или вне сетки) — кандидат
+    /// на новый период: частота дисплея упала (120 → 60, 90 → 60 Hz)
+    int64_t reseed_interval_us;
+    int reseed_count;
+} VsyncClock;
+
+/// Решение для головы очереди
+typedef enum VsDecision {
+    VS_PRESENT = 0,         // Рисовать сейчас
+    VS_WAIT,                // Рано: ждать до wake_at_us и перепланировать
+    VS_NEXT                 // Следующий кадр тоже успевает: текущий убрать из очереди
+} VsDecision;
+
+typedef struct VsPlan {
+    VsDecision decision;
+    int64_t target_vsync_us;  // Vsync, на котором кадр будет на экране (0 — без vsync)
+    int64_t period_us;
+    int64_t wake_at_us;       // VS_WAIT
+} VsPlan;
+
+typedef struct VsStats {
+    int64_t presented;        // Новые кадры
+    int64_t redraws;          // Тот же кадр ещё раз (interpolation)
+    int64_t dropped;          // NEXT по кадру, который не был показан
+    int64_t missed;           // Swap закончился позже target vsync
+    int64_t cadence[VS_CADENCE_BUCKETS];  // Сколько vsync'ов новый кадр был на экране
+} VsStats;
+
+typedef struct VideoScheduler {
+    int64_t latency_us;       // EWMA draw + swap
+    int64_t latency_dev_us;   // EWMA |отклонения|
+    int64_t last_target_us;   // Vsync последнего показа (любого)
+    int64_t last_new_target_us;  // Vsync последнего нового кадра (0 — цепочка каденса прервана)
+    VsStats stats;
 } VideoScheduler;
 
-/// Инициализировать VSync scheduler (ШАГ 1)
-///
-/// @param scheduler Scheduler для инициализации
-/// @param video_state Video state
-/// @param audio_state Audio state (для master clock)
-/// @param video_render Video renderer
-/// @return 0 при успехе, <0 при ошибке
-int video_scheduler_init(VideoScheduler *scheduler,
-                         VideoState *video_state,
-                         AudioState *audio_state,
-                         VideoRenderGL *video_render);
-
-/// Запустить VSync-driven рендеринг (ШАГ 1)
-///
-/// @param scheduler Scheduler
-/// @return 0 при успехе, <0 при ошибке
-int video_scheduler_start(VideoScheduler *scheduler);
+/// @return 0, <0 при ошибке pthread
+int vsync_clock_init(VsyncClock *c);
 
-/// Остановить VSync-driven рендеринг
-///
-/// @param scheduler Scheduler
-void video_scheduler_stop(VideoScheduler *scheduler);
+void vsync_clock_destroy(VsyncClock *c);
+
+/// Период от источника (частота дисплея), до первых tick'ов
+void vsync_clock_set_period(VsyncClock *c, int64_t period_us);
 
-/// Освободить ресурсы scheduler
+/// Очередной vsync (монотонное время). Пропущенные vsync'и допустимы; одинаковый
+/// интервал не по периоду несколько tick'ов подряд становится новым периодом
+void vsync_clock_tick(VsyncClock *c, int64_t vsync_us);
+
+/// @return false, если vsync'ов не было VSYNC_CLOCK_STALE_US или период неизвестен
+bool vsync_clock_get(VsyncClock *c, int64_t now_us, VsyncTiming *out);
+
+/// Первый vsync >= t_us
+int64_t vsync_timing_next(const VsyncTiming *vt, int64_t t_us);
+
+void video_scheduler_init(VideoScheduler *s);
+
+/// Seek / разрыв: цепочка каденса начинается заново (оценка latency сохраняется)
+void video_scheduler_reset(VideoScheduler *s);
+
+/// Сколько закладывать на draw + swap перед vsync'ом
 ///
-/// @param scheduler Scheduler
-void video_scheduler_release(VideoScheduler *scheduler);
+/// @param period_us Период vsync (ограничивает оценку), <= 0 — без ограничения
+int64_t video_scheduler_latency_us(const VideoScheduler *s, int64_t period_us);
 
-/// Получить master clock (ШАГ 3, 4)
+/// Спланировать показ головы очереди
 ///
-/// @param scheduler Scheduler
-/// @return Текущий master clock в секундах
-double video_scheduler_get_master_clock(VideoScheduler *scheduler);
+/// @param vt Vsync, NULL — без vsync (показ в deadline)
+/// @param due0_us Deadline головы очереди, <= 0 — неизвестен (показать на ближайшем vsync)
+/// @param due1_us Deadline следующего кадра, <= 0 — нет / неизвестен
+/// @param head_shown Голова уже показана (interpolation): NEXT — не drop
+VsDecision video_scheduler_plan(VideoScheduler *s, const VsyncTiming *vt, int64_t now_us,
+                                int64_t due0_us, int64_t due1_us, bool head_shown, VsPlan *plan);
 
+/// Кадр нарисован и отдан в swap
+///
+/// @param plan План показа, NULL — показ вне планировщика (первый кадр, seek)
+/// @param new_frame false — тот же кадр ещё раз
+/// @param draw_start_us, swap_done_us Замер draw + swap, draw_start_us <= 0 — без замера
+void video_scheduler_on_present(VideoScheduler *s, const VsPlan *plan, bool new_frame,
+                                int64_t draw_start_us, int64_t swap_done_us);
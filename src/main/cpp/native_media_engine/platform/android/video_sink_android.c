@@ -0,0 +1,14 @@
+/// 🔧 PLATFORM (Android): Video sink поверх VideoRenderGL
+
+#include "video_sink.h"
+#include "video_render_gl.h"
+
+// Глобальный renderer (из native_player_jni.c)
+extern VideoRenderGL *g_renderer;
+
+void video_sink_clear(double seek_target_sec) {
+    // 🔴 ИСПРАВЛЕНО: Используем g_renderer вместо ctx->video->video_render (который VideoRenderAndroid)
+    if (g_renderer) {
+        video_render_gl_clear(g_renderer, seek_target_sec);
+    }
+}
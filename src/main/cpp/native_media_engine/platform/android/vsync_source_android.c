@@ -0,0 +1,227 @@
+/// 🔧 PLATFORM (Android): Vsync от AChoreographer (реализация vsync_source.h)
+///
+/// AChoreographer привязан к ALooper потока, поэтому у источника свой поток:
+/// ALooper_prepare → AChoreographer_getInstance → frame callback, который
+/// отдаёт timestamp vsync'а в VsyncClock и перерегистрирует себя.
+/// frameTimeNanos — CLOCK_MONOTONIC, та же база, что platform_now_us().
+///
+/// minSdk 26, а postFrameCallback64 (API 29) и refresh rate callback (API 30)
+/// нужны на новых устройствах: берутся из libandroid.so через dlsym по
+/// android_get_device_api_level(), а не по __ANDROID_API__ сборки. Без refresh
+/// rate callback'а смену частоты дисплея VsyncClock определяет по интервалам.
+
+#include "vsync_source.h"
+#include "video_scheduler.h"
+#include "platform_time.h"
+#include "platform_log.h"
+#include <android/api-level.h>
+#include <android/choreographer.h>
+#include <android/looper.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define LOG_TAG "VsyncChoreographer"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+
+typedef void (*VsyncFrameCallback64)(int64_t frame_time_nanos, void *data);
+typedef void (*VsyncRefreshRateCallback)(int64_t vsync_period_nanos, void *data);
+typedef void (*PfnPostFrameCallback64)(AChoreographer *choreographer, VsyncFrameCallback64 callback,
+                                       void *data);
+typedef void (*PfnRefreshRateCallback)(AChoreographer *choreographer, VsyncRefreshRateCallback callback,
+                                       void *data);
+
+/// Функции AChoreographer новее minSdk (NULL — устройство старше)
+typedef struct VsyncChoreographerApi {
+    PfnPostFrameCallback64 post_frame_callback64;     // API 29
+    PfnRefreshRateCallback register_refresh_rate;     // API 30
+    PfnRefreshRateCallback unregister_refresh_rate;   // API 30
+} VsyncChoreographerApi;
+
+static VsyncChoreographerApi g_api;
+static pthread_once_t g_api_once = PTHREAD_ONCE_INIT;
+
+static void vsync_api_load(void) {
+    int api_level = android_get_device_api_level();
+    if (api_level < 29) {
+        return;
+    }
+    // libandroid.so уже загружен процессом: handle не закрываем
+    void *lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+    if (!lib) {
+        ALOGE("Failed to open libandroid.so: %s", dlerror());
+        return;
+    }
+    g_api.post_frame_callback64 = (PfnPostFrameCallback64)dlsym(lib, "AChoreographer_postFrameCallback64");
+    if (api_level >= 30) {
+        g_api.register_refresh_rate =
+            (PfnRefreshRateCallback)dlsym(lib, "AChoreographer_registerRefreshRateCallback");
+        g_api.unregister_refresh_rate =
+            (PfnRefreshRateCallback)dlsym(lib, "AChoreographer_unregisterRefreshRateCallback");
+        if (!g_api.register_refresh_rate || !g_api.unregister_refresh_rate) {
+            g_api.register_refresh_rate = NULL;
+            g_api.unregister_refresh_rate = NULL;
+        }
+    }
+}
+
+struct VsyncSource {
+    VsyncClock *clock;
+    AChoreographer *choreographer;
+    ALooper *looper;
+    atomic_int abort;
+    pthread_t thread;
+
+    /// Поток подготовил looper (или не смог): vsync_source_start ждёт этого
+    pthread_mutex_t ready_mutex;
+    pthread_cond_t ready_cond;
+    bool ready;
+    bool failed;
+};
+
+static void vsync_on_frame(VsyncSource *src, int64_t vsync_ns) {
+    if (atomic_load(&src->abort)) {
+        return;
+    }
+    vsync_clock_tick(src->clock, vsync_ns / 1000);
+}
+
+static void vsync_post_frame_callback(VsyncSource *src);
+
+static void vsync_frame_callback64(int64_t frame_time_nanos, void *data) {
+    VsyncSource *src = data;
+    vsync_on_frame(src, frame_time_nanos);
+    vsync_post_frame_callback(src);
+}
+
+static void vsync_frame_callback(long frame_time_nanos, void *data) {
+    VsyncSource *src = data;
+    int64_t vsync_ns = (int64_t)frame_time_nanos;
+    if (sizeof(long) < sizeof(int64_t)) {
+        // 32-bit ABI: long обрезает наносекунды до младших 32 бит (период ~4.3 с),
+        // старшие биты восстанавливаем по текущему времени: vsync был только что
+        int64_t now_ns = platform_now_us() * 1000;
+        vsync_ns = (now_ns & ~(int64_t)0xFFFFFFFF) | (int64_t)(uint32_t)frame_time_nanos;
+        if (vsync_ns > now_ns) {
+            vsync_ns -= (int64_t)1 << 32;
+        }
+    }
+    vsync_on_frame(src, vsync_ns);
+    vsync_post_frame_callback(src);
+}
+
+/// Следующий frame callback: 64-bit timestamp, если устройство умеет (API 29+)
+static void vsync_post_frame_callback(VsyncSource *src) {
+    if (atomic_load(&src->abort)) {
+        return;
+    }
+    if (g_api.post_frame_callback64) {
+        g_api.post_frame_callback64(src->choreographer, vsync_frame_callback64, src);
+    } else {
+        AChoreographer_postFrameCallback(src->choreographer, vsync_frame_callback, src);
+    }
+}
+
+static void vsync_refresh_rate_callback(int64_t vsync_period_nanos, void *data) {
+    VsyncSource *src = data;
+    vsync_clock_set_period(src->clock, vsync_period_nanos / 1000);
+    ALOGI("Display refresh period: %.2f ms", (double)vsync_period_nanos / 1e6);
+}
+
+static void vsync_signal_ready(VsyncSource *src, bool failed) {
+    pthread_mutex_lock(&src->ready_mutex);
+    src->ready = true;
+    src->failed = failed;
+    pthread_cond_broadcast(&src->ready_cond);
+    pthread_mutex_unlock(&src->ready_mutex);
+}
+
+static void *vsync_choreographer_thread(void *arg) {
+    VsyncSource *src = arg;
+
+    src->looper = ALooper_prepare(0);
+    src->choreographer = src->looper ? AChoreographer_getInstance() : NULL;
+    if (!src->choreographer) {
+        ALOGE("Failed to get AChoreographer instance");
+        vsync_signal_ready(src, true);
+        return NULL;
+    }
+    ALooper_acquire(src->looper);
+    vsync_signal_ready(src, false);
+
+    if (g_api.register_refresh_rate) {
+        g_api.register_refresh_rate(src->choreographer, vsync_refresh_rate_callback, src);
+    }
+    vsync_post_frame_callback(src);
+
+    // Callback'и вызываются внутри pollOnce; ALooper_wake из stop прерывает ожидание
+    while (!atomic_load(&src->abort)) {
+        ALooper_pollOnce(-1, NULL, NULL, NULL);
+    }
+
+    if (g_api.unregister_refresh_rate) {
+        g_api.unregister_refresh_rate(src->choreographer, vsync_refresh_rate_callback, src);
+    }
+    // Отложенный frame callback не вызовется: looper этого потока больше не опрашивается
+    return NULL;
+}
+
+VsyncSource *vsync_source_start(VsyncClock *clock, int refresh_hz) {
+    (void)refresh_hz;
+    if (!clock) {
+        return NULL;
+    }
+
+    VsyncSource *src = calloc(1, sizeof(*src));
+    if (!src) {
+        return NULL;
+    }
+    pthread_once(&g_api_once, vsync_api_load);
+    src->clock = clock;
+    atomic_init(&src->abort, 0);
+    pthread_mutex_init(&src->ready_mutex, NULL);
+    pthread_cond_init(&src->ready_cond, NULL);
+
+    if (pthread_create(&src->thread, NULL, vsync_choreographer_thread, src) != 0) {
+        ALOGE("Failed to create vsync thread");
+        pthread_cond_destroy(&src->ready_cond);
+        pthread_mutex_destroy(&src->ready_mutex);
+        free(src);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&src->ready_mutex);
+    while (!src->ready) {
+        pthread_cond_wait(&src->ready_cond, &src->ready_mutex);
+    }
+    bool failed = src->failed;
+    pthread_mutex_unlock(&src->ready_mutex);
+
+    if (failed) {
+        pthread_join(src->thread, NULL);
+        pthread_cond_destroy(&src->ready_cond);
+        pthread_mutex_destroy(&src->ready_mutex);
+        free(src);
+        return NULL;
+    }
+    ALOGI("Choreographer vsync started (frameCallback64=%d, refreshRateCallback=%d)",
+          g_api.post_frame_callback64 != NULL, g_api.register_refresh_rate != NULL);
+    return src;
+}
+
+void vsync_source_stop(VsyncSource *src) {
+    if (!src) {
+        return;
+    }
+    atomic_store(&src->abort, 1);
+    ALooper_wake(src->looper);
+    pthread_join(src->thread, NULL);
+    ALooper_release(src->looper);
+    pthread_cond_destroy(&src->ready_cond);
+    pthread_mutex_destroy(&src->ready_mutex);
+    free(src);
+    ALOGI("Choreographer vsync stopped");
+}
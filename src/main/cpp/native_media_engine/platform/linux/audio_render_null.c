@@ -0,0 +1,193 @@
+/// 🔧 PLATFORM (Linux): Null audio sink (реализация audio_render_android.h)
+///
+/// ar->audio_track указывает на NullAudioTrack — ядро проверяет только,
+/// что handle не NULL, и не разыменовывает его.
+
+#include "audio_render_android.h"
+#include "audio_render_null.h"
+#include "platform_time.h"
+#include "platform_log.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define LOG_TAG "AudioRenderNull"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+
+/// Ёмкость эмулируемого буфера AudioTrack (realtime режим)
+#define NULL_AUDIO_BUFFER_MS 100
+
+typedef struct NullAudioTrack {
+    pthread_mutex_t mutex;
+    /// Сэмплов (на канал) записано с последнего flush
+    int64_t frames_written;
+    /// Сэмплов проиграно до последнего start (realtime режим)
+    int64_t frames_played_base;
+    /// Момент последнего start (realtime режим)
+    int64_t started_at_us;
+} NullAudioTrack;
+
+static atomic_bool g_realtime = false;
+static atomic_llong g_total_frames = 0;
+
+void audio_render_null_set_realtime(bool realtime) {
+    atomic_store(&g_realtime, realtime);
+}
+
+int64_t audio_render_null_total_frames(void) {
+    return atomic_load(&g_total_frames);
+}
+
+/// Проиграно сэмплов (вызывать под mutex)
+static int64_t null_track_played(AudioRenderAndroid *ar, NullAudioTrack *t) {
+    if (!atomic_load(&g_realtime)) {
+        return t->frames_written;
+    }
+    int64_t played = t->frames_played_base;
+    if (ar->started) {
+        played += (platform_now_us() - t->started_at_us) * ar->sample_rate / 1000000;
+    }
+    return played < t->frames_written ? played : t->frames_written;
+}
+
+bool audio_render_init(AudioRenderAndroid *ar,
+                       JavaVM *jvm,
+                       int sample_rate,
+                       int channels) {
+    memset(ar, 0, sizeof(*ar));
+    if (sample_rate <= 0 || channels <= 0) {
+        ALOGE("audio_render_init: invalid params rate=%d ch=%d", sample_rate, channels);
+        return false;
+    }
+
+    NullAudioTrack *t = calloc(1, sizeof(NullAudioTrack));
+    if (!t) {
+        return false;
+    }
+    pthread_mutex_init(&t->mutex, NULL);
+
+    ar->jvm = jvm;
+    ar->audio_track = (jobject)t;
+    ar->sample_rate = sample_rate;
+    ar->channels = channels;
+    ar->bytes_per_sample = 2;
+    ar->started = false;
+
+    ALOGI("Null audio sink: rate=%d ch=%d realtime=%d", sample_rate, channels, (int)atomic_load(&g_realtime));
+    return true;
+}
+
+void audio_render_start(AudioRenderAndroid *ar) {
+    NullAudioTrack *t = (NullAudioTrack *)ar->audio_track;
+    if (!t) {
+        return;
+    }
+    pthread_mutex_lock(&t->mutex);
+    if (!ar->started) {
+        t->started_at_us = platform_now_us();
+        ar->started = true;
+    }
+    pthread_mutex_unlock(&t->mutex);
+}
+
+void audio_render_pause(AudioRenderAndroid *ar) {
+    NullAudioTrack *t = (NullAudioTrack *)ar->audio_track;
+    if (!t) {
+        return;
+    }
+    pthread_mutex_lock(&t->mutex);
+    if (ar->started) {
+        t->frames_played_base = null_track_played(ar, t);
+        ar->started = false;
+    }
+    pthread_mutex_unlock(&t->mutex);
+}
+
+void audio_render_stop(AudioRenderAndroid *ar) {
+    audio_render_pause(ar);
+}
+
+void audio_render_release(AudioRenderAndroid *ar) {
+    NullAudioTrack *t = (NullAudioTrack *)ar->audio_track;
+    if (!t) {
+        return;
+    }
+    ar->started = false;
+    ar->audio_track = NULL;
+    pthread_mutex_destroy(&t->mutex);
+    free(t);
+}
+
+int audio_render_write(AudioRenderAndroid *ar,
+                       const uint8_t *data,
+                       int size) {
+    NullAudioTrack *t = (NullAudioTrack *)ar->audio_track;
+    if (!t || !ar->started || !data || size <= 0) {
+        return 0;
+    }
+
+    int frame_bytes = ar->channels * ar->bytes_per_sample;
+    int64_t frames = size / frame_bytes;
+
+    // Realtime: блокируемся, пока буфер заполнен (как AudioTrack.write в MODE_STREAM)
+    if (atomic_load(&g_realtime)) {
+        int64_t capacity = (int64_t)ar->sample_rate * NULL_AUDIO_BUFFER_MS / 1000;
+        for (;;) {
+            pthread_mutex_lock(&t->mutex);
+            bool started = ar->started;
+            int64_t queued = t->frames_written - null_track_played(ar, t);
+            pthread_mutex_unlock(&t->mutex);
+            if (!started || queued + frames <= capacity) {
+                break;
+            }
+            usleep(2000);
+        }
+    }
+
+    pthread_mutex_lock(&t->mutex);
+    t->frames_written += frames;
+    pthread_mutex_unlock(&t->mutex);
+    atomic_fetch_add(&g_total_frames, frames);
+
+    return size;
+}
+
+int64_t audio_render_get_playback_head(AudioRenderAndroid *ar) {
+    NullAudioTrack *t = (NullAudioTrack *)ar->audio_track;
+    if (!t) {
+        return 0;
+    }
+    pthread_mutex_lock(&t->mutex);
+    int64_t played = null_track_played(ar, t);
+    pthread_mutex_unlock(&t->mutex);
+    return played;
+}
+
+int audio_render_get_latency(AudioRenderAndroid *ar) {
+    (void)ar;
+    return atomic_load(&g_realtime) ? NULL_AUDIO_BUFFER_MS : 0;
+}
+
+void audio_render_flush(AudioRenderAndroid *ar) {
+    NullAudioTrack *t = (NullAudioTrack *)ar->audio_track;
+    if (!t) {
+        return;
+    }
+    pthread_mutex_lock(&t->mutex);
+    // AudioTrack.flush() сбрасывает только непроигранные данные, head не уходит назад
+    int64_t played = null_track_played(ar, t);
+    t->frames_written = played;
+    t->frames_played_base = played;
+    t->started_at_us = platform_now_us();
+    pthread_mutex_unlock(&t->mutex);
+}
+
+int audio_render_get_play_state(AudioRenderAndroid *ar) {
+    if (!ar->audio_track) {
+        return -1;
+    }
+    return ar->started ? 3 : 2;  // PLAYSTATE_PLAYING : PLAYSTATE_PAUSED
+}
@@ -0,0 +1,23 @@
+/// 🔧 PLATFORM (Linux): Null audio sink
+///
+/// Реализует API audio_render_android.h без AudioTrack: PCM отбрасывается,
+/// playback head считается по записанным сэмплам.
+
+#ifndef AUDIO_RENDER_NULL_H
+#define AUDIO_RENDER_NULL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Режим темпа null-sink (глобальный, задаётся до audio_threads_start)
+///
+/// @param realtime false (по умолчанию) — write() возвращается сразу, head = всё записанное
+///                 (throughput-режим для бенчмарков);
+///                 true — write() блокируется как AudioTrack: в буфере не больше
+///                 ~100ms, head движется по монотонным часам
+void audio_render_null_set_realtime(bool realtime);
+
+/// Суммарное количество сэмплов (на канал), принятых null-sink'ами
+int64_t audio_render_null_total_frames(void);
+
+#endif // AUDIO_RENDER_NULL_H
@@ -0,0 +1,53 @@
+/// 🔧 PLATFORM (Linux): platform_log_print → stderr
+
+#include "platform_log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+static int g_min_prio = -1;
+static pthread_once_t g_log_once = PTHREAD_ONCE_INIT;
+
+static void platform_log_init_level(void) {
+    const char *env = getenv("SMART_FFMPEG_LOG_LEVEL");
+    g_min_prio = ANDROID_LOG_WARN;
+    if (!env) {
+        return;
+    }
+    if (strcmp(env, "verbose") == 0) g_min_prio = ANDROID_LOG_VERBOSE;
+    else if (strcmp(env, "debug") == 0) g_min_prio = ANDROID_LOG_DEBUG;
+    else if (strcmp(env, "info") == 0) g_min_prio = ANDROID_LOG_INFO;
+    else if (strcmp(env, "warn") == 0) g_min_prio = ANDROID_LOG_WARN;
+    else if (strcmp(env, "error") == 0) g_min_prio = ANDROID_LOG_ERROR;
+    else if (strcmp(env, "silent") == 0) g_min_prio = ANDROID_LOG_SILENT;
+}
+
+static char prio_letter(int prio) {
+    switch (prio) {
+        case ANDROID_LOG_VERBOSE: return 'V';
+        case ANDROID_LOG_DEBUG:   return 'D';
+        case ANDROID_LOG_INFO:    return 'I';
+        case ANDROID_LOG_WARN:    return 'W';
+        case ANDROID_LOG_ERROR:   return 'E';
+        case ANDROID_LOG_FATAL:   return 'F';
+        default:                  return '?';
+    }
+}
+
+int platform_log_print(int prio, const char *tag, const char *fmt, ...) {
+    pthread_once(&g_log_once, platform_log_init_level);
+    if (prio < g_min_prio) {
+        return 0;
+    }
+
+    // Одна строка = один fprintf (stderr не буферизуется, строки потоков не перемешиваются)
+    char line[1024];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+
+    return fprintf(stderr, "%c/%s: %s\n", prio_letter(prio), tag ? tag : "", line);
+}
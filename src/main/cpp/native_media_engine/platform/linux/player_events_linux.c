@@ -0,0 +1,95 @@
+/// 🔧 PLATFORM (Linux): Реализация player_events.h без JNI
+
+#include "player_events.h"
+#include "player_events_linux.h"
+#include "platform_log.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+
+#define LOG_TAG "PlayerEvents"
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define ALOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+static pthread_mutex_t g_listener_mutex = PTHREAD_MUTEX_INITIALIZER;
+static PlayerEventListener g_listener = NULL;
+static void *g_listener_user = NULL;
+
+void player_events_linux_set_listener(PlayerEventListener listener, void *user) {
+    pthread_mutex_lock(&g_listener_mutex);
+    g_listener = listener;
+    g_listener_user = user;
+    pthread_mutex_unlock(&g_listener_mutex);
+}
+
+static void emit(const char *event, const char *arg) {
+    ALOGD("event %s%s%s", event, arg ? " " : "", arg ? arg : "");
+
+    pthread_mutex_lock(&g_listener_mutex);
+    PlayerEventListener listener = g_listener;
+    void *user = g_listener_user;
+    pthread_mutex_unlock(&g_listener_mutex);
+
+    if (listener) {
+        listener(event, arg, user);
+    }
+}
+
+void native_player_emit_prepared_event(int has_audio) {
+    emit("prepared", has_audio ? "audio" : "noAudio");
+}
+
+void native_player_emit_prepared_event_with_data(PlayerContext *ctx, int has_audio, int64_t duration_ms) {
+    (void)ctx;
+    char arg[64];
+    snprintf(arg, sizeof(arg), "hasAudio=%d duration=%" PRId64, has_audio, duration_ms);
+    emit("prepared", arg);
+}
+
+void native_player_emit_duration_event(int64_t duration_ms) {
+    char arg[32];
+    snprintf(arg, sizeof(arg), "%" PRId64, duration_ms);
+    emit("duration", arg);
+}
+
+void native_player_emit_surface_ready_event(void) {
+    emit("surfaceReady", NULL);
+}
+
+void native_player_emit_first_frame_event(void) {
+    emit("firstFrame", NULL);
+}
+
+void native_player_emit_first_frame_after_seek_event(void) {
+    emit("firstFrameAfterSeek", NULL);
+}
+
+void native_player_emit_completed_event(void) {
+    emit("completed", NULL);
+}
+
+void native_player_emit_audio_state_event(const char *state) {
+    emit("audioState", state);
+}
+
+void native_player_emit_error_event(const char *message) {
+    ALOGI("error event: %s", message ? message : "");
+    emit("error", message);
+}
+
+void native_player_emit_frame_stepped_event(int64_t pts_ms) {
+    char arg[32];
+    snprintf(arg, sizeof(arg), "%" PRId64, pts_ms);
+    emit("frameStepped", arg);
+}
+
+void native_player_emit_diagnostic_event(const char *type, const char *key, const char *value) {
+    char arg[128];
+    snprintf(arg, sizeof(arg), "%s.%s=%s", type ? type : "", key ? key : "", value ? value : "");
+    emit("diagnostic", arg);
+}
+
+void notify_flutter_event(PlayerContext *ctx, const char *event) {
+    (void)ctx;
+    emit(event, NULL);
+}
@@ -0,0 +1,20 @@
+/// 🔧 PLATFORM (Linux): Приёмник событий плеера
+///
+/// На host события (player_events.h) не уходят во Flutter, а передаются
+/// опциональному listener'у — бенчмарки и harness используют его,
+/// чтобы ловить completed / firstFrameAfterSeek / error.
+
+#ifndef PLAYER_EVENTS_LINUX_H
+#define PLAYER_EVENTS_LINUX_H
+
+/// Listener событий
+///
+/// @param event Имя события ("completed", "firstFrameAfterSeek", "error", ...)
+/// @param arg Аргумент события или NULL
+/// @param user Пользовательский указатель
+typedef void (*PlayerEventListener)(const char *event, const char *arg, void *user);
+
+/// Установить listener (NULL — отключить). Вызывается из любого потока плеера.
+void player_events_linux_set_listener(PlayerEventListener listener, void *user);
+
+#endif // PLAYER_EVENTS_LINUX_H
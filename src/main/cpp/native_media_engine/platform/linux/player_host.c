@@ -0,0 +1,144 @@
+/// 🔧 PLATFORM (Linux): Headless жизненный цикл плеера
+
+#include "player_host.h"
+#include "video_sink_null.h"
+#include "audio_render_null.h"
+#include "player_watchdog.h"
+#include "platform_time.h"
+#include "platform_log.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+#define LOG_TAG "PlayerHost"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+
+PlayerContext *player_host_open(const char *path) {
+    if (!path) {
+        return NULL;
+    }
+
+    PlayerContext *ctx = (PlayerContext *)calloc(1, sizeof(PlayerContext));
+    if (!ctx) {
+        return NULL;
+    }
+
+    // Та же инициализация, что и в nativeCreatePlayerContext
+    atomic_init(&ctx->seek_serial, 0);
+    player_state_init(&ctx->state);
+    ctx->jvm = NULL;
+    ctx->play_requested = 0;
+    ctx->playback_mode = MODE_AV;
+    ctx->avsync_gate_open = 0;
+    ctx->has_pending_seek = false;
+    ctx->pending_seek_seconds = 0.0;
+    ctx->pending_seek_exact = false;
+
+    int ret = open_media(ctx, path);
+    if (ret < 0) {
+        ALOGE("player_host_open: open_media failed: %d (%s)", ret, path);
+        close_media(ctx);
+        free(ctx);
+        return NULL;
+    }
+
+    if (ctx->videoStream < 0 || !ctx->video || !ctx->video->codecCtx) {
+        ALOGE("player_host_open: no video stream (%s)", path);
+        close_media(ctx);
+        free(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+int player_host_start(PlayerContext *ctx, bool realtime) {
+    if (!ctx || !ctx->video) {
+        return -1;
+    }
+
+    audio_render_null_set_realtime(realtime);
+
+    // Render loop (null) — аналог render_loop_start после attach surface
+    if (video_sink_null_start(ctx, realtime) < 0) {
+        return -1;
+    }
+
+    // AVSYNC-GATE open + DECODE-AUTO-START (как после eglMakeCurrent в render loop)
+    ctx->avsync_gate_open = 1;
+    ctx->decode_started = 1;
+    ctx->state.abort_request = 0;
+
+    if (pthread_create(&ctx->demuxThread, NULL, demux_thread, ctx) != 0) {
+        ALOGE("player_host_start: failed to create demux thread");
+        ctx->decode_started = 0;
+        return -1;
+    }
+
+    if (video_decode_thread_start(ctx->video, ctx->audio) < 0) {
+        ALOGE("player_host_start: failed to start video decode thread");
+        return -1;
+    }
+
+    ctx->play_requested = 1;
+    return play(ctx);
+}
+
+bool player_host_wait_eof(PlayerContext *ctx, int timeout_ms) {
+    if (!ctx) {
+        return false;
+    }
+
+    int64_t deadline_us = timeout_ms > 0 ? platform_now_us() + (int64_t)timeout_ms * 1000 : 0;
+    while (!ctx->eof_reached) {
+        if (deadline_us && platform_now_us() >= deadline_us) {
+            return false;
+        }
+        usleep(2000);
+    }
+    return true;
+}
+
+void player_host_close(PlayerContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+
+    // Порядок как в player_shutdown: флаги → render loop → очереди → потоки
+    ctx->shutting_down = 1;
+    ctx->state.abort_request = 1;
+    ctx->abort = 1;
+
+    video_sink_null_stop(ctx);
+
+    if (ctx->video && ctx->video->frameQueue) {
+        frame_queue_abort(ctx->video->frameQueue);
+    }
+    if (ctx->video && ctx->video->packetQueue) {
+        packet_queue_abort(ctx->video->packetQueue);
+    }
+    if (ctx->audio && ctx->audio->frameQueue) {
+        frame_queue_abort(ctx->audio->frameQueue);
+    }
+    if (ctx->audio && ctx->audio->packetQueue) {
+        packet_queue_abort(ctx->audio->packetQueue);
+    }
+
+    if (ctx->video) {
+        video_threads_stop(ctx->video);
+    }
+    if (ctx->audio) {
+        audio_threads_stop(ctx->audio);
+    }
+    if (ctx->demuxThread) {
+        pthread_join(ctx->demuxThread, NULL);
+        ctx->demuxThread = 0;
+    }
+
+    avsync_watchdog_stop(ctx);
+    seek_watchdog_stop(ctx);
+
+    close_media(ctx);
+    subtitle_manager_destroy(&ctx->subtitles);
+    free(ctx);
+}
@@ -0,0 +1,40 @@
+/// 🔧 PLATFORM (Linux): Headless жизненный цикл плеера
+///
+/// Повторяет на host то, что на Android делают nativeCreatePlayerContext,
+/// surfaceReady (AVSYNC-GATE open + DECODE-AUTO-START), nativePlay и
+/// player_shutdown — но с null audio/video sink'ами вместо AudioTrack и EGL.
+/// Используется бенчмарками (src/main/cpp/native_media_engine/bench).
+
+#ifndef PLAYER_HOST_H
+#define PLAYER_HOST_H
+
+#include "ffmpeg_player.h"
+#include <stdbool.h>
+
+/// Создать PlayerContext и открыть файл (open_media)
+///
+/// @param path Путь к медиафайлу
+/// @return Контекст или NULL при ошибке
+PlayerContext *player_host_open(const char *path);
+
+/// Запустить pipeline: null render loop, demux_thread, video_decode_thread, play()
+///
+/// @param ctx Контекст (из player_host_open)
+/// @param realtime false — null sink'и не ограничивают темп (throughput),
+///                 true — темп по PTS / эмулированному AudioTrack
+/// @return 0 при успехе, <0 при ошибке
+int player_host_start(PlayerContext *ctx, bool realtime);
+
+/// Дождаться EOF (handle_eof → PLAYBACK_EOF)
+///
+/// @param ctx Контекст
+/// @param timeout_ms Таймаут в миллисекундах (<=0 — без таймаута)
+/// @return true если EOF достигнут, false по таймауту
+bool player_host_wait_eof(PlayerContext *ctx, int timeout_ms);
+
+/// Остановить все потоки, закрыть файл и освободить контекст
+///
+/// @param ctx Контекст (после вызова невалиден)
+void player_host_close(PlayerContext *ctx);
+
+#endif // PLAYER_HOST_H
@@ -0,0 +1,194 @@
+/// 🔧 PLATFORM (Linux): Null video sink (реализация video_sink.h)
+
+#include "video_sink.h"
+#include "video_sink_null.h"
+#include "video_renderer.h"
+#include "frame_queue.h"
+#include "avsync_gate.h"
+#include "player_watchdog.h"
+#include "player_events.h"
+#include "platform_time.h"
+#include "platform_log.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LOG_TAG "VideoSinkNull"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define ALOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+static pthread_mutex_t g_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static VideoSinkNullStats g_stats;
+static atomic_int g_sink_abort = 0;
+static bool g_realtime = false;
+
+/// Сдвиг wall clock относительно PTS (realtime режим), сбрасывается при seek
+static pthread_mutex_t g_pace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int64_t g_pace_origin_us = 0;
+static double g_pace_origin_pts = NAN;
+
+void video_sink_clear(double seek_target_sec) {
+    pthread_mutex_lock(&g_pace_mutex);
+    g_pace_origin_us = 0;
+    g_pace_origin_pts = NAN;
+    pthread_mutex_unlock(&g_pace_mutex);
+    ALOGD("video_sink_clear: seek_target=%.3f", seek_target_sec);
+}
+
+static void pace_frame(double pts) {
+    if (!g_realtime || isnan(pts)) {
+        return;
+    }
+    pthread_mutex_lock(&g_pace_mutex);
+    if (isnan(g_pace_origin_pts)) {
+        g_pace_origin_pts = pts;
+        g_pace_origin_us = platform_now_us();
+    }
+    int64_t due_us = g_pace_origin_us + (int64_t)((pts - g_pace_origin_pts) * 1000000.0);
+    pthread_mutex_unlock(&g_pace_mutex);
+
+    int64_t wait_us = due_us - platform_now_us();
+    if (wait_us > 0) {
+        usleep((useconds_t)(wait_us > 100000 ? 100000 : wait_us));
+    }
+}
+
+/// "Показать" кадр: то, что render loop делает после eglSwapBuffers
+static void present_frame(PlayerContext *ctx, VideoState *vs, Frame *f) {
+    video_clock_on_frame_render(vs, f->frame);
+
+    if (!isnan(f->pts) && f->pts >= 0.0) {
+        ctx->master_clock_ms = (int64_t)(f->pts * 1000.0);
+        avsync_gate_update_video_clock(&ctx->avsync_gate, (int64_t)(f->pts * 1000000.0));
+    }
+    ctx->last_render_ts_ms = platform_now_us() / 1000;
+    vs->first_frame_rendered = 1;
+
+    // First frame after seek: открываем gate, возобновляем audio, гасим seek watchdog
+    if (!ctx->seek.in_progress && ctx->waiting_first_frame_after_seek) {
+        ctx->waiting_first_frame_after_seek = 0;
+        avsync_gate_set_seek_in_progress(&ctx->avsync_gate, false);
+        native_player_emit_first_frame_after_seek_event();
+
+        if (ctx->audio && ctx->has_audio) {
+            audio_resume(ctx->audio);
+            ctx->seek.drop_audio = false;
+        }
+        seek_watchdog_stop(ctx);
+
+        pthread_mutex_lock(&g_stats_mutex);
+        g_stats.seeks_completed++;
+        g_stats.last_seek_complete_us = platform_now_us();
+        pthread_mutex_unlock(&g_stats_mutex);
+    }
+
+    pthread_mutex_lock(&g_stats_mutex);
+    g_stats.frames_presented++;
+    pthread_mutex_unlock(&g_stats_mutex);
+}
+
+static void *video_sink_null_thread(void *arg) {
+    PlayerContext *ctx = (PlayerContext *)arg;
+    VideoState *vs = ctx->video;
+
+    ALOGI("Null render loop started (realtime=%d)", (int)g_realtime);
+
+    while (!atomic_load(&g_sink_abort) && !ctx->abort) {
+        if (ctx->paused) {
+            usleep(5000);
+            continue;
+        }
+
+        Frame f;
+        if (frame_queue_pop(vs->frameQueue, &f, false) <= 0) {
+            usleep(1000);
+            continue;
+        }
+
+        // Фильтрация старых эпох (как ШАГ 10.4 в render loop)
+        int current_serial = atomic_load(&ctx->seek_serial);
+        if (f.serial != current_serial) {
+            av_frame_free(&f.frame);
+            pthread_mutex_lock(&g_stats_mutex);
+            g_stats.frames_dropped_serial++;
+            pthread_mutex_unlock(&g_stats_mutex);
+            continue;
+        }
+
+        // Seek target (как ШАГ 10.6 в render loop)
+        if (ctx->seek.in_progress) {
+            double seek_target_sec = ctx->seek.target_ms / 1000.0;
+            if (!player_scrub_keyframe_preview(ctx) &&
+                !isnan(f.pts) && f.pts >= 0.0 && f.pts + 0.002 < seek_target_sec) {
+                av_frame_free(&f.frame);
+                pthread_mutex_lock(&g_stats_mutex);
+                g_stats.frames_dropped_seek++;
+                pthread_mutex_unlock(&g_stats_mutex);
+                continue;
+            }
+
+            ctx->seek.in_progress = false;
+            ctx->seek_in_progress = 0;
+            present_frame(ctx, vs, &f);
+            av_frame_free(&f.frame);
+
+            player_seek_run_pending(ctx);
+            continue;
+        }
+
+        pace_frame(f.pts);
+        present_frame(ctx, vs, &f);
+        av_frame_free(&f.frame);
+    }
+
+    ALOGI("Null render loop stopped");
+    return NULL;
+}
+
+int video_sink_null_start(PlayerContext *ctx, bool realtime) {
+    if (!ctx || !ctx->video || !ctx->video->frameQueue) {
+        return -1;
+    }
+    if (ctx->rendering) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&g_stats_mutex);
+    memset(&g_stats, 0, sizeof(g_stats));
+    pthread_mutex_unlock(&g_stats_mutex);
+    video_sink_clear(0.0);
+
+    g_realtime = realtime;
+    atomic_store(&g_sink_abort, 0);
+
+    if (pthread_create(&ctx->renderThread, NULL, video_sink_null_thread, ctx) != 0) {
+        ALOGE("video_sink_null_start: pthread_create failed");
+        return -1;
+    }
+    ctx->rendering = 1;
+    ctx->renderer_ready = 1;
+    return 0;
+}
+
+void video_sink_null_stop(PlayerContext *ctx) {
+    if (!ctx || !ctx->rendering) {
+        return;
+    }
+    atomic_store(&g_sink_abort, 1);
+    pthread_join(ctx->renderThread, NULL);
+    ctx->renderThread = 0;
+    ctx->rendering = 0;
+    ctx->renderer_ready = 0;
+}
+
+void video_sink_null_get_stats(VideoSinkNullStats *out) {
+    if (!out) {
+        return;
+    }
+    pthread_mutex_lock(&g_stats_mutex);
+    *out = g_stats;
+    pthread_mutex_unlock(&g_stats_mutex);
+}
@@ -0,0 +1,41 @@
+/// 🔧 PLATFORM (Linux): Null video sink
+///
+/// Заменяет render loop (video_render_gl.c) на host: забирает кадры из
+/// ctx->video->frameQueue, повторяет логику seek/serial/master clock
+/// render loop'а, но ничего не рисует.
+
+#ifndef VIDEO_SINK_NULL_H
+#define VIDEO_SINK_NULL_H
+
+#include "ffmpeg_player.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Статистика null-презентера
+typedef struct VideoSinkNullStats {
+    int64_t frames_presented;      // Кадры, "показанные" (обновили master clock)
+    int64_t frames_dropped_serial; // Кадры из старой эпохи seek
+    int64_t frames_dropped_seek;   // Кадры до seek target
+    int64_t seeks_completed;       // Первые кадры после seek
+    int64_t last_seek_complete_us; // platform_now_us() последнего завершения seek
+} VideoSinkNullStats;
+
+/// Запустить null render loop (ctx->renderThread)
+///
+/// @param ctx Контекст плеера (open_media уже выполнен)
+/// @param realtime true — кадры выдаются по PTS относительно старта,
+///                 false — как можно быстрее (throughput)
+/// @return 0 при успехе, <0 при ошибке
+int video_sink_null_start(PlayerContext *ctx, bool realtime);
+
+/// Остановить null render loop
+///
+/// @param ctx Контекст плеера
+void video_sink_null_stop(PlayerContext *ctx);
+
+/// Снимок статистики
+///
+/// @param out Куда записать статистику
+void video_sink_null_get_stats(VideoSinkNullStats *out);
+
+#endif // VIDEO_SINK_NULL_H
@@ -0,0 +1,87 @@
+/// 🔧 PLATFORM (Linux): Симулированный дисплей (реализация vsync_source.h)
+///
+/// Vsync'и строго через 1 / refresh_hz от старта: поток спит до абсолютного
+/// времени (clock_nanosleep TIMER_ABSTIME), поэтому опоздание пробуждения не
+/// накапливается, а timestamp — расчётный, как у аппаратного vsync.
+
+#include "vsync_source.h"
+#include "video_scheduler.h"
+#include "platform_time.h"
+#include "platform_log.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define LOG_TAG "VsyncSim"
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define ALOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+
+#define VSYNC_SIM_DEFAULT_HZ 60
+
+struct VsyncSource {
+    VsyncClock *clock;
+    int64_t period_us;
+    atomic_int abort;
+    pthread_t thread;
+};
+
+static void *vsync_sim_thread(void *arg) {
+    VsyncSource *src = arg;
+    int64_t next_us = platform_now_us() + src->period_us;
+
+    while (!atomic_load(&src->abort)) {
+        struct timespec ts = {
+            .tv_sec = (time_t)(next_us / 1000000),
+            .tv_nsec = (long)(next_us % 1000000) * 1000,
+        };
+        if (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+            continue;
+        }
+        vsync_clock_tick(src->clock, next_us);
+        next_us += src->period_us;
+
+        // Поток стоял дольше периода: пропущенные vsync'и не догоняем
+        int64_t now_us = platform_now_us();
+        if (next_us < now_us) {
+            next_us += (now_us - next_us) / src->period_us * src->period_us + src->period_us;
+        }
+    }
+    return NULL;
+}
+
+VsyncSource *vsync_source_start(VsyncClock *clock, int refresh_hz) {
+    if (!clock) {
+        return NULL;
+    }
+    if (refresh_hz <= 0) {
+        refresh_hz = VSYNC_SIM_DEFAULT_HZ;
+    }
+
+    VsyncSource *src = calloc(1, sizeof(*src));
+    if (!src) {
+        return NULL;
+    }
+    src->clock = clock;
+    src->period_us = (1000000 + refresh_hz / 2) / refresh_hz;
+    atomic_init(&src->abort, 0);
+    vsync_clock_set_period(clock, src->period_us);
+
+    if (pthread_create(&src->thread, NULL, vsync_sim_thread, src) != 0) {
+        ALOGE("Failed to create vsync thread");
+        free(src);
+        return NULL;
+    }
+    ALOGI("Simulated vsync started: %d Hz (period %lld us)", refresh_hz, (long long)src->period_us);
+    return src;
+}
+
+void vsync_source_stop(VsyncSource *src) {
+    if (!src) {
+        return;
+    }
+    atomic_store(&src->abort, 1);
+    pthread_join(src->thread, NULL);  // Не дольше одного периода
+    free(src);
+}
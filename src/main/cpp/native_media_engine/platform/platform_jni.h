@@ -0,0 +1,35 @@
+/// 🔧 PLATFORM: JNI / ANativeWindow типы
+///
+/// Ядро плеера хранит JavaVM*, jobject, jmethodID и ANativeWindow* в своих
+/// структурах, но само их не разыменовывает. На host эти типы объявлены
+/// непрозрачными, чтобы заголовки ядра компилировались без NDK.
+
+#ifndef PLATFORM_JNI_H
+#define PLATFORM_JNI_H
+
+#ifdef __ANDROID__
+
+#include <jni.h>
+#include <android/native_window.h>
+
+#else
+
+#include <stdint.h>
+
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef uint8_t jboolean;
+
+typedef struct _jobject *jobject;
+typedef jobject jclass;
+typedef jobject jstring;
+typedef struct _jmethodID *jmethodID;
+
+typedef struct _JavaVM JavaVM;
+typedef struct _JNIEnv JNIEnv;
+
+typedef struct ANativeWindow ANativeWindow;
+
+#endif // __ANDROID__
+
+#endif // PLATFORM_JNI_H
@@ -0,0 +1,42 @@
+/// 🔧 PLATFORM: Логирование
+///
+/// На Android — прямой __android_log_print (logcat).
+/// На host (Linux) — тот же API поверх stderr, чтобы ALOG* макросы
+/// в ffmpeg_player/*.c работали без изменений.
+
+#ifndef PLATFORM_LOG_H
+#define PLATFORM_LOG_H
+
+#ifdef __ANDROID__
+
+#include <android/log.h>
+
+#else
+
+/// Приоритеты совпадают с android_LogPriority
+typedef enum {
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT,
+} android_LogPriority;
+
+/// Вывести строку лога в stderr
+///
+/// Порог задаётся переменной окружения SMART_FFMPEG_LOG_LEVEL
+/// (verbose|debug|info|warn|error|silent), по умолчанию warn —
+/// чтобы логирование не искажало бенчмарки.
+/// @return Количество записанных байт, 0 если строка отфильтрована
+int platform_log_print(int prio, const char *tag, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define __android_log_print platform_log_print
+
+#endif // __ANDROID__
+
+#endif // PLATFORM_LOG_H
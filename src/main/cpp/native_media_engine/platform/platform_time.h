@@ -0,0 +1,38 @@
+/// 🔧 PLATFORM: Источник времени
+///
+/// Монотонные часы для clock.c и бенчмарков. CLOCK_MONOTONIC доступен
+/// и в bionic, и в glibc, поэтому реализация общая.
+
+#ifndef PLATFORM_TIME_H
+#define PLATFORM_TIME_H
+
+#include <stdint.h>
+#include <time.h>
+
+/// Монотонное время в микросекундах
+static inline int64_t platform_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/// Монотонное время в секундах
+static inline double platform_now_sec(void) {
+    return (double)platform_now_us() / 1000000.0;
+}
+
+/// CPU-время процесса (все потоки) в микросекундах
+static inline int64_t platform_process_cpu_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/// CPU-время вызывающего потока в микросекундах
+static inline int64_t platform_thread_cpu_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+#endif // PLATFORM_TIME_H
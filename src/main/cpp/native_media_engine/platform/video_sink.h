@@ -0,0 +1,16 @@
+/// 🔧 PLATFORM: Video sink
+///
+/// Точка, через которую ядро (ffmpeg_player.c) обращается к презентеру кадров.
+/// На Android это VideoRenderGL (g_renderer), на Linux — null-презентер
+/// (platform/linux/video_sink_null.c), который потребляет FrameQueue без вывода.
+
+#ifndef PLATFORM_VIDEO_SINK_H
+#define PLATFORM_VIDEO_SINK_H
+
+/// Сбросить состояние презентера после seek
+///
+/// Вызывается из perform_fast_seek после flush очередей.
+/// @param seek_target_sec Целевая позиция seek в секундах
+void video_sink_clear(double seek_target_sec);
+
+#endif // PLATFORM_VIDEO_SINK_H
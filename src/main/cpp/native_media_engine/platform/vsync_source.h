@@ -0,0 +1,29 @@
+/// 🔧 PLATFORM: Источник vsync
+///
+/// Поток источника вызывает vsync_clock_tick() на каждом vsync дисплея,
+/// VideoScheduler (ffmpeg_player/video_scheduler.h) планирует показ кадров
+/// по фазе и периоду из VsyncClock.
+/// На Android это AChoreographer (platform/android/vsync_source_android.c),
+/// на Linux — симулированный дисплей 60/90/120 Hz
+/// (platform/linux/vsync_source_sim.c): по нему качество каденса
+/// измеряется без устройства.
+
+#ifndef PLATFORM_VSYNC_SOURCE_H
+#define PLATFORM_VSYNC_SOURCE_H
+
+struct VsyncClock;
+
+typedef struct VsyncSource VsyncSource;
+
+/// Запустить источник (свой поток)
+///
+/// @param clock Получатель vsync'ов, должен жить до vsync_source_stop
+/// @param refresh_hz Частота симулированного дисплея (Linux), <= 0 — 60 Hz.
+///                   На Android игнорируется: период берётся от дисплея
+/// @return NULL при ошибке
+VsyncSource *vsync_source_start(struct VsyncClock *clock, int refresh_hz);
+
+/// Остановить поток источника и освободить его (NULL допустим)
+void vsync_source_stop(VsyncSource *src);
+
+#endif // PLATFORM_VSYNC_SOURCE_H
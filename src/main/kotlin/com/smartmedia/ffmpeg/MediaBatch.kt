@@ -0,0 +1,125 @@
+package com.smartmedia.ffmpeg
+
+/**
+ * Batch duration, metadata and thumbnail extraction for gallery-sized file lists.
+ *
+ * Files are processed natively on a fixed-size worker pool (one worker per core
+ * by default), each file opened and probed once. Results arrive on the calling
+ * thread as they complete, so run the batch from a background thread or
+ * `Dispatchers.IO` instead of launching one coroutine per file.
+ *
+ * ```
+ * MediaBatch.run(paths, MediaBatch.Options(thumbnailWidth = 320, thumbnailHeight = 180)) { result ->
+ *     gallery.update(paths[result.index], result)
+ *     !cancelled  // false stops the batch
+ * }
+ * ```
+ */
+object MediaBatch {
+
+    /**
+     * What to extract from each file.
+     *
+     * @param duration Fill [Result.durationMs]
+     * @param metadata Fill [Result.metadata] (same keys as [SmartFfmpegBridge.getVideoMetadata])
+     * @param thumbnail Fill [Result.thumbnail]
+     * @param thumbnailTimeMs Thumbnail position in milliseconds
+     * @param thumbnailWidth Thumbnail width (0 = video width)
+     * @param thumbnailHeight Thumbnail height (0 = video height)
+     * @param fastThumbnail Nearest keyframe instead of the exact frame (see [SmartFfmpegBridge.extractThumbnailFast])
+     * @param thumbnailFormat RGBA, or JPEG / WebP encoded natively on the worker (ready for a disk cache)
+     * @param thumbnailQuality 1..100 for compressed formats
+     * @param threads Worker count (0 = number of cores, capped natively)
+     */
+    data class Options(
+        val duration: Boolean = true,
+        val metadata: Boolean = true,
+        val thumbnail: Boolean = true,
+        val thumbnailTimeMs: Long = 1000L,
+        val thumbnailWidth: Int = 0,
+        val thumbnailHeight: Int = 0,
+        val fastThumbnail: Boolean = false,
+        val thumbnailFormat: ThumbnailFormat = ThumbnailFormat.RGBA,
+        val thumbnailQuality: Int = ThumbnailFormat.DEFAULT_QUALITY,
+        val threads: Int = 0
+    ) {
+        /** Native output mask (media_batch.h MediaBatchOutput). */
+        internal val outputMask: Int
+            get() = (if (duration) OUTPUT_DURATION else 0) or
+                (if (metadata) OUTPUT_METADATA else 0) or
+                (if (thumbnail) OUTPUT_THUMBNAIL else 0)
+    }
+
+    /**
+     * Result for one file.
+     *
+     * @property index Index in the input list
+     * @property path Input path
+     * @property durationMs Duration in milliseconds, or -1
+     * @property metadata Metadata map, or null if not requested / no video stream
+     * @property thumbnail RGBA pixel data or encoded image ([Options.thumbnailFormat]), or null if not requested / failed
+     * @property thumbnailWidth Width of [thumbnail]
+     * @property thumbnailHeight Height of [thumbnail]
+     * @property error Error message if the file or the thumbnail failed, else null
+     */
+    class Result(
+        val index: Int,
+        val path: String,
+        val durationMs: Long,
+        val metadata: Map<String, Any>?,
+        val thumbnail: ByteArray?,
+        val thumbnailWidth: Int,
+        val thumbnailHeight: Int,
+        val error: String?
+    )
+
+    /**
+     * Raw native callback used by [SmartFfmpegBridge.runMediaBatch].
+     */
+    fun interface Listener {
+        /**
+         * @return true to continue, false to cancel the remaining files
+         */
+        fun onResult(
+            index: Int,
+            durationMs: Long,
+            metadata: Map<String, Any>?,
+            thumbnail: ByteArray?,
+            thumbnailWidth: Int,
+            thumbnailHeight: Int,
+            error: String?
+        ): Boolean
+    }
+
+    internal const val OUTPUT_DURATION = 1
+    internal const val OUTPUT_METADATA = 2
+    internal const val OUTPUT_THUMBNAIL = 4
+
+    /**
+     * Process [paths] on the native worker pool. Blocks until every file is
+     * delivered or [onResult] returns false.
+     *
+     * @param paths Absolute paths to video files
+     * @param options What to extract
+     * @param onResult Called on the calling thread, in completion order; return false to cancel
+     * @return Number of delivered results, or -1 on error
+     */
+    @JvmStatic
+    @JvmOverloads
+    fun run(paths: List<String>, options: Options = Options(), onResult: (Result) -> Boolean): Int {
+        val pathArray = paths.toTypedArray()
+        return SmartFfmpegBridge.runMediaBatch(
+            pathArray,
+            options.outputMask,
+            options.thumbnailTimeMs,
+            options.thumbnailWidth,
+            options.thumbnailHeight,
+            options.fastThumbnail,
+            options.thumbnailFormat.value,
+            options.thumbnailQuality,
+            options.threads
+        ) { index, durationMs, metadata, thumbnail, width, height, error ->
+            onResult(Result(index, pathArray[index], durationMs, metadata, thumbnail, width, height, error))
+        }
+    }
+}
@@ -0,0 +1,180 @@
+package com.smartmedia.ffmpeg
+
+import java.io.Closeable
+import java.nio.ByteBuffer
+
+/**
+ * Open-once media handle for batched thumbnail and metadata calls.
+ *
+ * The file is opened and probed once; the demuxer, the video decoder and the
+ * scaler stay warm until [close], so repeated thumbnails from one file pay only
+ * seek + decode. Calls on one handle are serialized; use separate handles for
+ * parallel work.
+ *
+ * ```
+ * MediaHandle.open(path)?.use { media ->
+ *     val meta = media.getMetadata()
+ *     val thumb = media.extractThumbnail(5000L, 320, 180)
+ * }
+ * ```
+ */
+class MediaHandle private constructor(private var handle: Long) : Closeable {
+
+    companion object {
+        /**
+         * Open a video file.
+         *
+         * @param videoPath Absolute path to video file
+         * @return Handle, or null if the file cannot be opened or probed
+         */
+        @JvmStatic
+        fun open(videoPath: String): MediaHandle? {
+            val handle = SmartFfmpegBridge.openMediaHandle(videoPath)
+            return if (handle != 0L) MediaHandle(handle) else null
+        }
+    }
+
+    /** True after [close]. */
+    val isClosed: Boolean
+        @Synchronized get() = handle == 0L
+
+    /**
+     * Duration in milliseconds, or -1 if not available.
+     */
+    @Synchronized
+    fun getDuration(): Long = SmartFfmpegBridge.getMediaHandleDuration(checkOpen())
+
+    /**
+     * Metadata map (same keys as [SmartFfmpegBridge.getVideoMetadata]), or null if there is no video stream.
+     */
+    @Synchronized
+    fun getMetadata(): Map<String, Any>? = SmartFfmpegBridge.getMediaHandleMetadata(checkOpen())
+
+    /**
+     * Metadata JSON (same format as [SmartFfmpegBridge.getVideoMetadataJson]).
+     */
+    @Synchronized
+    fun getMetadataJson(): String = SmartFfmpegBridge.getMediaHandleMetadataJson(checkOpen())
+
+    /**
+     * Extract a thumbnail.
+     *
+     * @param timeMs Time position in milliseconds
+     * @param width Target width (0 = video width)
+     * @param height Target height (0 = video height)
+     * @param fast Return the nearest keyframe at or before [timeMs] instead of decoding
+     *             forward to it (see [SmartFfmpegBridge.extractThumbnailFast])
+     * @return ByteArray containing RGBA pixel data, or null on error
+     */
+    @JvmOverloads
+    @Synchronized
+    fun extractThumbnail(timeMs: Long, width: Int, height: Int, fast: Boolean = false): ByteArray? =
+        SmartFfmpegBridge.extractMediaHandleThumbnail(checkOpen(), timeMs, width, height, fast)
+
+    /**
+     * Extract a thumbnail compressed natively to JPEG or WebP
+     * (see [SmartFfmpegBridge.extractThumbnailEncoded]).
+     *
+     * @param timeMs Time position in milliseconds
+     * @param width Target width (0 = video width)
+     * @param height Target height (0 = video height)
+     * @param format [ThumbnailFormat.JPEG] or [ThumbnailFormat.WEBP]
+     * @param quality 1..100
+     * @param fast Nearest keyframe instead of the exact frame
+     * @return Encoded image bytes, or null on error or if [format] is not supported
+     */
+    @JvmOverloads
+    @Synchronized
+    fun extractThumbnailEncoded(
+        timeMs: Long,
+        width: Int,
+        height: Int,
+        format: ThumbnailFormat = ThumbnailFormat.JPEG,
+        quality: Int = ThumbnailFormat.DEFAULT_QUALITY,
+        fast: Boolean = false
+    ): ByteArray? {
+        require(format != ThumbnailFormat.RGBA) { "Use extractThumbnail for RGBA" }
+        return SmartFfmpegBridge.extractMediaHandleThumbnailEncoded(
+            checkOpen(), timeMs, width, height, fast, format.value, quality
+        )
+    }
+
+    /**
+     * Extract a thumbnail straight into a direct [buffer] without allocating
+     * (see [SmartFfmpegBridge.extractThumbnailInto]). With a reused buffer a
+     * warm handle decodes thumbnails with no per-call native or Java allocation.
+     *
+     * @param timeMs Time position in milliseconds
+     * @param width Target width (must be > 0)
+     * @param height Target height (must be > 0)
+     * @param buffer Direct buffer, e.g. from [SmartFfmpegBridge.allocateThumbnailBuffer]
+     * @param fast Nearest keyframe instead of the exact frame
+     * @param stride Bytes per row in [buffer] (0 = width * 4)
+     * @return true on success, false on error
+     */
+    @JvmOverloads
+    @Synchronized
+    fun extractThumbnailInto(
+        timeMs: Long,
+        width: Int,
+        height: Int,
+        buffer: ByteBuffer,
+        fast: Boolean = false,
+        stride: Int = 0
+    ): Boolean {
+        require(buffer.isDirect) { "Thumbnail buffer must be direct" }
+        return SmartFfmpegBridge.extractMediaHandleThumbnailInto(
+            checkOpen(), timeMs, width, height, fast, buffer, stride
+        )
+    }
+
+    /**
+     * Extract [count] thumbnails evenly spaced over [startMs, endMs) into one
+     * RGBA sprite sheet, in a single ordered pass over the file.
+     *
+     * Tile `i` targets the middle of the `i`-th of [count] equal intervals and is
+     * placed at column `i % columns`, row `i / columns`. With [keyframesOnly] each
+     * tile is the keyframe at or before its target and only keyframes are decoded,
+     * which is much faster for long GOPs.
+     *
+     * @param count Number of tiles
+     * @param tileWidth Tile width in pixels
+     * @param tileHeight Tile height in pixels
+     * @param columns Tiles per row (0 = single row strip)
+     * @param startMs Range start in milliseconds
+     * @param endMs Range end in milliseconds (0 = duration)
+     * @param keyframesOnly Snap tiles to keyframes instead of exact frames
+     * @param timestampsOut Receives the actual frame time of each tile, size >= [count], may be null
+     * @return ByteArray containing RGBA pixel data, or null on error
+     */
+    @JvmOverloads
+    @Synchronized
+    fun extractSpriteSheet(
+        count: Int,
+        tileWidth: Int,
+        tileHeight: Int,
+        columns: Int = 0,
+        startMs: Long = 0L,
+        endMs: Long = 0L,
+        keyframesOnly: Boolean = false,
+        timestampsOut: LongArray? = null
+    ): ByteArray? = SmartFfmpegBridge.extractMediaHandleSpriteSheet(
+        checkOpen(), count, tileWidth, tileHeight, columns, startMs, endMs, keyframesOnly, timestampsOut
+    )
+
+    /**
+     * Release the native demuxer, decoder and scaler. Safe to call twice.
+     */
+    @Synchronized
+    override fun close() {
+        if (handle != 0L) {
+            SmartFfmpegBridge.closeMediaHandle(handle)
+            handle = 0L
+        }
+    }
+
+    private fun checkOpen(): Long {
+        check(handle != 0L) { "MediaHandle is closed" }
+        return handle
+    }
+}
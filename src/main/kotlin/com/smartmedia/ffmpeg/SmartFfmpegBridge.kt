@@ -30,6 +30,101 @@ object SmartFfmpegBridge {
         height: Int
     ): ByteArray?
 
+    /**
+     * Extract a fast thumbnail: the nearest keyframe at or before [timeMs].
+     *
+     * Only keyframes are decoded, the loop filter is skipped and decoders that
+     * support it (MJPEG, MPEG-2/4, ...) decode at reduced resolution when the
+     * thumbnail is small. Much faster than [extractThumbnail] for gallery grids,
+     * at the cost of an exact position.
+     *
+     * @param videoPath Absolute path to video file
+     * @param timeMs Time position in milliseconds
+     * @param width Target width (0 = video width)
+     * @param height Target height (0 = video height)
+     * @return ByteArray containing RGBA pixel data, or null on error
+     */
+    @JvmStatic
+    external fun extractThumbnailFast(
+        videoPath: String,
+        timeMs: Long,
+        width: Int,
+        height: Int
+    ): ByteArray?
+
+    /**
+     * Extract a thumbnail straight into a caller-owned direct [ByteBuffer].
+     *
+     * Pixels (RGBA8888) are written by the scaler directly into the buffer
+     * memory: no Java array is allocated and nothing is copied. Reuse one buffer
+     * (see [allocateThumbnailBuffer]) across calls to keep gallery scrolling
+     * garbage-free. Pixels start at index 0; the buffer's position and limit
+     * are not changed.
+     *
+     * @param videoPath Absolute path to video file
+     * @param timeMs Time position in milliseconds
+     * @param width Target width (must be > 0)
+     * @param height Target height (must be > 0)
+     * @param fast Nearest keyframe (see [extractThumbnailFast]) instead of the exact frame
+     * @param buffer Direct buffer with capacity >= stride * (height - 1) + width * 4
+     * @param stride Bytes per row in [buffer] (0 = width * 4)
+     * @return true on success, false on error (buffer contents undefined)
+     */
+    @JvmStatic
+    external fun extractThumbnailInto(
+        videoPath: String,
+        timeMs: Long,
+        width: Int,
+        height: Int,
+        fast: Boolean,
+        buffer: ByteBuffer,
+        stride: Int
+    ): Boolean
+
+    /**
+     * Extract a thumbnail compressed natively to JPEG or WebP.
+     *
+     * The frame is scaled straight into the encoder's pixel format and encoded
+     * with the bundled libavcodec encoders: a few KB cross JNI instead of
+     * width * height * 4 bytes, and there is nothing left to compress in Kotlin.
+     *
+     * @param videoPath Absolute path to video file
+     * @param timeMs Time position in milliseconds
+     * @param width Target width (0 = video width)
+     * @param height Target height (0 = video height)
+     * @param fast Nearest keyframe (see [extractThumbnailFast]) instead of the exact frame
+     * @param format [ThumbnailFormat.JPEG] or [ThumbnailFormat.WEBP] value
+     * @param quality 1..100 (see [ThumbnailFormat.DEFAULT_QUALITY])
+     * @return Encoded image bytes, or null on error or if [format] is not supported
+     */
+    @JvmStatic
+    external fun extractThumbnailEncoded(
+        videoPath: String,
+        timeMs: Long,
+        width: Int,
+        height: Int,
+        fast: Boolean,
+        format: Int,
+        quality: Int
+    ): ByteArray?
+
+    /**
+     * Whether the bundled FFmpeg has an encoder for a [ThumbnailFormat] value
+     * (prefer [ThumbnailFormat.isSupported]).
+     */
+    @JvmStatic
+    external fun isThumbnailFormatSupported(format: Int): Boolean
+
+    /**
+     * Allocate a direct buffer sized for one [width] x [height] RGBA8888 thumbnail
+     * (for [extractThumbnailInto] and [MediaHandle.extractThumbnailInto]).
+     */
+    @JvmStatic
+    fun allocateThumbnailBuffer(width: Int, height: Int): ByteBuffer {
+        require(width > 0 && height > 0) { "Thumbnail size must be positive: ${width}x$height" }
+        return ByteBuffer.allocateDirect(width * height * 4)
+    }
+
     /**
      * Get video duration in milliseconds.
      *
@@ -69,6 +164,141 @@ object SmartFfmpegBridge {
     @JvmStatic
     external fun getVideoMetadataJson(videoPath: String): String
 
+    /**
+     * Open a media handle for batched calls (see [MediaHandle]).
+     *
+     * @param videoPath Absolute path to video file
+     * @return Native handle, or 0 on error
+     */
+    @JvmStatic
+    external fun openMediaHandle(videoPath: String): Long
+
+    /**
+     * Close a handle returned by [openMediaHandle]. 0 is ignored.
+     */
+    @JvmStatic
+    external fun closeMediaHandle(handle: Long)
+
+    /**
+     * Duration in milliseconds through an open handle, or -1.
+     */
+    @JvmStatic
+    external fun getMediaHandleDuration(handle: Long): Long
+
+    /**
+     * Metadata through an open handle (same keys as [getVideoMetadata]).
+     */
+    @JvmStatic
+    external fun getMediaHandleMetadata(handle: Long): Map<String, Any>?
+
+    /**
+     * Metadata JSON through an open handle (same format as [getVideoMetadataJson]).
+     */
+    @JvmStatic
+    external fun getMediaHandleMetadataJson(handle: Long): String
+
+    /**
+     * Thumbnail through an open handle: pays only seek + decode.
+     *
+     * @param fast Nearest keyframe (see [extractThumbnailFast]) instead of the exact frame
+     * @return ByteArray containing RGBA pixel data, or null on error
+     */
+    @JvmStatic
+    external fun extractMediaHandleThumbnail(
+        handle: Long,
+        timeMs: Long,
+        width: Int,
+        height: Int,
+        fast: Boolean
+    ): ByteArray?
+
+    /**
+     * Compressed thumbnail through an open handle (see [extractThumbnailEncoded]).
+     *
+     * @return Encoded image bytes, or null on error
+     */
+    @JvmStatic
+    external fun extractMediaHandleThumbnailEncoded(
+        handle: Long,
+        timeMs: Long,
+        width: Int,
+        height: Int,
+        fast: Boolean,
+        format: Int,
+        quality: Int
+    ): ByteArray?
+
+    /**
+     * Thumbnail through an open handle into a direct buffer (see [extractThumbnailInto]).
+     *
+     * @return true on success, false on error
+     */
+    @JvmStatic
+    external fun extractMediaHandleThumbnailInto(
+        handle: Long,
+        timeMs: Long,
+        width: Int,
+        height: Int,
+        fast: Boolean,
+        buffer: ByteBuffer,
+        stride: Int
+    ): Boolean
+
+    /**
+     * Sprite sheet through an open handle: [count] tiles from one ordered pass
+     * over the file, laid out row-major with [columns] tiles per row
+     * (0 = single row).
+     *
+     * @param startMs Range start in milliseconds
+     * @param endMs Range end in milliseconds (0 = duration)
+     * @param keyframesOnly Use the keyframe at or before each target and decode keyframes only
+     * @param timestampsOut Receives the actual frame time of each tile in milliseconds, may be null
+     * @return ByteArray containing RGBA pixel data (columns * tileWidth wide), or null on error
+     */
+    @JvmStatic
+    external fun extractMediaHandleSpriteSheet(
+        handle: Long,
+        count: Int,
+        tileWidth: Int,
+        tileHeight: Int,
+        columns: Int,
+        startMs: Long,
+        endMs: Long,
+        keyframesOnly: Boolean,
+        timestampsOut: LongArray?
+    ): ByteArray?
+
+    /**
+     * Process a list of files on a bounded native worker pool (see [MediaBatch]).
+     *
+     * Blocks until every file is delivered or [listener] returns false; the
+     * listener is called on the calling thread, in completion order.
+     *
+     * @param videoPaths Absolute paths to video files
+     * @param outputs Mask of duration (1), metadata (2), thumbnail (4)
+     * @param timeMs Thumbnail position in milliseconds
+     * @param width Thumbnail width (0 = video width)
+     * @param height Thumbnail height (0 = video height)
+     * @param fast Nearest keyframe thumbnails (see [extractThumbnailFast])
+     * @param format [ThumbnailFormat] value of the thumbnail bytes passed to [listener]
+     * @param quality 1..100 for compressed formats
+     * @param threads Worker count (0 = number of cores)
+     * @return Number of delivered results, or -1 on error
+     */
+    @JvmStatic
+    external fun runMediaBatch(
+        videoPaths: Array<String>,
+        outputs: Int,
+        timeMs: Long,
+        width: Int,
+        height: Int,
+        fast: Boolean,
+        format: Int,
+        quality: Int,
+        threads: Int,
+        listener: MediaBatch.Listener
+    ): Int
+
     /**
      * Get FFmpeg version string.
      *
@@ -0,0 +1,30 @@
+package com.smartmedia.ffmpeg
+
+/**
+ * Output format of a thumbnail.
+ *
+ * Compressed formats are encoded natively with the bundled libavcodec
+ * encoders, so a disk cache can store the bytes as they are instead of
+ * compressing RGBA again in Kotlin.
+ *
+ * @property value Native format id (media_handle.h MediaThumbnailFormat)
+ */
+enum class ThumbnailFormat(val value: Int) {
+    /** RGBA8888, width * height * 4 bytes. */
+    RGBA(0),
+
+    /** Baseline JPEG (libavcodec MJPEG encoder, always available). */
+    JPEG(1),
+
+    /** WebP (libwebp through libavcodec; only if FFmpeg was built with it, see [isSupported]). */
+    WEBP(2);
+
+    /** True if the bundled FFmpeg can produce this format. */
+    val isSupported: Boolean
+        get() = this == RGBA || SmartFfmpegBridge.isThumbnailFormatSupported(value)
+
+    companion object {
+        /** Default quality (1..100) for compressed formats. */
+        const val DEFAULT_QUALITY = 80
+    }
+}
@@ -0,0 +1,38 @@
+package com.smartmedia.ffmpeg
+
+import org.junit.Test
+import kotlin.test.assertEquals
+
+/**
+ * Unit tests for MediaBatch options mapping to the native output mask.
+ * These tests run on JVM without requiring Android device.
+ */
+class MediaBatchOptionsTest {
+
+    @Test
+    fun testDefaultOptionsRequestEverything() {
+        val options = MediaBatch.Options()
+        
+        assertEquals(7, options.outputMask, "Default batch should request duration, metadata and thumbnail")
+        assertEquals(0, options.threads, "Default worker count should be chosen natively")
+        assertEquals(ThumbnailFormat.RGBA, options.thumbnailFormat, "Default batch thumbnails should stay RGBA")
+    }
+    
+    @Test
+    fun testThumbnailFormatMatchesNativeValues() {
+        // media_handle.h: MEDIA_THUMB_RGBA = 0, MEDIA_THUMB_JPEG = 1, MEDIA_THUMB_WEBP = 2
+        assertEquals(0, ThumbnailFormat.RGBA.value)
+        assertEquals(1, ThumbnailFormat.JPEG.value)
+        assertEquals(2, ThumbnailFormat.WEBP.value)
+        assertEquals(80, MediaBatch.Options(thumbnailFormat = ThumbnailFormat.JPEG).thumbnailQuality)
+    }
+    
+    @Test
+    fun testOutputMaskMatchesNativeFlags() {
+        // media_batch.h: MEDIA_BATCH_DURATION = 1, MEDIA_BATCH_INFO = 2, MEDIA_BATCH_THUMBNAIL = 4
+        assertEquals(1, MediaBatch.Options(metadata = false, thumbnail = false).outputMask)
+        assertEquals(2, MediaBatch.Options(duration = false, thumbnail = false).outputMask)
+        assertEquals(4, MediaBatch.Options(duration = false, metadata = false).outputMask)
+        assertEquals(0, MediaBatch.Options(duration = false, metadata = false, thumbnail = false).outputMask)
+    }
+}